@@ -88,20 +88,200 @@ bool ROWDiff::initialize(int argc, char* argv[]) throw()
    return true;
 }
 
+/// Prints the differences found by diffStreams(), pairing the records of
+/// the two files that have the same epoch.  The records arrive in time
+/// order, so only the latest unpaired record needs to be kept.
+class ROWDiffPrinter
+{
+public:
+   ROWDiffPrinter(const Rinex3ObsHeader& h1, const Rinex3ObsHeader& h2,
+                  Rinex3ObsHeader::RinexObsMap& rom)
+      : header1(h1), header2(h2), intersectRom(rom),
+        havePending1(false), havePending2(false)
+   {}
+
+      /// A record that is only in the first file
+   void first(const Rinex3ObsData& d);
+      /// A record that is only in the second file
+   void second(const Rinex3ObsData& d);
+      /// Print any record that is still waiting for its pair
+   void flush();
+
+private:
+      /// print the records that are before time t
+   void flushBefore(const CommonTime& t);
+   void printBoth(const Rinex3ObsData& d1, const Rinex3ObsData& d2);
+   void printOne(char mark, const Rinex3ObsData& d,
+                 const Rinex3ObsHeader& header);
+
+   const Rinex3ObsHeader& header1;
+   const Rinex3ObsHeader& header2;
+   Rinex3ObsHeader::RinexObsMap& intersectRom;
+   Rinex3ObsData pending1, pending2;
+   bool havePending1, havePending2;
+};
+
+void ROWDiffPrinter::first(const Rinex3ObsData& d)
+{
+   flushBefore(d.time);
+   if (havePending2)
+   {
+      printBoth(d, pending2);
+      havePending2 = false;
+      return;
+   }
+   if (havePending1)
+      printOne('<', pending1, header1);
+   pending1 = d;
+   havePending1 = true;
+}
+
+void ROWDiffPrinter::second(const Rinex3ObsData& d)
+{
+   flushBefore(d.time);
+   if (havePending1)
+   {
+      printBoth(pending1, d);
+      havePending1 = false;
+      return;
+   }
+   if (havePending2)
+      printOne('>', pending2, header2);
+   pending2 = d;
+   havePending2 = true;
+}
+
+void ROWDiffPrinter::flush()
+{
+   if (havePending1)
+      printOne('<', pending1, header1);
+   if (havePending2)
+      printOne('>', pending2, header2);
+   havePending1 = havePending2 = false;
+}
+
+void ROWDiffPrinter::flushBefore(const CommonTime& t)
+{
+   if (havePending1 && pending1.time < t)
+   {
+      printOne('<', pending1, header1);
+      havePending1 = false;
+   }
+   if (havePending2 && pending2.time < t)
+   {
+      printOne('>', pending2, header2);
+      havePending2 = false;
+   }
+}
+
+void ROWDiffPrinter::printBoth(const Rinex3ObsData& d1,
+                               const Rinex3ObsData& d2)
+{
+   Rinex3ObsData::DataMap::const_iterator firstObsItr = d1.obs.begin();
+   Rinex3ObsData::DataMap::const_iterator secondObsItr = d2.obs.begin();
+      // For each satellite
+   while(firstObsItr != d1.obs.end() || secondObsItr != d2.obs.end())
+   {
+         // Both files have data for that satellite
+      if(firstObsItr != d1.obs.end() && secondObsItr != d2.obs.end() &&
+         firstObsItr->first == secondObsItr->first)
+      {
+         string sysString = string(1,firstObsItr->first.systemChar());
+         cout << "-" << setw(3) << (static_cast<YDSTime>(d1.time))
+              << ' ' << setw(2) << firstObsItr->first << ' ';
+         Rinex3ObsHeader::RinexObsVec::iterator romIt;
+         for (romIt = intersectRom[sysString].begin();
+              romIt != intersectRom[sysString].end();
+              romIt++)
+         {
+            size_t idx1 = header1.getObsIndex(sysString,*romIt);
+            size_t idx2 = header2.getObsIndex(sysString,*romIt);
+            cout << setw(15) << setprecision(3) << fixed
+                 << firstObsItr->second[idx1].data - secondObsItr->second[idx2].data
+                 << ' ' << romIt->asString() << ' ';
+         }
+         firstObsItr++;
+         secondObsItr++;
+      }
+         // Only file 1 has data for that satellite
+      else if (
+         (firstObsItr != d1.obs.end()) &&
+         (
+            (secondObsItr == d2.obs.end()) ||
+            (firstObsItr->first < secondObsItr->first))
+         )
+      {
+         string sysString = string(1,firstObsItr->first.systemChar());
+         cout << "<" << setw(3) << (static_cast<YDSTime>(d1.time))
+              << ' ' << setw(2) << firstObsItr->first << ' ';
+         Rinex3ObsHeader::RinexObsVec::iterator romIt;
+         for (romIt = intersectRom[sysString].begin();
+              romIt != intersectRom[sysString].end();
+              romIt++)
+         {
+            size_t idx = header1.getObsIndex(sysString,*romIt);
+            cout << setw(15) << setprecision(3) << fixed
+                 << firstObsItr->second[idx].data << ' ' << romIt->asString() << ' ';
+         }
+         firstObsItr++;
+      }
+         // Only file 2 has data for that satellite
+      else if (secondObsItr != d2.obs.end())
+      {
+         string sysString = string(1,secondObsItr->first.systemChar());
+         cout << ">" << setw(3) << (static_cast<YDSTime>(d2.time))
+              << ' ' << setw(2) << secondObsItr->first << ' ';
+         Rinex3ObsHeader::RinexObsVec::iterator romIt;
+         for (romIt = intersectRom[sysString].begin();
+              romIt != intersectRom[sysString].end();
+              romIt++)
+         {
+            size_t idx = header2.getObsIndex(sysString,*romIt);
+            cout << setw(15) << setprecision(3) << fixed
+                 << secondObsItr->second[idx].data << ' ' << romIt->asString() << ' ';
+         }
+         secondObsItr++;
+      }
+      cout << endl;
+   }
+}
+
+void ROWDiffPrinter::printOne(char mark, const Rinex3ObsData& d,
+                              const Rinex3ObsHeader& header)
+{
+   Rinex3ObsData::DataMap::const_iterator obsItr = d.obs.begin();
+   for (;obsItr != d.obs.end(); obsItr++)
+   {
+      cout << mark << setw(3) << (static_cast<YDSTime>(d.time))
+           << ' ' << setw(2) << obsItr->first << ' ';
+      string sysString = string(1,obsItr->first.systemChar());
+      Rinex3ObsHeader::RinexObsVec::iterator romIt;
+      for (romIt = intersectRom[sysString].begin();
+           romIt != intersectRom[sysString].end();
+           romIt++)
+      {
+         size_t idx = header.getObsIndex(sysString,*romIt);
+         cout << setw(15) << setprecision(3) << fixed
+              << obsItr->second[idx].data << ' ' << romIt->asString() << ' ';
+      }
+      cout << endl;
+   }
+}
+
 void ROWDiff::process()
 {
-   gpstk::FileFilterFrameWithHeader<Rinex3ObsStream, Rinex3ObsData, Rinex3ObsHeader>
-      ff1(inputFileOption.getValue()[0]), ff2(inputFileOption.getValue()[1]);
-
-   // no data?  FIX make this program faster.. if one file
-   // doesn't exist, there's little point in reading any.
-   if (ff1.emptyHeader())
-      cerr << "No header information for " << inputFileOption.getValue()[0]
-           << endl;
-   if (ff2.emptyHeader())
-      cerr << "No header information for " << inputFileOption.getValue()[1]
-           << endl;
-   if (ff1.emptyHeader() || ff2.emptyHeader())
+   typedef gpstk::FileFilterFrameWithHeader<Rinex3ObsStream, Rinex3ObsData,
+                                            Rinex3ObsHeader> FFF;
+   std::string file1(inputFileOption.getValue()[0]);
+   std::string file2(inputFileOption.getValue()[1]);
+   Rinex3ObsStream ros1(file1.c_str()), ros2(file2.c_str());
+
+   // no data?
+   if (!ros1.good())
+      cerr << "No header information for " << file1 << endl;
+   if (!ros2.good())
+      cerr << "No header information for " << file2 << endl;
+   if (!ros1.good() || !ros2.good())
    {
       cerr << "Check that files exist." << endl;
       cerr << "diff failed." << endl;
@@ -112,11 +292,13 @@ void ROWDiff::process()
    // determine whether the two input files have the same observation types
 
    Rinex3ObsHeader header1, header2;
-   Rinex3ObsStream ros1(inputFileOption.getValue()[0]), ros2(inputFileOption.getValue()[1]);
 
    ros1 >> header1;
    ros2 >> header2;
 
+   // the headers used to compare the data
+   Rinex3ObsHeader diffHeader1(header1), diffHeader2(header2);
+
    // find the obs data intersection
 
    if(header1.version != header2.version)
@@ -136,7 +318,7 @@ void ROWDiff::process()
             r2it++;
          }
          header1.mapObsTypes["G"] = r3ov;
-         ff1.frontHeader().mapObsTypes["G"] = r3ov;
+         diffHeader1.mapObsTypes["G"] = r3ov;
       }
       else if (header2.version < 3 && header1.version >= 3)
       {
@@ -149,7 +331,7 @@ void ROWDiff::process()
             r2it++;
          }
          header2.mapObsTypes["G"] = r3ov;
-         ff2.frontHeader().mapObsTypes["G"] = r3ov;
+         diffHeader2.mapObsTypes["G"] = r3ov;
       }
    }
 
@@ -224,15 +406,18 @@ void ROWDiff::process()
       }
    }
 
-   std::list<Rinex3ObsData> a =
-      ff1.halfDiff(ff2,Rinex3ObsDataOperatorLessThanFull(intersectRom), precision);
-   std::list<Rinex3ObsData> b =
-      ff2.halfDiff(ff1, Rinex3ObsDataOperatorLessThanFull(intersectRom), precision);
-
-   pair< list<Rinex3ObsData>, list<Rinex3ObsData> > difflist =
-      pair< list<Rinex3ObsData>, list<Rinex3ObsData> >( a, b);
+   // compare the files one epoch at a time, printing the differences
+   // as they are found
+   ROWDiffPrinter printer(header1, header2, intersectRom);
+   auto first = [&printer](const Rinex3ObsData& d) { printer.first(d); };
+   auto second = [&printer](const Rinex3ObsData& d) { printer.second(d); };
+   unsigned long ndiff =
+      FFF::diffStreams(ros1, diffHeader1, ros2, diffHeader2,
+                       Rinex3ObsDataOperatorLessThanFull(intersectRom),
+                       precision, first, second);
+   printer.flush();
 
-   if (difflist.first.empty() && difflist.second.empty())
+   if (ndiff == 0)
    {
       //Indicate to the user, before exiting, that rowdiff
       //performed properly and no differences were found.
@@ -244,129 +429,6 @@ void ROWDiff::process()
 
       // differences found
    exitCode = DIFFS_CODE;
-
-   list<Rinex3ObsData>::iterator firstDiffItr = difflist.first.begin();
-   list<Rinex3ObsData>::iterator secondDiffItr = difflist.second.begin();
-   while(firstDiffItr != difflist.first.end() || secondDiffItr != difflist.second.end())
-   {
-         //Epoch in both files
-      if(firstDiffItr->time == secondDiffItr->time)
-      {
-         Rinex3ObsData::DataMap::iterator firstObsItr = firstDiffItr->obs.begin();
-         Rinex3ObsData::DataMap::iterator secondObsItr = secondDiffItr->obs.begin();
-            // For each satellite
-         while(firstObsItr != firstDiffItr->obs.end() || secondObsItr != secondDiffItr->obs.end())
-         {
-               // Both files have data for that satellite
-            if(firstObsItr->first == secondObsItr->first)
-            {
-               string sysString = string(1,firstObsItr->first.systemChar());
-               cout << "-" << setw(3) << (static_cast<YDSTime>(firstDiffItr->time))
-                    << ' ' << setw(2) << firstObsItr->first << ' ';
-               Rinex3ObsHeader::RinexObsVec::iterator romIt;
-               for (romIt = intersectRom[sysString].begin();
-                    romIt != intersectRom[sysString].end();
-                    romIt++)
-               {
-                  size_t idx1 = header1.getObsIndex(sysString,*romIt);
-                  size_t idx2 = header2.getObsIndex(sysString,*romIt);
-                  cout << setw(15) << setprecision(3) << fixed
-                       << firstObsItr->second[idx1].data - secondObsItr->second[idx2].data
-                       << ' ' << romIt->asString() << ' ';
-               }
-               firstObsItr++;
-               secondObsItr++;
-            }
-               // Only file 1 has data for that satellite
-            else if (
-               (firstObsItr != firstDiffItr->obs.end()) &&
-               (
-                  (secondObsItr == secondDiffItr->obs.end()) ||
-                  (firstObsItr->first.id < secondObsItr->first.id))
-               )
-            {
-               string sysString = string(1,firstObsItr->first.systemChar());
-               cout << "<" << setw(3) << (static_cast<YDSTime>(firstDiffItr->time))
-                    << ' ' << setw(2) << firstObsItr->first << ' ';
-               Rinex3ObsHeader::RinexObsVec::iterator romIt;
-               for (romIt = intersectRom[sysString].begin();
-                    romIt != intersectRom[sysString].end();
-                    romIt++)
-               {
-                  size_t idx = header1.getObsIndex(sysString,*romIt);
-                  cout << setw(15) << setprecision(3) << fixed
-                       << firstObsItr->second[idx].data << ' ' << romIt->asString() << ' ';
-               }
-               firstObsItr++;
-            }
-               // Only file 2 has data for that satellite
-            else if (secondObsItr != secondDiffItr->obs.end())
-            {
-               string sysString = string(1,secondObsItr->first.systemChar());
-               cout << ">" << setw(3) << (static_cast<YDSTime>(secondDiffItr->time))
-                    << ' ' << setw(2) << secondObsItr->first << ' ';
-               Rinex3ObsHeader::RinexObsVec::iterator romIt;
-               for (romIt = intersectRom[sysString].begin();
-                    romIt != intersectRom[sysString].end();
-                    romIt++)
-               {
-                  size_t idx = header2.getObsIndex(sysString,*romIt);
-                  cout << setw(15) << setprecision(3) << fixed
-                       << secondObsItr->second[idx].data << ' ' << romIt->asString() << ' ';
-               }
-               secondObsItr++;
-            }
-            cout << endl;
-         }
-
-         firstDiffItr++;
-         secondDiffItr++;
-      }
-         //Epoch only in first file
-      else if((firstDiffItr != difflist.first.end()) && firstDiffItr->time < secondDiffItr->time)
-      {
-         Rinex3ObsData::DataMap::iterator firstObsItr = firstDiffItr->obs.begin();
-         for (;firstObsItr != firstDiffItr->obs.end(); firstObsItr++)
-         {
-            cout << "<" << setw(3) << (static_cast<YDSTime>(firstDiffItr->time))
-                 << ' ' << setw(2) << firstObsItr->first << ' ';
-            string sysString = string(1,firstObsItr->first.systemChar());
-            Rinex3ObsHeader::RinexObsVec::iterator romIt;
-            for (romIt = intersectRom[sysString].begin();
-                 romIt != intersectRom[sysString].end();
-                 romIt++)
-            {
-               size_t idx = header1.getObsIndex(sysString,*romIt);
-               cout << setw(15) << setprecision(3) << fixed
-                    << firstObsItr->second[idx].data << ' ' << romIt->asString() << ' ';
-            }
-            cout << endl;
-         }
-         firstDiffItr++;
-      }
-         //Epoch only in second file
-      else if (secondDiffItr != difflist.second.end()) // && (secondDiffItr->time < firstDiffItr->time)
-      {
-         Rinex3ObsData::DataMap::iterator secondObsItr = secondDiffItr->obs.begin();
-         for (;secondObsItr != secondDiffItr->obs.end(); secondObsItr++)
-         {
-            cout << ">" << setw(3) << (static_cast<YDSTime>(secondDiffItr->time))
-                 << ' ' << setw(2) << secondObsItr->first << ' ';
-            string sysString = string(1,secondObsItr->first.systemChar());
-            Rinex3ObsHeader::RinexObsVec::iterator romIt;
-            for (romIt = intersectRom[sysString].begin();
-                 romIt != intersectRom[sysString].end();
-                 romIt++)
-            {
-               size_t idx = header2.getObsIndex(sysString,*romIt);
-               cout << setw(15) << setprecision(3) << fixed
-                    << secondObsItr->second[idx].data << ' ' << romIt->asString() << ' ';
-            }
-            cout << endl;
-         }
-         secondDiffItr++;
-      }
-   }
 }
 
 int main(int argc, char* argv[])
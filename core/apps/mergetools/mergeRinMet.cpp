@@ -39,6 +39,8 @@
 // mergeRinMet
 // Merge and sort rinex metrological files
 
+#include <cstdio>
+
 #include "RinexMetStream.hpp"
 #include "RinexMetHeader.hpp"
 #include "RinexMetData.hpp"
@@ -63,16 +65,92 @@ public:
    
 protected:
    virtual void process();
+
+private:
+   typedef FileFilterFrameWithHeader<RinexMetStream, RinexMetData,
+                                     RinexMetHeader> FFF;
+
+      /** merge the files one record at a time, into a temporary file
+       * that replaces the output only if every file is in time order;
+       * return false, leaving the output untouched, if one is not */
+   bool streamMerge(const std::vector<std::string>& files);
+      /// merge the files in memory, in any order
+   void sortMerge(const std::vector<std::string>& files);
+      /// set the pgm/runby/date field
+   void setProgram(RinexMetHeader& header);
 };
 
 void MergeRinMet::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
+   if (!streamMerge(files))
+      sortMerge(files);
+}
+
+bool MergeRinMet::streamMerge(const std::vector<std::string>& files)
+{
+   FFF::StreamList streams;
+   std::list<RinexMetHeader> headers;
+   FFF::openStreams(files, streams, headers);
+
+      // get the header data
+   RinexMetHeaderTouchHeaderMerge merged;
+   for (const auto& h : headers)
+      merged(h);
+   setProgram(merged.theHeader);
+
+      // make the directory (if needed) and write the header to the
+      // temporary file
+   std::string outputFile = outputFileOption.getValue().front();
+   std::string::size_type pos = outputFile.rfind('/');
+   if (pos != std::string::npos)
+      FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+
+   std::string tmpFile = outputFile + ".tmp";
+   bool sorted;
+   try
+   {
+      RinexMetStream strm(tmpFile.c_str(), std::ios::out|std::ios::trunc);
+      strm.exceptions(std::ios::failbit);
+      strm << merged.theHeader;
+
+         // merge and filter the data; the merge stops if a file is out
+         // of order
+      auto write = [&strm](const RinexMetData& data) { strm << data; };
+      FFF::mergeStreams(streams,
+                        RinexMetDataOperatorLessThanFull(merged.obsSet),
+                        RinexMetDataOperatorEqualsSimple(),
+                        write, sorted);
+   }
+   catch (...)
+   {
+      std::remove(tmpFile.c_str());
+      throw;
+   }
+
+   if (!sorted)
+   {
+      std::remove(tmpFile.c_str());
+      cerr << "mergeRinMet: an input file is not in time order;"
+           << " sorting all the input in memory." << endl;
+      return false;
+   }
+   if (std::rename(tmpFile.c_str(), outputFile.c_str()) != 0)
+   {
+      std::remove(tmpFile.c_str());
+      Exception e("Could not rename " + tmpFile + " to " + outputFile);
+      GPSTK_THROW(e);
+   }
+
+   return true;
+}
+
+void MergeRinMet::sortMerge(const std::vector<std::string>& files)
+{
       // FFF will sort and merge the data using
       // a simple time check
-   FileFilterFrameWithHeader<RinexMetStream, RinexMetData, RinexMetHeader> 
-      fff(files);
+   FFF fff(files);
 
       // get the header data
    RinexMetHeaderTouchHeaderMerge merged;
@@ -82,16 +160,20 @@ void MergeRinMet::process()
    fff.sort(RinexMetDataOperatorLessThanFull(merged.obsSet));
    fff.unique(RinexMetDataOperatorEqualsSimple());
    
-      // set the pgm/runby/date field
-   merged.theHeader.fileProgram = std::string("mergeRinMet");
-   merged.theHeader.fileAgency = std::string("gpstk");
-   merged.theHeader.date = CivilTime(SystemTime()).asString();
+   setProgram(merged.theHeader);
 
       // write the header
    std::string outputFile = outputFileOption.getValue().front();
    fff.writeFile(outputFile, merged.theHeader);
 }
 
+void MergeRinMet::setProgram(RinexMetHeader& header)
+{
+   header.fileProgram = std::string("mergeRinMet");
+   header.fileAgency = std::string("gpstk");
+   header.date = CivilTime(SystemTime()).asString();
+}
+
 int main(int argc, char* argv[])
 {
    try
@@ -39,6 +39,8 @@
 // mergeRinObs
 // Merge and sort rinex observation files
 
+#include <cstdio>
+
 #include "RinexObsStream.hpp"
 #include "RinexObsHeader.hpp"
 #include "RinexObsData.hpp"
@@ -63,16 +65,115 @@ public:
 
 protected:
    virtual void process();
+
+private:
+   typedef FileFilterFrameWithHeader<RinexObsStream, RinexObsData,
+                                     RinexObsHeader> FFF;
+
+      /** merge the files one record at a time, into a temporary file
+       * that replaces the output only if every file is in time order;
+       * return false, leaving the output untouched, if one is not */
+   bool streamMerge(const std::vector<std::string>& files);
+      /// merge the files in memory, in any order
+   void sortMerge(const std::vector<std::string>& files);
+      /// set the pgm/runby/date field
+   void setProgram(RinexObsHeader& header);
+};
+
+   /// Write the merged header just before the first record, which gives
+   /// the time of first obs, then write each record.
+struct MergedObsWriter
+{
+   MergedObsWriter(RinexObsStream& s, RinexObsHeader& h)
+      : strm(s), header(h), headerWritten(false)
+   {}
+
+   void operator()(const RinexObsData& data)
+   {
+      if (!headerWritten)
+      {
+         header.firstObs = data.time;
+         strm << header;
+         headerWritten = true;
+      }
+      strm << data;
+   }
+
+   RinexObsStream& strm;
+   RinexObsHeader& header;
+   bool headerWritten;
 };
 
 void MergeRinObs::process()
 {
    std::vector<std::string> files = inputFileOption.getValue();
 
+   if (!streamMerge(files))
+      sortMerge(files);
+}
+
+bool MergeRinObs::streamMerge(const std::vector<std::string>& files)
+{
+   FFF::StreamList streams;
+   std::list<RinexObsHeader> headers;
+   FFF::openStreams(files, streams, headers);
+
+      // get the header data
+   RinexObsHeaderTouchHeaderMerge merged;
+   for (const auto& h : headers)
+      merged(h);
+   setProgram(merged.theHeader);
+
+      // make the directory (if needed) and write the temporary file,
+      // merging and filtering the data using the obs set from the
+      // merged header; the merge stops if a file is out of order
+   std::string outputFile = outputFileOption.getValue().front();
+   std::string::size_type pos = outputFile.rfind('/');
+   if (pos != std::string::npos)
+      FileUtils::makeDir(outputFile.substr(0,pos).c_str(), 0755);
+
+   std::string tmpFile = outputFile + ".tmp";
+   bool sorted;
+   try
+   {
+      RinexObsStream strm(tmpFile.c_str(), std::ios::out|std::ios::trunc);
+      strm.exceptions(std::ios::failbit);
+      MergedObsWriter writer(strm, merged.theHeader);
+      FFF::mergeStreams(streams,
+                        RinexObsDataOperatorLessThanFull(merged.obsSet),
+                        RinexObsDataOperatorEqualsSimple(),
+                        writer, sorted);
+      if (sorted && !writer.headerWritten)
+         strm << merged.theHeader;
+   }
+   catch (...)
+   {
+      std::remove(tmpFile.c_str());
+      throw;
+   }
+
+   if (!sorted)
+   {
+      std::remove(tmpFile.c_str());
+      cerr << "mergeRinObs: an input file is not in time order;"
+           << " sorting all the input in memory." << endl;
+      return false;
+   }
+   if (std::rename(tmpFile.c_str(), outputFile.c_str()) != 0)
+   {
+      std::remove(tmpFile.c_str());
+      Exception e("Could not rename " + tmpFile + " to " + outputFile);
+      GPSTK_THROW(e);
+   }
+
+   return true;
+}
+
+void MergeRinObs::sortMerge(const std::vector<std::string>& files)
+{
       // FFF will sort and merge the obs data using
       // a simple time check
-   FileFilterFrameWithHeader<RinexObsStream, RinexObsData, RinexObsHeader> 
-      fff(files);
+   FFF fff(files);
 
       // get the header data
    RinexObsHeaderTouchHeaderMerge merged;
@@ -84,17 +185,20 @@ void MergeRinObs::process()
    
       // set the time of first obs in the header
    merged.theHeader.firstObs = fff.front().time;
-
-      // set the pgm/runby/date field
-   merged.theHeader.fileProgram = std::string("mergeRinObs");
-   merged.theHeader.fileAgency = std::string("gpstk");
-   merged.theHeader.date = CivilTime(SystemTime()).asString();
+   setProgram(merged.theHeader);
 
       // write the file
    std::string outputFile = outputFileOption.getValue().front();
    fff.writeFile(outputFile, merged.theHeader);
 }
 
+void MergeRinObs::setProgram(RinexObsHeader& header)
+{
+   header.fileProgram = std::string("mergeRinObs");
+   header.fileAgency = std::string("gpstk");
+   header.date = CivilTime(SystemTime()).asString();
+}
+
 int main(int argc, char* argv[])
 {
    try
@@ -204,6 +204,8 @@ public:
    double SlopeLimit;         // Upper limit on RAIM 'slope'
    int maxReject;             // Max number of sats to reject [-1 for no limit]
    int nIter;                 // Maximum iteration count in linearized LS
+   int nThreads;              // Number of threads used in RAIM [0 for all cores]
+   bool rankUpdate;           // Screen RAIM combinations using rank updates
    double convLimit;          // Minimum convergence criterion in estimation (meters)
 
    string TropStr;            // temp used to parse --trop
@@ -491,6 +493,8 @@ public:
       prs.SlopeLimit = C.SlopeLimit;
       prs.NSatsReject = C.maxReject;
       prs.MaxNIterations = C.nIter;
+      prs.NThreads = C.nThreads;
+      prs.RankUpdateRAIM = C.rankUpdate;
       prs.ConvergenceLimit = C.convLimit;
 
       // initialize apriori solution
@@ -1649,6 +1653,8 @@ void Configuration::SetDefaults(void) throw()
       SlopeLimit = dummy.SlopeLimit;
       maxReject = dummy.NSatsReject;
       nIter = dummy.MaxNIterations;
+      nThreads = dummy.NThreads;
+      rankUpdate = dummy.RankUpdateRAIM;
       convLimit = dummy.ConvergenceLimit;
    }
 
@@ -1926,6 +1932,10 @@ string Configuration::BuildCommandLine(void) throw()
             "Maximum iteration count in linearized LS");
    opts.Add(0, "conv", "lim", false, false, &convLimit, "",
             "Maximum convergence criterion in estimation in meters");
+   opts.Add(0, "threads", "n", false, false, &nThreads, "",
+            "Number of threads used in the RAIM algorithm [0 for all cores]");
+   opts.Add(0, "rankUpdate", "", false, false, &rankUpdate, "",
+            "Screen RAIM combinations by rank updates of the all-sat. solution");
    opts.Add(0, "Trop", "m,T,P,H", false, false, &TropStr, "",
             "Trop model <m> [one of Zero,Black,Saas,NewB,Neill,GG,GGHt,Global\n"
             "                      with optional weather T(C),P(mb),RH(%)]");
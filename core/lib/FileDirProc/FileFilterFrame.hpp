@@ -44,6 +44,9 @@
 #ifndef GPSTK_FILEFILTERFRAME_HPP
 #define GPSTK_FILEFILTERFRAME_HPP
 
+#include <memory>
+#include <vector>
+
 #include "FileSpec.hpp"
 #include "FileFilter.hpp"
 #include "FileSpecFind.hpp"
@@ -68,6 +71,11 @@ namespace gpstk
        * to.  
        *
        * See the examples in FileFilterFrameTest.cpp for a demonstration.
+       *
+       * For inputs too large to hold in memory, mergeStreams() and
+       * diffStreams() do the work of sort()/unique() and diff() on
+       * files that are already sorted, reading one record at a time
+       * from each file instead of loading them.
        */
    template <class FileStream, class FileData>
    class FileFilterFrame : public FileFilter<FileData>
@@ -166,6 +174,108 @@ namespace gpstk
           */
       bool writeFile(FileStream& stream) const;
 
+         /// Streams to be merged by mergeStreams().
+      typedef std::vector< std::shared_ptr<FileStream> > StreamList;
+
+         /**
+          * Merge the data of several streams, each already sorted by
+          * comp, into a single sequence sorted by comp, dropping
+          * duplicates as unique(equal) does.  Only the next record of
+          * each stream is held (in a heap), so memory does not grow with
+          * the length of the streams.  Records that compare equal are
+          * taken in the order of the streams, so the output is that of
+          * reading the streams in order with addData() followed by
+          * sort(comp) and unique(equal).
+          * @param[in] streams the input streams, positioned at their
+          *   first data record (i.e. after the header, if any)
+          * @param[in] comp strict weak ordering of the data
+          * @param[in] equal test for duplicates
+          * @param[in] op operation called as op(data) for each record
+          *   of the merged output, in order
+          * @return the number of records passed to op
+          * @throw InvalidRequest if a stream is not sorted by comp; op
+          *   has then already been called for part of the output
+          */
+      template <class Compare, class BinaryPredicate, class Operation>
+      static unsigned long mergeStreams(const StreamList& streams,
+                                        Compare comp,
+                                        BinaryPredicate equal,
+                                        Operation& op);
+
+         /**
+          * As mergeStreams() above, but a stream that is not sorted by
+          * comp stops the merge without an exception.  The order of
+          * each stream is checked against its previous record as it is
+          * read, so the streams are read only once.
+          * @param[out] sorted false if the merge stopped at a stream
+          *   that is not sorted; op has then been called for part of
+          *   the output, which the caller should discard.
+          * @return the number of records passed to op */
+      template <class Compare, class BinaryPredicate, class Operation>
+      static unsigned long mergeStreams(const StreamList& streams,
+                                        Compare comp,
+                                        BinaryPredicate equal,
+                                        Operation& op,
+                                        bool& sorted);
+
+         /**
+          * Merge the data of the given files, each already sorted by
+          * comp, onto output with mergeStreams().  Files that can not
+          * be opened are skipped, as in the constructors.
+          * @warning As writeFile(), this does not write headers.
+          * @return the number of records written
+          * @throw InvalidRequest if a file is not sorted by comp
+          * @throw Exception when there's a file error
+          */
+      template <class Compare, class BinaryPredicate>
+      static unsigned long mergeFiles(const std::vector<std::string>& fileList,
+                                      FileStream& output,
+                                      Compare comp,
+                                      BinaryPredicate equal);
+
+         /**
+          * Compare two streams, both sorted by comp, one record at a
+          * time.  Records of left that are not in right are passed to
+          * leftOnly, and records of right that are not in left to
+          * rightOnly, in the order of comp; this is the result of diff()
+          * without loading either stream.
+          * @param[in] left,right the input streams, positioned at their
+          *   first data record
+          * @param[in] comp strict weak ordering of the data
+          * @param[in] leftOnly operation called as leftOnly(data)
+          * @param[in] rightOnly operation called as rightOnly(data)
+          * @return the number of records passed to leftOnly and rightOnly
+          */
+      template <class Compare, class Operation1, class Operation2>
+      static unsigned long diffStreams(FileStream& left,
+                                       FileStream& right,
+                                       Compare comp,
+                                       Operation1& leftOnly,
+                                       Operation2& rightOnly);
+
+   protected:
+         /** The walk of diffStreams(), with leftLess(l,r) comparing a
+          * record l of left with a record r of right, and rightLess(r,l)
+          * the reverse, for comparisons that depend on the stream. */
+      template <class Compare1, class Compare2,
+                class Operation1, class Operation2>
+      static unsigned long diffSorted(FileStream& left,
+                                      FileStream& right,
+                                      Compare1 leftLess,
+                                      Compare2 rightLess,
+                                      Operation1& leftOnly,
+                                      Operation2& rightOnly);
+
+         /// Read the next record of s into data; data is unchanged at EOF.
+      static bool readRecord(FileStream& s, FileData& data)
+      {
+         FileData next;
+         if (!(s >> next))
+            return false;
+         std::swap(data, next);
+         return true;
+      }
+
    protected:
          /**  Run init() to load the data into the filter.
           * @throw Exception */
@@ -337,6 +447,175 @@ namespace gpstk
       return true;
    }
 
+   template <class FileStream, class FileData>
+   template <class Compare, class BinaryPredicate, class Operation>
+   unsigned long FileFilterFrame<FileStream,FileData> ::
+   mergeStreams(const StreamList& streams,
+                Compare comp,
+                BinaryPredicate equal,
+                Operation& op)
+   {
+      bool sorted;
+      unsigned long count = mergeStreams(streams, comp, equal, op, sorted);
+      if (!sorted)
+      {
+         InvalidRequest exc("An input stream is not sorted.");
+         GPSTK_THROW(exc);
+      }
+      return count;
+   }
+
+   template <class FileStream, class FileData>
+   template <class Compare, class BinaryPredicate, class Operation>
+   unsigned long FileFilterFrame<FileStream,FileData> ::
+   mergeStreams(const StreamList& streams,
+                Compare comp,
+                BinaryPredicate equal,
+                Operation& op,
+                bool& sorted)
+   {
+      sorted = true;
+         // the next record of each stream
+      std::vector<FileData> next(streams.size());
+
+         // heap of stream indexes, smallest record on top; equal records
+         // are taken from the first stream so the merge is stable
+      auto greater = [&](size_t l, size_t r)
+         {
+            if (comp(next[r], next[l]))
+               return true;
+            if (comp(next[l], next[r]))
+               return false;
+            return l > r;
+         };
+      std::vector<size_t> heap;
+      for (size_t i = 0; i < streams.size(); i++)
+      {
+         if (readRecord(*streams[i], next[i]))
+         {
+            heap.push_back(i);
+            std::push_heap(heap.begin(), heap.end(), greater);
+         }
+      }
+
+      unsigned long count = 0;
+      bool haveLast = false;
+      FileData last;
+      FileData data;
+      while (!heap.empty())
+      {
+         size_t i = heap.front();
+         std::pop_heap(heap.begin(), heap.end(), greater);
+         heap.pop_back();
+
+            // read ahead first, to check the order of this stream
+         bool more = readRecord(*streams[i], data);
+         if (more && comp(data, next[i]))
+         {
+            sorted = false;
+            return count;
+         }
+
+            // keep only the first of many equal values, as unique()
+         if (!haveLast || !equal(last, next[i]))
+         {
+            op(next[i]);
+            count++;
+            std::swap(last, next[i]);
+            haveLast = true;
+         }
+
+         if (more)
+         {
+            std::swap(next[i], data);
+            heap.push_back(i);
+            std::push_heap(heap.begin(), heap.end(), greater);
+         }
+      }
+
+      return count;
+   }
+
+   template <class FileStream, class FileData>
+   template <class Compare, class BinaryPredicate>
+   unsigned long FileFilterFrame<FileStream,FileData> ::
+   mergeFiles(const std::vector<std::string>& fileList,
+              FileStream& output,
+              Compare comp,
+              BinaryPredicate equal)
+   {
+      StreamList streams;
+      for (const auto& i : fileList)
+      {
+         std::shared_ptr<FileStream> s(new FileStream(i.c_str()));
+         if (s->good())
+            streams.push_back(s);
+      }
+
+      output.exceptions(std::ios::failbit);
+      auto write = [&output](const FileData& data) { output << data; };
+      return mergeStreams(streams, comp, equal, write);
+   }
+
+   template <class FileStream, class FileData>
+   template <class Compare, class Operation1, class Operation2>
+   unsigned long FileFilterFrame<FileStream,FileData> ::
+   diffStreams(FileStream& left,
+               FileStream& right,
+               Compare comp,
+               Operation1& leftOnly,
+               Operation2& rightOnly)
+   {
+      return diffSorted(left, right, comp, comp, leftOnly, rightOnly);
+   }
+
+   template <class FileStream, class FileData>
+   template <class Compare1, class Compare2,
+             class Operation1, class Operation2>
+   unsigned long FileFilterFrame<FileStream,FileData> ::
+   diffSorted(FileStream& left,
+              FileStream& right,
+              Compare1 leftLess,
+              Compare2 rightLess,
+              Operation1& leftOnly,
+              Operation2& rightOnly)
+   {
+      FileData l, r;
+      bool haveLeft = readRecord(left, l);
+      bool haveRight = readRecord(right, r);
+      unsigned long count = 0;
+
+      while (haveLeft)
+      {
+         if (!haveRight || leftLess(l, r))
+         {
+            leftOnly(l);
+            count++;
+            haveLeft = readRecord(left, l);
+         }
+         else if (rightLess(r, l))
+         {
+            rightOnly(r);
+            count++;
+            haveRight = readRecord(right, r);
+         }
+         else
+         {
+            haveLeft = readRecord(left, l);
+            haveRight = readRecord(right, r);
+         }
+      }
+
+      while (haveRight)
+      {
+         rightOnly(r);
+         count++;
+         haveRight = readRecord(right, r);
+      }
+
+      return count;
+   }
+
 }  // namespace gpstk
 
 #endif // GPSTK_FILEFILTERFRAME_HPP
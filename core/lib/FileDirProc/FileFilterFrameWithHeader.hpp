@@ -229,6 +229,49 @@ namespace gpstk
          return toReturn;
       }
 
+         /**
+          * Open each file in fileList and read its header, leaving
+          * the stream at the first data record, for use with
+          * mergeStreams() or diffStreams().  Files that can not be
+          * opened are skipped, as in init().
+          * @param[in] fileList the files to open
+          * @param[out] streams the open streams
+          * @param[out] headers the header of each stream, in order
+          * @throw Exception when a header can not be read
+          */
+      static void
+      openStreams(const std::vector<std::string>& fileList,
+                  typename FileFilterFrame<FileStream,FileData>::StreamList&
+                  streams,
+                  std::list<FileHeader>& headers);
+
+         /// diffStreams() without headers, from FileFilterFrame
+      using FileFilterFrame<FileStream,FileData>::diffStreams;
+
+         /**
+          * Streaming version of halfDiff() in both directions: compare
+          * two sorted streams with p, using the given headers and
+          * precision, passing the records of left that are not in right
+          * to leftOnly and those of right that are not in left to
+          * rightOnly, in order.  See FileFilterFrame::diffStreams().
+          * @return the number of records passed to leftOnly and rightOnly
+          */
+      template <class BinaryPredicate, class Operation1, class Operation2>
+      static unsigned long
+      diffStreams(FileStream& left, const FileHeader& leftHeader,
+                  FileStream& right, const FileHeader& rightHeader,
+                  BinaryPredicate p, int precision,
+                  Operation1& leftOnly, Operation2& rightOnly)
+      {
+         long double epsilon = 1 / std::pow((long double)10,precision);
+         auto leftLess = [&](const FileData& l, const FileData& r)
+            { return p(l, leftHeader, r, rightHeader, epsilon); };
+         auto rightLess = [&](const FileData& r, const FileData& l)
+            { return p(r, rightHeader, l, leftHeader, epsilon); };
+         return FileFilterFrame<FileStream,FileData>::
+            diffSorted(left, right, leftLess, rightLess, leftOnly, rightOnly);
+      }
+
          /** performs the operation op on the header list. */
       template <class Operation>
       FileFilterFrameWithHeader& touchHeader(Operation& op)
@@ -433,6 +476,33 @@ namespace gpstk
       return headerList.back();
    }
 
+   template <class FileStream, class FileData, class FileHeader>
+   void
+   FileFilterFrameWithHeader<FileStream,FileData,FileHeader> ::
+   openStreams(const std::vector<std::string>& fileList,
+               typename FileFilterFrame<FileStream,FileData>::StreamList&
+               streams,
+               std::list<FileHeader>& headers)
+   {
+      for (const auto& i : fileList)
+      {
+         std::shared_ptr<FileStream> s(new FileStream(i.c_str()));
+
+         if (s->good())
+         {
+            s->exceptions(std::ios::failbit);
+
+            FileHeader header;
+            *s >> header;
+            headers.push_back(header);
+
+               // the data are read as in FileFilterFrame::init()
+            s->exceptions(std::ios::goodbit);
+            streams.push_back(s);
+         }
+      }
+   }
+
    template <class FileStream, class FileData, class FileHeader>
    void
    FileFilterFrameWithHeader<FileStream,FileData,FileHeader> :: 
@@ -0,0 +1,151 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file MemoryMappedFile.cpp
+ * Read-only view of the contents of a file, mapped into memory.
+ */
+
+#include <fstream>
+#include <iterator>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "MemoryMappedFile.hpp"
+
+namespace gpstk
+{
+   MemoryMappedFile ::
+   MemoryMappedFile()
+         : begin(0), length(0), isopen(false), mapped(false)
+   {
+   }
+
+
+   MemoryMappedFile ::
+   MemoryMappedFile(const std::string& fn)
+         : begin(0), length(0), isopen(false), mapped(false)
+   {
+      open(fn);
+   }
+
+
+   MemoryMappedFile ::
+   ~MemoryMappedFile()
+   {
+      close();
+   }
+
+
+   void MemoryMappedFile ::
+   open(const std::string& fn)
+   {
+      close();
+
+#ifndef WIN32
+      int fd = ::open(fn.c_str(), O_RDONLY);
+      if(fd < 0)
+      {
+         FileMissingException e("Could not open file " + fn);
+         GPSTK_THROW(e);
+      }
+
+      struct stat st;
+      if(::fstat(fd, &st) != 0)
+      {
+         ::close(fd);
+         FileMissingException e("Could not stat file " + fn);
+         GPSTK_THROW(e);
+      }
+
+      length = st.st_size;
+      if(length > 0)
+      {
+         void *p = ::mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+         if(p == MAP_FAILED)
+         {
+            ::close(fd);
+            length = 0;
+            FileMissingException e("Could not map file " + fn);
+            GPSTK_THROW(e);
+         }
+            // readers here parse from the front to the back
+         ::madvise(p, length, MADV_SEQUENTIAL);
+         begin = static_cast<const char*>(p);
+         mapped = true;
+      }
+         // the mapping does not need the descriptor
+      ::close(fd);
+#else
+      std::ifstream ifs(fn.c_str(), std::ios::in | std::ios::binary);
+      if(!ifs)
+      {
+         FileMissingException e("Could not open file " + fn);
+         GPSTK_THROW(e);
+      }
+      buffer.assign(std::istreambuf_iterator<char>(ifs),
+                    std::istreambuf_iterator<char>());
+      length = buffer.size();
+      begin = (length > 0 ? &buffer[0] : 0);
+#endif
+
+      filename = fn;
+      isopen = true;
+   }
+
+
+   void MemoryMappedFile ::
+   close()
+   {
+#ifndef WIN32
+      if(mapped)
+         ::munmap(const_cast<char*>(begin), length);
+#endif
+      buffer.clear();
+      filename.clear();
+      begin = 0;
+      length = 0;
+      isopen = mapped = false;
+   }
+
+} // namespace gpstk
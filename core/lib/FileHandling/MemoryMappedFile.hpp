@@ -0,0 +1,125 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file MemoryMappedFile.hpp
+ * Read-only view of the contents of a file, mapped into memory.
+ */
+
+#ifndef GPSTK_MEMORYMAPPEDFILE_HPP
+#define GPSTK_MEMORYMAPPEDFILE_HPP
+
+#include <string>
+#include <vector>
+
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * Map the entire contents of a file, read-only, into memory, so
+       * that readers can parse it in place rather than copying it
+       * through a stream one line at a time. On POSIX systems the
+       * file is mmap()ed; elsewhere it is read into a buffer, which
+       * gives the same interface without the benefit.
+       *
+       * Objects may not be copied; the mapping is released by close()
+       * or the destructor, which invalidates pointers from data().
+       */
+   class MemoryMappedFile
+   {
+   public:
+         /// Default constructor; no file is open.
+      MemoryMappedFile();
+
+         /** Common constructor; map the file fn.
+          * @param[in] fn name of the file to map
+          * @throw FileMissingException if the file cannot be opened
+          *   or mapped.
+          */
+      MemoryMappedFile(const std::string& fn);
+
+         /// Destructor, unmaps the file.
+      ~MemoryMappedFile();
+
+      MemoryMappedFile(const MemoryMappedFile&) = delete;
+      MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+         /** Map the file fn, first closing any file already mapped.
+          * @param[in] fn name of the file to map
+          * @throw FileMissingException if the file cannot be opened
+          *   or mapped.
+          */
+      void open(const std::string& fn);
+
+         /// Unmap the file, if any.
+      void close();
+
+         /// True if a file is mapped (it may be empty).
+      bool isOpen() const
+      { return isopen; }
+
+         /// Pointer to the first byte of the file; not null terminated.
+      const char* data() const
+      { return begin; }
+
+         /// Size of the file in bytes.
+      size_t size() const
+      { return length; }
+
+         /// Name of the mapped file.
+      const std::string& fileName() const
+      { return filename; }
+
+   private:
+      std::string filename;   ///< name of the mapped file
+      const char *begin;      ///< start of the contents
+      size_t length;          ///< size of the contents in bytes
+      bool isopen;            ///< true if a file is mapped
+      bool mapped;            ///< true if begin is from mmap()
+      std::vector<char> buffer;  ///< contents, if not mapped
+   }; // class MemoryMappedFile
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_MEMORYMAPPEDFILE_HPP
@@ -114,6 +114,7 @@ namespace gpstk
    {
       headerRead = false;
       header = RinexObsHeader();
+      previousTime = CommonTime::BEGINNING_OF_TIME;
    }
 
 }  // End of namespace gpstk
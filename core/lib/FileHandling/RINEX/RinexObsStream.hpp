@@ -51,6 +51,7 @@
 
 #include "FFTextStream.hpp"
 #include "RinexObsHeader.hpp"
+#include "CommonTime.hpp"
 
 namespace gpstk
 {
@@ -111,6 +112,10 @@ namespace gpstk
          /// The header for this file.
       RinexObsHeader header;
 
+         /** Epoch of the last record read that had one; used for
+          * event records (epoch flag 2-4) that have no epoch. */
+      CommonTime previousTime;
+
          /// Check if the input stream is the kind of RinexObsStream
       static bool isRinexObsStream(std::istream& i);
 
@@ -0,0 +1,597 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Rinex3ObsCache.cpp
+ * Binary, column-oriented cache of decoded RINEX observation data.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "Rinex3ObsCache.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "BinUtils.hpp"
+#include "StringUtils.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+         /// First bytes after the header of a cache file.
+      const char cacheMagic[8] = { '\x89', 'R', 'I', 'N', 'O', 'B', 'S', '\n' };
+         /// Size of the magic, format version and table offset.
+      const size_t preambleSize = 20;
+
+         /// Append little-endian binary values to a buffer.
+      class TableWriter
+      {
+      public:
+         void u8(uint8_t v)
+         { buf.push_back(static_cast<char>(v)); }
+         void u16(uint16_t v)
+         { char b[2]; BinUtils::buhtois(b, v); buf.append(b, 2); }
+         void i16(int16_t v)
+         { char b[2]; BinUtils::buhtoiss(b, v); buf.append(b, 2); }
+         void u32(uint32_t v)
+         { char b[4]; BinUtils::buhtoil(b, v); buf.append(b, 4); }
+         void i32(int32_t v)
+         { char b[4]; BinUtils::buhtoisl(b, v); buf.append(b, 4); }
+         void u64(uint64_t v)
+         { char b[8]; BinUtils::buhtoill(b, v); buf.append(b, 8); }
+         void f64(double v)
+         { char b[8]; BinUtils::buhtoid(b, v); buf.append(b, 8); }
+         string buf;
+      };
+
+         /// Extract little-endian binary values from a buffer.
+      class TableReader
+      {
+      public:
+         TableReader(const string& b) : buf(b), pos(0) {}
+            /// @throw FFStreamError if fewer than n bytes are left
+         void need(size_t n)
+         {
+            if(buf.size() - pos < n)
+            {
+               FFStreamError e("Truncated observation cache tables");
+               GPSTK_THROW(e);
+            }
+         }
+         uint8_t u8()
+         { need(1); return static_cast<uint8_t>(buf[pos++]); }
+         uint16_t u16()
+         { need(2); uint16_t v; BinUtils::buitohs(&buf[pos], v); pos += 2;
+            return v; }
+         int16_t i16()
+         { need(2); int16_t v; BinUtils::buitohss(&buf[pos], v); pos += 2;
+            return v; }
+         uint32_t u32()
+         { need(4); uint32_t v; BinUtils::buitohl(&buf[pos], v); pos += 4;
+            return v; }
+         int32_t i32()
+         { need(4); int32_t v; BinUtils::buitohsl(&buf[pos], v); pos += 4;
+            return v; }
+         uint64_t u64()
+         { need(8); uint64_t v; BinUtils::buitohll(&buf[pos], v); pos += 8;
+            return v; }
+         double f64()
+         { need(8); double v; BinUtils::buitohd(&buf[pos], v); pos += 8;
+            return v; }
+         const string& buf;
+         size_t pos;
+      };
+   }
+
+
+   const uint32_t Rinex3ObsCache::formatVersion = 1;
+
+
+   Rinex3ObsCache ::
+   Rinex3ObsCache()
+         : base(0), loaded(true), next(0)
+   {
+   }
+
+
+   void Rinex3ObsCache ::
+   add(const Rinex3ObsData& rod)
+   {
+      size_t e = times.size();
+      times.push_back(rod.time);
+      epochFlags.push_back(rod.epochFlag);
+      numSVs.push_back(rod.numSVs);
+      clockOffsets.push_back(rod.clockOffset);
+
+         // auxiliary header records are only kept as text
+      if(rod.epochFlag >= 2 && rod.epochFlag <= 5 &&
+         rod.auxHeader.numberHeaderRecordsToBeWritten() > 0)
+      {
+         events[e] = rod;
+         eventOffsets.push_back(1);
+         return;
+      }
+      eventOffsets.push_back(0);
+
+      Rinex3ObsData::DataMap::const_iterator it;
+      for(it = rod.obs.begin(); it != rod.obs.end(); ++it)
+      {
+         SatColumn& sc(sats[it->first]);
+         const vector<RinexDatum>& v(it->second);
+         sc.epoch.push_back(e);
+         sc.nobs.push_back(v.size());
+         if(sc.obs.size() < v.size())
+            sc.obs.resize(v.size());
+         for(size_t k = 0; k < v.size(); k++)
+         {
+            ObsColumn& oc(sc.obs[k]);
+            oc.epoch.push_back(e);
+            oc.data.push_back(v[k].data);
+            oc.lli.push_back(v[k].lli);
+            oc.ssi.push_back(v[k].ssi);
+            oc.blanks.push_back(blankBits(v[k]));
+         }
+      }
+   }
+
+
+   void Rinex3ObsCache ::
+   write(const std::string& fn) const
+   {
+      Rinex3ObsStream strm(fn.c_str(), ios::out | ios::binary);
+      if(!strm)
+      {
+         FFStreamError e("Unable to open " + fn);
+         GPSTK_THROW(e);
+      }
+      strm.exceptions(ios::failbit);
+
+      try
+      {
+         strm << header;
+         uint64_t start = strm.tellp();
+
+         TableWriter pre;
+         pre.buf.assign(cacheMagic, sizeof(cacheMagic));
+         pre.u32(formatVersion);
+         pre.u64(0);
+         strm.write(pre.buf.data(), pre.buf.size());
+
+            // event records, as RINEX text
+         vector<uint64_t> offsets(eventOffsets);
+         map<size_t, Rinex3ObsData>::const_iterator eit;
+         for(eit = events.begin(); eit != events.end(); ++eit)
+         {
+            offsets[eit->first] = strm.tellp();
+            strm << eit->second;
+         }
+         uint64_t tables = strm.tellp();
+
+            // epoch table
+         TableWriter tw;
+         size_t n = times.size();
+         vector<long> days(n), msods(n);
+         vector<double> fsods(n);
+         vector<TimeSystem> tss(n);
+         for(size_t i = 0; i < n; i++)
+            times[i].getInternal(days[i], msods[i], fsods[i], tss[i]);
+         tw.u32(n);
+         for(size_t i = 0; i < n; i++) tw.i32(days[i]);
+         for(size_t i = 0; i < n; i++) tw.u32(msods[i]);
+         for(size_t i = 0; i < n; i++) tw.f64(fsods[i]);
+         for(size_t i = 0; i < n; i++) tw.u8(static_cast<int>(tss[i]));
+         for(size_t i = 0; i < n; i++) tw.i16(epochFlags[i]);
+         for(size_t i = 0; i < n; i++) tw.i16(numSVs[i]);
+         for(size_t i = 0; i < n; i++) tw.f64(clockOffsets[i]);
+         for(size_t i = 0; i < n; i++) tw.u64(offsets[i]);
+
+            // satellite and observation columns
+         tw.u32(sats.size());
+         map<RinexSatID, SatColumn>::const_iterator sit;
+         for(sit = sats.begin(); sit != sats.end(); ++sit)
+         {
+            const SatColumn& sc(sit->second);
+            string id(sit->first.toString());
+            tw.u8(id.size());
+            tw.buf.append(id);
+            tw.u32(sc.epoch.size());
+            for(size_t i = 0; i < sc.epoch.size(); i++) tw.u32(sc.epoch[i]);
+            for(size_t i = 0; i < sc.nobs.size(); i++) tw.u16(sc.nobs[i]);
+            tw.u16(sc.obs.size());
+            for(size_t k = 0; k < sc.obs.size(); k++)
+            {
+               const ObsColumn& oc(sc.obs[k]);
+                  // the most common blank flags of the empty fields
+                  // become the column's fill, and those rows are not
+                  // stored
+               vector<size_t> rows, count(8, 0);
+               for(size_t i = 0; i < oc.epoch.size(); i++)
+               {
+                  if(oc.data[i] == 0 && oc.lli[i] == 0 && oc.ssi[i] == 0)
+                     count[oc.blanks[i]]++;
+               }
+               uint8_t fill = max_element(count.begin(), count.end()) -
+                  count.begin();
+               for(size_t i = 0; i < oc.epoch.size(); i++)
+               {
+                  if(oc.data[i] != 0 || oc.lli[i] != 0 || oc.ssi[i] != 0 ||
+                     oc.blanks[i] != fill)
+                     rows.push_back(i);
+               }
+               tw.u8(fill);
+               tw.u32(rows.size());
+               for(size_t i = 0; i < rows.size(); i++)
+                  tw.u32(oc.epoch[rows[i]]);
+               for(size_t i = 0; i < rows.size(); i++)
+                  tw.f64(oc.data[rows[i]]);
+               for(size_t i = 0; i < rows.size(); i++)
+                  tw.u8(oc.lli[rows[i]]);
+               for(size_t i = 0; i < rows.size(); i++)
+                  tw.u8(oc.ssi[rows[i]]);
+               for(size_t i = 0; i < rows.size(); i++)
+                  tw.u8(oc.blanks[rows[i]]);
+            }
+         }
+         strm.write(tw.buf.data(), tw.buf.size());
+
+            // now that the tables' location is known, fill it in
+         TableWriter loc;
+         loc.u64(tables);
+         strm.seekp(start + preambleSize - 8);
+         strm.write(loc.buf.data(), loc.buf.size());
+         strm.close();
+      }
+      catch(Exception& e)
+      {
+         e.addText("Writing observation cache " + fn);
+         GPSTK_RETHROW(e);
+      }
+      catch(std::exception& se)
+      {
+         FFStreamError e("Writing observation cache " + fn + ": " +
+                         se.what());
+         GPSTK_THROW(e);
+      }
+   }
+
+
+   size_t Rinex3ObsCache ::
+   convert(const std::string& rinexFile, const std::string& cacheFile)
+   {
+      Rinex3ObsStream strm(rinexFile.c_str(), ios::in);
+      if(!strm)
+      {
+         FFStreamError e("Unable to open " + rinexFile);
+         GPSTK_THROW(e);
+      }
+      strm.exceptions(ios::failbit);
+
+      Rinex3ObsCache cache;
+      Rinex3ObsData rod;
+      try
+      {
+         strm >> cache.header;
+         while(strm >> rod)
+            cache.add(rod);
+      }
+      catch(Exception& e)
+      {
+         e.addText("Reading " + rinexFile);
+         GPSTK_RETHROW(e);
+      }
+      cache.write(cacheFile);
+      return cache.size();
+   }
+
+
+   bool Rinex3ObsCache ::
+   seekTime(Rinex3ObsStream& strm, const CommonTime& t)
+   {
+      if(!loaded)
+         load(strm);
+      strm.clear();
+
+         // the epoch table is normally in time order
+      if(is_sorted(times.begin(), times.end()))
+         next = lower_bound(times.begin(), times.end(), t) - times.begin();
+      else
+      {
+         for(next = 0; next < times.size() && times[next] < t; next++)
+            ;
+      }
+
+      map<RinexSatID, SatColumn>::iterator sit;
+      for(sit = sats.begin(); sit != sats.end(); ++sit)
+      {
+         SatColumn& sc(sit->second);
+         sc.next = lower_bound(sc.epoch.begin(), sc.epoch.end(), next) -
+            sc.epoch.begin();
+         for(size_t k = 0; k < sc.obs.size(); k++)
+         {
+            ObsColumn& oc(sc.obs[k]);
+            oc.next = lower_bound(oc.epoch.begin(), oc.epoch.end(), next) -
+               oc.epoch.begin();
+         }
+      }
+      return next < times.size();
+   }
+
+
+   void Rinex3ObsCache ::
+   rewind()
+   {
+      next = 0;
+      map<RinexSatID, SatColumn>::iterator sit;
+      for(sit = sats.begin(); sit != sats.end(); ++sit)
+      {
+         sit->second.next = 0;
+         for(size_t k = 0; k < sit->second.obs.size(); k++)
+            sit->second.obs[k].next = 0;
+      }
+   }
+
+
+   void Rinex3ObsCache ::
+   attach(Rinex3ObsStream& strm)
+   {
+      strm.obsCache.reset();
+      streambuf *buf = strm.rdbuf();
+      if(buf == NULL ||
+         buf->sgetc() != static_cast<unsigned char>(cacheMagic[0]))
+         return;
+      streampos pos = buf->pubseekoff(0, ios::cur, ios::in);
+      if(pos == streampos(-1))
+         return;
+      strm.obsCache = std::make_shared<Rinex3ObsCache>();
+      strm.obsCache->base = pos;
+      strm.obsCache->loaded = false;
+   }
+
+
+   void Rinex3ObsCache ::
+   load(Rinex3ObsStream& strm)
+   {
+         // The tables are read directly from the stream buffer, so as
+         // not to disturb the stream state.
+      streambuf *buf = strm.rdbuf();
+      char pre[preambleSize];
+      if(buf->pubseekpos(base, ios::in) == streampos(-1) ||
+         buf->sgetn(pre, preambleSize) != streamsize(preambleSize) ||
+         memcmp(pre, cacheMagic, sizeof(cacheMagic)) != 0)
+      {
+         FFStreamError e("Not an observation cache file: " + strm.filename);
+         GPSTK_THROW(e);
+      }
+      uint32_t version;
+      uint64_t tables;
+      BinUtils::buitohl(pre, version, sizeof(cacheMagic));
+      BinUtils::buitohll(pre, tables, sizeof(cacheMagic) + 4);
+      if(version != formatVersion)
+      {
+         FFStreamError e("Unsupported observation cache format version " +
+                         StringUtils::asString(version));
+         GPSTK_THROW(e);
+      }
+      streampos end = buf->pubseekoff(0, ios::end, ios::in);
+      if(end == streampos(-1) || tables < base + preambleSize ||
+         tables > static_cast<uint64_t>(end))
+      {
+         FFStreamError e("Invalid observation cache table offset");
+         GPSTK_THROW(e);
+      }
+      string tbl(static_cast<uint64_t>(end) - tables, '\0');
+      if(buf->pubseekpos(tables, ios::in) == streampos(-1) ||
+         buf->sgetn(&tbl[0], tbl.size()) != streamsize(tbl.size()))
+      {
+         FFStreamError e("Unable to read observation cache tables");
+         GPSTK_THROW(e);
+      }
+
+      TableReader tr(tbl);
+      size_t n = tr.u32();
+      tr.need(n * 37);
+      vector<long> days(n), msods(n);
+      vector<double> fsods(n);
+      times.resize(n);
+      epochFlags.resize(n);
+      numSVs.resize(n);
+      clockOffsets.resize(n);
+      eventOffsets.resize(n);
+      for(size_t i = 0; i < n; i++) days[i] = tr.i32();
+      for(size_t i = 0; i < n; i++) msods[i] = tr.u32();
+      for(size_t i = 0; i < n; i++) fsods[i] = tr.f64();
+      for(size_t i = 0; i < n; i++)
+      {
+         TimeSystem ts(static_cast<TimeSystem>(tr.u8()));
+         try
+         {
+            times[i].setInternal(days[i], msods[i], fsods[i], ts);
+         }
+         catch(InvalidParameter& ip)
+         {
+            FFStreamError e("Invalid epoch in observation cache: " +
+                            ip.getText());
+            GPSTK_THROW(e);
+         }
+      }
+      for(size_t i = 0; i < n; i++) epochFlags[i] = tr.i16();
+      for(size_t i = 0; i < n; i++) numSVs[i] = tr.i16();
+      for(size_t i = 0; i < n; i++) clockOffsets[i] = tr.f64();
+      for(size_t i = 0; i < n; i++) eventOffsets[i] = tr.u64();
+
+      size_t nsats = tr.u32();
+      for(size_t s = 0; s < nsats; s++)
+      {
+         size_t len = tr.u8();
+         tr.need(len);
+         RinexSatID sat;
+         try
+         {
+            sat = RinexSatID(tbl.substr(tr.pos, len));
+         }
+         catch(Exception&)
+         {
+            FFStreamError e("Invalid satellite in observation cache: " +
+                            tbl.substr(tr.pos, len));
+            GPSTK_THROW(e);
+         }
+         tr.pos += len;
+         SatColumn& sc(sats[sat]);
+         size_t rows = tr.u32();
+         tr.need(rows * 6);
+         sc.epoch.resize(rows);
+         sc.nobs.resize(rows);
+         for(size_t i = 0; i < rows; i++) sc.epoch[i] = tr.u32();
+         for(size_t i = 0; i < rows; i++) sc.nobs[i] = tr.u16();
+         sc.obs.resize(tr.u16());
+         for(size_t i = 0; i < rows; i++)
+         {
+            if(sc.nobs[i] > sc.obs.size())
+            {
+               FFStreamError e("Invalid observation count in cache for " +
+                               sat.toString());
+               GPSTK_THROW(e);
+            }
+         }
+         for(size_t k = 0; k < sc.obs.size(); k++)
+         {
+            ObsColumn& oc(sc.obs[k]);
+            oc.fill = tr.u8();
+            rows = tr.u32();
+            tr.need(rows * 15);
+            oc.epoch.resize(rows);
+            oc.data.resize(rows);
+            oc.lli.resize(rows);
+            oc.ssi.resize(rows);
+            oc.blanks.resize(rows);
+            for(size_t i = 0; i < rows; i++) oc.epoch[i] = tr.u32();
+            for(size_t i = 0; i < rows; i++) oc.data[i] = tr.f64();
+            for(size_t i = 0; i < rows; i++) oc.lli[i] = tr.u8();
+            for(size_t i = 0; i < rows; i++) oc.ssi[i] = tr.u8();
+            for(size_t i = 0; i < rows; i++) oc.blanks[i] = tr.u8();
+         }
+      }
+      loaded = true;
+      rewind();
+   }
+
+
+   bool Rinex3ObsCache ::
+   getRecord(Rinex3ObsStream& strm, Rinex3ObsData& rod)
+   {
+      if(!loaded)
+         load(strm);
+
+      if(next >= times.size())
+      {
+            // like the end of a text file, set eof and fail
+         try
+         {
+            strm.setstate(ios::eofbit | ios::failbit);
+         }
+         catch(std::exception&)
+         {
+         }
+         EndOfFile e("EOF encountered");
+         GPSTK_THROW(e);
+      }
+
+      uint32_t e = next++;
+      if(eventOffsets[e] != 0)
+      {
+         strm.clear();
+         strm.seekg(eventOffsets[e]);
+         return false;
+      }
+
+         // every member of rod is set here; replacing it with a
+         // default Rinex3ObsData, as the text reader does, costs as
+         // much as the rest of this function
+      rod.time = times[e];
+      rod.epochFlag = epochFlags[e];
+      rod.numSVs = numSVs[e];
+      rod.clockOffset = clockOffsets[e];
+      if(!rod.auxHeader.valid.empty() || !rod.auxHeader.commentList.empty())
+         rod.auxHeader = Rinex3ObsHeader();
+      strm.previousTime = rod.time;
+
+         // Reuse the entries of rod.obs for the satellites it already
+         // has, which are usually most of them when records are read
+         // in a loop.
+      Rinex3ObsData::DataMap::iterator oit(rod.obs.begin());
+      map<RinexSatID, SatColumn>::iterator sit;
+      for(sit = sats.begin(); sit != sats.end(); ++sit)
+      {
+         SatColumn& sc(sit->second);
+         if(sc.next >= sc.epoch.size() || sc.epoch[sc.next] != e)
+            continue;
+         while(oit != rod.obs.end() && oit->first < sit->first)
+            oit = rod.obs.erase(oit);
+         if(oit == rod.obs.end() || sit->first < oit->first)
+            oit = rod.obs.insert(oit, make_pair(sit->first,
+                                                vector<RinexDatum>()));
+         vector<RinexDatum>& v(oit->second);
+         ++oit;
+         size_t nobs = sc.nobs[sc.next++];
+         v.resize(nobs);
+         for(size_t k = 0; k < nobs; k++)
+         {
+            ObsColumn& oc(sc.obs[k]);
+            RinexDatum& rd(v[k]);
+            uint8_t blanks = oc.fill;
+            rd.data = 0;
+            rd.lli = rd.ssi = 0;
+            if(oc.next < oc.epoch.size() && oc.epoch[oc.next] == e)
+            {
+               rd.data = oc.data[oc.next];
+               rd.lli = oc.lli[oc.next];
+               rd.ssi = oc.ssi[oc.next];
+               blanks = oc.blanks[oc.next++];
+            }
+            rd.dataBlank = (blanks & 1) != 0;
+            rd.lliBlank = (blanks & 2) != 0;
+            rd.ssiBlank = (blanks & 4) != 0;
+         }
+      }
+      rod.obs.erase(oit, rod.obs.end());
+      return true;
+   }
+
+} // namespace gpstk
@@ -0,0 +1,241 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Rinex3ObsCache.hpp
+ * Binary, column-oriented cache of decoded RINEX observation data.
+ */
+
+#ifndef GPSTK_RINEX3OBSCACHE_HPP
+#define GPSTK_RINEX3OBSCACHE_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iosfwd>
+#include <stdint.h>
+
+#include "CommonTime.hpp"
+#include "RinexSatID.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+   class Rinex3ObsStream;
+
+      /**
+       * This class holds decoded RINEX observation data as columns,
+       * and reads and writes them as a binary cache file that is
+       * much faster to load than the RINEX text it came from.
+       *
+       * A cache file starts with the RINEX header, as text, followed
+       * by binary tables (all little-endian):
+       *  - an epoch table: time, epoch flag, number of satellites and
+       *    receiver clock offset of every record, in file order;
+       *  - for each satellite, the indices of the epochs in which it
+       *    appears and its number of observations in each;
+       *  - for each satellite and observation type, a column of
+       *    epoch indices, values, LLI, SSI and blank flags.
+       *    Fields that are blank are not stored.
+       *
+       * Event records (epoch flag 2-5) that carry auxiliary header
+       * records are kept as RINEX text between the header and the
+       * tables.
+       *
+       * Since the header is RINEX, a cache file is read with a
+       * Rinex3ObsStream just like the RINEX file it was written
+       * from, and yields the same Rinex3ObsHeader and Rinex3ObsData
+       * records; reading the header attaches a Rinex3ObsCache to the
+       * stream (Rinex3ObsStream::obsCache), which then supplies the
+       * data records.  The epoch table serves as the index for
+       * seekTime().
+       *
+       * @code
+       *    // write a cache
+       * Rinex3ObsCache cache;
+       * Rinex3ObsStream in("file.obs");
+       * Rinex3ObsData rod;
+       * in >> cache.header;
+       * while(in >> rod)
+       *    cache.add(rod);
+       * cache.write("file.obs.bin");
+       *    // read it
+       * Rinex3ObsStream strm("file.obs.bin");
+       * strm >> header;
+       * strm.obsCache->seekTime(strm, startTime);
+       * while(strm >> rod) { ... }
+       * @endcode
+       *
+       * @sa Rinex3ObsStream, Rinex3ObsData and Rinex3ObsHeader.
+       */
+   class Rinex3ObsCache
+   {
+   public:
+         /// Version of the cache file format written by write().
+      static const uint32_t formatVersion;
+
+         /// Create an empty cache.
+      Rinex3ObsCache();
+
+         /// Header written by write().
+      Rinex3ObsHeader header;
+
+         /** Append a data record, which must have been read using
+          * (or be consistent with) #header.
+          * @param[in] rod the record to store. */
+      void add(const Rinex3ObsData& rod);
+
+         /** Write #header and all the records that have been added
+          * to a cache file.
+          * @param[in] fn the name of the file to write.
+          * @throw FFStreamError if the file cannot be written. */
+      void write(const std::string& fn) const;
+
+         /** Read a RINEX observation file and write its contents to
+          * a cache file.
+          * @param[in] rinexFile the RINEX file to read.
+          * @param[in] cacheFile the name of the cache file to write.
+          * @return the number of records written.
+          * @throw FFStreamError if either file cannot be read or
+          *   written. */
+      static size_t convert(const std::string& rinexFile,
+                            const std::string& cacheFile);
+
+         /** Return the number of records (epochs) in the cache.  The
+          * tables of a cache that is read from a stream are loaded
+          * when the first record is read, or by seekTime(). */
+      size_t size() const
+      { return times.size(); }
+
+         /** Position the cache so that the next record read is the
+          * first one at or after a given time.  Like seekg(), this
+          * clears the end-of-file state of \a strm.
+          * @param[in] strm the stream from which the cache is read.
+          * @param[in] t the time of interest.
+          * @return false if there is no record at or after \a t.
+          * @throw FFStreamError if the cache file is corrupt. */
+      bool seekTime(Rinex3ObsStream& strm, const CommonTime& t);
+
+         /** Position the cache so that the next record read is the
+          * first one in the file.  The state of the stream is left
+          * unchanged, see seekTime(). */
+      void rewind();
+
+         /** Called by Rinex3ObsHeader when it has been read from \a
+          * strm; set strm.obsCache if \a strm is a cache file, and
+          * reset it otherwise. */
+      static void attach(Rinex3ObsStream& strm);
+
+         /** Called by Rinex3ObsData to get the next record from \a
+          * strm.  Event records that are kept as text are left to
+          * the caller, with strm positioned at the record.
+          * @param[in] strm the stream from which the cache is read.
+          * @param[out] rod the record read; if the return is false,
+          *   it is unchanged.
+          * @return true if \a rod was read, false if the caller is to
+          *   read it from \a strm.
+          * @throw EndOfFile after the last record.
+          * @throw FFStreamError if the cache file is corrupt. */
+      bool getRecord(Rinex3ObsStream& strm, Rinex3ObsData& rod);
+
+   private:
+         /// One observation type of one satellite.
+      struct ObsColumn
+      {
+         ObsColumn() : fill(0), next(0) {}
+         std::vector<uint32_t> epoch;  ///< epoch index of each row
+         std::vector<double> data;     ///< RinexDatum::data
+         std::vector<uint8_t> lli;     ///< RinexDatum::lli
+         std::vector<uint8_t> ssi;     ///< RinexDatum::ssi
+         std::vector<uint8_t> blanks;  ///< blank flags, see blankBits()
+            /// Blank flags of the rows that are not stored.
+         uint8_t fill;
+         size_t next;                  ///< next row to read
+      };
+
+         /// All the data of one satellite.
+      struct SatColumn
+      {
+         SatColumn() : next(0) {}
+         std::vector<uint32_t> epoch;  ///< epoch index of each row
+         std::vector<uint16_t> nobs;   ///< observations in each epoch
+         std::vector<ObsColumn> obs;   ///< one per observation index
+         size_t next;                  ///< next row to read
+      };
+
+         /// Pack the blank flags of a RinexDatum into 3 bits.
+      static uint8_t blankBits(const RinexDatum& rd)
+      { return (rd.dataBlank ? 1 : 0) | (rd.lliBlank ? 2 : 0) |
+            (rd.ssiBlank ? 4 : 0); }
+
+         /** Read the tables of the cache file \a strm, which starts
+          * at #base.
+          * @throw FFStreamError if the file is not a valid cache. */
+      void load(Rinex3ObsStream& strm);
+
+         /// Epoch table
+      std::vector<CommonTime> times;
+      std::vector<short> epochFlags;
+      std::vector<short> numSVs;
+      std::vector<double> clockOffsets;
+         /// File offset of each event kept as text, 0 for the others.
+      std::vector<uint64_t> eventOffsets;
+
+         /// Event records kept as text, by epoch index, for write().
+      std::map<size_t, Rinex3ObsData> events;
+
+         /// Data columns
+      std::map<RinexSatID, SatColumn> sats;
+
+         /// File offset of the first byte after the header.
+      uint64_t base;
+         /// Whether the tables have been read from the file.
+      bool loaded;
+         /// Index of the next record to read.
+      size_t next;
+   }; // class Rinex3ObsCache
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_RINEX3OBSCACHE_HPP
@@ -47,6 +47,7 @@
 #include "RinexObsID.hpp"
 #include "Rinex3ObsStream.hpp"
 #include "Rinex3ObsData.hpp"
+#include "Rinex3ObsCache.hpp"
 
 using namespace gpstk::StringUtils;
 using namespace std;
@@ -379,8 +380,6 @@ namespace gpstk
    
    void reallyGetRecordVer2(Rinex3ObsStream& strm, Rinex3ObsData& rod)
    {
-      static CommonTime previousTime(CommonTime::BEGINNING_OF_TIME);
-
          // get the epoch line and check
       string line;
       while(line.empty())        // ignore blank lines in place of epoch lines
@@ -416,7 +415,7 @@ namespace gpstk
          GPSTK_THROW(e);
       }
       else if(noEpochTime)
-         rod.time = previousTime;
+         rod.time = strm.previousTime;
       else
       {
          try
@@ -477,7 +476,7 @@ namespace gpstk
             // end rod.time = parseTime(line, strm.header);
 
             // save for next call
-         previousTime = rod.time;
+         strm.previousTime = rod.time;
       }
 
          // number of satellites
@@ -597,6 +596,11 @@ namespace gpstk
          // If the header hasn't been read, read it.
       if(!strm.headerRead) strm >> strm.header;
 
+         // a cache file supplies its records from its tables, except
+         // for the event records it keeps as text
+      if(strm.obsCache && strm.obsCache->getRecord(strm, *this))
+         return;
+
       Rinex3ObsData rod;
 
          // clear out this ObsData
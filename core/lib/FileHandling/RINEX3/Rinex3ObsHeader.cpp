@@ -51,6 +51,7 @@
 #include "TimeString.hpp"
 #include "Rinex3ObsStream.hpp"
 #include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsCache.hpp"
 
 using namespace std;
 using namespace gpstk::StringUtils;
@@ -1810,6 +1811,9 @@ namespace gpstk
          }
       }
 
+         // the data of an observation cache file follow its header
+      Rinex3ObsCache::attach(strm);
+
    } // end reallyGetRecord
 
       // This method maps v2.11 GPS observation types to the v3 equivalent.
@@ -2182,8 +2186,15 @@ namespace gpstk
          {
             string R2ot, lab(mit->second[i].asString(version));
                // the list of all tracking code characters for this sys, freq
-            string allCodes(
-               RinexObsID::validRinexTrackingCodes[mit->first[0]][lab[1]]);
+            string allCodes;
+            const auto& sysit =
+               RinexObsID::validRinexTrackingCodes.find(mit->first[0]);
+            if (sysit != RinexObsID::validRinexTrackingCodes.end())
+            {
+               const auto& cbit = sysit->second.find(lab[1]);
+               if (cbit != sysit->second.end())
+                  allCodes = cbit->second;
+            }
 
             if (lab == string("C1C"))
                R2ot = string("C1");
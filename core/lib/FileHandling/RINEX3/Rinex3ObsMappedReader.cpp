@@ -0,0 +1,501 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Rinex3ObsMappedReader.cpp
+ * Read RINEX 3 observation data in place from a memory-mapped file.
+ */
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <map>
+
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "CivilTime.hpp"
+#include "StringUtils.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   namespace
+   {
+         // Copy the field [pos,pos+n) of a line of length len into buf, as
+         // std::string::substr() would (buf must hold n+1 characters).
+      inline void copyField(const char *line, size_t len, size_t pos, size_t n,
+                            char *buf)
+      {
+         size_t m(pos < len ? std::min(n, len-pos) : 0);
+         memcpy(buf, line+pos, m);
+         buf[m] = '\0';
+      }
+
+         // StringUtils::asInt(line.substr(pos,n)), for n < 16
+      inline long fieldInt(const char *line, size_t len, size_t pos, size_t n)
+      {
+         char buf[16];
+         copyField(line, len, pos, n, buf);
+         return strtol(buf, 0, 10);
+      }
+
+         // StringUtils::asDouble(string(p,n)), for n < 32. Plain fixed
+         // point numbers, as RINEX writes, are converted here; since
+         // the integer mantissa (< 2^53) and the power of ten are both
+         // exact doubles, the division is rounded exactly as strtod()
+         // rounds. Anything else is given to strtod().
+      double parseDouble(const char *p, size_t n)
+      {
+         static const double pow10[] = { 1.e0, 1.e1, 1.e2, 1.e3, 1.e4, 1.e5,
+                     1.e6, 1.e7, 1.e8, 1.e9, 1.e10, 1.e11, 1.e12, 1.e13,
+                     1.e14, 1.e15 };
+         size_t i(0);
+         while(i < n && p[i] == ' ') i++;
+         bool neg(false);
+         if(i < n && (p[i] == '-' || p[i] == '+'))
+            neg = (p[i++] == '-');
+
+         unsigned long long mant(0);
+         int ndig(0), nfrac(0);
+         bool point(false);
+         for( ; i < n; i++)
+         {
+            if(p[i] >= '0' && p[i] <= '9')
+            {
+               mant = 10*mant + (p[i]-'0');
+               ndig++;
+               if(point) nfrac++;
+            }
+            else if(p[i] == '.' && !point)
+               point = true;
+            else
+               break;
+         }
+
+         if(i == n && ndig > 0 && ndig <= 15)
+         {
+            double d(double(mant)/pow10[nfrac]);
+            return (neg ? -d : d);
+         }
+
+         char buf[32];
+         memcpy(buf, p, n);
+         buf[n] = '\0';
+         return strtod(buf, 0);
+      }
+
+         // StringUtils::asDouble(line.substr(pos,n)), for n < 32
+      inline double fieldDouble(const char *line, size_t len, size_t pos,
+                                size_t n)
+      {
+         return parseDouble(line+pos, (pos < len ? std::min(n, len-pos) : 0));
+      }
+
+         // RinexDatum::fromString(string(f,16))
+      inline void parseDatum(const char *f, RinexDatum& rd)
+      {
+         size_t i(0);
+         while(i < 14 && f[i] == ' ') i++;
+         rd.dataBlank = (i == 14);
+         rd.data = (rd.dataBlank ? 0. : parseDouble(f, 14));
+         rd.lliBlank = (f[14] == ' ');
+         rd.lli = (isdigit(static_cast<unsigned char>(f[14])) ? f[14]-'0' : 0);
+         rd.ssiBlank = (f[15] == ' ');
+         rd.ssi = (isdigit(static_cast<unsigned char>(f[15])) ? f[15]-'0' : 0);
+      }
+
+         // RinexSatID(string(p,n)), which is slow, so the IDs are
+         // remembered (in each thread).
+         // @throw FFStreamError
+      const RinexSatID& parseSatID(const char *p, size_t n)
+      {
+         static thread_local std::map<unsigned long, RinexSatID> satIDs;
+         unsigned long key(n);
+         for(size_t i = 0; i < n; i++)
+            key = (key << 8) | static_cast<unsigned char>(p[i]);
+         std::map<unsigned long, RinexSatID>::iterator it(satIDs.find(key));
+         if(it == satIDs.end())
+         {
+            try
+            {
+               it = satIDs.insert(
+                  std::make_pair(key, RinexSatID(string(p, n)))).first;
+            }
+            catch(Exception& e)
+            {
+               FFStreamError ffse(e);
+               GPSTK_THROW(ffse);
+            }
+         }
+         return it->second;
+      }
+
+         // As Rinex3ObsData::parseTime(), for a line of length >= 31
+      CommonTime parseTime(const char *line, size_t len, const TimeSystem& ts)
+      {
+         if( (line[ 1] != ' ') || (line[ 6] != ' ') || (line[ 9] != ' ') ||
+             (line[12] != ' ') || (line[15] != ' ') || (line[18] != ' ') ||
+             (line[29] != ' ') || (line[30] != ' '))
+         {
+            FFStreamError e("Invalid time format");
+            GPSTK_THROW(e);
+         }
+
+            // if there's no time, just return a bad time
+         if(find_if(line+2, line+29,
+                    [](char c) { return c != ' '; }) == line+29)
+            return CommonTime::BEGINNING_OF_TIME;
+
+         try
+         {
+            int year(fieldInt(line, len,  2, 4));
+            int month(fieldInt(line, len,  7, 2));
+            int day(fieldInt(line, len, 10, 2));
+            int hour(fieldInt(line, len, 13, 2));
+            int min(fieldInt(line, len, 16, 2));
+            double sec(fieldDouble(line, len, 19, 11));
+
+               // Real Rinex has epochs 'yy mm dd hr 59 60.0' surprisingly often.
+            double ds(0);
+            if(sec >= 60.)
+            {
+               ds = sec;
+               sec = 0.0;
+            }
+
+            CommonTime rv = CivilTime(year,month,day,hour,min,sec)
+               .convertToCommonTime();
+            if(ds != 0) rv += ds;
+
+            rv.setTimeSystem(ts);
+
+            return rv;
+         }
+         catch(gpstk::Exception& e)
+         {
+            FFStreamError err(e);
+            GPSTK_THROW(err);
+         }
+      }
+   }
+
+
+   Rinex3ObsMappedReader ::
+   Rinex3ObsMappedReader()
+         : timesystem(TimeSystem::GPS), dataStart(0), next(0)
+   {
+   }
+
+
+   Rinex3ObsMappedReader ::
+   Rinex3ObsMappedReader(const std::string& fn)
+         : timesystem(TimeSystem::GPS), dataStart(0), next(0)
+   {
+      open(fn);
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   open(const std::string& fn)
+   {
+      close();
+
+         // read the header as usual, and note where it ends
+      Rinex3ObsStream strm(fn.c_str(), std::ios::in);
+      if(!strm)
+      {
+         FileMissingException e("Could not open file " + fn);
+         GPSTK_THROW(e);
+      }
+      strm.exceptions(std::ios::failbit);
+      try
+      {
+         strm >> strm.header;
+      }
+      catch(Exception& e)
+      {
+         e.addText("Reading header of " + fn);
+         GPSTK_RETHROW(e);
+      }
+      if(strm.header.version < 3)
+      {
+         FFStreamError e("Not a RINEX 3 file: " + fn);
+         GPSTK_THROW(e);
+      }
+      if(strm.obsCache)
+      {
+         FFStreamError e("Not a RINEX text file (observation cache): "
+                         + fn);
+         GPSTK_THROW(e);
+      }
+      header = strm.header;
+      timesystem = strm.timesystem;
+      dataStart = next = strm.tellg();
+      strm.close();
+
+      file.open(fn);
+
+      numObs.assign(256, 0);
+      std::map<std::string, std::vector<RinexObsID> >::const_iterator it;
+      for(it = header.mapObsTypes.begin(); it != header.mapObsTypes.end(); ++it)
+         if(it->first.size() == 1)
+            numObs[static_cast<unsigned char>(it->first[0])] = it->second.size();
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   close()
+   {
+      file.close();
+      header = Rinex3ObsHeader();
+      timesystem = TimeSystem::GPS;
+      dataStart = next = 0;
+      numObs.clear();
+   }
+
+
+   void Rinex3ObsMappedReader ::
+   seek(size_t offset)
+   {
+      if(offset < dataStart || offset > file.size())
+      {
+         InvalidRequest e("Offset " + StringUtils::asString(offset)
+                          + " is not within the data of " + file.fileName());
+         GPSTK_THROW(e);
+      }
+      next = offset;
+   }
+
+
+   const char* Rinex3ObsMappedReader ::
+   getLine(size_t& pos, size_t& len) const
+   {
+      if(pos >= file.size())
+         return 0;
+
+      const char *line = file.data() + pos;
+      const char *end = static_cast<const char*>(
+         memchr(line, '\n', file.size()-pos));
+      if(end)
+      {
+         len = end - line;
+         pos += len + 1;
+      }
+      else
+      {
+         len = file.size() - pos;
+         pos = file.size();
+      }
+
+         // as FFTextStream::formattedGetLine()
+      while(len > 0 && line[len-1] == '\r') len--;
+      for(size_t i = 0; i < len; i++)
+      {
+            // isprint() in the "C" locale
+         if(line[i] < 0x20 || line[i] > 0x7e)
+         {
+            FFStreamError err("Non-text data in file.");
+            GPSTK_THROW(err);
+         }
+      }
+
+      while(len > 0 && line[len-1] == ' ') len--;
+
+      return line;
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   getRecord(Rinex3ObsData& rod)
+   {
+      return getRecord(next, rod);
+   }
+
+
+   bool Rinex3ObsMappedReader ::
+   getRecord(size_t& offset, Rinex3ObsData& rod) const
+   {
+      if(offset < dataStart)
+      {
+         InvalidRequest e("Offset " + StringUtils::asString(offset)
+                          + " is not within the data of " + file.fileName());
+         GPSTK_THROW(e);
+      }
+
+      size_t pos(offset), len;
+      const char *line = getLine(pos, len);
+      if(!line)
+         return false;
+
+      try
+      {
+            // as rod = Rinex3ObsData(), but constructing a header only
+            // if auxHeader holds any header records
+         rod.time = CommonTime::BEGINNING_OF_TIME;
+         rod.epochFlag = rod.numSVs = -1;
+         rod.clockOffset = 0.0;
+         rod.obs.clear();
+         if(!rod.auxHeader.valid.empty())
+            rod.auxHeader = Rinex3ObsHeader();
+
+            // Check and parse the epoch line --------------------------------
+            // Check for epoch marker ('>') and following space.
+         if(len < 31 || line[0] != '>' || line[1] != ' ')
+         {
+            FFStreamError e("Bad epoch line: >" + string(line,len) + "<");
+            GPSTK_THROW(e);
+         }
+
+         rod.epochFlag = fieldInt(line, len, 31, 1);
+         if(rod.epochFlag < 0 || rod.epochFlag > 6)
+         {
+            FFStreamError e("Invalid epoch flag: "
+                            + StringUtils::asString(rod.epochFlag));
+            GPSTK_THROW(e);
+         }
+
+         rod.time = parseTime(line, len, timesystem);
+
+         rod.numSVs = fieldInt(line, len, 32, 3);
+
+         if(len > 41)
+            rod.clockOffset = fieldDouble(line, len, 41, 15);
+         else
+            rod.clockOffset = 0.0;
+
+            // Read the observations: SV ID and data -------------------------
+         if(rod.epochFlag == 0 || rod.epochFlag == 1 || rod.epochFlag == 6)
+         {
+            for(int isv = 0; isv < rod.numSVs; isv++)
+            {
+               line = getLine(pos, len);
+               if(!line)
+               {
+                  FFStreamError e("Unexpected EOF");
+                  GPSTK_THROW(e);
+               }
+
+               const RinexSatID& sat(parseSatID(line, std::min(len, size_t(3))));
+
+                  // fields past the end of the line are blank
+               int size(numObs[static_cast<unsigned char>(sat.systemChar())]);
+               vector<RinexDatum>& data = rod.obs[sat];
+               data.resize(size);
+               for(int i = 0; i < size; i++)
+               {
+                  size_t fpos(3 + 16*i);
+                  if(fpos + 16 <= len)
+                     parseDatum(line + fpos, data[i]);
+                  else
+                  {
+                     char buf[16];
+                     memset(buf, ' ', 16);
+                     if(fpos < len)
+                        memcpy(buf, line + fpos, len - fpos);
+                     parseDatum(buf, data[i]);
+                  }
+               }
+            }
+         }
+
+            // ... or the auxiliary header information
+         else if(rod.numSVs > 0)
+         {
+            rod.auxHeader.clear();
+            for(int i = 0; i < rod.numSVs; i++)
+            {
+               line = getLine(pos, len);
+               if(!line)
+               {
+                  FFStreamError e("Unexpected EOF");
+                  GPSTK_THROW(e);
+               }
+               string hline(line, len);
+               rod.auxHeader.parseHeaderRecord(hline);
+            }
+         }
+      }
+      catch(Exception& e)
+      {
+         e.addText("In record at byte " + StringUtils::asString(offset)
+                   + " of " + file.fileName());
+         GPSTK_RETHROW(e);
+      }
+
+      offset = pos;
+      return true;
+   }
+
+
+   std::vector<size_t> Rinex3ObsMappedReader ::
+   findEpochs() const
+   {
+      std::vector<size_t> offsets;
+      size_t pos(dataStart), start, len;
+      const char *line;
+      while(true)
+      {
+         start = pos;
+         if(!(line = getLine(pos, len)))
+            break;
+         if(len < 31 || line[0] != '>' || line[1] != ' ')
+         {
+            FFStreamError e("Bad epoch line at byte "
+                            + StringUtils::asString(start) + " of "
+                            + file.fileName());
+            GPSTK_THROW(e);
+         }
+         offsets.push_back(start);
+
+            // both data and auxiliary header records have numSVs lines
+         long n(fieldInt(line, len, 32, 3));
+         for(long i = 0; i < n; i++)
+         {
+            if(!getLine(pos, len))
+            {
+               FFStreamError e("Unexpected EOF in " + file.fileName());
+               GPSTK_THROW(e);
+            }
+         }
+      }
+      return offsets;
+   }
+
+} // namespace gpstk
@@ -0,0 +1,195 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Rinex3ObsMappedReader.hpp
+ * Read RINEX 3 observation data in place from a memory-mapped file.
+ */
+
+#ifndef GPSTK_RINEX3OBSMAPPEDREADER_HPP
+#define GPSTK_RINEX3OBSMAPPEDREADER_HPP
+
+#include <string>
+#include <vector>
+
+#include "MemoryMappedFile.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class reads RINEX 3 Obs files, like Rinex3ObsStream, but
+       * maps the whole file into memory and parses the fixed-width
+       * fields of the data records in place, rather than copying each
+       * line and each field into a std::string. It produces the same
+       * Rinex3ObsData records as Rinex3ObsStream does, in the same
+       * order, and is much faster for large (e.g. 24h 1Hz multi-GNSS)
+       * files.
+       *
+       * The header is read with a Rinex3ObsStream when the file is
+       * opened. Only RINEX version 3 files are supported; the reader
+       * is read-only.
+       *
+       * @code
+       * Rinex3ObsMappedReader rdr("file.obs");
+       * Rinex3ObsData rod;
+       * while(rdr.getRecord(rod)) { ... }
+       * @endcode
+       *
+       * @sa Rinex3ObsStream, Rinex3ObsData and MemoryMappedFile.
+       */
+   class Rinex3ObsMappedReader
+   {
+   public:
+         /// Default constructor; no file is open.
+      Rinex3ObsMappedReader();
+
+         /** Common constructor; open and read the header of a file.
+          * @param[in] fn the RINEX 3 file to open
+          * @throw FileMissingException if the file cannot be opened
+          * @throw FFStreamError if the header cannot be read, or the
+          *   file is not RINEX version 3 text (e.g. it is a
+          *   Rinex3ObsCache file)
+          */
+      Rinex3ObsMappedReader(const std::string& fn);
+
+         /** Open a file, closing any that is open, and read its header.
+          * @param[in] fn the RINEX 3 file to open
+          * @throw FileMissingException if the file cannot be opened
+          * @throw FFStreamError if the header cannot be read, or the
+          *   file is not RINEX version 3 text (e.g. it is a
+          *   Rinex3ObsCache file)
+          */
+      void open(const std::string& fn);
+
+         /// Close the file.
+      void close();
+
+         /** Read the next observation record.
+          * @param[out] rod the record, exactly as Rinex3ObsStream
+          *   would read it. For speed, rod.auxHeader is only reset if
+          *   it holds header records (its valid field is not empty),
+          *   as it does when rod was read by this reader.
+          * @return true if a record was read, false at the end of the file
+          * @throw FFStreamError if the record is not valid; the read
+          *   position is not changed.
+          */
+      bool getRecord(Rinex3ObsData& rod);
+
+         /** Read the observation record that begins at a given offset
+          * (e.g. from findEpochs()). This does not use or change the
+          * read position of getRecord(rod), and several threads may
+          * call it at once.
+          * @param[in,out] offset byte offset in the file of the record;
+          *   on success, the offset of the following record
+          * @param[out] rod the record, as for getRecord(rod)
+          * @return true if a record was read, false at the end of the file
+          * @throw FFStreamError if the record is not valid; offset is
+          *   not changed.
+          * @throw InvalidRequest if offset is before the data
+          */
+      bool getRecord(size_t& offset, Rinex3ObsData& rod) const;
+
+         /** Find the start of every observation record in the file,
+          * without parsing the data. Only the epoch lines are
+          * examined, for the number of lines in each record.
+          * @return byte offsets of the records, for use with seek() or
+          *   getRecord(offset,rod)
+          * @throw FFStreamError if an epoch line is not valid, or the
+          *   file ends within a record
+          */
+      std::vector<size_t> findEpochs() const;
+
+         /// Position the reader at the first observation record.
+      void rewind()
+      { next = dataStart; }
+
+         /// Byte offset in the file of the next record to be read.
+      size_t tell() const
+      { return next; }
+
+         /** Position the reader at the record that begins at the given
+          * offset (e.g. from tell() or findEpochs()).
+          * @throw InvalidRequest if offset is not within the data
+          */
+      void seek(size_t offset);
+
+         /// Size of the file in bytes.
+      size_t size() const
+      { return file.size(); }
+
+         /// Name of the open file.
+      const std::string& fileName() const
+      { return file.fileName(); }
+
+         /// The header for this file.
+      Rinex3ObsHeader header;
+
+         /// Time system for epochs in this file
+      TimeSystem timesystem;
+
+   private:
+         /** Find the line starting at offset pos; return in len its
+          * length without the line terminator and trailing spaces,
+          * and in pos the offset of the following line.
+          * @return pointer to the line, or null at the end of the file
+          * @throw FFStreamError if the line contains non-text data */
+      const char* getLine(size_t& pos, size_t& len) const;
+
+         /// The mapped file.
+      MemoryMappedFile file;
+
+         /// Offset of the first record, after the header.
+      size_t dataStart;
+
+         /// Offset of the next record.
+      size_t next;
+
+         /// Number of observation types, indexed by system character.
+      std::vector<int> numObs;
+   }; // class Rinex3ObsMappedReader
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_RINEX3OBSMAPPEDREADER_HPP
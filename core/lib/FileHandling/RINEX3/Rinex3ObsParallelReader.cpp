@@ -0,0 +1,356 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Rinex3ObsParallelReader.cpp
+ * Decode a list of RINEX 3 observation files with a pool of threads.
+ */
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <system_error>
+
+#include "Rinex3ObsParallelReader.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "StringUtils.hpp"
+
+using namespace std;
+
+namespace gpstk
+{
+   struct Rinex3ObsParallelReader::FileState
+   {
+      FileState()
+            : pending(0), ready(false), finalized(false)
+      {}
+
+         /// What is returned to the caller.
+      FileData data;
+         /// Reader for the mapped file.
+      Rinex3ObsMappedReader reader;
+         /// Offsets of the epochs in the mapped file.
+      std::vector<size_t> offsets;
+         /// The error that ended each chunk, if any.
+      std::vector< std::unique_ptr<Exception> > chunkErrors;
+         /// Number of tasks queued or running for this file.
+      size_t pending;
+         /// True when all tasks for this file are done.
+      bool ready;
+         /// True when data has been assembled for the caller.
+      bool finalized;
+   };
+
+
+   const size_t Rinex3ObsParallelReader::splitFile = size_t(-1);
+
+
+   Rinex3ObsParallelReader ::
+   Rinex3ObsParallelReader(const std::vector<std::string>& filenames,
+                           unsigned nthreads,
+                           unsigned chunkEpochs)
+         : chunkSize(chunkEpochs > 0 ? chunkEpochs : 1), nextFile(0),
+           firstKept(0), stopping(false)
+   {
+      if(nthreads == 0)
+         nthreads = thread::hardware_concurrency();
+      if(nthreads == 0)
+         nthreads = 1;
+      ahead = 2*nthreads;
+
+      for(size_t i = 0; i < filenames.size(); i++)
+      {
+         files.push_back(unique_ptr<FileState>(new FileState));
+         files.back()->data.fileName = filenames[i];
+      }
+      schedule(ahead);
+
+      try
+      {
+         for(unsigned i = 0; i < nthreads; i++)
+            threads.push_back(thread(&Rinex3ObsParallelReader::work, this));
+      }
+      catch(std::system_error& se)
+      {
+         shutdown();
+         Exception e(string("Could not start threads: ") + se.what());
+         GPSTK_THROW(e);
+      }
+   }
+
+
+   Rinex3ObsParallelReader ::
+   ~Rinex3ObsParallelReader()
+   {
+      shutdown();
+   }
+
+
+   Rinex3ObsParallelReader::FileData& Rinex3ObsParallelReader ::
+   getFile(size_t i)
+   {
+      if(i >= files.size() || i < firstKept)
+      {
+         InvalidRequest e("File " + StringUtils::asString(i)
+                          + " is not available");
+         GPSTK_THROW(e);
+      }
+
+      {
+         unique_lock<mutex> lock(mtx);
+         schedule(i + ahead);
+         workCV.notify_all();
+
+            // release earlier files once their workers are done
+         for( ; firstKept < i; firstKept++)
+         {
+            FileState& fs(*files[firstKept]);
+            doneCV.wait(lock, [&fs]{ return fs.ready; });
+            fs.data = FileData();
+            fs.reader.close();
+            fs.offsets.clear();
+            fs.chunkErrors.clear();
+         }
+         FileState& fs(*files[i]);
+         doneCV.wait(lock, [&fs]{ return fs.ready; });
+      }
+
+      FileState& fs(*files[i]);
+      if(!fs.finalized)
+      {
+            // the records end at the first error
+         for(size_t c = 0; c < fs.chunkErrors.size(); c++)
+         {
+            if(fs.chunkErrors[c])
+            {
+               fs.data.failed = true;
+               fs.data.error = *fs.chunkErrors[c];
+               fs.data.chunks.resize(c+1);
+               break;
+            }
+         }
+         fs.reader.close();
+         fs.offsets.clear();
+         fs.chunkErrors.clear();
+         fs.finalized = true;
+      }
+      return fs.data;
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   work()
+   {
+      while(true)
+      {
+         Task task;
+         {
+            unique_lock<mutex> lock(mtx);
+            workCV.wait(lock, [this]{ return stopping || !tasks.empty(); });
+            if(stopping)
+               return;
+            task = tasks.front();
+            tasks.pop_front();
+         }
+         if(task.chunk == splitFile)
+            split(task.file);
+         else
+            decode(task.file, task.chunk);
+      }
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   split(size_t f)
+   {
+      FileState& fs(*files[f]);
+      bool mapped(false);
+      try
+      {
+         fs.reader.open(fs.data.fileName);
+         fs.offsets = fs.reader.findEpochs();
+         mapped = true;
+      }
+      catch(Exception&)
+      {
+            // the stream will find (and report) the same problem
+      }
+      catch(std::exception&)
+      {
+      }
+
+      if(!mapped)
+      {
+         fs.reader.close();
+         fs.offsets.clear();
+         readStream(fs);
+         finish(f, 0);
+         return;
+      }
+
+      fs.data.opened = fs.data.headerRead = true;
+      fs.data.header = fs.reader.header;
+      fs.data.chunkSize = chunkSize;
+      size_t nchunks((fs.offsets.size() + chunkSize - 1) / chunkSize);
+      fs.data.chunks.resize(nchunks);
+      fs.chunkErrors.resize(nchunks);
+      finish(f, nchunks);
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   decode(size_t f, size_t c)
+   {
+      FileState& fs(*files[f]);
+      vector<Rinex3ObsData>& recs(fs.data.chunks[c]);
+      size_t beg(c*chunkSize);
+      size_t end(std::min(beg+chunkSize, fs.offsets.size()));
+      size_t n(0);
+
+      recs.resize(end-beg);
+      try
+      {
+         for(size_t i = beg; i < end; i++, n++)
+         {
+            size_t offset(fs.offsets[i]);
+            fs.reader.getRecord(offset, recs[n]);
+         }
+      }
+      catch(Exception& e)
+      {
+         fs.chunkErrors[c].reset(new Exception(e));
+      }
+      catch(std::exception& se)
+      {
+         fs.chunkErrors[c].reset(new Exception(se.what()));
+      }
+      recs.resize(n);
+
+      finish(f, 0);
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   readStream(FileState& fs)
+   {
+      Rinex3ObsStream strm(fs.data.fileName.c_str());
+      if(!strm.is_open())
+         return;
+      fs.data.opened = true;
+      strm.exceptions(fstream::failbit);
+
+      fs.data.chunks.resize(1);
+      vector<Rinex3ObsData>& recs(fs.data.chunks[0]);
+      try
+      {
+         strm >> fs.data.header;
+         fs.data.headerRead = true;
+
+         Rinex3ObsData rod;
+         while(strm >> rod)
+            recs.push_back(rod);
+      }
+      catch(Exception& e)
+      {
+         fs.data.failed = true;
+         fs.data.error = e;
+      }
+      catch(std::exception& se)
+      {
+         fs.data.failed = true;
+         fs.data.error = Exception(se.what());
+      }
+      fs.data.chunkSize = std::max<size_t>(recs.size(), 1);
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   finish(size_t f, size_t ntasks)
+   {
+      lock_guard<mutex> lock(mtx);
+      FileState& fs(*files[f]);
+
+         // put the chunks at the front of the queue, in order, so the
+         // earliest file is finished first
+      for(size_t c = ntasks; c > 0; c--)
+      {
+         Task task = { f, c-1 };
+         tasks.push_front(task);
+      }
+      fs.pending += ntasks;
+      if(ntasks > 0)
+         workCV.notify_all();
+
+      if(--fs.pending == 0)
+      {
+         fs.ready = true;
+         doneCV.notify_all();
+      }
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   schedule(size_t n)
+   {
+      for( ; nextFile < files.size() && nextFile < n; nextFile++)
+      {
+         Task task = { nextFile, splitFile };
+         tasks.push_back(task);
+         files[nextFile]->pending = 1;
+      }
+   }
+
+
+   void Rinex3ObsParallelReader ::
+   shutdown()
+   {
+      {
+         lock_guard<mutex> lock(mtx);
+         stopping = true;
+      }
+      workCV.notify_all();
+      for(size_t i = 0; i < threads.size(); i++)
+      {
+         if(threads[i].joinable())
+            threads[i].join();
+      }
+      threads.clear();
+   }
+
+} // namespace gpstk
@@ -0,0 +1,247 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file Rinex3ObsParallelReader.hpp
+ * Decode a list of RINEX 3 observation files with a pool of threads.
+ */
+
+#ifndef GPSTK_RINEX3OBSPARALLELREADER_HPP
+#define GPSTK_RINEX3OBSPARALLELREADER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "Exception.hpp"
+#include "Rinex3ObsHeader.hpp"
+#include "Rinex3ObsData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup FileHandling
+      //@{
+
+      /**
+       * This class reads a list of RINEX Obs files using a pool of
+       * worker threads, and hands the decoded files to the caller one
+       * at a time, in the order given. Each file is opened with a
+       * Rinex3ObsMappedReader, the start of each epoch is found, and
+       * the epochs are split into chunks which the workers decode
+       * concurrently; several files are decoded ahead of the one the
+       * caller is using. Files that cannot be read this way (RINEX 2
+       * files, or files with errors) are read by a single worker with
+       * a Rinex3ObsStream.
+       *
+       * The records for each file are exactly those read by
+       *
+       * @code
+       * Rinex3ObsStream strm(filename);
+       * strm.exceptions(std::fstream::failbit);
+       * strm >> strm.header;
+       * while(strm >> rod) { ... }
+       * @endcode
+       *
+       * and if that would throw, the records before the error are
+       * returned with the exception.
+       *
+       * @code
+       * Rinex3ObsParallelReader rdr(filenames);
+       * for(size_t i = 0; i < rdr.numFiles(); i++)
+       * {
+       *    Rinex3ObsParallelReader::FileData& fd(rdr.getFile(i));
+       *    for(size_t j = 0; j < fd.size(); j++) { ... fd[j] ... }
+       * }
+       * @endcode
+       *
+       * @sa Rinex3ObsMappedReader and Rinex3ObsStream.
+       */
+   class Rinex3ObsParallelReader
+   {
+   public:
+         /// All that was read from one file.
+      class FileData
+      {
+      public:
+         FileData()
+               : opened(false), headerRead(false), failed(false),
+                 chunkSize(1)
+         {}
+
+            /// Number of records read.
+         size_t size() const
+         {
+            return chunks.empty() ? 0 :
+               (chunks.size()-1)*chunkSize + chunks.back().size();
+         }
+
+            /// Access the i'th record read from the file.
+         Rinex3ObsData& operator[](size_t i)
+         { return chunks[i/chunkSize][i%chunkSize]; }
+
+            /// Name of the file.
+         std::string fileName;
+            /// True if the file was opened.
+         bool opened;
+            /// True if the header was read.
+         bool headerRead;
+            /// The header of the file, if headerRead.
+         Rinex3ObsHeader header;
+            /** True if reading the file stopped at an error, which is
+             * in the header if headerRead is false, and after the
+             * last record otherwise. */
+         bool failed;
+            /// The exception at which reading stopped, if failed.
+         Exception error;
+
+      private:
+         friend class Rinex3ObsParallelReader;
+            /// The records, in chunks of chunkSize.
+         std::vector< std::vector<Rinex3ObsData> > chunks;
+            /// Number of records in each chunk but the last.
+         size_t chunkSize;
+      }; // class FileData
+
+         /** Start decoding files.
+          * @param[in] filenames the files to read, in order
+          * @param[in] nthreads number of worker threads; 0 means one
+          *   for each processor
+          * @param[in] chunkEpochs number of epochs decoded by a
+          *   worker at a time
+          * @throw Exception if the threads cannot be started
+          */
+      Rinex3ObsParallelReader(const std::vector<std::string>& filenames,
+                              unsigned nthreads = 0,
+                              unsigned chunkEpochs = 256);
+
+         /// Stop the workers; files not yet returned are not read.
+      ~Rinex3ObsParallelReader();
+
+         /// Number of files in the list.
+      size_t numFiles() const
+      { return files.size(); }
+
+         /// Number of worker threads.
+      size_t numThreads() const
+      { return threads.size(); }
+
+         /** Wait until a file has been decoded, and return it. Files
+          * must be requested in order, though some may be skipped;
+          * requesting a file releases all earlier ones.
+          * @param[in] i index of the file in the list
+          * @return the data for the file, valid until a later file
+          *   is requested or this object is destroyed
+          * @throw InvalidRequest if i is out of range, or an earlier
+          *   file than one already requested
+          */
+      FileData& getFile(size_t i);
+
+   private:
+         /// Work for a thread: a file to split, or a chunk to decode.
+      struct Task
+      {
+         size_t file;      ///< index of the file
+         size_t chunk;     ///< index of the chunk, or splitFile
+      };
+
+         /// The decoding state of one file.
+      struct FileState;
+
+         /// Task::chunk for a file that has not been split.
+      static const size_t splitFile;
+
+         /// Worker thread: run tasks until stopped.
+      void work();
+
+         /** Open file f, find its epochs and queue its chunks, or
+          * read it with a stream if that fails. */
+      void split(size_t f);
+
+         /// Decode chunk c of file f.
+      void decode(size_t f, size_t c);
+
+         /// Read a file with a Rinex3ObsStream, in one task.
+      void readStream(FileState& fs);
+
+         /** Record that a task for file f is done, having queued
+          * ntasks more for that file; the file is ready when none
+          * remain. */
+      void finish(size_t f, size_t ntasks);
+
+         /** Queue files up to but not including file n for
+          * splitting; call with mtx locked. */
+      void schedule(size_t n);
+
+         /// Stop and join the workers.
+      void shutdown();
+
+         /// Number of epochs in each chunk.
+      size_t chunkSize;
+         /// Number of files decoded ahead of the one requested.
+      size_t ahead;
+
+         /// All the files, in order.
+      std::vector< std::unique_ptr<FileState> > files;
+         /// Index of the next file to be queued for splitting.
+      size_t nextFile;
+         /// Index of the earliest file not yet released.
+      size_t firstKept;
+
+         /// Tasks waiting for a worker.
+      std::deque<Task> tasks;
+         /// Set to stop the workers.
+      bool stopping;
+         /// Guards tasks, stopping and the task counts of the files.
+      std::mutex mtx;
+         /// Signals the workers that there are tasks, or to stop.
+      std::condition_variable workCV;
+         /// Signals the caller that a file is ready.
+      std::condition_variable doneCV;
+         /// The worker threads.
+      std::vector<std::thread> threads;
+   }; // class Rinex3ObsParallelReader
+
+      //@}
+
+} // namespace gpstk
+
+#endif // GPSTK_RINEX3OBSPARALLELREADER_HPP
@@ -81,6 +81,8 @@ namespace gpstk
          std::ios::openmode mode )
    {
       FFTextStream::open(fn, mode);
+      previousTime = CommonTime::BEGINNING_OF_TIME;
+      obsCache.reset();
    }
 
 
@@ -90,6 +92,8 @@ namespace gpstk
       headerRead = false;
       header = Rinex3ObsHeader();
       timesystem = TimeSystem::GPS;
+      previousTime = CommonTime::BEGINNING_OF_TIME;
+      obsCache.reset();
    }
 
 
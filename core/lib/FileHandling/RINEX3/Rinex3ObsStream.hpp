@@ -48,15 +48,19 @@
 #include <list>
 #include <map>
 #include <string>
+#include <memory>
 
 #include "FFTextStream.hpp"
 #include "Rinex3ObsHeader.hpp"
+#include "CommonTime.hpp"
 
 namespace gpstk
 {
       /// @ingroup FileHandling
       //@{
 
+   class Rinex3ObsCache;
+
       /**
        * This class reads RINEX 3 Obs files.
        *
@@ -112,6 +116,15 @@ namespace gpstk
          /// Time system for epochs in this file
       TimeSystem timesystem;
 
+         /** Epoch of the last RINEX 2 record read that had one; used
+          * for event records (epoch flag 2-4) that have no epoch. */
+      CommonTime previousTime;
+
+         /** If this stream is a binary observation cache file, the
+          * cache that supplies its data records; set when the header
+          * is read.  @sa Rinex3ObsCache */
+      std::shared_ptr<Rinex3ObsCache> obsCache;
+
          /// Check if the input stream is the kind of Rinex3ObsStream
       static bool isRinex3ObsStream(std::istream& i);
 
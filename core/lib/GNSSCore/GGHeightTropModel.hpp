@@ -116,6 +116,10 @@ namespace gpstk
       virtual std::string name(void)
       { return std::string("GGHeight"); }
 
+         /// Return a copy of this model, allocated with new
+      virtual GGHeightTropModel* clone(void) const
+      { return new GGHeightTropModel(*this); }
+
          /** Compute and return the full tropospheric delay
           * @param elevation Elevation of satellite as seen at
           *   receiver, in degrees
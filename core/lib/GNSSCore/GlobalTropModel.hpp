@@ -136,6 +136,10 @@ namespace gpstk
       virtual std::string name()
       { return std::string("Global"); }
 
+      /// Return a copy of this model, allocated with new
+      virtual GlobalTropModel* clone(void) const
+      { return new GlobalTropModel(*this); }
+
          /** Compute and return the full tropospheric delay. The receiver
           * height, latitude and Day oy Year must has been set before using
           * the appropriate constructor or the provided methods.
@@ -120,6 +120,10 @@ namespace gpstk
       virtual std::string name(void)
          { return std::string("MOPS"); }
 
+      /// Return a copy of this model, allocated with new
+      virtual MOPSTropModel* clone(void) const
+         { return new MOPSTropModel(*this); }
+
 
          /** Compute and return the full tropospheric delay. The receiver
           *  height, latitude and Day oy Year must has been set before using
@@ -138,6 +138,10 @@ namespace gpstk
       virtual std::string name(void)
       { return std::string("NB"); }
 
+         /// Return a copy of this model, allocated with new
+      virtual NBTropModel* clone(void) const
+      { return new NBTropModel(*this); }
+
          /** Compute and return the full tropospheric delay
           * @param elevation Elevation of satellite as seen at
           *   receiver, in degrees
@@ -129,6 +129,10 @@ namespace gpstk
       virtual std::string name(void)
          { return std::string("Neill"); }
 
+      /// Return a copy of this model, allocated with new
+      virtual NeillTropModel* clone(void) const
+         { return new NeillTropModel(*this); }
+
          /** Compute and return the full tropospheric delay. The receiver
           * height, latitude and Day oy Year must has been set before using
           * the appropriate constructor or the provided methods.
@@ -261,7 +261,15 @@ namespace gpstk
       char ot(strID[0]);
       char cb(strID[1]);
       char tc(strID[2]);
-      const std::string &codes(RinexObsID::validRinexTrackingCodes[sys][cb]);
+         // find(), not operator[], which would insert into the shared map
+      std::string codes;
+      const auto& sysit = RinexObsID::validRinexTrackingCodes.find(sys);
+      if (sysit != RinexObsID::validRinexTrackingCodes.end())
+      {
+         const auto& cbit = sysit->second.find(cb);
+         if (cbit != sysit->second.end())
+            codes = cbit->second;
+      }
       if(ot == ' ' || ot == '-')
       {
          return false;
@@ -117,6 +117,13 @@ namespace gpstk
       virtual std::string name(void)
       { return std::string("Undefined"); }
 
+         /** Return a copy of this model, allocated with new, or
+          * null if the model cannot be copied.  A copy has its own
+          * state, so that copies may be used in separate threads.
+          * The models in this library all return a copy. */
+      virtual TropModel* clone(void) const
+      { return 0; }
+
          /** Compute and return the full tropospheric delay
           * @param elevation Elevation of satellite as seen at
           *   receiver, in degrees
@@ -286,6 +293,10 @@ namespace gpstk
       virtual std::string name(void)
       { return std::string("Zero"); }
 
+         /// Return a copy of this model, allocated with new
+      virtual ZeroTropModel* clone(void) const
+      { return new ZeroTropModel(*this); }
+
          /** Compute and return the full tropospheric delay
           * @param elevation Elevation of satellite as seen at receiver, in degrees
           * @throw InvalidTropModel
@@ -72,124 +72,169 @@ namespace gpstk
    ClockRecord ClockSatStore::getValue(const SatID& sat, const CommonTime& ttag)
       const
    {
-      try {
-         checkTimeSystem(ttag.getTimeSystem());
-
-         bool isExact;
-         ClockRecord rec;
-         DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
+      if(frozen)
+         return interpValue<FrozenTableIterator>(sat, ttag);
+      return interpValue<DataTableIterator>(sat, ttag);
+   }
 
-         isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift);
-         if(isExact && haveClockDrift) {
-            rec = it1->second;
-            return rec;
-         }
+   bool ClockSatStore::tryGetValue(const SatID& sat, const CommonTime& ttag,
+                                   ClockRecord& rec) const
+   {
+      const TimeSystem ts(ttag.getTimeSystem());
+      if(ts != TimeSystem::Any && storeTimeSystem != TimeSystem::Any
+         && ts != storeTimeSystem)
+         return false;
+
+      bool isExact;
+      if(frozen) {
+         FrozenTableIterator it1, it2;
+         if(!tryGetTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift,
+                                 isExact))
+            return false;
+         rec = interpRecord(it1, it2, isExact, ttag);
+         return true;
+      }
+      DataTableIterator it1, it2;
+      if(!tryGetTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift,
+                              isExact))
+         return false;
+      rec = interpRecord(it1, it2, isExact, ttag);
+      return true;
+   }
 
-         // pull data out of the data table
-         size_t n,Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
-         CommonTime ttag0(it1->first);
-         vector<double> times,biases,drifts,accels,sig_biases,sig_drifts,sig_accels;
+   // Implementation of getValue() for either kind of table
+   template <class Iterator>
+   ClockRecord ClockSatStore::interpValue(const SatID& sat, const CommonTime& ttag)
+      const
+   {
+      try {
+         checkTimeSystem(ttag.getTimeSystem());
 
-         kt=it1; n=0;
-         while(1) {
-            // find index of matching time tag
-            if(isExact && ABS(kt->first-ttag) < 1.e-8) Nmatch = n;
-            times.push_back(kt->first - ttag0);    // sec
-            biases.push_back(kt->second.bias);     // sec
-            drifts.push_back(kt->second.drift);    // sec/sec
-            accels.push_back(kt->second.accel);    // sec/sec^2
-            sig_biases.push_back(kt->second.sig_bias);     // sec
-            sig_drifts.push_back(kt->second.sig_drift);    // sec/sec
-            sig_accels.push_back(kt->second.sig_accel);    // sec/sec^2
-            if(kt == it2) break;
-            ++kt;
-            ++n;
-         };
+         Iterator it1, it2;        // cf. TabularSatStore.hpp
+         bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift));
+         return interpRecord(it1, it2, isExact, ttag);
+      }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+   }
 
-         if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
+   // Interpolate the interval (it1,it2) found by getTableInterval()
+   template <class Iterator>
+   ClockRecord ClockSatStore::interpRecord(const Iterator& it1,
+                                           const Iterator& it2,
+                                           bool isExact,
+                                           const CommonTime& ttag) const
+   {
+         ClockRecord rec;
+      Iterator kt;
 
-         // interpolate
-         rec.accel = rec.sig_accel = 0.0;              // defaults
-         double dt(ttag-ttag0), err, slope;
-         if(haveClockDrift) {
-            if(interpType == 2) {
-               // Lagrange interpolation
-               rec.bias = LagrangeInterpolation(times,biases,dt,err);      // sec
-               rec.drift = LagrangeInterpolation(times,drifts,dt,err);     // sec/sec
-            }
-            else {
-               // linear interpolation
-               slope = (biases[Nhi]-biases[Nlow]) /
-                                   (times[Nhi]-times[Nlow]);               // sec/sec
-               rec.bias = biases[Nlow] + slope*(dt-times[Nlow]);           // sec
-               slope = (drifts[Nhi]-drifts[Nlow])/(times[Nhi]-times[Nlow]);
-               rec.drift = drifts[Nlow] + slope*(dt-times[Nlow]);          // sec/sec
-            }
+      if(isExact && haveClockDrift) {
+         rec = it1->second;
+         return rec;
+      }
 
-            // sigmas
-            if(isExact)
-               rec.sig_bias = sig_biases[Nmatch];
-            else
-               rec.sig_bias = RSS(sig_biases[Nhi],sig_biases[Nlow]);
-            rec.sig_drift = RSS(sig_drifts[Nhi],sig_drifts[Nlow]);
+      // pull data out of the data table
+      size_t n,Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
+      CommonTime ttag0(it1->first);
+      vector<double> times,biases,drifts,accels,sig_biases,sig_drifts,sig_accels;
+
+      kt=it1; n=0;
+      while(1) {
+         // find index of matching time tag
+         if(isExact && ABS(kt->first-ttag) < 1.e-8) Nmatch = n;
+         times.push_back(kt->first - ttag0);    // sec
+         biases.push_back(kt->second.bias);     // sec
+         drifts.push_back(kt->second.drift);    // sec/sec
+         accels.push_back(kt->second.accel);    // sec/sec^2
+         sig_biases.push_back(kt->second.sig_bias);     // sec
+         sig_drifts.push_back(kt->second.sig_drift);    // sec/sec
+         sig_accels.push_back(kt->second.sig_accel);    // sec/sec^2
+         if(kt == it2) break;
+         ++kt;
+         ++n;
+      };
+
+      if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
+
+      // interpolate
+      rec.accel = rec.sig_accel = 0.0;              // defaults
+      double dt(ttag-ttag0), err, slope;
+      if(haveClockDrift) {
+         if(interpType == 2) {
+            // Lagrange interpolation
+            rec.bias = LagrangeInterpolation(times,biases,dt,err);      // sec
+            rec.drift = LagrangeInterpolation(times,drifts,dt,err);     // sec/sec
+         }
+         else {
+            // linear interpolation
+            slope = (biases[Nhi]-biases[Nlow]) /
+                                (times[Nhi]-times[Nlow]);               // sec/sec
+            rec.bias = biases[Nlow] + slope*(dt-times[Nlow]);           // sec
+            slope = (drifts[Nhi]-drifts[Nlow])/(times[Nhi]-times[Nlow]);
+            rec.drift = drifts[Nlow] + slope*(dt-times[Nlow]);          // sec/sec
          }
-         else {                              // must interpolate biases to get drift
-            if(interpType == 2) {
-               // Lagrange interpolation
-               LagrangeInterpolation(times,biases,dt,rec.bias,rec.drift);
-            }
-            else {
-               // linear interpolation
-               rec.drift = (biases[Nhi]-biases[Nlow]) /
-                                   (times[Nhi]-times[Nlow]);            // sec/sec^2
-               rec.bias = biases[Nlow] + (dt-times[Nlow])*rec.drift;    // sec/sec
-            }
 
-            // sigmas
-            if(isExact)
-               rec.sig_bias = sig_biases[Nmatch];
-            else
-               rec.sig_bias = RSS(sig_biases[Nhi],sig_biases[Nlow]);
-            // TD ?
-            rec.sig_drift = rec.sig_bias/(times[Nhi]-times[Nlow]);
+         // sigmas
+         if(isExact)
+            rec.sig_bias = sig_biases[Nmatch];
+         else
+            rec.sig_bias = RSS(sig_biases[Nhi],sig_biases[Nlow]);
+         rec.sig_drift = RSS(sig_drifts[Nhi],sig_drifts[Nlow]);
+      }
+      else {                              // must interpolate biases to get drift
+         if(interpType == 2) {
+            // Lagrange interpolation
+            LagrangeInterpolation(times,biases,dt,rec.bias,rec.drift);
+         }
+         else {
+            // linear interpolation
+            rec.drift = (biases[Nhi]-biases[Nlow]) /
+                                (times[Nhi]-times[Nlow]);            // sec/sec^2
+            rec.bias = biases[Nlow] + (dt-times[Nlow])*rec.drift;    // sec/sec
          }
 
-         if(haveClockAccel) {
-            if(interpType == 2) {
-               // Lagrange interpolation
-               rec.accel = LagrangeInterpolation(times,accels,dt,err);  // sec/sec^2
-            }
-            else {
-               // linear interpolation
-               slope = (drifts[Nhi]-drifts[Nlow]) /
-                                   (times[Nhi]-times[Nlow]);            // sec/sec^2
-               rec.accel = accels[Nlow] + slope*(dt-times[Nlow]);       // sec/sec^2
-            }
+         // sigmas
+         if(isExact)
+            rec.sig_bias = sig_biases[Nmatch];
+         else
+            rec.sig_bias = RSS(sig_biases[Nhi],sig_biases[Nlow]);
+         // TD ?
+         rec.sig_drift = rec.sig_bias/(times[Nhi]-times[Nlow]);
+      }
 
-            // sigma
-            if(isExact)
-               rec.sig_accel = sig_accels[Nmatch];
-            else
-               rec.sig_accel = RSS(sig_accels[Nhi],sig_accels[Nlow]);
+      if(haveClockAccel) {
+         if(interpType == 2) {
+            // Lagrange interpolation
+            rec.accel = LagrangeInterpolation(times,accels,dt,err);  // sec/sec^2
+         }
+         else {
+            // linear interpolation
+            slope = (drifts[Nhi]-drifts[Nlow]) /
+                                (times[Nhi]-times[Nlow]);            // sec/sec^2
+            rec.accel = accels[Nlow] + slope*(dt-times[Nlow]);       // sec/sec^2
          }
-         else if(haveClockDrift) {              // must interpolate drift to get accel
-            if(interpType == 2) {
-               // Lagrange interpolation  (err is a dummy here)
-               LagrangeInterpolation(times,drifts,dt,err,rec.accel);
-            }
-            else {
-               // linear interpolation                                  // sec/sec^2
-               rec.accel = (drifts[Nhi]-drifts[Nlow]) / (times[Nhi]-times[Nlow]);
-            }
 
-            // sigmas  TD is there a better way?
-            rec.sig_accel = rec.sig_drift/(times[Nhi]-times[Nlow]);
+         // sigma
+         if(isExact)
+            rec.sig_accel = sig_accels[Nmatch];
+         else
+            rec.sig_accel = RSS(sig_accels[Nhi],sig_accels[Nlow]);
+      }
+      else if(haveClockDrift) {              // must interpolate drift to get accel
+         if(interpType == 2) {
+            // Lagrange interpolation  (err is a dummy here)
+            LagrangeInterpolation(times,drifts,dt,err,rec.accel);
+         }
+         else {
+            // linear interpolation                                  // sec/sec^2
+            rec.accel = (drifts[Nhi]-drifts[Nlow]) / (times[Nhi]-times[Nlow]);
          }
-         // else zero
 
-         return rec;
+         // sigmas  TD is there a better way?
+         rec.sig_accel = rec.sig_drift/(times[Nhi]-times[Nlow]);
       }
-      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+      // else zero
+
+      return rec;
    }
 
    // Return the clock bias for the given satellite at the given time
@@ -202,11 +247,21 @@ namespace gpstk
    //  c) checkInterval is true and the interval is larger than maxInterval
    double ClockSatStore::getClockBias(const SatID& sat, const CommonTime& ttag)
       const
+   {
+      if(frozen)
+         return interpClockBias<FrozenTableIterator>(sat, ttag);
+      return interpClockBias<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getClockBias() for either kind of table
+   template <class Iterator>
+   double ClockSatStore::interpClockBias(const SatID& sat, const CommonTime& ttag)
+      const
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
 
-         DataTableIterator it1, it2, kt;
+         Iterator it1, it2, kt;
          if(getTableInterval(sat, ttag, Nhalf, it1, it2, true)) {
             // exact match
             ClockRecord rec;
@@ -251,11 +306,21 @@ namespace gpstk
    //  d) there is no drift data in the store
    double ClockSatStore::getClockDrift(const SatID& sat, const CommonTime& ttag)
       const
+   {
+      if(frozen)
+         return interpClockDrift<FrozenTableIterator>(sat, ttag);
+      return interpClockDrift<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getClockDrift() for either kind of table
+   template <class Iterator>
+   double ClockSatStore::interpClockDrift(const SatID& sat, const CommonTime& ttag)
+      const
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
 
-         DataTableIterator it1, it2, kt;
+         Iterator it1, it2, kt;
          bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveClockDrift));
          if(isExact && haveClockDrift) {
             ClockRecord rec;
@@ -319,6 +384,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          if(rec.drift != 0.0) haveClockDrift = true;
          if(rec.accel != 0.0) haveClockAccel = true;
@@ -350,6 +416,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          if(tables.find(sat) != tables.end() &&
             tables[sat].find(ttag) != tables[sat].end()) {
@@ -377,6 +444,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          haveClockDrift = true;
 
@@ -406,6 +474,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          haveClockAccel = true;
 
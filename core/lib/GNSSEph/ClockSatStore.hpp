@@ -156,6 +156,16 @@ namespace gpstk
       virtual ClockRecord getValue(const SatID& sat, const CommonTime& ttag)
          const;
 
+         /** Compute the value for the given satellite at the given
+          * time as getValue() does, but return false instead of
+          * throwing if it cannot be computed.
+          * @param[in] sat the SatID of the satellite of interest
+          * @param[in] ttag the time (CommonTime) of interest
+          * @param[out] rec the data value(s), if true is returned
+          * @return true if rec was computed */
+      bool tryGetValue(const SatID& sat, const CommonTime& ttag,
+                       ClockRecord& rec) const;
+
          /** Return the clock bias for the given satellite at the given time
           * @param[in] sat the SatID of the satellite of interest
           * @param[in] ttag the time (CommonTime) of interest
@@ -266,6 +276,25 @@ namespace gpstk
       void setLinearInterp(void) throw()
       { interpType = 1; setInterpolationOrder(2); }
 
+   private:
+         /** Implementations of getValue(), getClockBias() and
+          * getClockDrift() for either the std::map tables
+          * (Iterator = DataTableIterator) or the frozen tables
+          * (Iterator = FrozenTableIterator).
+          * @throw InvalidRequest as the public functions */
+      template <class Iterator>
+      ClockRecord interpValue(const SatID& sat, const CommonTime& ttag) const;
+         /** Interpolate the interval (it1,it2) found by
+          * getTableInterval(); the common part of interpValue() and
+          * tryGetValue(). */
+      template <class Iterator>
+      ClockRecord interpRecord(const Iterator& it1, const Iterator& it2,
+                               bool isExact, const CommonTime& ttag) const;
+      template <class Iterator>
+      double interpClockBias(const SatID& sat, const CommonTime& ttag) const;
+      template <class Iterator>
+      double interpClockDrift(const SatID& sat, const CommonTime& ttag) const;
+
    }; // end class ClockSatStore
 
       //@}
@@ -55,6 +55,38 @@
 
 namespace gpstk
 {
+   namespace
+   {
+         /** The parity bits D25-D30 contributed by each possible value
+          * of each of the three bytes of data bits d1-d24, so that the
+          * parity of a word is the exclusive-OR of three table entries
+          * rather than six bit counts.  Built from the bit masks in
+          * EngNav::computeParity(). */
+      struct ParityTable
+      {
+         ParityTable();
+         uint8_t byte[3][256];  ///< D25 in bit 5 ... D30 in bit 0
+      };
+
+      ParityTable :: ParityTable()
+      {
+         static const uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L,
+                                            0x2EC7CD00L, 0x1763E680L,
+                                            0x2BB1F340L, 0x0B7A89C0L };
+            // d1-d24 are bits 29-6 of the word
+         for (int b=0; b<3; b++)
+         {
+            for (uint32_t v=0; v<256; v++)
+            {
+               uint32_t d = v << (22 - 8*b);
+               byte[b][v] = 0;
+               for (int k=0; k<6; k++)
+                  byte[b][v] |= (BinUtils::countBits(bmask[k] & d) % 2) << (5-k);
+            }
+         }
+      }
+   }
+
    /// DecodeBits .
    struct DecodeBits
    {
@@ -632,8 +664,8 @@ namespace gpstk
                                     bool knownUpright)
    {
          /*
-           This function is somewhat table-driven.  There is one
-           element in bmask for each of the six parity bits.  Each
+           This function is table-driven; see ParityTable.  There is
+           one element in bmask for each of the six parity bits.  Each
            element is a bit mask with bits set corresponding to the
            bits which are to be exclusive-OR'd together to form the
            parity check bit.  The following bit maps define the bmask
@@ -651,10 +683,8 @@ namespace gpstk
            D29    10 1011 1011 0001 1111 0011 0100 0000
            D30    00 1011 0111 1010 1000 1001 1100 0000
          */
-      uint32_t bmask[6] = { 0x3B1F3480L, 0x1D8F9A40L, 0x2EC7CD00L,
-                            0x1763E680L, 0x2BB1F340L, 0x0B7A89C0L };
+      static const ParityTable table;
 
-      uint32_t D = 0;
       uint32_t d = sfword;
       uint32_t D29 = getd29(psfword);
       uint32_t D30 = getd30(psfword);
@@ -665,12 +695,14 @@ namespace gpstk
          // new.
       if (D30 && !knownUpright)
          d = ~d;
-      D |= ((D29 + BinUtils::countBits(bmask[0] & d)) % 2) << 5;
-      D |= ((D30 + BinUtils::countBits(bmask[1] & d)) % 2) << 4;
-      D |= ((D29 + BinUtils::countBits(bmask[2] & d)) % 2) << 3;
-      D |= ((D30 + BinUtils::countBits(bmask[3] & d)) % 2) << 2;
-      D |= ((D30 + BinUtils::countBits(bmask[4] & d)) % 2) << 1;
-      D |= ((D29 + BinUtils::countBits(bmask[5] & d)) % 2);
+      uint32_t D = table.byte[0][(d >> 22) & 0xff] ^
+                   table.byte[1][(d >> 14) & 0xff] ^
+                   table.byte[2][(d >> 6) & 0xff];
+         // D29* enters D25, D27 and D30; D30* enters D26, D28 and D29
+      if (D29)
+         D ^= 0x29;
+      if (D30)
+         D ^= 0x16;
 
       return D;
    }
@@ -43,6 +43,7 @@
 #define GPSTK_GLOEPHEMERIS_HPP
 
 #include <iostream>
+#include <memory>
 #include "Triple.hpp"
 #include "Xvt.hpp"
 #include "CommonTime.hpp"
@@ -83,6 +84,11 @@ namespace gpstk
          /** Compute satellite position & velocity at the given time
           *  using this ephemeris data.
           *
+          *  The orbit is integrated once, over the whole fit interval, and
+          *  cached in this object (and its copies); each call interpolates
+          *  the cache, agreeing with svXvtOverrideFit() to better than
+          *  0.1 mm in position and 1 micron/s in velocity.
+          *
           * @param epoch   Epoch to compute position and velocity.
           *
           * @throw InvalidRequest if required data has not been stored.
@@ -96,6 +102,8 @@ namespace gpstk
           *  THIS IS ONLY INTENDED FOR SPECIAL TEST PURPOSES.  GENERAL
           *  USE IS STRONGLY DISCOURAGED. 
           *
+          *  The orbit is integrated from the ephemeris epoch on every call.
+          *
           * @param epoch   Epoch to compute position and velocity.
           *
           */
@@ -252,8 +260,44 @@ namespace gpstk
 
 
          /// Function implementing the derivative of GLONASS orbital model.
-      Vector<double> derivative( const Vector<double>& inState,
-                                 const Vector<double>& accel ) const;
+         /// The state is (x,vx,y,vy,z,vz) in km and km/s.
+      static void derivative( const double inState[6],
+                              const double accel[3],
+                              double dxt[6] );
+
+         /// Earth rotation rate of PZ-90 (rad/s)
+      static const double we;
+
+         /// Spacing (s) of the nodes of the cached orbit used by svXvt()
+      static const double denseStep;
+
+         /// The orbit integrated over the fit interval, from which svXvt()
+         /// interpolates; defined in GloEphemeris.cpp.
+      class DenseOrbit;
+
+         /// Cache of denseOrbit(), shared with copies of this object.
+      mutable std::shared_ptr<const DenseOrbit> dense;
+
+         /// Return the cached orbit, integrating it first if necessary.
+      std::shared_ptr<const DenseOrbit> denseOrbit() const;
+
+         /** Get the reference state (x,vx,y,vy,z,vz) in an absolute
+          * coordinate system, and the sidereal angle at 0h and the seconds
+          * of day of ephTime that define it. */
+      void initialState( double state[6], double& s0, double& sod ) const;
+
+         /// Lunisolar acceleration in the absolute system at angle s.
+      void lunisolarAccel( double s, double accel[3] ) const;
+
+         /** Integrate state in the absolute system from one epoch to
+          * another with the Runge-Kutta step; numSeconds (seconds of day of
+          * the angle s0) is advanced with it. */
+      void integrate( double state[6], double s0, double& numSeconds,
+                      const CommonTime& from, const CommonTime& to ) const;
+
+         /// Rotate a state at angle s back to PZ-90 and add the clock.
+      Xvt makeXvt( const double state[6], double s,
+                   const CommonTime& epoch ) const;
 
 
 
@@ -157,7 +157,7 @@ namespace gpstk
       }
 
          // We now have the proper reference data record. Let's use it
-      GloEphemeris data( i->second );
+      const GloEphemeris& data( i->second );
 
          // Compute the satellite position, velocity and clock offset
       sv = data.svXvt( epoch );
@@ -168,6 +168,201 @@ namespace gpstk
    }; // End of method 'GloEphemerisStore::getXvt()'
 
 
+   bool GloEphemerisStore::tryGetXvt( const SatID& sat,
+                                      const CommonTime& epoch,
+                                      Xvt& xvt ) const
+   {
+      try
+      {
+            // Same checks as getXvt(), without the exceptions
+         if ( epoch.getTimeSystem() != initialTime.getTimeSystem() ||
+              epoch < (initialTime - 900.0) ||
+              epoch > (finalTime   + 900.0) )
+         {
+            return false;
+         }
+
+         GloEphMap::const_iterator svmap = pe.find(sat);
+         if (svmap == pe.end() || svmap->second.empty())
+         {
+            return false;
+         }
+         const TimeGloMap& sem = svmap->second;
+
+         const GloEphemeris *data =
+            selectEphemeris(sem, sem.lower_bound(epoch), epoch);
+         if (data == NULL)
+         {
+            return false;
+         }
+
+         xvt = data->svXvt(epoch);
+         return true;
+      }
+      catch (Exception& e)
+      {
+         return false;
+      }
+
+   }; // End of method 'GloEphemerisStore::tryGetXvt()'
+
+
+   unsigned GloEphemerisStore::getXvtBatch(const SatID& sat,
+                                           const std::vector<CommonTime>& times,
+                                           std::vector<Xvt>& xvt) const
+   {
+      unsigned n(0);
+      Xvt unavail;
+      unavail.health = Xvt::HealthStatus::Unavailable;
+      xvt.assign(times.size(), unavail);
+
+      GloEphMap::const_iterator svmap = pe.find(sat);
+      if (svmap == pe.end() || svmap->second.empty())
+      {
+         return n;
+      }
+      const TimeGloMap& sem = svmap->second;
+
+         // Time limits, with the margin used by getXvt()
+      const CommonTime first(initialTime - 900.0), last(finalTime + 900.0);
+
+         // 'it' is sem.lower_bound(*itTime); while the times increase it
+         // only moves forward, so walk it rather than search again.
+      TimeGloMap::const_iterator it;
+      const CommonTime *itTime(NULL);
+      for (size_t k = 0; k < times.size(); k++)
+      {
+         const CommonTime& epoch(times[k]);
+         try
+         {
+            if ( epoch.getTimeSystem() != initialTime.getTimeSystem() ||
+                 epoch < first || epoch > last )
+            {
+               continue;
+            }
+
+            if ( itTime && !(epoch < *itTime) )
+            {
+               while ( it != sem.end() && it->first < epoch )
+               {
+                  ++it;
+               }
+            }
+            else
+            {
+               it = sem.lower_bound(epoch);
+            }
+            itTime = &epoch;
+
+            const GloEphemeris *data = selectEphemeris(sem, it, epoch);
+            if (data == NULL)
+            {
+               continue;
+            }
+
+            xvt[k] = data->svXvt(epoch);
+            n++;
+         }
+         catch (Exception& e)
+         {
+            xvt[k] = unavail;
+            itTime = NULL;
+         }
+      }
+
+      return n;
+
+   }; // End of method 'GloEphemerisStore::getXvtBatch()'
+
+
+   unsigned GloEphemerisStore::getXvtBatch(const std::vector<SatID>& sats,
+                                           const CommonTime& epoch,
+                                           std::vector<Xvt>& xvt) const
+   {
+      unsigned n(0);
+      Xvt unavail;
+      unavail.health = Xvt::HealthStatus::Unavailable;
+      xvt.assign(sats.size(), unavail);
+
+      try
+      {
+            // Same limits as getXvt(), checked once for all satellites
+         if ( epoch.getTimeSystem() != initialTime.getTimeSystem() ||
+              epoch < (initialTime - 900.0) ||
+              epoch > (finalTime   + 900.0) )
+         {
+            return n;
+         }
+      }
+      catch (Exception& e)
+      {
+         return n;
+      }
+
+      for (size_t k = 0; k < sats.size(); k++)
+      {
+         try
+         {
+            GloEphMap::const_iterator svmap = pe.find(sats[k]);
+            if (svmap == pe.end() || svmap->second.empty())
+            {
+               continue;
+            }
+            const TimeGloMap& sem = svmap->second;
+
+            const GloEphemeris *data =
+               selectEphemeris(sem, sem.lower_bound(epoch), epoch);
+            if (data == NULL)
+            {
+               continue;
+            }
+
+            xvt[k] = data->svXvt(epoch);
+            n++;
+         }
+         catch (Exception& e)
+         {
+            xvt[k] = unavail;
+         }
+      }
+
+      return n;
+
+   }; // End of method 'GloEphemerisStore::getXvtBatch()'
+
+
+   const GloEphemeris* GloEphemerisStore::
+   selectEphemeris( const TimeGloMap& sem,
+                    TimeGloMap::const_iterator i,
+                    const CommonTime& epoch )
+   {
+         // If we reached the end, the requested time is beyond the last
+         // ephemeris record, but it may still be within the allowable time
+         // span, so we can use the last record.
+      if ( i == sem.end() )
+      {
+         --i;
+      }
+
+         // If key > (epoch+900), we must use the previous record if possible.
+      if ( ( i->first > (epoch+900.0) ) && ( i != sem.begin() ) )
+      {
+         --i;
+      }
+
+         // Check that the given epoch is within the available time limits for
+         // this specific satellite, with a margin of 15 minutes (900 seconds).
+      if ( epoch <  (i->first - 900.0) ||
+           epoch >= (i->first   + 900.0)   )
+      {
+         return NULL;
+      }
+
+      return &(i->second);
+
+   }; // End of method 'GloEphemerisStore::selectEphemeris()'
+
+
    Xvt GloEphemerisStore::computeXvt(const SatID& sat,
                                      const CommonTime& epoch) const throw()
    {
@@ -231,7 +426,7 @@ namespace gpstk
          }
 
             // We now have the proper reference data record. Let's use it
-         GloEphemeris data(i->second);
+         const GloEphemeris& data(i->second);
 
             // Compute the satellite position, velocity and clock offset
          rv = data.svXvt(epoch);
@@ -44,6 +44,7 @@
 
 #include <iostream>
 #include <set>
+#include <vector>
 
 #include "XvtStore.hpp"
 #include "GloEphemeris.hpp"
@@ -134,6 +135,41 @@ namespace gpstk
       virtual Xvt computeXvt(const SatID& id, const CommonTime& t)
          const throw();
 
+         /** Compute the Xvt of a satellite as getXvt() does, but
+          * return false instead of throwing when the time system or
+          * time is not covered by the store; see
+          * XvtStore::tryGetXvt().
+          * @param[in] id the satellite's identifier
+          * @param[in] epoch the time to look up
+          * @param[out] xvt the Xvt of the satellite at epoch
+          * @return true if xvt was computed */
+      virtual bool tryGetXvt(const SatID& id, const CommonTime& epoch,
+                             Xvt& xvt) const;
+
+         /** Compute the Xvt of one satellite at many times; see
+          * XvtStore::getXvtBatch().  The satellite is looked up
+          * once, for increasing times the table position is carried
+          * forward from one time to the next, and the ephemeris is
+          * not copied for each time.
+          * @param[in] id the satellite's identifier
+          * @param[in] times the times to look up
+          * @param[out] xvt the Xvts, resized to times.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const SatID& id,
+                                   const std::vector<CommonTime>& times,
+                                   std::vector<Xvt>& xvt) const;
+
+         /** Compute the Xvt of many satellites at one time; see
+          * XvtStore::getXvtBatch().  The time is checked against the
+          * limits of the store only once.
+          * @param[in] ids the satellites' identifiers
+          * @param[in] t the time to look up
+          * @param[out] xvt the Xvts, resized to ids.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const std::vector<SatID>& ids,
+                                   const CommonTime& t,
+                                   std::vector<Xvt>& xvt) const;
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
@@ -297,6 +333,14 @@ namespace gpstk
          /// Integration step for Runge-Kutta algorithm (1 second by default)
       double step;
 
+         /** The record getXvt() uses for epoch, given the table of one
+          * satellite and i = sem.lower_bound(epoch).
+          * @return a pointer to the record, or NULL if epoch is out
+          *   of the boundaries of the nearest record. */
+      static const GloEphemeris* selectEphemeris(const TimeGloMap& sem,
+                                                 TimeGloMap::const_iterator i,
+                                                 const CommonTime& epoch);
+
    };  // End of class 'GloEphemerisStore'
 
       //@}
@@ -47,6 +47,7 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
 
 #include "StringUtils.hpp"
 #include "MathBase.hpp"
@@ -61,6 +62,17 @@ using namespace gpstk::StringUtils;
 
 namespace gpstk
 {
+      // The selections made by findUserOrbitEph() and findNearOrbitEph(),
+      // for either TimeOrbitEphTable or FlatOrbitEphTable; defined below.
+   template <class Table>
+   static const OrbitEph* selectUserEph(const Table& table,
+                                        typename Table::const_iterator it,
+                                        const CommonTime& t);
+   template <class Table>
+   static const OrbitEph* selectNearEph(const Table& table,
+                                        typename Table::const_iterator itNext,
+                                        const CommonTime& t);
+
    Xvt OrbitEphStore::getXvt(const SatID& sat, const CommonTime& t) const
    {
       try
@@ -92,6 +104,34 @@ namespace gpstk
    }
 
 
+   bool OrbitEphStore::tryGetXvt(const SatID& sat, const CommonTime& t,
+                                 Xvt& xvt) const
+   {
+      try
+      {
+            // get the appropriate OrbitEph
+         const OrbitEph *eph = findOrbitEph(sat,t);
+         if (!eph)
+            return false;
+
+         const bool healthy(eph->isHealthy());
+         if (onlyHealthy && !healthy)
+            return false;
+
+            // compute the position, velocity and time
+         xvt = eph->svXvt(t);
+         xvt.health = (healthy ? Xvt::HealthStatus::Healthy
+                       : Xvt::HealthStatus::Unhealthy);
+         return true;
+      }
+      catch(Exception& e)
+      {
+            // only for conflicting time systems or an unloaded OrbitEph
+         return false;
+      }
+   }
+
+
    Xvt OrbitEphStore::computeXvt(const SatID& sat, const CommonTime& t) const
       throw()
    {
@@ -116,6 +156,92 @@ namespace gpstk
    }
 
 
+   unsigned OrbitEphStore::getXvtBatch(const SatID& sat,
+                                       const vector<CommonTime>& times,
+                                       vector<Xvt>& xvt) const
+   {
+      unsigned n(0);
+      Xvt unavail;
+      unavail.health = Xvt::HealthStatus::Unavailable;
+      xvt.assign(times.size(), unavail);
+
+      SatTableMap::const_iterator sit = satTables.find(sat);
+      if(sit == satTables.end() || sit->second.empty())
+         return n;
+      const TimeOrbitEphTable& table = sit->second;
+
+         // it is table.lower_bound(*itTime); while the times increase
+         // it only moves forward, so walk it rather than search again.
+      TimeOrbitEphTable::const_iterator it;
+      const CommonTime *itTime(NULL);
+      for(size_t i=0; i<times.size(); i++)
+      {
+         const CommonTime& t(times[i]);
+         try
+         {
+            if(itTime && !(t < *itTime))
+            {
+               while(it != table.end() && it->first < t)
+                  ++it;
+            }
+            else
+            {
+               it = table.lower_bound(t);
+            }
+            itTime = &t;
+
+            const OrbitEph *eph = (strictMethod
+                                   ? selectUserOrbitEph(table, it, t)
+                                   : selectNearOrbitEph(table, it, t));
+            if(!eph || (onlyHealthy && !eph->isHealthy()))
+               continue;
+
+            xvt[i] = eph->svXvt(t);
+            xvt[i].health = (eph->isHealthy() ? Xvt::HealthStatus::Healthy
+                             : Xvt::HealthStatus::Unhealthy);
+            n++;
+         }
+         catch(Exception& e)
+         {
+            xvt[i] = unavail;
+            itTime = NULL;
+         }
+      }
+      return n;
+   }
+
+
+   unsigned OrbitEphStore::getXvtBatch(const vector<SatID>& sats,
+                                       const CommonTime& t,
+                                       vector<Xvt>& xvt) const
+   {
+      unsigned n(0);
+      Xvt unavail;
+      unavail.health = Xvt::HealthStatus::Unavailable;
+      xvt.assign(sats.size(), unavail);
+
+      for(size_t i=0; i<sats.size(); i++)
+      {
+         try
+         {
+            const OrbitEph *eph = findOrbitEph(sats[i], t);
+            if(!eph || (onlyHealthy && !eph->isHealthy()))
+               continue;
+
+            xvt[i] = eph->svXvt(t);
+            xvt[i].health = (eph->isHealthy() ? Xvt::HealthStatus::Healthy
+                             : Xvt::HealthStatus::Unhealthy);
+            n++;
+         }
+         catch(Exception& e)
+         {
+            xvt[i] = unavail;
+         }
+      }
+      return n;
+   }
+
+
    Xvt::HealthStatus OrbitEphStore ::
    getSVHealth(const SatID& sat, const CommonTime& t) const throw()
    {
@@ -249,6 +375,7 @@ namespace gpstk
    OrbitEph* OrbitEphStore::addEphemeris(const OrbitEph* eph)
    {
       OrbitEph *ret(0);
+      invalidateIndex();
       try {
          // is the satellite found in the table? If not, create one
          if(satTables.find(eph->satID) == satTables.end()) {
@@ -359,6 +486,7 @@ namespace gpstk
    //---------------------------------------------------------------------------------
    void OrbitEphStore::edit(const CommonTime& tmin, const CommonTime& tmax)
    {
+      invalidateIndex();
       for(SatTableMap::iterator i = satTables.begin(); i != satTables.end(); i++)
       {
          TimeOrbitEphTable& eMap = i->second;
@@ -387,6 +515,7 @@ namespace gpstk
    //---------------------------------------------------------------------------------
    void OrbitEphStore::clear(void)
    {
+      invalidateIndex();
       for(SatTableMap::iterator ui=satTables.begin(); ui!=satTables.end(); ui++) {
          TimeOrbitEphTable& toet = ui->second;
          for(TimeOrbitEphTable::iterator toeti = toet.begin(); toeti != toet.end(); toeti++) {
@@ -441,23 +570,42 @@ namespace gpstk
    const OrbitEph* OrbitEphStore::findUserOrbitEph(const SatID& sat,
                                                    const CommonTime& t) const
    {
+      if(useFlatIndex) {
+         const FlatIndexEntry *entry = flatIndex.find(satTables, sat);
+         if(!entry || entry->table.empty())
+            return NULL;
+         return selectUserEph(entry->table, flatLowerBound(*entry, t), t);
+      }
+
       // Is this satellite found in the table?
-      if(satTables.find(sat) == satTables.end())
+      SatTableMap::const_iterator sit = satTables.find(sat);
+      if(sit == satTables.end())
          return NULL;
       // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
+      const TimeOrbitEphTable& table = sit->second;
+
+      if (table.empty())
+         return NULL;
+
+      return selectUserOrbitEph(table, table.lower_bound(t), t);
+   }
 
+   //---------------------------------------------------------------------------------
+   // The selection made by findUserOrbitEph(), given it = table.lower_bound(t)
+   // for a non-empty table.
+   // Table is TimeOrbitEphTable or FlatOrbitEphTable.
+   template <class Table>
+   static const OrbitEph* selectUserEph(const Table& table,
+                                        typename Table::const_iterator it,
+                                        const CommonTime& t)
+   {
       // The map is ordered by beginning times of validity, which
       // is another way of saying "earliest transmit time".  A call
       // to table.lower_bound(t) will return the element of the map
-      // with a key "just beyond t" assuming the t is NOT a direct match for any key.
-
-      if (table.empty())
-         return NULL;
+      // with a key "just beyond t" assuming the t is NOT a direct match for any
+      // key; for a direct match it returns the matching element.
 
-      TimeOrbitEphTable::const_iterator it = table.find(t);
-      if(it == table.end()) {                   // not a direct match
-         it = table.lower_bound(t);
+      if(it == table.end() || t < it->first) {    // not a direct match
 
          // Tricky case here.  If the key is beyond the last key in the table,
          // lower_bound() will return table.end(). However, this doesn't entirely
@@ -466,7 +614,7 @@ namespace gpstk
          // to cover time t. Therefore, if it==table.end() we need to check
          // the period of validity of the final element in the table against time t.
          if(it == table.end()) {
-            TimeOrbitEphTable::const_reverse_iterator rit = table.rbegin();
+            typename Table::const_reverse_iterator rit = table.rbegin();
             if(rit->second->isValid(t))         // Last element in map works
             {
                return rit->second;
@@ -522,26 +670,51 @@ namespace gpstk
 
       return it->second;
 
-   }  // end OrbitEph* OrbitEphStore::findUserOrbitEph
+   }  // end selectUserEph
+
+   const OrbitEph* OrbitEphStore::selectUserOrbitEph(
+      const TimeOrbitEphTable& table, TimeOrbitEphTable::const_iterator it,
+      const CommonTime& t)
+   {
+      return selectUserEph(table, it, t);
+   }
 
 
    //---------------------------------------------------------------------------------
    const OrbitEph* OrbitEphStore::findNearOrbitEph(const SatID& sat,
                                                    const CommonTime& t) const
    {
+      if(useFlatIndex) {
+         const FlatIndexEntry *entry = flatIndex.find(satTables, sat);
+         if(!entry || entry->table.empty())
+            return NULL;
+         return selectNearEph(entry->table, flatLowerBound(*entry, t), t);
+      }
+
         // Check for any OrbitEph for this SV
-      if(satTables.find(sat) == satTables.end())
+      SatTableMap::const_iterator sit = satTables.find(sat);
+      if(sit == satTables.end())
          return NULL;
 
       // No OrbitEph in store for requested sat time
       // Define reference to the relevant map of orbital elements
-      const TimeOrbitEphTable& table = getTimeOrbitEphMap(sat);
+      const TimeOrbitEphTable& table = sit->second;
 
       if (table.empty())
          return NULL;
 
-      TimeOrbitEphTable::const_iterator itNext = table.find(t);
-      if(itNext != table.end())               // exact match
+      return selectNearOrbitEph(table, table.lower_bound(t), t);
+   }
+
+   //---------------------------------------------------------------------------------
+   // The selection made by findNearOrbitEph(), given itNext = table.lower_bound(t)
+   // for a non-empty table.
+   template <class Table>
+   static const OrbitEph* selectNearEph(const Table& table,
+                                        typename Table::const_iterator itNext,
+                                        const CommonTime& t)
+   {
+      if(itNext != table.end() && !(t < itNext->first))   // exact match
          return itNext->second;
 
       // Three cases:
@@ -550,7 +723,6 @@ namespace gpstk
       // 3. t is after all OrbitEph in the store
 
       // lower_bound returns the first element with key >= t
-      itNext = table.lower_bound(t);
       if(itNext == table.begin())             // Test for case 2
       {
             // Verify the first item in the table has a fit interval that
@@ -566,7 +738,7 @@ namespace gpstk
        // Test for case 3
       if(itNext == table.end()) 
       {
-         TimeOrbitEphTable::const_reverse_iterator rit = table.rbegin();
+         typename Table::const_reverse_iterator rit = table.rbegin();
             // Verify the last item in the table has a fit interval that
             // covers the time of interest.   If not, then there are no
             // data sets available that cover the time of interest, so return
@@ -579,7 +751,7 @@ namespace gpstk
 
       // case 1: it is not the beginning, so safe to decrement
       CommonTime nextTOE = itNext->second->ctToe;
-      TimeOrbitEphTable::const_iterator itPrior = itNext;
+      typename Table::const_iterator itPrior = itNext;
       itPrior--;
       CommonTime lastTOE = itPrior->second->ctToe;
       double diffToNext = nextTOE - t;
@@ -587,8 +759,8 @@ namespace gpstk
 
          // Determine which is closer to Toe and assign temporary
          // pointers accordingly.  
-      TimeOrbitEphTable::const_iterator itSelect;
-      TimeOrbitEphTable::const_iterator itUnSelect;
+      typename Table::const_iterator itSelect;
+      typename Table::const_iterator itUnSelect;
       if(diffToNext > diffFromLast)
       {
          itSelect = itPrior;
@@ -614,6 +786,84 @@ namespace gpstk
       return NULL;
    }
 
+   const OrbitEph* OrbitEphStore::selectNearOrbitEph(
+      const TimeOrbitEphTable& table, TimeOrbitEphTable::const_iterator itNext,
+      const CommonTime& t)
+   {
+      return selectNearEph(table, itNext, t);
+   }
+
+   //---------------------------------------------------------------------------------
+   // Usually t is near the time of the last search, so look there first.
+   OrbitEphStore::FlatOrbitEphTable::const_iterator
+   OrbitEphStore::flatLowerBound(const FlatIndexEntry& entry, const CommonTime& t)
+   {
+      const FlatOrbitEphTable& table = entry.table;
+      size_t n = table.size();
+      size_t k = entry.last.load(std::memory_order_relaxed);
+      if(k > n)
+         k = n;
+         // table[k-1].first < t <= table[k].first means lower_bound is k;
+         // otherwise try the next entry, then search
+      if(k == 0 || table[k-1].first < t) {
+         if(k == n || !(table[k].first < t))
+            return table.begin() + k;
+         if(k+1 == n || !(table[k+1].first < t)) {
+            entry.last.store(k+1, std::memory_order_relaxed);
+            return table.begin() + (k+1);
+         }
+      }
+      FlatOrbitEphTable::const_iterator it =
+         std::lower_bound(table.begin(), table.end(), t,
+                          [](const FlatOrbitEphTable::value_type& e,
+                             const CommonTime& tt)
+                          { return e.first < tt; });
+      entry.last.store(it - table.begin(), std::memory_order_relaxed);
+      return it;
+   }
+
+   //---------------------------------------------------------------------------------
+   const OrbitEphStore::FlatIndexEntry*
+   OrbitEphStore::FlatIndex::find(const SatTableMap& tables, const SatID& sat) const
+   {
+      if(!built.load(std::memory_order_acquire)) {
+         std::lock_guard<std::mutex> lock(buildMutex);
+         if(!built.load(std::memory_order_relaxed)) {
+            entries.clear();
+            bySystem.clear();
+            others.clear();
+            for(SatTableMap::const_iterator it = tables.begin();
+                it != tables.end(); ++it)
+            {
+               entries.emplace_back();
+               FlatIndexEntry& entry = entries.back();
+               entry.table.assign(it->second.begin(), it->second.end());
+               size_t sys = static_cast<size_t>(it->first.system);
+               int id = it->first.id;
+               if(id < 0 || id > maxDenseID) {
+                  others[it->first] = &entry;
+                  continue;
+               }
+               if(bySystem.size() <= sys)
+                  bySystem.resize(sys+1);
+               if(bySystem[sys].size() <= size_t(id))
+                  bySystem[sys].resize(id+1, NULL);
+               bySystem[sys][id] = &entry;
+            }
+            built.store(true, std::memory_order_release);
+         }
+      }
+      size_t sys = static_cast<size_t>(sat.system);
+      if(sat.id >= 0 && sat.id <= maxDenseID) {
+         if(sys < bySystem.size() && size_t(sat.id) < bySystem[sys].size())
+            return bySystem[sys][sat.id];
+         return NULL;
+      }
+      std::map<SatID, const FlatIndexEntry*>::const_iterator it =
+         others.find(sat);
+      return (it == others.end() ? NULL : it->second);
+   }
+
    //---------------------------------------------------------------------------------
    // Add all ephemerides to an existing list<OrbitEph>.
    // If SatID sat is given, limit selections to sat's satellite system, plus if
@@ -48,9 +48,14 @@
 #ifndef GPSTK_ORBITEPHSTORE_HPP
 #define GPSTK_ORBITEPHSTORE_HPP
 
+#include <atomic>
+#include <deque>
 #include <iostream>
 #include <list>
+#include <map>
+#include <mutex>
 #include <set>
+#include <vector>
 
 #include "OrbitEph.hpp"
 #include "Exception.hpp"
@@ -80,7 +85,8 @@ namespace gpstk
       OrbitEphStore()
             : initialTime(CommonTime::END_OF_TIME),
               finalTime(CommonTime::BEGINNING_OF_TIME),
-              strictMethod(true)
+              strictMethod(true),
+              useFlatIndex(true)
       {
          timeSystem = TimeSystem::Any;
          initialTime.setTimeSystem(timeSystem);
@@ -122,6 +128,44 @@ namespace gpstk
       virtual Xvt computeXvt(const SatID& id, const CommonTime& t) const
          throw();
 
+         /** Compute the Xvt of a satellite as getXvt() does, but
+          * return false instead of throwing when there is no
+          * OrbitEph for the satellite at time t, or when onlyHealthy
+          * is set and that OrbitEph is unhealthy; see
+          * XvtStore::tryGetXvt().
+          * @param[in] id satellite SatID
+          * @param[in] t the time to look up
+          * @param[out] xvt the Xvt of the satellite at time t
+          * @return true if xvt was computed */
+      virtual bool tryGetXvt(const SatID& id, const CommonTime& t, Xvt& xvt)
+         const;
+
+         /** Compute the Xvt of one satellite at many times; see
+          * XvtStore::getXvtBatch().  The ephemeris search is done
+          * once per satellite, and for increasing times the table
+          * position is carried forward from one time to the next.
+          * @note The selection is the one made by findUserOrbitEph()
+          *   or findNearOrbitEph() of this class, according to the
+          *   search method; derived classes that override those
+          *   should override this as well.
+          * @param[in] id satellite SatID
+          * @param[in] times the times to look up
+          * @param[out] xvt the Xvts, resized to times.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const SatID& id,
+                                   const std::vector<CommonTime>& times,
+                                   std::vector<Xvt>& xvt) const;
+
+         /** Compute the Xvt of many satellites at one time; see
+          * XvtStore::getXvtBatch().
+          * @param[in] ids satellite SatIDs
+          * @param[in] t the time to look up
+          * @param[out] xvt the Xvts, resized to ids.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const std::vector<SatID>& ids,
+                                   const CommonTime& t,
+                                   std::vector<Xvt>& xvt) const;
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
@@ -351,6 +395,22 @@ namespace gpstk
          return false; 
       }
 
+         /** Search a compact copy of the tables (the default) rather
+          * than the tables themselves.  The copy holds, for each
+          * satellite, a sorted array of (key, OrbitEph*) and the
+          * position found by the last search, so that repeated
+          * lookups for a satellite at nearby times take constant
+          * time; it is built by the first search after the store is
+          * modified.  The OrbitEph chosen is the same either way.
+          * @note Searches may be made from several threads at once,
+          *   provided none modifies the store meanwhile. */
+      void setFlatIndex(bool flag)
+      { useFlatIndex = flag; invalidateIndex(); }
+
+         /// Return true if searches use the compact copy of the tables.
+      bool getFlatIndex() const throw()
+      { return useFlatIndex; }
+
          /** This map stores sets of unique orbital elements for a
           * single satellite.  The key is the beginning of the period
           * of validity for each set of elements. */
@@ -388,6 +448,94 @@ namespace gpstk
          /// flag indicating search method (find...Eph) to use.
       bool strictMethod;
 
+         /// flag indicating searches use flatIndex; see setFlatIndex().
+      bool useFlatIndex;
+
+         /// One satellite's table, as an array.
+      typedef std::vector<std::pair<CommonTime, OrbitEph*> > FlatOrbitEphTable;
+
+         /// One satellite's entry in the flat index.
+      struct FlatIndexEntry
+      {
+         FlatIndexEntry() : last(0) {}
+         FlatOrbitEphTable table;
+            /// Position in table found by the most recent search.
+         mutable std::atomic<size_t> last;
+      };
+
+         /** Compact copy of satTables, with a search cache; built on
+          * demand by a const search, so it is thread-safe to build.
+          * Copying a store does not copy the index. */
+      class FlatIndex
+      {
+      public:
+         FlatIndex() : built(false) {}
+         FlatIndex(const FlatIndex&) : built(false) {}
+         FlatIndex& operator=(const FlatIndex&)
+         { clear(); return *this; }
+
+            /** Return the entry for sat, building the index from
+             * tables first if needed; NULL if sat is not in tables. */
+         const FlatIndexEntry* find(const SatTableMap& tables,
+                                    const SatID& sat) const;
+
+            /// Discard the index.
+         void clear()
+         {
+            entries.clear();
+            bySystem.clear();
+            others.clear();
+            built.store(false);
+         }
+
+      private:
+         mutable std::deque<FlatIndexEntry> entries;
+            /// Entries by [system][id], for ids 0 to maxDenseID.
+         mutable std::vector<std::vector<const FlatIndexEntry*> > bySystem;
+            /// Entries for other ids.
+         mutable std::map<SatID, const FlatIndexEntry*> others;
+         static const int maxDenseID = 1023;
+         mutable std::atomic<bool> built;
+         mutable std::mutex buildMutex;
+      };
+
+         /** Must be called whenever satTables is changed; derived
+          * classes that modify satTables or the keys in it directly
+          * must call this as well. */
+      void invalidateIndex()
+      { flatIndex.clear(); }
+
+
+         /** The choices made by findUserOrbitEph() and
+          * findNearOrbitEph() once the table for the satellite has
+          * been found.
+          * @param table non-empty table of elements for the satellite
+          * @param it table.lower_bound(t)
+          * @param t the time of interest
+          * @return a pointer to the desired OrbitEph, or NULL if no
+          *   OrbitEph found. */
+      static const OrbitEph* selectUserOrbitEph(
+         const TimeOrbitEphTable& table,
+         TimeOrbitEphTable::const_iterator it,
+         const CommonTime& t);
+      static const OrbitEph* selectNearOrbitEph(
+         const TimeOrbitEphTable& table,
+         TimeOrbitEphTable::const_iterator it,
+         const CommonTime& t);
+
+         /** The position in a flat table that table.lower_bound(t)
+          * would return, using and updating the entry's last search.
+          * @throw InvalidRequest if t cannot be compared with the
+          *   keys (incompatible time systems) */
+      static FlatOrbitEphTable::const_iterator flatLowerBound(
+         const FlatIndexEntry& entry,
+         const CommonTime& t);
+
+   private:
+         /// Compact copy of satTables, used if useFlatIndex.
+      FlatIndex flatIndex;
+
+   protected:
          /// Convenience routines
       void updateTimeLimits(const OrbitEph* eph)
       {
@@ -43,6 +43,7 @@
 #include <math.h>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 #include "PackedNavBits.hpp"
 #include "GPSWeekSecond.hpp"
@@ -57,21 +58,25 @@ namespace gpstk
    PackedNavBits::PackedNavBits()
                  : transmitTime(CommonTime::BEGINNING_OF_TIME),
                    parityStatus(psUnknown),
-                   bits(900),
+                   words((900+63)/64),
+                   bits_size(900),
                    bits_used(0),
                    rxID(""),
-                   xMitCoerced(false)
+                   xMitCoerced(false),
+                   bitsCacheValid(false)
    {
       transmitTime.setTimeSystem(TimeSystem::GPS);
    }
    PackedNavBits::PackedNavBits(const SatID& satSysArg, 
                                 const ObsID& obsIDArg,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : words((900+63)/64),
+                                  bits_size(900),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
-                                  xMitCoerced(false)
+                                  xMitCoerced(false),
+                                  bitsCacheValid(false)
    {
       satSys = satSysArg;
       obsID = obsIDArg;
@@ -83,11 +88,13 @@ namespace gpstk
                                 const ObsID& obsIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : words((900+63)/64),
+                                  bits_size(900),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
-                                  xMitCoerced(false)
+                                  xMitCoerced(false),
+                                  bitsCacheValid(false)
    {
       satSys = satSysArg;
       obsID = obsIDArg;
@@ -101,11 +108,13 @@ namespace gpstk
                                 const NavID& navIDArg,
                                 const std::string rxString,
                                 const CommonTime& transmitTimeArg)
-                                : bits(900),
+                                : words((900+63)/64),
+                                  bits_size(900),
                                   parityStatus(psUnknown),
                                   bits_used(0),
                                   rxID(""),
-                                  xMitCoerced(false)
+                                  xMitCoerced(false),
+                                  bitsCacheValid(false)
    {
       satSys = satSysArg;
       obsID = obsIDArg;
@@ -117,6 +126,7 @@ namespace gpstk
 
       // Copy constructor
    PackedNavBits::PackedNavBits(const PackedNavBits& right)
+                                : bitsCacheValid(false)
    {
       satSys = right.satSys; 
       obsID  = right.obsID;
@@ -124,12 +134,10 @@ namespace gpstk
       rxID   = right.rxID;
       transmitTime = right.transmitTime;
       bits_used = right.bits_used;
-      bits.resize(bits_used);
+      words.assign(right.words.begin(), right.words.begin() +
+                   std::min(right.words.size(), size_t(bits_used+63)/64));
+      resizeBits(bits_used);
       parityStatus = right.parityStatus;
-      for (int i=0;i<bits_used;i++)
-      {
-         bits[i] = right.bits[i];
-      }
       xMitCoerced = right.xMitCoerced;
    }
  
@@ -187,8 +195,10 @@ namespace gpstk
    
    void PackedNavBits::clearBits()
    {
-      bits.clear();
+      words.clear();
+      bits_size = 0;
       bits_used = 0;
+      bitsCacheValid = false;
    }
 
    ObsID PackedNavBits::getobsID() const
@@ -225,20 +235,30 @@ namespace gpstk
    uint64_t PackedNavBits::asUint64_t(const int startBit, 
                                       const int numBits ) const
    {
-      uint64_t temp = 0L;       // Set up a temporary variable with a known size
-                                // It needs to be AT LEAST 33 bits.
       size_t stop = startBit + numBits;
-      if (stop>bits.size())
+      if (stop>bits_size)
       {
          InvalidParameter exc("Requested bits not present.");
          GPSTK_THROW(exc);
       }
-      for (size_t i=startBit; i<stop; ++i)
-      {
-         temp <<= 1;
-         if (bits[i]) temp++;
-      }
-      return( temp ); 
+         // Only the last 64 bits of a longer field fit in the result.
+      if (numBits>64)
+         return getWordBits( stop-64, 64 );
+      return getWordBits( startBit, numBits );
+   }
+
+   uint64_t PackedNavBits::getWordBits(const size_t startBit,
+                                       const int numBits ) const
+   {
+      if (numBits<=0) return 0;
+      size_t ndx = startBit >> 6;
+      unsigned offset = startBit & 63;
+         // Left justify the field, taking the rest from the next word
+         // if it straddles two.
+      uint64_t temp = words[ndx] << offset;
+      if (offset + numBits > 64)
+         temp |= words[ndx+1] >> (64 - offset);
+      return( temp >> (64 - numBits) );
    }
 
    unsigned long PackedNavBits::asUnsignedLong(const int startBit, 
@@ -265,7 +285,7 @@ namespace gpstk
       
          // Convert to double and scale
       double dval = (double) uint;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -276,7 +296,7 @@ namespace gpstk
 
          // Convert to double and scale
       double dval = (double) s;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -315,7 +335,7 @@ namespace gpstk
       
          // Convert to double and scale
       double dval = (double) smag;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
                              
@@ -416,7 +436,7 @@ namespace gpstk
       
          // Convert to double and scale
       double dval = (double) ulong;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -441,7 +461,7 @@ namespace gpstk
 
          // Convert to double and scale
       double dval = (double) s;
-      dval *= pow(static_cast<double>(2), power2);
+      dval = ldexp(dval, power2);
       return( dval );
    }
 
@@ -457,7 +477,19 @@ namespace gpstk
 
    bool PackedNavBits::asBool( const unsigned bitNum) const
    {
-      return bits[bitNum]; 
+      return (words[bitNum >> 6] >> (63 - (bitNum & 63))) & 1; 
+   }
+
+   const std::vector<bool>& PackedNavBits::getBits() const
+   {
+      if (!bitsCacheValid)
+      {
+         bitsCache.resize(bits_size);
+         for (size_t i=0;i<bits_size;i++)
+            bitsCache[i] = asBool(i);
+         bitsCacheValid = true;
+      }
+      return bitsCache;
    }
 
 
@@ -469,7 +501,7 @@ namespace gpstk
       uint64_t out = (uint64_t) value;
       out /= scale;
 
-      uint64_t test = pow(static_cast<double>(2),numBits) - 1; 
+      uint64_t test = numBits>=64 ? ~uint64_t(0) : (uint64_t(1)<<numBits) - 1; 
       if ( out > test )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -488,7 +520,7 @@ namespace gpstk
       out = (int64_t) value;
       out /= scale;
 
-      int64_t test = pow(static_cast<double>(2),numBits-1) - 1; 
+      int64_t test = numBits>=64 ? INT64_MAX : (int64_t(1)<<(numBits-1)) - 1; 
       if ( ( out > test ) || ( out < -( test + 1 ) ) )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -501,7 +533,7 @@ namespace gpstk
                                           const int power2 ) 
    {
       uint64_t out = (uint64_t) ScaleValue(value, power2);
-      uint64_t test = pow(static_cast<double>(2),numBits) - 1;
+      uint64_t test = numBits>=64 ? ~uint64_t(0) : (uint64_t(1)<<numBits) - 1;
       if ( out > test )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -520,7 +552,7 @@ namespace gpstk
          int64_t out;
       };
       out = (int64_t) ScaleValue(value, power2);
-      int64_t test = pow(static_cast<double>(2),numBits-1) - 1; 
+      int64_t test = numBits>=64 ? INT64_MAX : (int64_t(1)<<(numBits-1)) - 1; 
       if ( ( out > test ) || ( out < -( test + 1 ) ) )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -539,7 +571,7 @@ namespace gpstk
       };
       double temp = Radians/PI;
       out = (int64_t) ScaleValue(temp, power2);
-      int64_t test = pow(static_cast<double>(2), numBits-1) - 1; 
+      int64_t test = numBits>=64 ? INT64_MAX : (int64_t(1)<<(numBits-1)) - 1; 
       if ( ( out > test ) || ( out < -( test + 1 ) ) )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
@@ -592,32 +624,68 @@ namespace gpstk
    {
       int old_bits_used = bits_used;
       bits_used += right.bits_used;
-      bits.resize(bits_used);
+      resizeBits(bits_used);
       
-      for (int i=0;i<right.bits_used;i++)
+      for (int i=0;i<right.bits_used;i+=64)
       {
-         bits[i+old_bits_used] = right.bits[i];
+         int n = right.bits_used - i;
+         if (n>64) n = 64;
+         setWordBits(i+old_bits_used, right.getWordBits(i,n), n);
       }
    }
 
    void PackedNavBits::addUint64_t( const uint64_t value, const int numBits )
    {
-      size_t ndx = bits_used;
-      uint64_t mask = 0x0000000000000001L;
-      mask <<= (numBits-1);
+      if (bits_used + numBits > bits_size)
+         resizeBits(bits_used + numBits);
+      setWordBits(bits_used, value, numBits);
+      bits_used += numBits;
+   }
 
-      for (int i=0; i<numBits; ++i)
+   void PackedNavBits::setWordBits( const size_t startBit,
+                                    const uint64_t value,
+                                    const int numBits )
+   {
+      if (numBits<=0) return;
+      bitsCacheValid = false;
+      if (numBits>64)
       {
-         bits[ndx] = false;
-         if (value & mask) 
-         {
-             //set the bits to true
-            bits[ndx] = true;
-         }
-         mask>>= 1;
-         ndx++;
+            // The bits ahead of a 64-bit value are zero.
+         setWordBits(startBit, 0, numBits-64);
+         setWordBits(startBit+numBits-64, value, 64);
+         return;
       }
-      bits_used += numBits;
+      uint64_t mask = numBits==64 ? ~uint64_t(0) : (uint64_t(1)<<numBits) - 1;
+      size_t ndx = startBit >> 6;
+      unsigned offset = startBit & 63;
+      if (offset + numBits <= 64)
+      {
+         unsigned shift = 64 - offset - numBits;
+         words[ndx] = (words[ndx] & ~(mask << shift)) |
+                      ((value & mask) << shift);
+      }
+      else
+      {
+            // The field straddles two words; the first holds the
+            // most significant (64-offset) bits.
+         unsigned nlow = offset + numBits - 64;
+         uint64_t hiMask = (uint64_t(1) << (64 - offset)) - 1;
+         words[ndx] = (words[ndx] & ~hiMask) | ((value & mask) >> nlow);
+         unsigned shift = 64 - nlow;
+         uint64_t loMask = ((uint64_t(1) << nlow) - 1) << shift;
+         words[ndx+1] = (words[ndx+1] & ~loMask) | (value << shift);
+      }
+   }
+
+   void PackedNavBits::resizeBits( const size_t numBits )
+   {
+      bitsCacheValid = false;
+      words.resize((numBits+63)/64, 0);
+      bits_size = numBits;
+         // Keep the unused bits of the last word zero so that whole
+         // words may be compared.
+      if (numBits & 63)
+         words.back() &= ~uint64_t(0) << (64 - (numBits & 63));
    }
 
    //--------------------------------------------------------------------------
@@ -627,9 +695,8 @@ namespace gpstk
    // in which left has a FALSE whereas right has a TRUE starting at the 
    // lowest index and scanning to the maximum index.
    //
-   // NOTE: This is one of the cases in which the PackedNavBits implementation 
-   // is probably not the fastest.  Since we are scanning a bit array rather 
-   // than testing a series of unsigned ints.
+   // Since the bits are stored most significant first, the first differing
+   // bit is found by comparing whole words as unsigned integers.
    bool PackedNavBits::operator<(const PackedNavBits& right) const
    {
          // If the two objects don't have the same number of bits,
@@ -637,22 +704,17 @@ namespace gpstk
          // happen.  In the context of NavFilter, data SHOULD be
          // from the same system, therefore, the same length should 
          // always be true.
-      if (bits.size()!=right.bits.size())
+      if (bits_size!=right.bits_size)
       {
-         if (bits.size()<right.bits.size()) return true;
+         if (bits_size<right.bits_size) return true;
          return false;
       }
 
-      for (int i=0;i<bits.size();i++)
+      for (size_t i=0;i<words.size();i++)
       {
-         if (bits[i]==false && right.bits[i]==true)
-         //if (bits[i]<right.bits[i])
+         if (words[i]!=right.words[i])
          {
-            return true;
-         }
-         if (bits[i]==true && right.bits[i]==false)
-         {
-            return false;
+            return words[i]<right.words[i];
          }
       }
       return false;
@@ -660,20 +722,12 @@ namespace gpstk
 
    void PackedNavBits::invert( )
    {
-         // Each bit is either 1 or 0.
-         // Starting with 1 and subtracting the 
-         // current value will yield the inverse
-         //   
-         //  Input    Equation     Result
-         //    1       1 - 1          0
-         //    0       1 - 0          1
-         //
-         // This accomplishes the purpose without incurring
-         // the cost of a conditional statement.
-      for (int i=0;i<bits.size();i++)
+         // Invert whole words, then clear the bits beyond the end.
+      for (size_t i=0;i<words.size();i++)
       {
-         bits[i] = 1 - bits[i];
+         words[i] = ~words[i];
       }
+      resizeBits(bits_size);
    } 
 
       /**
@@ -697,9 +751,11 @@ namespace gpstk
       short finalBit = endBit;
       if (finalBit==-1) finalBit = bits_used - 1;
 
-      for (short i=startBit; i<=finalBit; i++)
+      for (int i=startBit; i<=finalBit; i+=64)
       {
-         bits[i] = src.bits[i];
+         int n = finalBit - i + 1;
+         if (n>64) n = 64;
+         setWordBits(i, src.getWordBits(i,n), n);
       }
    }
 
@@ -722,27 +778,14 @@ namespace gpstk
       uint64_t out = (uint64_t) value;
       out /= scale;
 
-      uint64_t test = pow(static_cast<double>(2),numBits) - 1; 
+      uint64_t test = numBits>=64 ? ~uint64_t(0) : (uint64_t(1)<<numBits) - 1; 
       if ( out > test )
       {
          InvalidParameter exc("Scaled value too large for specifed bit length");
          GPSTK_THROW(exc);
       }
 
-      size_t ndx = startBit;
-      uint64_t mask = 0x0000000000000001L; 
-
-      mask <<= (numBits-1);
-      for (int i=0; i<numBits; i++)
-      {
-         bits[ndx] = false;
-         if (out & mask)
-         {
-            bits[ndx] = true;
-         }
-         mask >>= 1;
-         ndx++;
-      }
+      setWordBits(startBit, out, numBits);
    }
 
 
@@ -757,7 +800,7 @@ namespace gpstk
    //--------------------------------------------------------------------------
    void PackedNavBits::trimsize()
    {
-      bits.resize(bits_used);
+      resizeBits(bits_used);
    }
 
    //--------------------------------------------------------------------------
@@ -777,7 +820,7 @@ namespace gpstk
    double PackedNavBits::ScaleValue( const double value, const int power2) const
    {
       double temp = value;
-      temp /= pow(static_cast<double>(2), power2);
+      temp = ldexp(temp, -power2);
       if (temp >= 0) temp += 0.5; // Takes care of rounding
       else temp -= 0.5;
       return ( temp );
@@ -820,10 +863,10 @@ namespace gpstk
       int numBitInWord = 0;
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (asBool(i)) word++;
        
          numBitInWord++;
          if (numBitInWord >= 32)
@@ -859,10 +902,10 @@ namespace gpstk
       int bit_count    = 0; 
       int word_count   = 0;
       uint32_t word    = 0;
-      for(size_t i = 0; i < bits.size(); ++i)
+      for(size_t i = 0; i < bits_size; ++i)
       {
          word <<= 1;
-         if (bits[i]) word++;
+         if (asBool(i)) word++;
        
          numBitInWord++;
          if (numBitInWord >= numBitsPerWord)
@@ -876,7 +919,7 @@ namespace gpstk
             //but ONLY if there are more bits left to put on the next line.
             if (word_count>0 && 
                 word_count % rollover == 0 &&
-                (i+1) < bits.size()) s << endl;        
+                (i+1) < bits_size) s << endl;        
          }
       }
          // Need to check if there is a partial word in the buffer
@@ -886,7 +929,7 @@ namespace gpstk
          s << delimiter << " 0x" << setw(8) << setfill('0') << hex << word << dec << setfill(' ');
       }
       s.flags(oldFlags);      // Reset whatever conditions pertained on entry
-      return(bits.size()); 
+      return(bits_size); 
    }
 
    bool PackedNavBits::operator==(const PackedNavBits& right) const
@@ -939,19 +982,23 @@ namespace gpstk
    {
          // If the two objects don't have the same number of bits,
          // don't even try to compare them. 
-      if (bits.size()!=right.bits.size()) return false; 
+      if (bits_size!=right.bits_size) return false; 
+      if (bits_size==0) return true;
 
       short startBit = startBitA;
       short endBit = endBitA; 
          // Check for nonsense arguments
       if (endBit==-1 ||
-          endBit>=int(bits.size())) endBit = bits.size()-1;
+          endBit>=int(bits_size)) endBit = bits_size-1;
       if (startBit<0) startBit=0;
-      if (startBit>=int(bits.size())) startBit = bits.size()-1;
+      if (startBit>=int(bits_size)) startBit = bits_size-1;
 
-      for (int i=startBit;i<=endBit;i++)
+         // Compare up to 64 bits at a time
+      for (int i=startBit;i<=endBit;i+=64)
       {
-         if (bits[i]!=right.bits[i])
+         int n = endBit - i + 1;
+         if (n>64) n = 64;
+         if (getWordBits(i,n)!=right.getWordBits(i,n))
          {
             return false;
          }
@@ -436,8 +436,14 @@ namespace gpstk
       void setXmitCoerced(bool tf=true) {xMitCoerced=tf;}
       bool isXmitCoerced() const {return xMitCoerced;}
 
-      const std::vector<bool>& getBits() const
-      { return bits; }
+         /** Return the bits, one element per bit, including any bits
+          * beyond getNumBits() that have been allocated.  The bits
+          * are stored in words, so this is a copy, rebuilt by the
+          * first call after the bits change; the reference is valid
+          * until the bits next change.  As it may update the copy,
+          * do not call it on the same object from several threads at
+          * once. */
+      const std::vector<bool>& getBits() const;
 
          /** Indicate the status of parity/CRC checking.  Must be
           * explicitly set after construction, no parity checking is
@@ -450,13 +456,20 @@ namespace gpstk
       NavID navID;             /**< Defines the navigation message tracked */ 
       std::string rxID;        /**< Defines the receiver that collected the data */
       CommonTime transmitTime; /**< Time nav message is transmitted */
-      std::vector<bool> bits;  /**< Holds the packed data */
+         /** Holds the packed data, 64 bits per word, most significant
+          * bit first; bits beyond bits_size are always zero. */
+      std::vector<uint64_t> words;
+      size_t bits_size;        /**< Number of bits allocated in words */
       int bits_used;
       
       bool xMitCoerced;        /**< Used to indicate that the transmit
                                   time is NOT directly derived from
                                   the SOW in the message */
 
+         /// The bits as returned by getBits(), if bitsCacheValid
+      mutable std::vector<bool> bitsCache;
+      mutable bool bitsCacheValid;
+
          /** Unpack the bits
           * @throw InvalidParameter
           */
@@ -465,6 +478,19 @@ namespace gpstk
          /** Pack the bits */
       void addUint64_t( const uint64_t value, const int numBits );
 
+         /** Return numBits (at most 64) bits starting at startBit,
+          * right justified, without checking the range. */
+      uint64_t getWordBits( const size_t startBit, const int numBits ) const;
+
+         /** Overwrite numBits (at most 64) bits starting at startBit
+          * with the low bits of value, without checking the range. */
+      void setWordBits( const size_t startBit, const uint64_t value,
+                        const int numBits );
+
+         /** Change the number of bits allocated, zeroing any new bits
+          * and any bits beyond the new size. */
+      void resizeBits( const size_t numBits );
+
          /** Extend the sign bit for signed values */
       int64_t SignExtend( const int startBit, const int numBits ) const;
    
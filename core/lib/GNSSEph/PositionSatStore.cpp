@@ -83,6 +83,93 @@ namespace gpstk
       return os;
    }
 
+   // Scratch space for one interpolation of the tables. The table entries
+   // in the interval are gathered column-wise (structure of arrays) into a
+   // single block, followed by the workspace for LagrangeInterpolation(), so
+   // that no allocation is done per call. Orders up to 2*MAXNHALF live on
+   // the stack; larger orders fall back to one heap block.
+   class PositionSatStore::InterpBuffer
+   {
+   public:
+         /// Columns: time, Pos[3], Vel[3], Acc[3], sigPos[3], sigVel[3], sigAcc[3]
+      static const size_t NCOLS = 19;
+      static const size_t MAXNHALF = 16;
+
+      explicit InterpBuffer(unsigned int nhalf)
+            : N(2*nhalf), npts(0)
+      {
+         size_t len(NCOLS*N + LagrangeWorkSize(N));
+         if(nhalf > MAXNHALF) {
+            heap.resize(len);
+            data = &heap[0];
+         }
+         else
+            data = stack;
+      }
+
+         /// Gather the table entries [it1,it2] (from either a DataTable
+         /// or a FrozenTable) into the columns, with times
+         /// relative to the first entry. The components selected by
+         /// doP, doV and doA (and their sigmas) are gathered.
+         /// @return the index of the entry matching ttag, or N if none
+      template <class Iterator>
+      size_t gather(const Iterator& it1, const Iterator& it2,
+                    const CommonTime& ttag, bool doP, bool doV, bool doA)
+      {
+         size_t nmatch(N);
+         Iterator kt(it1);
+         npts = 0;
+         while(1) {
+            if(npts == N) {
+               InvalidRequest e("Interpolation interval larger than 2*Nhalf");
+               GPSTK_THROW(e);
+            }
+            if(ABS(kt->first - ttag) < 1.e-8)
+               nmatch = npts;
+            times()[npts] = kt->first - it1->first;      // sec
+            const PositionRecord& rec(kt->second);
+            for(int i=0; i<3; i++) {
+               if(doP) {
+                  P(i)[npts] = rec.Pos[i];
+                  sigP(i)[npts] = rec.sigPos[i];
+               }
+               if(doV) {
+                  V(i)[npts] = rec.Vel[i];
+                  sigV(i)[npts] = rec.sigVel[i];
+               }
+               if(doA) {
+                  A(i)[npts] = rec.Acc[i];
+                  sigA(i)[npts] = rec.sigAcc[i];
+               }
+            }
+            ++npts;
+            if(kt == it2) break;
+            ++kt;
+         }
+         return nmatch;
+      }
+
+      size_t size() const { return npts; }
+      double *times() { return data; }
+      double *P(int i) { return data + (1+i)*N; }
+      double *V(int i) { return data + (4+i)*N; }
+      double *A(int i) { return data + (7+i)*N; }
+      double *sigP(int i) { return data + (10+i)*N; }
+      double *sigV(int i) { return data + (13+i)*N; }
+      double *sigA(int i) { return data + (16+i)*N; }
+      double *work() { return data + NCOLS*N; }
+
+   private:
+      static const size_t MAXLEN = NCOLS*2*MAXNHALF + 4*MAXNHALF
+                                 + (2*MAXNHALF*(2*MAXNHALF+1))/2;
+
+      size_t N;                  ///< capacity, 2*Nhalf
+      size_t npts;               ///< number of points gathered
+      double *data;              ///< either stack or &heap[0]
+      double stack[MAXLEN];
+      std::vector<double> heap;
+   };
+
    // Return value for the given satellite at the given time (usually via
    // interpolation of the data table). This interface from TabularSatStore.
    // @param[in] sat the SatID of the satellite of interest
@@ -94,97 +181,123 @@ namespace gpstk
    //  c) checkInterval is true and the interval is larger than maxInterval
    PositionRecord PositionSatStore::getValue(const SatID& sat, const CommonTime& ttag)
       const
+   {
+      if(frozen)
+         return interpValue<FrozenTableIterator>(sat, ttag);
+      return interpValue<DataTableIterator>(sat, ttag);
+   }
+
+   bool PositionSatStore::tryGetValue(const SatID& sat, const CommonTime& ttag,
+                                      PositionRecord& rec) const
+   {
+      bool isExact;
+      if(frozen) {
+         FrozenTableIterator it1, it2;
+         if(!tryGetTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity,
+                                 isExact))
+            return false;
+         rec = interpRecord(it1, it2, isExact, ttag);
+         return true;
+      }
+      DataTableIterator it1, it2;
+      if(!tryGetTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity,
+                              isExact))
+         return false;
+      rec = interpRecord(it1, it2, isExact, ttag);
+      return true;
+   }
+
+   // Implementation of getValue() for either kind of table
+   template <class Iterator>
+   PositionRecord PositionSatStore::interpValue(const SatID& sat, const CommonTime& ttag)
+      const
    {
       try {
-         bool isExact;
-         int i;
-         PositionRecord rec;
-         DataTableIterator it1, it2, kt;        // cf. TabularSatStore.hpp
+         Iterator it1, it2;        // cf. TabularSatStore.hpp
+         bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity));
+         return interpRecord(it1, it2, isExact, ttag);
+      }
+      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+   }
 
-         isExact = getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity);
-         if(isExact && haveVelocity) {
-            rec = it1->second;
-            return rec;
-         }
+   // Interpolate the interval (it1,it2) found by getTableInterval()
+   template <class Iterator>
+   PositionRecord PositionSatStore::interpRecord(const Iterator& it1,
+                                                 const Iterator& it2,
+                                                 bool isExact,
+                                                 const CommonTime& ttag) const
+   {
+         int i;
+      PositionRecord rec;
 
-         // pull data out of the data table
-         size_t n,Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
-         CommonTime ttag0(it1->first);
-         vector<double> times,P[3],V[3],A[3],sigP[3],sigV[3],sigA[3];
+      if(isExact && haveVelocity) {
+         rec = it1->second;
+         return rec;
+      }
 
-         kt = it1; n=0;
-         while(1) {
-            // find index matching ttag
-            if(isExact && ABS(kt->first - ttag) < 1.e-8)
-               Nmatch = n;
-            times.push_back(kt->first - ttag0);          // sec
-            for(i=0; i<3; i++) {
-               P[i].push_back(kt->second.Pos[i]);
-               V[i].push_back(kt->second.Vel[i]);
-               A[i].push_back(kt->second.Acc[i]);
-               sigP[i].push_back(kt->second.sigPos[i]);
-               sigV[i].push_back(kt->second.sigVel[i]);
-               sigA[i].push_back(kt->second.sigAcc[i]);
+      // pull data out of the data table
+      size_t Nlow(Nhalf-1),Nhi(Nhalf),Nmatch(Nhalf);
+      InterpBuffer buf(Nhalf);
+      size_t n(buf.gather(it1, it2, ttag, true, haveVelocity, haveAcceleration));
+      if(isExact && n < buf.size())
+         Nmatch = n;
+      const size_t N(buf.size());
+      const double *times(buf.times());
+      double *work(buf.work());
+
+      if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
+
+      // Lagrange interpolation
+      rec.sigAcc = rec.Acc = Triple(0,0,0);        // default
+      double dt(ttag-it1->first), err;      // dt in seconds
+      if(haveVelocity) {
+         for(i=0; i<3; i++) {
+            // interpolate the positions
+            rec.Pos[i] = LagrangeInterpolation(times,buf.P(i),N,dt,err,work);
+            if(haveAcceleration) {
+               // interpolate velocities and acclerations
+               rec.Vel[i] = LagrangeInterpolation(times,buf.V(i),N,dt,err,work);
+               rec.Acc[i] = LagrangeInterpolation(times,buf.A(i),N,dt,err,work);
+            }
+            else {
+               // interpolate velocities(dm/s) to get V and A
+               LagrangeInterpolation(times,buf.V(i),N,dt,rec.Vel[i],rec.Acc[i],
+                                     work);
+               rec.Acc[i] *= 0.1;      // dm/s/s -> m/s/s
             }
-            if(kt == it2) break;
-            ++kt;
-            ++n;
-         };
-
-         if(isExact && Nmatch == (int)(Nhalf-1)) { Nlow++; Nhi++; }
-
-         // Lagrange interpolation
-         rec.sigAcc = rec.Acc = Triple(0,0,0);        // default
-         double dt(ttag-ttag0), err;           // dt in seconds
-         if(haveVelocity) {
-            for(i=0; i<3; i++) {
-               // interpolate the positions
-               rec.Pos[i] = LagrangeInterpolation(times,P[i],dt,err);
-               if(haveAcceleration) {
-                  // interpolate velocities and acclerations
-                  rec.Vel[i] = LagrangeInterpolation(times,V[i],dt,err);
-                  rec.Acc[i] = LagrangeInterpolation(times,A[i],dt,err);
-               }
-               else {
-                  // interpolate velocities(dm/s) to get V and A
-                  LagrangeInterpolation(times,V[i],dt,rec.Vel[i],rec.Acc[i]);
-                  rec.Acc[i] *= 0.1;      // dm/s/s -> m/s/s
-               }
 
-               if(isExact) {
-                  rec.sigPos[i] = sigP[i][Nmatch];
-                  rec.sigVel[i] = sigV[i][Nmatch];
-                  if(haveAcceleration) rec.sigAcc[i] = sigA[i][Nmatch];
-               }
-               else {
-                  // TD is this sigma related to 'err' in the Lagrange call?
-                  rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
-                  rec.sigVel[i] = RSS(sigV[i][Nhi],sigV[i][Nlow]);
-                  if(haveAcceleration)
-                     rec.sigAcc[i] = RSS(sigA[i][Nhi],sigA[i][Nlow]);
-               }
-               // else Acc=sig_Acc=0   // TD can we do better?
+            if(isExact) {
+               rec.sigPos[i] = buf.sigP(i)[Nmatch];
+               rec.sigVel[i] = buf.sigV(i)[Nmatch];
+               if(haveAcceleration) rec.sigAcc[i] = buf.sigA(i)[Nmatch];
+            }
+            else {
+               // TD is this sigma related to 'err' in the Lagrange call?
+               rec.sigPos[i] = RSS(buf.sigP(i)[Nhi],buf.sigP(i)[Nlow]);
+               rec.sigVel[i] = RSS(buf.sigV(i)[Nhi],buf.sigV(i)[Nlow]);
+               if(haveAcceleration)
+                  rec.sigAcc[i] = RSS(buf.sigA(i)[Nhi],buf.sigA(i)[Nlow]);
             }
+            // else Acc=sig_Acc=0   // TD can we do better?
          }
-         else {               // no V data - must interpolate position to get velocity
-            for(i=0; i<3; i++) {
-               // interpolate positions(km) to get P and V
-               LagrangeInterpolation(times,P[i],dt,rec.Pos[i],rec.Vel[i]);
-               rec.Vel[i] *= 10000.;         // km/sec -> dm/sec
-
-               if(isExact) {
-                  rec.sigPos[i] = sigP[i][Nmatch];
-               }
-               else {
-                  rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
-               }
-               // TD
-               rec.sigVel[i] = 0.0;
+      }
+      else {               // no V data - must interpolate position to get velocity
+         for(i=0; i<3; i++) {
+            // interpolate positions(km) to get P and V
+            LagrangeInterpolation(times,buf.P(i),N,dt,rec.Pos[i],rec.Vel[i],work);
+            rec.Vel[i] *= 10000.;         // km/sec -> dm/sec
+
+            if(isExact) {
+               rec.sigPos[i] = buf.sigP(i)[Nmatch];
             }
+            else {
+               rec.sigPos[i] = RSS(buf.sigP(i)[Nhi],buf.sigP(i)[Nlow]);
+            }
+            // TD
+            rec.sigVel[i] = 0.0;
          }
-         return rec;
       }
-      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+      return rec;
    }
 
    // Return the position for the given satellite at the given time
@@ -197,10 +310,20 @@ namespace gpstk
    //  c) checkInterval is true and the interval is larger than maxInterval
    Triple PositionSatStore::getPosition(const SatID& sat, const CommonTime& ttag)
       const
+   {
+      if(frozen)
+         return interpPosition<FrozenTableIterator>(sat, ttag);
+      return interpPosition<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getPosition() for either kind of table
+   template <class Iterator>
+   Triple PositionSatStore::interpPosition(const SatID& sat, const CommonTime& ttag)
+      const
    {
       try {
          int i;
-         DataTableIterator it1, it2, kt;
+         Iterator it1, it2;
 
          if(getTableInterval(sat, ttag, Nhalf, it1, it2, true)) {
             // exact match
@@ -210,22 +333,15 @@ namespace gpstk
          }
 
          // pull data out of the data table
-         vector<double> times,P[3];
-         CommonTime ttag0(it1->first);
-         kt = it1;
-         while(1) {
-            times.push_back(kt->first - ttag0);    // sec
-            for(i=0; i<3; i++)
-               P[i].push_back(kt->second.Pos[i]);
-            if(kt == it2) break;
-            ++kt;
-         };
+         InterpBuffer buf(Nhalf);
+         buf.gather(it1, it2, ttag, true, false, false);
 
          // interpolate
          Triple pos;
-         double dt(ttag-ttag0), err;
+         double dt(ttag-it1->first), err;
          for(i=0; i<3; i++)
-            pos[i] = LagrangeInterpolation(times,P[i],dt,err);
+            pos[i] = LagrangeInterpolation(buf.times(),buf.P(i),buf.size(),dt,err,
+                                           buf.work());
 
          return pos;
       }
@@ -242,10 +358,20 @@ namespace gpstk
    //  c) checkInterval is true and the interval is larger than maxInterval
    Triple PositionSatStore::getVelocity(const SatID& sat, const CommonTime& ttag)
       const
+   {
+      if(frozen)
+         return interpVelocity<FrozenTableIterator>(sat, ttag);
+      return interpVelocity<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getVelocity() for either kind of table
+   template <class Iterator>
+   Triple PositionSatStore::interpVelocity(const SatID& sat, const CommonTime& ttag)
+      const
    {
       try {
          int i;
-         DataTableIterator it1, it2, kt;
+         Iterator it1, it2;
 
          bool isExact(getTableInterval(sat, ttag, Nhalf, it1, it2, haveVelocity));
          if(isExact && haveVelocity) {
@@ -254,28 +380,21 @@ namespace gpstk
             return rec.Vel;
          }
 
-         // pull data out of the data table
-         CommonTime ttag0(it1->first);
-         vector<double> times,D[3];       // D will be either Pos or Vel
-
-         kt = it1;
-         while(1) {
-            times.push_back(kt->first - ttag0);    // sec
-            for(i=0; i<3; i++)
-               D[i].push_back(haveVelocity ? kt->second.Vel[i] : kt->second.Pos[i]);
-            if(kt == it2) break;
-            ++kt;
-         };
+         // pull data out of the data table; interpolate either Pos or Vel
+         InterpBuffer buf(Nhalf);
+         buf.gather(it1, it2, ttag, !haveVelocity, haveVelocity, false);
 
          // interpolate
          Triple Vel;
-         double dt(ttag-ttag0), err;
+         double dt(ttag-it1->first), err;
          for(i=0; i<3; i++) {
             if(haveVelocity)
-               Vel[i] = LagrangeInterpolation(times,D[i],dt,err);
+               Vel[i] = LagrangeInterpolation(buf.times(),buf.V(i),buf.size(),dt,
+                                              err,buf.work());
             else {
                // interpolate positions(km) to get velocity // err is dummy
-               LagrangeInterpolation(times,D[i],dt,err,Vel[i]);
+               LagrangeInterpolation(buf.times(),buf.P(i),buf.size(),dt,err,Vel[i],
+                                     buf.work());
                Vel[i] *= 10000.;                                  // km/s -> dm/s
             }
          }
@@ -296,6 +415,16 @@ namespace gpstk
    //  d) neither velocity nor acceleration data are present
    Triple PositionSatStore::getAcceleration(const SatID& sat, const CommonTime& ttag)
       const
+   {
+      if(frozen)
+         return interpAcceleration<FrozenTableIterator>(sat, ttag);
+      return interpAcceleration<DataTableIterator>(sat, ttag);
+   }
+
+   // Implementation of getAcceleration() for either kind of table
+   template <class Iterator>
+   Triple PositionSatStore::interpAcceleration(const SatID& sat, const CommonTime& ttag)
+      const
    {
       if(!haveVelocity && !haveAcceleration) {
          InvalidRequest e("Neither velocity nor acceleration data are present");
@@ -304,7 +433,7 @@ namespace gpstk
 
       try {
          int i;
-         DataTableIterator it1, it2, kt;
+         Iterator it1, it2;
 
          bool isExact(getTableInterval(sat,ttag,Nhalf,it1,it2,haveAcceleration));
          if(isExact && haveAcceleration) {
@@ -314,27 +443,21 @@ namespace gpstk
             return rec.Acc;
          }
 
-         // pull data out of the data table
-         vector<double> times,D[3];                // D will be either Vel or Acc
-         CommonTime ttag0(it1->first);
-         kt = it1;
-         while(1) {
-            times.push_back(kt->first - ttag0);    // sec
-            for(i=0; i<3; i++)
-               D[i].push_back(haveAcceleration ? kt->second.Acc[i]:kt->second.Vel[i]);
-            if(kt == it2) break;
-            ++kt;
-         };
+         // pull data out of the data table; interpolate either Vel or Acc
+         InterpBuffer buf(Nhalf);
+         buf.gather(it1, it2, ttag, false, !haveAcceleration, haveAcceleration);
 
          // interpolate
          Triple Acc;
-         double dt(ttag-ttag0), err;
+         double dt(ttag-it1->first), err;
          for(i=0; i<3; i++) {
             if(haveAcceleration) {
-               Acc[i] = LagrangeInterpolation(times,D[i],dt,err);
+               Acc[i] = LagrangeInterpolation(buf.times(),buf.A(i),buf.size(),dt,
+                                              err,buf.work());
             }
             else {
-               LagrangeInterpolation(times,D[i],dt,err,Acc[i]);   // err is dummy
+               LagrangeInterpolation(buf.times(),buf.V(i),buf.size(),dt,err,Acc[i],
+                                     buf.work());                 // err is dummy
                Acc[i] *= 0.1;                                     // dm/s/s -> m/s/s
             }
          }
@@ -350,6 +473,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          int i;
          if(!haveVelocity)
@@ -381,6 +505,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          if(tables.find(sat) != tables.end() &&
             tables[sat].find(ttag) != tables[sat].end()) {
@@ -407,6 +532,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          haveVelocity = true;
 
@@ -435,6 +561,7 @@ namespace gpstk
    {
       try {
          checkTimeSystem(ttag.getTimeSystem());
+         thaw();
 
          haveAcceleration = true;
 
@@ -119,6 +119,11 @@ namespace gpstk
          /// Store half the interpolation order, for convenience
       unsigned int Nhalf;
 
+         /** Fixed-size scratch space used to gather the interpolation
+          * interval from the tables without allocating; defined in
+          * PositionSatStore.cpp. */
+      class InterpBuffer;
+
          // member functions
    public:
 
@@ -154,6 +159,16 @@ namespace gpstk
           *     maxInterval */
       PositionRecord getValue(const SatID& sat, const CommonTime& ttag) const;
 
+         /** Compute the value for the given satellite at the given
+          * time as getValue() does, but return false instead of
+          * throwing if it cannot be computed.
+          * @param[in] sat the SatID of the satellite of interest
+          * @param[in] ttag the time (CommonTime) of interest
+          * @param[out] rec the data value(s), if true is returned
+          * @return true if rec was computed */
+      bool tryGetValue(const SatID& sat, const CommonTime& ttag,
+                       PositionRecord& rec) const;
+
          /** Return the position for the given satellite at the given time
           * @param[in] sat the SatID of the satellite of interest
           * @param[in] ttag the time (CommonTime) of interest
@@ -261,6 +276,29 @@ namespace gpstk
       void rejectBadPositions(const bool flag)
       { rejectBadPosFlag=flag; }
 
+   private:
+         /** Implementations of getValue(), getPosition(),
+          * getVelocity() and getAcceleration() for either the
+          * std::map tables (Iterator = DataTableIterator) or the
+          * frozen tables (Iterator = FrozenTableIterator).
+          * @throw InvalidRequest as the public functions */
+      template <class Iterator>
+      PositionRecord interpValue(const SatID& sat, const CommonTime& ttag)
+         const;
+         /** Interpolate the interval (it1,it2) found by
+          * getTableInterval(); the common part of interpValue() and
+          * tryGetValue(). */
+      template <class Iterator>
+      PositionRecord interpRecord(const Iterator& it1, const Iterator& it2,
+                                  bool isExact, const CommonTime& ttag) const;
+      template <class Iterator>
+      Triple interpPosition(const SatID& sat, const CommonTime& ttag) const;
+      template <class Iterator>
+      Triple interpVelocity(const SatID& sat, const CommonTime& ttag) const;
+      template <class Iterator>
+      Triple interpAcceleration(const SatID& sat, const CommonTime& ttag)
+         const;
+
    }; // end class PositionSatStore
 
       //@}
@@ -300,6 +300,38 @@ namespace gpstk
    }
 
 
+   bool Rinex3EphemerisStore::tryGetXvt(const SatID& sat,
+                                        const CommonTime& inttag,
+                                        Xvt& xvt) const
+   {
+      try {
+         switch(sat.system) {
+            case SatelliteSystem::GPS:
+               return ORBstore.tryGetXvt(sat,
+                  correctTimeSystem(inttag, TimeSystem::GPS), xvt);
+            case SatelliteSystem::Galileo:
+               return ORBstore.tryGetXvt(sat,
+                  correctTimeSystem(inttag, TimeSystem::GAL), xvt);
+            case SatelliteSystem::BeiDou:
+               return ORBstore.tryGetXvt(sat,
+                  correctTimeSystem(inttag, TimeSystem::BDT), xvt);
+            case SatelliteSystem::QZSS:
+               return ORBstore.tryGetXvt(sat,
+                  correctTimeSystem(inttag, TimeSystem::QZS), xvt);
+            case SatelliteSystem::Glonass:
+               return GLOstore.tryGetXvt(sat,
+                  correctTimeSystem(inttag, TimeSystem::GLO), xvt);
+            default:
+               return false;
+         }
+      }
+      catch(Exception& e) {
+         // the time system correction failed
+         return false;
+      }
+   }
+
+
    Xvt Rinex3EphemerisStore ::
    computeXvt(const SatID& sat, const CommonTime& inttag) const throw()
    {
@@ -149,6 +149,17 @@ namespace gpstk
       virtual Xvt computeXvt(const SatID& id, const CommonTime& t) const
          throw();
 
+         /** Compute the Xvt of a satellite as getXvt() does, but
+          * return false instead of throwing; the request is passed
+          * to tryGetXvt() of the store for the satellite's system.
+          * See XvtStore::tryGetXvt().
+          * @param[in] sat the satellite of interest
+          * @param[in] ttag the time to look up
+          * @param[out] xvt the Xvt of the satellite at ttag
+          * @return true if xvt was computed */
+      virtual bool tryGetXvt(const SatID& sat, const CommonTime& ttag,
+                             Xvt& xvt) const;
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
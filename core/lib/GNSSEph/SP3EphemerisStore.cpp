@@ -90,28 +90,112 @@ namespace gpstk
       try { crec = clkStore.getValue(sat,ttag); }
       catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
 
-      try {
-         Xvt retXvt;
-         retXvt.health = Xvt::HealthStatus::Unavailable;
-         for(int i=0; i<3; i++) {
-            retXvt.x[i] = prec.Pos[i] * 1000.0;    // km -> m
-            retXvt.v[i] = prec.Vel[i] * 0.1;       // dm/s -> m/s
-         }
-         if(useSP3clock) {                            // SP3
-            retXvt.clkbias = crec.bias * 1.e-6;       // microsec -> sec
-            retXvt.clkdrift = crec.drift * 1.e-6;     // microsec/sec -> sec/sec
-         }
-         else {                                       // RINEX clock
-            retXvt.clkbias = crec.bias;               // sec
-            retXvt.clkdrift = crec.drift;             // sec/sec
+      return makeXvt(prec, crec);
+   }
+
+
+   bool SP3EphemerisStore::tryGetXvt(const SatID& sat, const CommonTime& ttag,
+                                     Xvt& xvt) const
+   {
+      PositionRecord prec;
+      ClockRecord crec;
+      if(!posStore.tryGetValue(sat,ttag,prec) ||
+         !clkStore.tryGetValue(sat,ttag,crec))
+         return false;
+
+      xvt = makeXvt(prec, crec);
+      return true;
+   }
+
+
+   Xvt SP3EphemerisStore::makeXvt(const PositionRecord& prec,
+                                  const ClockRecord& crec) const
+   {
+      Xvt retXvt;
+      for(int i=0; i<3; i++) {
+         retXvt.x[i] = prec.Pos[i] * 1000.0;    // km -> m
+         retXvt.v[i] = prec.Vel[i] * 0.1;       // dm/s -> m/s
+      }
+      if(useSP3clock) {                            // SP3
+         retXvt.clkbias = crec.bias * 1.e-6;       // microsec -> sec
+         retXvt.clkdrift = crec.drift * 1.e-6;     // microsec/sec -> sec/sec
+      }
+      else {                                       // RINEX clock
+         retXvt.clkbias = crec.bias;               // sec
+         retXvt.clkdrift = crec.drift;             // sec/sec
+      }
+
+         // compute relativity correction, in seconds
+      retXvt.computeRelativityCorrection();
+      retXvt.health = Xvt::HealthStatus::Unused;
+      return retXvt;
+   }
+
+
+   unsigned SP3EphemerisStore::getXvtBatch(const SatID& sat,
+                                           const vector<CommonTime>& times,
+                                           vector<Xvt>& xvt) const
+   {
+      unsigned n(0);
+      Xvt unavail;
+      unavail.health = Xvt::HealthStatus::Unavailable;
+      xvt.assign(times.size(), unavail);
+
+         // tryGetXvt() fails for any time outside these limits
+      CommonTime tbeg, tend;
+      if(!getTableLimits(sat, tbeg, tend))
+         return n;
+
+      for(size_t i=0; i<times.size(); i++) {
+         try {
+            if(times[i] < tbeg || times[i] > tend)
+               continue;
          }
+         catch(Exception& e) { continue; }
+         if(tryGetXvt(sat, times[i], xvt[i]))
+            n++;
+         else
+            xvt[i] = unavail;
+      }
 
-            // compute relativity correction, in seconds
-         retXvt.computeRelativityCorrection();
-         retXvt.health = Xvt::HealthStatus::Unused;
-         return retXvt;
+      return n;
+   }
+
+
+   unsigned SP3EphemerisStore::getXvtBatch(const vector<SatID>& sats,
+                                           const CommonTime& ttag,
+                                           vector<Xvt>& xvt) const
+   {
+      unsigned n(0);
+      Xvt unavail;
+      unavail.health = Xvt::HealthStatus::Unavailable;
+      xvt.assign(sats.size(), unavail);
+
+      for(size_t i=0; i<sats.size(); i++) {
+         if(tryGetXvt(sats[i], ttag, xvt[i]))
+            n++;
+         else
+            xvt[i] = unavail;
       }
-      catch(InvalidRequest& e) { GPSTK_RETHROW(e); }
+
+      return n;
+   }
+
+
+   bool SP3EphemerisStore::getTableLimits(const SatID& sat, CommonTime& tbeg,
+                                          CommonTime& tend) const
+   {
+      if(!posStore.isPresent(sat) || !clkStore.isPresent(sat))
+         return false;
+
+      tbeg = posStore.getInitialTime(sat);
+      tend = posStore.getFinalTime(sat);
+      CommonTime tc(clkStore.getInitialTime(sat));
+      if(tc > tbeg) tbeg = tc;
+      tc = clkStore.getFinalTime(sat);
+      if(tc < tend) tend = tc;
+
+      return true;
    }
 
 
@@ -591,6 +675,9 @@ namespace gpstk
             // close
          strm.close();
 
+            // compact the tables for lookup, now that loading is done
+         posStore.freeze();
+         clkStore.freeze();
       }
       catch (Exception& e)
       {
@@ -773,6 +860,8 @@ namespace gpstk
 
          strm.close();
 
+            // compact the tables for lookup, now that loading is done
+         clkStore.freeze();
       }
       catch(Exception& e)
       {
@@ -125,6 +125,19 @@ namespace gpstk
 
          // member functions
 
+         /** Private utility routine used by getXvtBatch(); find the
+          * span of times covered by both the position and the clock
+          * table of sat.
+          * @return false if sat is missing from either table */
+      bool getTableLimits(const SatID& sat, CommonTime& tbeg,
+                          CommonTime& tend) const;
+
+         /** Private utility routine used by getXvt() and
+          * tryGetXvt(); convert interpolated position and clock
+          * records to an Xvt in meters and seconds, including the
+          * relativity correction. */
+      Xvt makeXvt(const PositionRecord& prec, const ClockRecord& crec) const;
+
          /** Private utility routine used by the loadFile and
          * loadSP3File routines.  Store position (velocity) and clock
          * data from SP3 files in clock and position stores. Also
@@ -184,6 +197,43 @@ namespace gpstk
       virtual Xvt computeXvt(const SatID& id, const CommonTime& t) const
          throw();
 
+         /** Compute the Xvt of a satellite as getXvt() does, but
+          * return false instead of throwing when the position or
+          * clock tables cannot be interpolated at ttag; see
+          * XvtStore::tryGetXvt().  No exception is thrown along the
+          * way, so this is much cheaper than getXvt() when data are
+          * missing.
+          * @param[in] sat the satellite of interest
+          * @param[in] ttag the time to look up
+          * @param[out] xvt the Xvt of the satellite at ttag
+          * @return true if xvt was computed */
+      virtual bool tryGetXvt(const SatID& sat, const CommonTime& ttag,
+                             Xvt& xvt) const;
+
+         /** Compute the Xvt of one satellite at many times; see
+          * XvtStore::getXvtBatch().  The limits of the position and
+          * clock tables for the satellite are found once, and times
+          * outside them are marked Unavailable without attempting
+          * the interpolation.  With the tables compacted by loading,
+          * this keeps the cost per time to the interpolation itself.
+          * @param[in] id the satellite of interest
+          * @param[in] times the times to look up
+          * @param[out] xvt the Xvts, resized to times.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const SatID& id,
+                                   const std::vector<CommonTime>& times,
+                                   std::vector<Xvt>& xvt) const;
+
+         /** Compute the Xvt of many satellites at one time; see
+          * XvtStore::getXvtBatch(), and getXvtBatch(id,times,xvt).
+          * @param[in] ids the satellites of interest
+          * @param[in] t the time to look up
+          * @param[out] xvt the Xvts, resized to ids.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const std::vector<SatID>& ids,
+                                   const CommonTime& t,
+                                   std::vector<Xvt>& xvt) const;
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
@@ -580,7 +630,9 @@ namespace gpstk
           * clock files, this routine will also accept that file type
           * and load the data into the clock store. This routine will
           * may set the velocity, acceleration, bias or drift 'have'
-          * flags.
+          * flags.  Once the file is loaded the tables are compacted
+          * for lookup (see TabularSatStore::freeze()); the add...()
+          * routines and edit() undo this until the next load.
           * @param filename name of file (SP3 or RINEX clock format) to load 
           * @throw Exception if time step is inconsistent with previous value
           */
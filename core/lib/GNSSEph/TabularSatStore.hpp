@@ -45,6 +45,9 @@
 #define GPSTK_TABULAR_SAT_STORE_INCLUDE
 
 #include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -85,6 +88,101 @@ namespace gpstk
          /// std::map with key=SatID, value=DataTable
       typedef std::map<SatID, DataTable> SatTable;
 
+         /** Read-only, contiguous copy of one satellite's DataTable,
+          * built by freeze().  The records are held in a sorted
+          * std::vector of (time,record) pairs, so that its iterators
+          * may be used exactly like DataTable iterators (it->first,
+          * it->second), and the times are also kept as a flat array of
+          * offsets (seconds) from the first record.  Lookup is O(1)
+          * on a regular grid (the usual case for SP3 and clock data),
+          * and a binary search over the offsets otherwise; in either
+          * case the result is then confirmed with CommonTime
+          * comparisons, so it is identical to the std::map lookup. */
+      class FrozenTable
+      {
+      public:
+            /// sorted (time, record) pairs
+         typedef std::vector< std::pair<CommonTime, DataRecord> > Records;
+         typedef typename Records::const_iterator const_iterator;
+
+            /// Empty table
+         FrozenTable() : step(0.0) {}
+
+            /// Compact the given table
+         explicit FrozenTable(const DataTable& dtable)
+               : step(0.0)
+         {
+            recs.assign(dtable.begin(), dtable.end());
+            offsets.resize(recs.size());
+            for(size_t i=0; i<recs.size(); i++)
+               offsets[i] = recs[i].first - recs[0].first;
+
+               // is this a regular grid? if so, index = offset/step
+            if(recs.size() > 1)
+            {
+               step = offsets[1];
+               for(size_t i=2; i<recs.size(); i++)
+               {
+                  if(std::fabs(offsets[i]-offsets[i-1]-step) > 1.e-8)
+                  {
+                     step = 0.0;
+                     break;
+                  }
+               }
+            }
+         }
+
+         const_iterator begin() const { return recs.begin(); }
+         const_iterator end() const { return recs.end(); }
+         size_t size() const { return recs.size(); }
+
+            /// Same as std::map::lower_bound(): the first record with
+            /// time not less than ttag.
+            /// @throw InvalidRequest if the time systems do not match
+         const_iterator lower_bound(const CommonTime& ttag) const
+         {
+            if(recs.empty())
+               return recs.end();
+
+            const long n(recs.size());
+            double dt(ttag - recs[0].first);
+            long i;
+            if(dt <= 0.0)
+               i = 0;
+            else if(dt > offsets[n-1])
+               i = n;
+            else if(step > 0.0)
+               i = static_cast<long>(std::ceil(dt/step));
+            else
+               i = std::lower_bound(offsets.begin(), offsets.end(), dt)
+                  - offsets.begin();
+            if(i > n) i = n;
+
+               // the guess is right or off by one; settle it exactly
+            while(i > 0 && !(recs[i-1].first < ttag))
+               --i;
+            while(i < n && recs[i].first < ttag)
+               ++i;
+
+            return recs.begin() + i;
+         }
+
+            /// Same as std::map::find()
+            /// @throw InvalidRequest if the time systems do not match
+         const_iterator find(const CommonTime& ttag) const
+         {
+            const_iterator it(lower_bound(ttag));
+            if(it != recs.end() && ttag < it->first)
+               return recs.end();
+            return it;
+         }
+
+      private:
+         Records recs;                 ///< the data, sorted in time
+         std::vector<double> offsets;  ///< seconds since recs[0].first
+         double step;                  ///< grid spacing (sec), 0 if irregular
+      };
+
          // member data
    protected:
 
@@ -130,6 +228,227 @@ namespace gpstk
 
       typedef typename DataTable::const_iterator DataTableIterator;
 
+         /// iterator into the frozen tables; used like DataTableIterator
+      typedef typename FrozenTable::const_iterator FrozenTableIterator;
+
+         /** Frozen (compacted) copies of the tables, built by
+          * freeze(); frozenSats is sorted and parallel to
+          * frozenTables.  These are used by getTableInterval() in
+          * place of the std::map tables while frozen is true. */
+      std::vector<SatID> frozenSats;
+      std::vector<FrozenTable> frozenTables;
+
+         /// True when the frozen tables are built and current
+      bool frozen;
+
+         /// Outcome of locateInterval(), used to choose the exception.
+      enum IntervalStatus
+      {
+         intervalOK,          ///< it1 and it2 are valid
+         tooFewData,          ///< table has fewer than 2 entries
+         noDataAfter,         ///< ttag is after the last entry
+         tooFewBefore1,       ///< ttag is at or before the first entry
+         tooFewBefore2,       ///< ttag follows the first entry
+         tooFewBefore3,       ///< too few entries before ttag
+         tooFewAfter,         ///< too few entries after ttag
+         dataGap,             ///< gap between the entries around ttag
+         intervalTooLarge     ///< interval is wider than maxInterval
+      };
+
+         /** Locate the given time in the table dtable, which is
+          * either a DataTable or a FrozenTable, without throwing on
+          * inadequate data; this is the search done by
+          * findInterval().  Arguments are as getTableInterval().
+          * @param[out] exactMatch true if ttag is a time in dtable;
+          *   the return value of getTableInterval()
+          * @return intervalOK if it1 and it2 are valid, otherwise
+          *   the reason they are not
+          * @throw InvalidRequest only if the time systems of ttag and
+          *   the table conflict */
+      template <class Table>
+      IntervalStatus locateInterval(const Table& dtable,
+                                    const CommonTime& ttag,
+                                    const int& nhalf,
+                                    typename Table::const_iterator& it1,
+                                    typename Table::const_iterator& it2,
+                                    bool exactReturn,
+                                    bool& exactMatch)
+         const
+      {
+            // cannot interpolate with one point
+         if(dtable.size() < 2)
+            return tooFewData;
+
+            // find the timetag in this table
+
+            /** @note throw here if time systems do not match and
+             * are not "Any" */
+         it1 = dtable.find(ttag);
+            // is it an exact match?
+         exactMatch = (it1 != dtable.end());
+
+            // user must decide whether to return with exact value;
+            // e.g. without velocity data, user needs the interval
+            // to compute v from x data
+         if(exactMatch && exactReturn)
+            return intervalOK;
+
+            // lower_bound points to the first element with key >= ttag
+         it1 = it2 = dtable.lower_bound(ttag);
+         if (it1 == dtable.end())
+            return noDataAfter;
+
+            // ttag is <= first time in table
+         if(it1 == dtable.begin())
+         {
+               // at table begin but its an exact match && an
+               // interval of only 2
+            if(exactMatch && nhalf==1)
+            {
+               ++(it2 = it1);
+               return intervalOK;
+            }
+            return tooFewBefore1;
+         }
+
+            // move it1 down by one
+         if(--it1 == dtable.begin())
+         {
+               // if an interval of only 2
+            if(nhalf==1)
+            {
+               ++(it2 = it1);
+               return intervalOK;
+            }
+            return tooFewBefore2;
+         }
+
+            //LOG(INFO) << "OK, have interval " << printTime(it1->first,"%F/%g") <<
+            //" <= " <<printTime(ttag,"%F/%g")<< " < " <<printTime(it2->first,"%F/%g");
+
+            // now have it1->first <= ttag < it2->first and it2 ==
+            // it1+1 check for gap between these two table entries
+            // surrounding ttag
+         if(checkDataGap && (it2->first-it1->first) > gapInterval)
+            return dataGap;
+
+            // now expand the interval to include 2*nhalf timesteps
+         for(int k=0; k<nhalf-1; k++)
+         {
+            bool last(k==nhalf-2); // true only on the last iteration
+               // move left by one; if require full interval && out
+               // of room on left, fail
+            if(--it1 == dtable.begin() && !last)
+               return tooFewBefore3;
+               //LOG(INFO) << k << " expand left " << printTime(it1->first,"%F/%g");
+
+            if(++it2 == dtable.end())
+            {
+               if(exactMatch && last && it1 != dtable.begin())
+               {
+                     // exact match && at end of interval && with
+                     // room to move down
+
+                     // move interval down by one
+                  it2--;
+                  it1--;
+               }
+               else
+                  return tooFewAfter;
+            }
+               //LOG(INFO) << k << " expand right " << printTime(it2->first,"%F/%g");
+         }
+
+            // check that the interval is not too large
+         if(checkInterval && (it2->first - it1->first) > maxInterval)
+            return intervalTooLarge;
+
+         return intervalOK;
+      }
+
+         /** Locate the given time in the table dtable, which is
+          * either a DataTable or a FrozenTable; this implements
+          * getTableInterval() for both kinds of table.  Arguments
+          * are the same as getTableInterval().
+          * @throw InvalidRequest as getTableInterval() */
+      template <class Table>
+      bool findInterval(const Table& dtable,
+                        const SatID& sat,
+                        const CommonTime& ttag,
+                        const int& nhalf,
+                        typename Table::const_iterator& it1,
+                        typename Table::const_iterator& it2,
+                        bool exactReturn)
+         const
+      {
+         static const char *fmt=
+            " at time %F/%.3g %4Y/%02m/%02d %2H:%02M:%.3f %P";
+
+         bool exactMatch(false);
+         std::string msg;
+         switch(locateInterval(dtable, ttag, nhalf, it1, it2, exactReturn,
+                               exactMatch))
+         {
+            case intervalOK:
+               return exactMatch;
+            case tooFewData:
+               msg = "Inadequate data (size < 2) for satellite ";
+               break;
+            case noDataAfter:
+               msg = "No data in time range for satellite ";
+               break;
+            case tooFewBefore1:
+               msg = "Inadequate data before(1) requested time for"
+                  " satellite ";
+               break;
+            case tooFewBefore2:
+               msg = "Inadequate data before(2) requested time for"
+                  " satellite ";
+               break;
+            case tooFewBefore3:
+               msg = "Inadequate data before(3) requested time for"
+                  " satellite ";
+               break;
+            case tooFewAfter:
+               msg = "Inadequate data after(2) requested time for"
+                  " satellite ";
+               break;
+            case dataGap:
+               msg = "Gap at interpolation time for satellite ";
+               break;
+            case intervalTooLarge:
+               msg = "Interpolation interval too large for satellite ";
+               break;
+         }
+         InvalidRequest e(msg + gpstk::StringUtils::asString(sat) +
+                          printTime(ttag,fmt));
+         GPSTK_THROW(e);
+      }
+
+         /** locateInterval() for tryGetTableInterval(); the time
+          * systems are compared first, so that this does not
+          * throw. */
+      template <class Table>
+      bool tryInterval(const Table& dtable,
+                       const CommonTime& ttag,
+                       const int& nhalf,
+                       typename Table::const_iterator& it1,
+                       typename Table::const_iterator& it2,
+                       bool exactReturn,
+                       bool& exactMatch)
+         const throw()
+      {
+         if(dtable.size() == 0)
+            return false;
+         const TimeSystem ts(ttag.getTimeSystem()),
+            tableTS(dtable.begin()->first.getTimeSystem());
+         if(ts != TimeSystem::Any && tableTS != TimeSystem::Any
+            && ts != tableTS)
+            return false;
+         return (locateInterval(dtable, ttag, nhalf, it1, it2, exactReturn,
+                                exactMatch) == intervalOK);
+      }
+
          // member functions
    public:
          /// Default constructor
@@ -137,7 +456,7 @@ namespace gpstk
       : storeTimeSystem(TimeSystem::Any),
          havePosition(false), haveVelocity(false),
          haveClockBias(false), haveClockDrift(false),
-         checkDataGap(false), checkInterval(false)
+         checkDataGap(false), checkInterval(false), frozen(false)
       {}
          /// Destructor
       virtual ~TabularSatStore() {}
@@ -219,9 +538,6 @@ namespace gpstk
       {
          try
          {
-            static const char *fmt=
-               " at time %F/%.3g %4Y/%02m/%02d %2H:%02M:%.3f %P";
-
                // find the DataTable for this sat
             typename std::map<SatID, DataTable>::const_iterator satit;
             satit = tables.find(sat);
@@ -233,139 +549,51 @@ namespace gpstk
                GPSTK_THROW(e);
             }
 
-               // this is the data table for the sat
-            const DataTable& dtable(satit->second);
-
-               // cannot interpolate with one point
-            if(dtable.size() < 2)
-            {
-               InvalidRequest e("Inadequate data (size < 2) for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               // find the timetag in this table
-
-               /** @note throw here if time systems do not match and
-                * are not "Any" */
-            it1 = dtable.find(ttag);
-               // is it an exact match?
-            bool exactMatch(it1 != dtable.end());
-
-               // user must decide whether to return with exact value;
-               // e.g. without velocity data, user needs the interval
-               // to compute v from x data
-            if(exactMatch && exactReturn)
-               return true;
-
-               // lower_bound points to the first element with key >= ttag
-            it1 = it2 = dtable.lower_bound(ttag);
-            if (it1 == dtable.end())
-            {
-               InvalidRequest e("No data in time range for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               // ttag is <= first time in table
-            if(it1 == dtable.begin())
-            {
-                  // at table begin but its an exact match && an
-                  // interval of only 2
-               if(exactMatch && nhalf==1)
-               {
-                  ++(it2 = it1);
-                  return exactMatch;
-               }
-               InvalidRequest e("Inadequate data before(1) requested time for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               // move it1 down by one
-            if(--it1 == dtable.begin())
-            {
-                  // if an interval of only 2
-               if(nhalf==1)
-               {
-                  ++(it2 = it1);
-                  return exactMatch;
-               }
-               InvalidRequest e("Inadequate data before(2) requested time for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
-               GPSTK_THROW(e);
-            }
-
-               //LOG(INFO) << "OK, have interval " << printTime(it1->first,"%F/%g") <<
-               //" <= " <<printTime(ttag,"%F/%g")<< " < " <<printTime(it2->first,"%F/%g");
+            return findInterval(satit->second, sat, ttag, nhalf, it1, it2,
+                                exactReturn);
+         }
+         catch(InvalidRequest& ir)
+         {
+            GPSTK_RETHROW(ir);
+         }
+      }
 
-               // now have it1->first <= ttag < it2->first and it2 ==
-               // it1+1 check for gap between these two table entries
-               // surrounding ttag
-            if(checkDataGap && (it2->first-it1->first) > gapInterval)
+         /** Version of getTableInterval() for use when the store is
+          * frozen (see freeze()); the arguments, results and
+          * exceptions are the same, but the iterators point into the
+          * compacted tables.
+          * @throw InvalidRequest as getTableInterval(), and also if
+          *   the store is not frozen */
+      bool getTableInterval(const SatID& sat,
+                            const CommonTime& ttag,
+                            const int& nhalf,
+                            FrozenTableIterator& it1,
+                            FrozenTableIterator& it2,
+                            bool exactReturn=true)
+         const
+      {
+         try
+         {
+            if(!frozen)
             {
-               InvalidRequest e("Gap at interpolation time for satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
+               InvalidRequest e("Store is not frozen");
                GPSTK_THROW(e);
             }
 
-               // now expand the interval to include 2*nhalf timesteps
-            for(int k=0; k<nhalf-1; k++)
-            {
-               bool last(k==nhalf-2); // true only on the last iteration
-                  // move left by one; if require full interval && out
-                  // of room on left, fail
-               if(--it1 == dtable.begin() && !last)
-               {
-                  InvalidRequest
-                     e("Inadequate data before(3) requested time for"
-                       " satellite " + gpstk::StringUtils::asString(sat) +
-                       printTime(ttag,fmt));
-                  GPSTK_THROW(e);
-               }
-                  //LOG(INFO) << k << " expand left " << printTime(it1->first,"%F/%g");
-
-               if(++it2 == dtable.end())
-               {
-                  if(exactMatch && last && it1 != dtable.begin())
-                  {
-                        // exact match && at end of interval && with
-                        // room to move down
-
-                        // move interval down by one
-                     it2--;
-                     it1--;
-                  }
-                  else
-                  {
-                     InvalidRequest
-                        e("Inadequate data after(2) requested time for"
-                          " satellite " + gpstk::StringUtils::asString(sat) +
-                          printTime(ttag,fmt));
-                     GPSTK_THROW(e);
-                  }
-               }
-                  //LOG(INFO) << k << " expand right " << printTime(it2->first,"%F/%g");
-            }
-
-               // check that the interval is not too large
-            if(checkInterval && (it2->first - it1->first) > maxInterval)
+               // find the FrozenTable for this sat
+            typename std::vector<SatID>::const_iterator satit;
+            satit = std::lower_bound(frozenSats.begin(), frozenSats.end(),
+                                     sat);
+            if(satit == frozenSats.end() || sat < *satit)
             {
-               InvalidRequest e("Interpolation interval too large for"
-                                " satellite " +
-                                gpstk::StringUtils::asString(sat) +
-                                printTime(ttag,fmt));
+               InvalidRequest
+                  e("Satellite " + gpstk::StringUtils::asString(sat) +
+                    " not found.");
                GPSTK_THROW(e);
             }
 
-            return exactMatch;
+            return findInterval(frozenTables[satit-frozenSats.begin()],
+                                sat, ttag, nhalf, it1, it2, exactReturn);
          }
          catch(InvalidRequest& ir)
          {
@@ -373,6 +601,50 @@ namespace gpstk
          }
       }
 
+         /** Versions of getTableInterval() for either kind of table
+          * that return false instead of throwing; for use where
+          * missing data is expected, e.g. in
+          * SP3EphemerisStore::tryGetXvt().
+          * @param[out] exactMatch the return value of
+          *   getTableInterval()
+          * @return true if it1 and it2 are valid, false where
+          *   getTableInterval() would throw */
+      bool tryGetTableInterval(const SatID& sat,
+                               const CommonTime& ttag,
+                               const int& nhalf,
+                               typename DataTable::const_iterator& it1,
+                               typename DataTable::const_iterator& it2,
+                               bool exactReturn,
+                               bool& exactMatch)
+         const throw()
+      {
+         typename std::map<SatID, DataTable>::const_iterator satit;
+         satit = tables.find(sat);
+         if(satit == tables.end())
+            return false;
+         return tryInterval(satit->second, ttag, nhalf, it1, it2,
+                            exactReturn, exactMatch);
+      }
+
+      bool tryGetTableInterval(const SatID& sat,
+                               const CommonTime& ttag,
+                               const int& nhalf,
+                               FrozenTableIterator& it1,
+                               FrozenTableIterator& it2,
+                               bool exactReturn,
+                               bool& exactMatch)
+         const throw()
+      {
+         if(!frozen)
+            return false;
+         typename std::vector<SatID>::const_iterator satit;
+         satit = std::lower_bound(frozenSats.begin(), frozenSats.end(), sat);
+         if(satit == frozenSats.end() || sat < *satit)
+            return false;
+         return tryInterval(frozenTables[satit-frozenSats.begin()], ttag,
+                            nhalf, it1, it2, exactReturn, exactMatch);
+      }
+
          /** Version of getTableInterval() which does not require the
           * time of interest to lie in the center of the interval,
           * with nhalf points on either side.  (See getTableInterval()
@@ -653,6 +925,8 @@ namespace gpstk
                 const CommonTime& tmax = CommonTime::END_OF_TIME)
          throw()
       {
+         thaw();
+
             // loop over satellites
          typename SatTable::iterator it;
          for(it=tables.begin(); it!=tables.end(); it++)
@@ -680,12 +954,53 @@ namespace gpstk
          /// Remove all data and reset time limits
       inline void clear() throw()
       {
+         thaw();
          typename std::map<SatID, DataTable>::iterator satit;
          for(satit=tables.begin(); satit!=tables.end(); ++satit)
             satit->second.clear();
          tables.clear();
       }
 
+         /** Compact the data tables into contiguous, sorted arrays
+          * (one FrozenTable per satellite) and use them for all
+          * subsequent lookups, in place of the std::map tables.  Call
+          * this once loading is finished; adding or editing data
+          * thaws the store again.  The results of getValue() etc. are
+          * the same whether or not the store is frozen.
+          * @note The std::map tables are kept: they are the editable
+          *   master copy used by the add...() routines, edit(),
+          *   dump() and getSatList() etc., and the frozen tables are
+          *   rebuilt from them after every change.  Freezing thus
+          *   roughly doubles the memory held by the store; call
+          *   thaw() to release the frozen copy. */
+      void freeze()
+      {
+         frozenSats.clear();
+         frozenTables.clear();
+         frozenSats.reserve(tables.size());
+         frozenTables.reserve(tables.size());
+         typename SatTable::const_iterator it;
+         for(it=tables.begin(); it!=tables.end(); ++it)
+         {
+            frozenSats.push_back(it->first);
+            frozenTables.push_back(FrozenTable(it->second));
+         }
+         frozen = true;
+      }
+
+         /// Discard the frozen tables, reverting to the std::map tables.
+      void thaw() throw()
+      {
+         if(!frozen)
+            return;
+         frozen = false;
+         frozenSats.clear();
+         frozenTables.clear();
+      }
+
+         /// Return true if the store is frozen (see freeze())
+      bool isFrozen() const throw() { return frozen; }
+
          /// Return true if the given SatID is present in the store
       virtual bool isPresent(const SatID& sat) const throw()
       { return (tables.find(sat) != tables.end()); }
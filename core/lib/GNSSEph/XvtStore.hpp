@@ -47,6 +47,7 @@
 
 #include <iostream>
 #include <set>
+#include <vector>
 
 #include "Exception.hpp"
 #include "CommonTime.hpp"
@@ -94,6 +95,94 @@ namespace gpstk
       virtual Xvt computeXvt(const IndexType& id, const CommonTime& t)
          const throw() = 0;
 
+         /** Compute the position, velocity and clock offset of the
+          * indicated object, reporting failure with the return value
+          * rather than an exception.  The result, and the conditions
+          * under which it fails (including the onlyHealthy flag), are
+          * those of getXvt(); this is intended for loops over many
+          * objects or times, where some are expected to be missing
+          * and the cost of throwing would dominate.  This default
+          * calls getXvt(); derived classes override it to avoid
+          * throwing at all.
+          * @param[in] id the object's identifier
+          * @param[in] t the time to look up
+          * @param[out] xvt the Xvt of the object at the indicated
+          *   time; undefined if false is returned
+          * @return true if xvt was computed, false where getXvt()
+          *   would throw */
+      virtual bool tryGetXvt(const IndexType& id, const CommonTime& t,
+                             Xvt& xvt) const
+      {
+         try
+         {
+            xvt = getXvt(id, t);
+            return true;
+         }
+         catch(Exception& e)
+         {
+            return false;
+         }
+      }
+
+         /** Compute the Xvt of one object at many times.  Each
+          * element of xvt is what getXvt(id,times[i]) would return,
+          * except that where getXvt() would throw, the element has
+          * health Xvt::HealthStatus::Unavailable instead.  Derived
+          * classes override this to amortize lookups across the
+          * times, which is most effective when times is sorted in
+          * increasing order.
+          * @param[in] id the object's identifier
+          * @param[in] times the times to look up
+          * @param[out] xvt the Xvts, resized to times.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const IndexType& id,
+                                   const std::vector<CommonTime>& times,
+                                   std::vector<Xvt>& xvt) const
+      {
+         unsigned n(0);
+         xvt.resize(times.size());
+         for(std::size_t i=0; i<times.size(); i++)
+         {
+            if(tryGetXvt(id, times[i], xvt[i]))
+            {
+               n++;
+            }
+            else
+            {
+               xvt[i] = Xvt();
+               xvt[i].health = Xvt::HealthStatus::Unavailable;
+            }
+         }
+         return n;
+      }
+
+         /** Compute the Xvt of many objects at one time, with the
+          * same conventions as getXvtBatch(id,times,xvt).
+          * @param[in] ids the objects' identifiers
+          * @param[in] t the time to look up
+          * @param[out] xvt the Xvts, resized to ids.size()
+          * @return the number of Xvts successfully computed */
+      virtual unsigned getXvtBatch(const std::vector<IndexType>& ids,
+                                   const CommonTime& t,
+                                   std::vector<Xvt>& xvt) const
+      {
+         unsigned n(0);
+         xvt.resize(ids.size());
+         for(std::size_t i=0; i<ids.size(); i++)
+         {
+            if(tryGetXvt(ids[i], t, xvt[i]))
+            {
+               n++;
+            }
+            else
+            {
+               xvt[i] = Xvt();
+               xvt[i].health = Xvt::HealthStatus::Unavailable;
+            }
+         }
+         return n;
+      }
+
          /** Get the satellite health at a specific time.
           * @param[in] id the object's identifier
           * @param[in] t the time to look up
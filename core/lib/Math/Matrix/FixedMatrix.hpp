@@ -0,0 +1,463 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file FixedMatrix.hpp
+ * Matrix class with the dimensions fixed at compile time, and the small
+ * linear algebra (multiply, inverse, Cholesky) specialized for it
+ */
+
+#ifndef GPSTK_FIXEDMATRIX_HPP
+#define GPSTK_FIXEDMATRIX_HPP
+
+#include <algorithm>
+#include "Matrix.hpp"
+#include "FixedVector.hpp"
+
+namespace gpstk
+{
+
+      /// @ingroup MathGroup
+      //@{
+
+      /**
+       * A matrix whose dimensions R x C are fixed at compile time; the
+       * elements are stored, in row major order, in the object itself,
+       * so no heap allocation is done. Intended for the 3x3 rotations
+       * and small normal matrices that appear in inner loops.
+       *
+       * FixedMatrix is a RefMatrixBase, so all the MatrixBase operators
+       * and functions (e.g. inverseLUD(), SVD) apply; those return
+       * Matrix<T>. The operators and functions defined below for
+       * FixedMatrix arguments are chosen by overload resolution over
+       * the generic ones, and return FixedMatrix or FixedVector; the
+       * loops in them have compile time limits, so the compiler can
+       * unroll them. Multiplication, sums and transpose do the same
+       * arithmetic, in the same order, as the Matrix<T> versions.
+       * A FixedMatrix converts to Matrix<T> through the Matrix
+       * constructor from ConstMatrixBase.
+       */
+   template <class T, size_t R, size_t C>
+   class FixedMatrix : public RefMatrixBase<T, FixedMatrix<T,R,C> >
+   {
+   public:
+         /// STL value_type
+      typedef T value_type;
+         /// STL reference type
+      typedef T& reference;
+         /// STL const reference type
+      typedef const T& const_reference;
+         /// STL iterator type
+      typedef T* iterator;
+         /// STL const iterator type
+      typedef const T* const_iterator;
+
+         /// the (compile time) number of rows
+      static const size_t numRows = R;
+         /// the (compile time) number of columns
+      static const size_t numCols = C;
+
+         /// default constructor; all elements are zero
+      FixedMatrix()
+      { for(size_t i=0; i<R*C; i++) m[i] = T(0); }
+         /// constructor with all elements set to initialValue
+      explicit FixedMatrix(const T initialValue)
+      { for(size_t i=0; i<R*C; i++) m[i] = initialValue; }
+         /// copies R*C elements, in row major order, from vec
+      explicit FixedMatrix(const T* vec)
+      { for(size_t i=0; i<R*C; i++) m[i] = vec[i]; }
+         /** constructor from a ConstMatrixBase object of dimension R x C
+          * @throw MatrixException if the dimensions are not R x C */
+      template <class BaseClass>
+      FixedMatrix(const ConstMatrixBase<T, BaseClass>& mat)
+      { assignChecked(mat); }
+
+         /// return the R x R identity matrix
+      static FixedMatrix identity()
+      {
+         FixedMatrix toReturn;
+         for(size_t i=0; i<R && i<C; i++) toReturn(i,i) = T(1);
+         return toReturn;
+      }
+
+         /// STL iterator begin
+      iterator begin() { return m; }
+         /// STL const iterator begin
+      const_iterator begin() const { return m; }
+         /// STL iterator end
+      iterator end() { return m + R*C; }
+         /// STL const iterator end
+      const_iterator end() const { return m + R*C; }
+
+         /// The size of the matrix.
+      size_t size() const { return R*C; }
+         /// The number of columns in the matrix.
+      size_t cols() const { return C; }
+         /// The number of rows in the matrix.
+      size_t rows() const { return R; }
+
+         /// Non-const matrix operator(row,col)
+      T& operator() (size_t rowNum, size_t colNum)
+      { return m[rowNum*C + colNum]; }
+         /// Const matrix operator(row,col)
+      T operator() (size_t rowNum, size_t colNum) const
+      { return m[rowNum*C + colNum]; }
+
+         /// Copy row i of the matrix into a FixedVector.
+      FixedVector<T,C> rowCopy(size_t i) const
+      { return FixedVector<T,C>(m + i*C); }
+         /// Copy column j of the matrix into a FixedVector.
+      FixedVector<T,R> colCopy(size_t j) const
+      {
+         FixedVector<T,R> toReturn;
+         for(size_t i=0; i<R; i++) toReturn(i) = m[i*C + j];
+         return toReturn;
+      }
+
+         /// sets all elements to t
+      FixedMatrix& operator=(const T t)
+      { for(size_t i=0; i<R*C; i++) m[i] = t; return *this; }
+         /// copies R*C elements, in row major order, from array
+      FixedMatrix& operator=(const T* array)
+      { for(size_t i=0; i<R*C; i++) m[i] = array[i]; return *this; }
+         /** assignment from a ConstMatrixBase object of dimension R x C
+          * @throw MatrixException if the dimensions are not R x C */
+      template <class BaseClass>
+      FixedMatrix& operator=(const ConstMatrixBase<T, BaseClass>& mat)
+      { assignChecked(mat); return *this; }
+
+   private:
+         /// @throw MatrixException
+      template <class BaseClass>
+      void assignChecked(const ConstMatrixBase<T, BaseClass>& mat)
+      {
+         if(mat.rows() != R || mat.cols() != C) {
+            MatrixException e("Invalid dimensions for FixedMatrix assignment");
+            GPSTK_THROW(e);
+         }
+         for(size_t i=0; i<R; i++)
+            for(size_t j=0; j<C; j++)
+               m[i*C + j] = mat(i,j);
+      }
+
+         /// the elements, row major
+      T m[R*C];
+   };
+
+   template <class T, size_t R, size_t C>
+   const size_t FixedMatrix<T,R,C>::numRows;
+   template <class T, size_t R, size_t C>
+   const size_t FixedMatrix<T,R,C>::numCols;
+
+      /// FixedMatrix * FixedMatrix : row by column multiplication
+   template <class T, size_t R, size_t K, size_t C>
+   inline FixedMatrix<T,R,C> operator*(const FixedMatrix<T,R,K>& l,
+                                       const FixedMatrix<T,K,C>& r)
+   {
+      FixedMatrix<T,R,C> toReturn;
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            for(size_t k=0; k<K; k++)
+               toReturn(i,j) += l(i,k) * r(k,j);
+      return toReturn;
+   }
+
+      /// FixedMatrix times FixedVector, returning a FixedVector
+   template <class T, size_t R, size_t C>
+   inline FixedVector<T,R> operator*(const FixedMatrix<T,R,C>& m,
+                                     const FixedVector<T,C>& v)
+   {
+      FixedVector<T,R> toReturn;
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            toReturn[i] += m(i,j) * v[j];
+      return toReturn;
+   }
+
+      /// FixedVector times FixedMatrix, returning a FixedVector
+   template <class T, size_t R, size_t C>
+   inline FixedVector<T,C> operator*(const FixedVector<T,R>& v,
+                                     const FixedMatrix<T,R,C>& m)
+   {
+      FixedVector<T,C> toReturn;
+      for(size_t i=0; i<C; i++)
+         for(size_t j=0; j<R; j++)
+            toReturn[i] += m(j,i) * v[j];
+      return toReturn;
+   }
+
+      /// sum of two FixedMatrix
+   template <class T, size_t R, size_t C>
+   inline FixedMatrix<T,R,C> operator+(const FixedMatrix<T,R,C>& l,
+                                       const FixedMatrix<T,R,C>& r)
+   {
+      FixedMatrix<T,R,C> toReturn;
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            toReturn(i,j) = l(i,j) + r(i,j);
+      return toReturn;
+   }
+
+      /// difference of two FixedMatrix
+   template <class T, size_t R, size_t C>
+   inline FixedMatrix<T,R,C> operator-(const FixedMatrix<T,R,C>& l,
+                                       const FixedMatrix<T,R,C>& r)
+   {
+      FixedMatrix<T,R,C> toReturn;
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            toReturn(i,j) = l(i,j) - r(i,j);
+      return toReturn;
+   }
+
+      /// Multiplies all the elements of m by d.
+   template <class T, size_t R, size_t C>
+   inline FixedMatrix<T,R,C> operator*(const FixedMatrix<T,R,C>& m, const T d)
+   {
+      FixedMatrix<T,R,C> toReturn(m);
+      for(size_t i=0; i<R; i++)
+         for(size_t j=0; j<C; j++)
+            toReturn(i,j) *= d;
+      return toReturn;
+   }
+
+      /// Multiplies all the elements of m by d.
+   template <class T, size_t R, size_t C>
+   inline FixedMatrix<T,R,C> operator*(const T d, const FixedMatrix<T,R,C>& m)
+   { return m*d; }
+
+      /// Returns the transpose of the FixedMatrix m
+   template <class T, size_t R, size_t C>
+   inline FixedMatrix<T,C,R> transpose(const FixedMatrix<T,R,C>& m)
+   {
+      FixedMatrix<T,C,R> toReturn;
+      for(size_t i=0; i<C; i++)
+         for(size_t j=0; j<R; j++)
+            toReturn(i,j) = m(j,i);
+      return toReturn;
+   }
+
+      /**
+       * Return a 3x3 FixedMatrix rotation through \c angle radians
+       * about \c axis number (= 1, 2 or 3); the same matrix as
+       * rotation(angle,axis), without the allocation.
+       * @throw MatrixException
+       */
+   template <class T>
+   inline FixedMatrix<T,3,3> fixedRotation(T angle, int axis)
+   {
+      if (axis < 1 || axis > 3)
+      {
+         MatrixException e("Invalid axis (must be 1,2, or 3)");
+         GPSTK_THROW(e);
+      }
+      FixedMatrix<T,3,3> toReturn;
+      int i1 = axis-1;
+      int i2 = (i1+1) % 3;
+      int i3 = (i2+1) % 3;
+      toReturn(i1,i1) = 1.0;
+      toReturn(i2,i2) = toReturn(i3,i3) = ::cos(angle);
+      toReturn(i3,i2) = -(toReturn(i2,i3) = ::sin(angle));
+      return toReturn;
+   }
+
+      /**
+       * Inverts the square FixedMatrix m. 2x2 and 3x3 matrices use the
+       * closed form (adjoint over determinant); larger ones use
+       * Gauss-Jordan elimination with partial pivoting.
+       * @throw SingularMatrixException if m is singular
+       */
+   template <class T, size_t N>
+   inline FixedMatrix<T,N,N> inverse(const FixedMatrix<T,N,N>& m)
+   {
+      FixedMatrix<T,N,N> a(m), toReturn(FixedMatrix<T,N,N>::identity());
+      size_t i, j, r, p;
+      for(r=0; r<N; r++) {
+            // pivot on the largest element in column r
+         p = r;
+         for(i=r+1; i<N; i++)
+            if(ABS(a(i,r)) > ABS(a(p,r))) p = i;
+         if(a(p,r) == T(0)) {
+            SingularMatrixException e("Singular matrix");
+            GPSTK_THROW(e);
+         }
+         if(p != r) {
+            for(j=0; j<N; j++) {
+               std::swap(a(r,j), a(p,j));
+               std::swap(toReturn(r,j), toReturn(p,j));
+            }
+         }
+            // scale row r so that a(r,r) is 1
+         const T d(T(1)/a(r,r));
+         for(j=0; j<N; j++) { a(r,j) *= d; toReturn(r,j) *= d; }
+            // do the elimination
+         for(i=0; i<N; i++) {
+            if(i == r) continue;
+            const T f(a(i,r));
+            for(j=0; j<N; j++) {
+               a(i,j) -= f * a(r,j);
+               toReturn(i,j) -= f * toReturn(r,j);
+            }
+         }
+      }
+      return toReturn;
+   }
+
+      /// 2x2 specialization of inverse(FixedMatrix)
+      /// @throw SingularMatrixException
+   template <class T>
+   inline FixedMatrix<T,2,2> inverse(const FixedMatrix<T,2,2>& m)
+   {
+      const T det(m(0,0)*m(1,1) - m(0,1)*m(1,0));
+      if(det == T(0)) {
+         SingularMatrixException e("Singular matrix");
+         GPSTK_THROW(e);
+      }
+      FixedMatrix<T,2,2> toReturn;
+      toReturn(0,0) =  m(1,1)/det;
+      toReturn(0,1) = -m(0,1)/det;
+      toReturn(1,0) = -m(1,0)/det;
+      toReturn(1,1) =  m(0,0)/det;
+      return toReturn;
+   }
+
+      /// 3x3 specialization of inverse(FixedMatrix)
+      /// @throw SingularMatrixException
+   template <class T>
+   inline FixedMatrix<T,3,3> inverse(const FixedMatrix<T,3,3>& m)
+   {
+      FixedMatrix<T,3,3> toReturn;
+         // cofactors, transposed
+      toReturn(0,0) = m(1,1)*m(2,2) - m(1,2)*m(2,1);
+      toReturn(0,1) = m(0,2)*m(2,1) - m(0,1)*m(2,2);
+      toReturn(0,2) = m(0,1)*m(1,2) - m(0,2)*m(1,1);
+      toReturn(1,0) = m(1,2)*m(2,0) - m(1,0)*m(2,2);
+      toReturn(1,1) = m(0,0)*m(2,2) - m(0,2)*m(2,0);
+      toReturn(1,2) = m(0,2)*m(1,0) - m(0,0)*m(1,2);
+      toReturn(2,0) = m(1,0)*m(2,1) - m(1,1)*m(2,0);
+      toReturn(2,1) = m(0,1)*m(2,0) - m(0,0)*m(2,1);
+      toReturn(2,2) = m(0,0)*m(1,1) - m(0,1)*m(1,0);
+      const T det(m(0,0)*toReturn(0,0) + m(0,1)*toReturn(1,0)
+                                       + m(0,2)*toReturn(2,0));
+      if(det == T(0)) {
+         SingularMatrixException e("Singular matrix");
+         GPSTK_THROW(e);
+      }
+      return toReturn * (T(1)/det);
+   }
+
+      /**
+       * Compute the Cholesky factor L of the square, symmetric and
+       * positive definite FixedMatrix m, so that m = L*transpose(L)
+       * with L lower triangular; the same L as class Cholesky. Only
+       * the lower triangle of m is used.
+       * @throw MatrixException if m is not positive definite
+       */
+   template <class T, size_t N>
+   inline FixedMatrix<T,N,N> cholesky(const FixedMatrix<T,N,N>& m)
+   {
+      FixedMatrix<T,N,N> L;
+      size_t i, j, k;
+      for(j=0; j<N; j++) {
+         T d(m(j,j));
+         for(k=0; k<j; k++) d -= L(j,k)*L(j,k);
+         if(d <= T(0)) {
+            MatrixException e("Cholesky fails - eigenvalue <= 0");
+            GPSTK_THROW(e);
+         }
+         L(j,j) = SQRT(d);
+         for(i=j+1; i<N; i++) {
+            T s(m(i,j));
+            for(k=0; k<j; k++) s -= L(i,k)*L(j,k);
+            L(i,j) = s/L(j,j);
+         }
+      }
+      return L;
+   }
+
+      /**
+       * Solve m*x = b for x, given the Cholesky factor L of m
+       * (m = L*transpose(L)), by forward and back substitution.
+       */
+   template <class T, size_t N>
+   inline FixedVector<T,N> choleskySolve(const FixedMatrix<T,N,N>& L,
+                                         const FixedVector<T,N>& b)
+   {
+      FixedVector<T,N> y, x;
+      size_t j, k;
+      for(j=0; j<N; j++) {
+         y(j) = b(j);
+         for(k=0; k<j; k++) y(j) -= L(j,k)*y(k);
+         y(j) /= L(j,j);
+      }
+      for(j=N; j-- > 0; ) {
+         x(j) = y(j);
+         for(k=j+1; k<N; k++) x(j) -= L(k,j)*x(k);
+         x(j) /= L(j,j);
+      }
+      return x;
+   }
+
+      /**
+       * Inverts the square, symmetric and positive definite FixedMatrix
+       * m using its Cholesky factor.
+       * @throw MatrixException if m is not positive definite
+       */
+   template <class T, size_t N>
+   inline FixedMatrix<T,N,N> inverseChol(const FixedMatrix<T,N,N>& m)
+   {
+      FixedMatrix<T,N,N> L(cholesky(m)), LI;
+      size_t i, j, k;
+         // LI = inverse(L), also lower triangular
+      for(i=0; i<N; i++) {
+         LI(i,i) = T(1)/L(i,i);
+         for(j=0; j<i; j++) {
+            T sum(0);
+            for(k=j; k<i; k++) sum += L(i,k)*LI(k,j);
+            LI(i,j) = -sum*LI(i,i);
+         }
+      }
+         // inverse(m) = transpose(LI)*LI
+      return transpose(LI) * LI;
+   }
+
+      //@}
+
+}  // namespace
+
+#endif
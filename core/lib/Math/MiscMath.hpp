@@ -86,46 +86,82 @@ namespace gpstk
 
       /** Lagrange interpolation on data (X[i],Y[i]), i=0,N-1 to compute Y(x).
        * Also return an estimate of the estimation error in 'err'.
-       * This routine assumes that N=X.size() is even and that x is
+       * This routine assumes that N is even and that x is
        * centered on the interval, that is X[N/2-1] <= x <= X[N/2].
-       * @note This routine will work for N as small as 4, however
-       *   tests with satellite ephemerides have shown that N=4 yields
-       *   m-level errors, N=6 cm-level, N=8 ~0.1mm level and N=10
-       *   ~numerical noise errors; best to use N>=8.
-       * @throw Exception
+       * This version works on plain arrays and does no allocation;
+       * the caller supplies the scratch space.
+       * @param[in] X array of N abscissae
+       * @param[in] Y array of N ordinates
+       * @param[in] N number of data points, at least 4
+       * @param[in] x abscissa at which to interpolate
+       * @param[out] err estimate of the interpolation error
+       * @param work scratch array of length at least
+       *   LagrangeWorkSize(N)
+       * @return interpolated value Y(x)
+       * @throw Exception if N < 4
        */
    template <class T>
-   T LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
-                           const T& x, T& err)
+   T LagrangeInterpolation(const T *X, const T *Y, const std::size_t N,
+                           const T& x, T& err, T *work)
    {
-      if(Y.size() < X.size() || X.size() < 4) {
+      if(N < 4) {
          GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
       }
 
       std::size_t i,j,k;
       T y,del;
-      std::vector<T> D,Q;
+      T *D(work), *Q(work+N);
 
       err = T(0);
-      k = X.size()/2;
+      k = N/2;
       if(x == X[k]) return Y[k];
       if(x == X[k-1]) return Y[k-1];
       if(ABS(x-X[k-1]) < ABS(x-X[k])) k=k-1;
-      for(i=0; i<X.size(); i++) {
-         Q.push_back(Y[i]);
-         D.push_back(Y[i]);
+      for(i=0; i<N; i++) {
+         Q[i] = Y[i];
+         D[i] = Y[i];
       }
       y = Y[k--];
-      for(j=1; j<X.size(); j++) {
-         for(i=0; i<X.size()-j; i++) {
+      for(j=1; j<N; j++) {
+         for(i=0; i<N-j; i++) {
             del = (Q[i+1]-D[i])/(X[i]-X[i+j]);
             D[i] = (X[i+j]-x)*del;
             Q[i] = (X[i]-x)*del;
          }
-         err = (2*(k+1) < X.size()-j ? Q[k+1] : D[k--]);    // NOT 2*k
+         err = (2*(k+1) < N-j ? Q[k+1] : D[k--]);    // NOT 2*k
          y += err;
       }
       return y;
+   }  // end T LagrangeInterpolation(const T*, const T*, size_t, const T, T&, T*)
+
+      /** Length of the scratch array needed by the array versions of
+       * LagrangeInterpolation() for N data points; this is enough
+       * for both the value-only and the value-and-derivative forms. */
+   inline std::size_t LagrangeWorkSize(const std::size_t N)
+   {
+      return 2*N + (N*(N+1))/2;
+   }
+
+      /** Lagrange interpolation on data (X[i],Y[i]), i=0,N-1 to compute Y(x).
+       * Also return an estimate of the estimation error in 'err'.
+       * This routine assumes that N=X.size() is even and that x is
+       * centered on the interval, that is X[N/2-1] <= x <= X[N/2].
+       * @note This routine will work for N as small as 4, however
+       *   tests with satellite ephemerides have shown that N=4 yields
+       *   m-level errors, N=6 cm-level, N=8 ~0.1mm level and N=10
+       *   ~numerical noise errors; best to use N>=8.
+       * @throw Exception
+       */
+   template <class T>
+   T LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
+                           const T& x, T& err)
+   {
+      if(Y.size() < X.size() || X.size() < 4) {
+         GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
+      }
+
+      std::vector<T> work(2*X.size());
+      return LagrangeInterpolation(&X[0], &Y[0], X.size(), x, err, &work[0]);
    }  // end T LagrangeInterpolation(vector, vector, const T, T&)
 
       // The following is a
@@ -143,24 +179,33 @@ namespace gpstk
       // in a vector of length N(N+1)/2, where Qij==Q[i+j*(j+1)/2] (ignore i=j).
 
       /** Perform Lagrange interpolation on the data (X[i],Y[i]),
-       * i=1,N (N=X.size()), returning the value of Y(x) and dY(x)/dX.
-       * Assumes that x is between X[k-1] and X[k], where k=N/2 and N > 2;
-       * @warning for use with the precise (SP3) ephemeris only when
-       * velocity is not available; estimates of velocity, and
-       * especially clock drift, not as accurate.
-       * @throw Exception
+       * i=0,N-1 held in plain arrays, returning the value of Y(x) and
+       * dY(x)/dX. Assumes that x is between X[k-1] and X[k], where
+       * k=N/2 and N > 2. This version does no allocation; the caller
+       * supplies the scratch space.
+       * @param[in] X array of N abscissae
+       * @param[in] Y array of N ordinates
+       * @param[in] N number of data points, at least 4
+       * @param[in] x abscissa at which to interpolate
+       * @param[out] y interpolated value Y(x)
+       * @param[out] dydx interpolated derivative dY(x)/dX
+       * @param work scratch array of length at least
+       *   LagrangeWorkSize(N)
+       * @throw Exception if N < 4
        */
    template <class T>
-   void LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
-                              const T& x, T& y, T& dydx)
+   void LagrangeInterpolation(const T *X, const T *Y, const std::size_t N,
+                              const T& x, T& y, T& dydx, T *work)
    {
-      if(Y.size() < X.size() || X.size() < 4) {
+      if(N < 4) {
          GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
       }
 
-      std::size_t i,j,k,N=X.size(),M;
+      std::size_t i,j,k,M;
       M = (N*(N+1))/2;
-      std::vector<T> P(N,T(1)),Q(M,T(1)),D(N,T(1));
+      T *P(work), *D(work+N), *Q(work+2*N);
+      for(i=0; i<N; i++) P[i] = D[i] = T(1);
+      for(i=0; i<M; i++) Q[i] = T(1);
       for(i=0; i<N; i++) {
          for(j=0; j<N; j++) {
             if(i != j) {
@@ -185,6 +230,26 @@ namespace gpstk
             }
          dydx += Y[i]*S;
       }
+   }  // end void LagrangeInterpolation(const T*, const T*, size_t, const T, T&, T&, T*)
+
+      /** Perform Lagrange interpolation on the data (X[i],Y[i]),
+       * i=1,N (N=X.size()), returning the value of Y(x) and dY(x)/dX.
+       * Assumes that x is between X[k-1] and X[k], where k=N/2 and N > 2;
+       * @warning for use with the precise (SP3) ephemeris only when
+       * velocity is not available; estimates of velocity, and
+       * especially clock drift, not as accurate.
+       * @throw Exception
+       */
+   template <class T>
+   void LagrangeInterpolation(const std::vector<T>& X, const std::vector<T>& Y,
+                              const T& x, T& y, T& dydx)
+   {
+      if(Y.size() < X.size() || X.size() < 4) {
+         GPSTK_THROW(Exception("Input vectors must be of same length, at least 4"));
+      }
+
+      std::vector<T> work(LagrangeWorkSize(X.size()));
+      LagrangeInterpolation(&X[0], &Y[0], X.size(), x, y, dydx, &work[0]);
    }  // end void LagrangeInterpolation(vector, vector, const T, T&, T&)
 
 
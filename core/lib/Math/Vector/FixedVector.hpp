@@ -0,0 +1,202 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/**
+ * @file FixedVector.hpp
+ * Vector class with the size fixed at compile time
+ */
+
+#ifndef GPSTK_FIXEDVECTOR_HPP
+#define GPSTK_FIXEDVECTOR_HPP
+
+#include "Vector.hpp"
+
+namespace gpstk
+{
+      /// @ingroup MathGroup
+      //@{
+
+      /**
+       * A vector whose size N is fixed at compile time; the elements
+       * live in the object itself, so no heap allocation is done.
+       * It is a RefVectorBase, so all the VectorBase operators and
+       * functions apply; those return Vector<T>, while the operators
+       * defined below for FixedVector arguments return FixedVector.
+       * A FixedVector converts to Vector<T> through the Vector
+       * constructor from ConstVectorBase.
+       */
+   template <class T, size_t N>
+   class FixedVector : public RefVectorBase<T, FixedVector<T,N> >
+   {
+   public:
+         /// STL value type
+      typedef T value_type;
+         /// STL reference type
+      typedef T& reference;
+         /// STL const reference type
+      typedef const T& const_reference;
+         /// STL iterator type
+      typedef T* iterator;
+         /// STL const iterator type
+      typedef const T* const_iterator;
+
+         /// the (compile time) number of elements
+      static const size_t length = N;
+
+         /// default constructor; all elements are zero
+      FixedVector()
+      { for(size_t i=0; i<N; i++) v[i] = T(0); }
+         /// constructor with all elements set to initialValue
+      explicit FixedVector(const T initialValue)
+      { for(size_t i=0; i<N; i++) v[i] = initialValue; }
+         /// copies N elements from vec
+      explicit FixedVector(const T* vec)
+      { for(size_t i=0; i<N; i++) v[i] = vec[i]; }
+         /** constructor from a ConstVectorBase object of size N
+          * @throw VectorException if the size is not N */
+      template <class E>
+      FixedVector(const ConstVectorBase<T, E>& vec)
+      { assignChecked(vec); }
+
+         /// STL iterator begin
+      iterator begin() { return v; }
+         /// STL const iterator begin
+      const_iterator begin() const { return v; }
+         /// STL iterator end
+      iterator end() { return v + N; }
+         /// STL const iterator end
+      const_iterator end() const { return v + N; }
+
+         /// Non-const operator []
+      T& operator[] (size_t i)
+      { return v[i]; }
+         /// Const operator []
+      T operator[] (size_t i) const
+      { return v[i]; }
+         /// Non-const operator ()
+      T& operator() (size_t i)
+      { return v[i]; }
+         /// Const operator ()
+      T operator() (size_t i) const
+      { return v[i]; }
+
+         /// STL size
+      size_t size() const { return N; }
+
+         /// sets all elements to t
+      FixedVector& operator=(const T t)
+      { for(size_t i=0; i<N; i++) v[i] = t; return *this; }
+         /// copies N elements from array
+      FixedVector& operator=(const T* array)
+      { for(size_t i=0; i<N; i++) v[i] = array[i]; return *this; }
+         /** assignment from a ConstVectorBase object of size N
+          * @throw VectorException if the size is not N */
+      template <class E>
+      FixedVector& operator=(const ConstVectorBase<T, E>& x)
+      { assignChecked(x); return *this; }
+
+   private:
+         /// @throw VectorException
+      template <class E>
+      void assignChecked(const ConstVectorBase<T, E>& x)
+      {
+         if(x.size() != N) {
+            VectorException e("Invalid size for FixedVector assignment");
+            GPSTK_THROW(e);
+         }
+         for(size_t i=0; i<N; i++) v[i] = x[i];
+      }
+
+         /// the elements
+      T v[N];
+   };
+
+   template <class T, size_t N>
+   const size_t FixedVector<T,N>::length;
+
+      /// sum of two FixedVectors
+   template <class T, size_t N>
+   inline FixedVector<T,N> operator+(const FixedVector<T,N>& l,
+                                     const FixedVector<T,N>& r)
+   {
+      FixedVector<T,N> toReturn(l);
+      for(size_t i=0; i<N; i++) toReturn[i] += r[i];
+      return toReturn;
+   }
+
+      /// difference of two FixedVectors
+   template <class T, size_t N>
+   inline FixedVector<T,N> operator-(const FixedVector<T,N>& l,
+                                     const FixedVector<T,N>& r)
+   {
+      FixedVector<T,N> toReturn(l);
+      for(size_t i=0; i<N; i++) toReturn[i] -= r[i];
+      return toReturn;
+   }
+
+      /// multiplies all the elements of v by d
+   template <class T, size_t N>
+   inline FixedVector<T,N> operator*(const FixedVector<T,N>& v, const T d)
+   {
+      FixedVector<T,N> toReturn(v);
+      for(size_t i=0; i<N; i++) toReturn[i] *= d;
+      return toReturn;
+   }
+
+      /// multiplies all the elements of v by d
+   template <class T, size_t N>
+   inline FixedVector<T,N> operator*(const T d, const FixedVector<T,N>& v)
+   { return v*d; }
+
+      /// cross product of two 3-vectors
+   template <class T>
+   inline FixedVector<T,3> cross(const FixedVector<T,3>& l,
+                                 const FixedVector<T,3>& r)
+   {
+      FixedVector<T,3> toReturn;
+      toReturn[0] = l[1] * r[2] - l[2] * r[1];
+      toReturn[1] = l[2] * r[0] - l[0] * r[2];
+      toReturn[2] = l[0] * r[1] - l[1] * r[0];
+      return toReturn;
+   }
+
+      //@}
+
+}  // namespace
+
+#endif
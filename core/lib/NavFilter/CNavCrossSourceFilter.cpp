@@ -130,10 +130,10 @@ namespace gpstk
          for (cit2=mm.begin(); cit2!=mm.end(); cit2++)
          {
             const CNavFilterData* cfdp = cit2->first;
-            const NavMsgList& nml = cit2->second;
+            const NavMsgVec& nml = cit2->second;
 
             s << "  Key  ptr: " << cfdp << ": " << *cfdp << std::endl;
-            NavMsgList::const_iterator cit3;
+            NavMsgVec::const_iterator cit3;
             for (cit3=nml.begin(); cit3!=nml.end(); cit3++)
             {
                const NavFilterKey* nfkp = *cit3;
@@ -100,7 +100,7 @@ namespace gpstk
 
    protected:
          /// Map from subframe data to source list
-      typedef std::map<CNavFilterData*, NavMsgList, CNavMsgSort> MessageMap;
+      typedef std::map<CNavFilterData*, NavMsgVec, CNavMsgSort> MessageMap;
          /// Map from PRN to SubframeMap
       typedef std::map<uint32_t, MessageMap> NavMap;
 
@@ -88,7 +88,7 @@ namespace gpstk
 
    protected:
          /// Map from subframe data to source list
-      typedef std::map<LNavFilterData*, NavMsgList, LNavMsgSort> SubframeMap;
+      typedef std::map<LNavFilterData*, NavMsgVec, LNavMsgSort> SubframeMap;
          /// Map from PRN to SubframeMap
       typedef std::map<uint32_t, SubframeMap> NavMap;
 
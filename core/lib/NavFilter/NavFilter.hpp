@@ -42,6 +42,7 @@
 #include <iterator>
 #include <stdint.h>
 #include <list>
+#include <vector>
 #include "ObsID.hpp"
 #include "NavFilterKey.hpp"
 
@@ -56,9 +57,16 @@ namespace gpstk
    {
    public:
       typedef std::list<NavFilterKey*> NavMsgList;
+         /** Message list for use inside filters, where the messages
+          * are only appended and scanned. */
+      typedef std::vector<NavFilterKey*> NavMsgVec;
 
       NavFilter();
 
+         /** Filters may be deleted through a NavFilter pointer, as
+          * ShardedNavFilterMgr does. */
+      virtual ~NavFilter() {}
+
          /** Validate/filter navigation messages.
           * This method is called by NavFilterMgr.  Messages are
           * ingested and filtered results returned, but not
@@ -151,6 +159,9 @@ namespace gpstk
           * stored by the derived filter class. */
       inline void accept(const NavMsgList& valid, NavMsgList& msgBitsOut);
 
+         /// Add a vector of validated nav messages to the output list.
+      inline void accept(const NavMsgVec& valid, NavMsgList& msgBitsOut);
+
          /** Add an invalid nav message to the reject list.  This
           * method should be used by derived classes to pass validated
           * navigation message back to the NavFilterMgr user ONLY once
@@ -164,6 +175,9 @@ namespace gpstk
           * ONLY once the nav data is no longer being internally
           * stored by the derived filter class. */
       inline void reject(const NavMsgList& invalid);
+
+         /// Add a vector of invalid nav messages to the reject list.
+      inline void reject(const NavMsgVec& invalid);
    };
 
       //@}
@@ -181,6 +195,12 @@ namespace gpstk
                 std::back_insert_iterator<NavMsgList>(msgBitsOut));
    }
 
+   void NavFilter ::
+   accept(const NavMsgVec& valid, NavMsgList& msgBitsOut)
+   {
+      msgBitsOut.insert(msgBitsOut.end(), valid.begin(), valid.end());
+   }
+
    void NavFilter ::
    reject(NavFilterKey* data)
    {
@@ -194,6 +214,12 @@ namespace gpstk
                 std::back_insert_iterator<NavMsgList>(rejected));
    }
 
+   void NavFilter ::
+   reject(const NavMsgVec& invalid)
+   {
+      rejected.insert(rejected.end(), invalid.begin(), invalid.end());
+   }
+
 } // namepace gpstk
 
 #endif // NAVFILTER_HPP
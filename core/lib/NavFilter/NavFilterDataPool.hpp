@@ -0,0 +1,201 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef NAVFILTERDATAPOOL_HPP
+#define NAVFILTERDATAPOOL_HPP
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "NavFilter.hpp"
+#include "LNavFilterData.hpp"
+#include "CNavFilterData.hpp"
+
+namespace gpstk
+{
+      /// @ingroup NavFilter
+      //@{
+
+      /** Interface through which NavFilterMgr gives messages back to
+       * the pool they came from.  @see NavFilterDataPool. */
+   class NavFilterKeyPool
+   {
+   public:
+      virtual ~NavFilterKeyPool() {}
+
+         /** Give a message back to the pool.
+          * @pre msg was obtained from this pool and is not in use. */
+      virtual void release(NavFilterKey* msg) = 0;
+
+         /// Give a list of messages back to the pool.
+      void release(const NavFilter::NavMsgList& msgs)
+      {
+         NavFilter::NavMsgList::const_iterator nmli;
+         for (nmli = msgs.begin(); nmli != msgs.end(); nmli++)
+            release(*nmli);
+      }
+   };
+
+
+      /** Pool of navigation message objects (NavFilterKey child
+       * classes) to be passed to NavFilterMgr.  Objects are allocated
+       * in blocks, and those given back are handed out again by
+       * get() rather than freed, so that a steady stream of messages
+       * needs no memory allocation once the pool has grown to the
+       * number of messages in use at once.  All the objects are
+       * freed with the pool.
+       *
+       * Recycled objects keep the contents they had when released;
+       * the application is expected to set all the fields it uses.
+       *
+       * @code
+       * NavFilterDataPool<LNavPoolData> pool;
+       * NavFilterMgr mgr;
+       * mgr.setPool(&pool);
+       * ...
+       * LNavPoolData *fd = pool.get();
+       * // fill in fd->prn, fd->timeStamp, fd->words ...
+       * NavFilter::NavMsgList l = mgr.validate(fd);
+       * // use l, then
+       * pool.release(l);
+       * @endcode
+       *
+       * @warning This class is not thread-safe. */
+   template <class Data>
+   class NavFilterDataPool : public NavFilterKeyPool
+   {
+   public:
+      using NavFilterKeyPool::release;
+
+      NavFilterDataPool() {}
+
+         /// Get an unused object.
+      Data* get()
+      {
+         if (freeList.empty())
+         {
+               // std::deque does not move existing elements
+            store.emplace_back();
+            return &store.back();
+         }
+         Data *rv = freeList.back();
+         freeList.pop_back();
+         return rv;
+      }
+
+         /** Give an object back to the pool.
+          * @pre msg was obtained from this pool's get() and has not
+          *   been released since. */
+      virtual void release(NavFilterKey* msg)
+      { freeList.push_back(static_cast<Data*>(msg)); }
+
+         /// Number of objects allocated by the pool.
+      size_t size() const throw()
+      { return store.size(); }
+
+         /// Number of objects available for get() without allocation.
+      size_t available() const throw()
+      { return freeList.size(); }
+
+   private:
+      std::deque<Data> store;
+      std::vector<Data*> freeList;
+
+         // the objects belong to the pool
+      NavFilterDataPool(const NavFilterDataPool&);
+      NavFilterDataPool& operator=(const NavFilterDataPool&);
+   };
+
+
+      /** LNavFilterData with its own storage for the subframe, for
+       * use with NavFilterDataPool. */
+   class LNavPoolData : public LNavFilterData
+   {
+   public:
+      LNavPoolData()
+      { sf = words; }
+      LNavPoolData(const LNavPoolData& right)
+            : LNavFilterData(right)
+      { std::copy(right.words, right.words+10, words); sf = words; }
+      LNavPoolData& operator=(const LNavPoolData& right)
+      {
+         LNavFilterData::operator=(right);
+         std::copy(right.words, right.words+10, words);
+         sf = words;
+         return *this;
+      }
+
+         /// The subframe, to which sf points.
+      uint32_t words[10];
+   };
+
+
+      /** CNavFilterData with its own PackedNavBits, for use with
+       * NavFilterDataPool.  Set the message with setBits(), which
+       * reuses the storage of the previous message. */
+   class CNavPoolData : public CNavFilterData
+   {
+   public:
+      CNavPoolData()
+      { pnb = &bits; }
+      CNavPoolData(const CNavPoolData& right)
+            : CNavFilterData(right), bits(right.bits)
+      { pnb = &bits; }
+      CNavPoolData& operator=(const CNavPoolData& right)
+      {
+         CNavFilterData::operator=(right);
+         bits = right.bits;
+         pnb = &bits;
+         return *this;
+      }
+
+         /// Copy msg into bits and set the key fields from it.
+      void setBits(const PackedNavBits& msg)
+      {
+         bits = msg;
+         loadData(&bits);
+      }
+
+         /// The message, to which pnb points.
+      PackedNavBits bits;
+   };
+
+      //@}
+}
+
+#endif // NAVFILTERDATAPOOL_HPP
@@ -37,11 +37,13 @@
 //==============================================================================
 
 #include "NavFilterMgr.hpp"
+#include "NavFilterDataPool.hpp"
 
 namespace gpstk
 {
    NavFilterMgr ::
    NavFilterMgr()
+         : pool(NULL)
    {
    }
 
@@ -58,7 +60,7 @@ namespace gpstk
    {
       NavFilter::NavMsgList rv, newrv;
       rv.push_back(msgBits);
-      rejected.clear();
+      recycleRejected();
       for (FilterList::iterator i = filters.begin(); i != filters.end(); i++)
       {
          if (rv.empty())
@@ -68,7 +70,7 @@ namespace gpstk
          (*i)->validate(rv, newrv);
          if (!(*i)->rejected.empty())
             rejected.insert(*i);
-         rv = newrv;
+         rv.swap(newrv);
       }
       return rv;
    }
@@ -81,12 +83,18 @@ namespace gpstk
       NavFilter::NavMsgList rv, rv1, rv2;
          // current and next filter
       FilterList::iterator fliCur, fliNxt;
-      rejected.clear();
+      recycleRejected();
+         // Clear the rejected data once, up front, so that messages
+         // rejected while cascading the data of an earlier filter
+         // are still there on return.
+      for (fliCur = filters.begin(); fliCur != filters.end(); fliCur++)
+      {
+         (*fliCur)->rejected.clear();
+      }
          // touch ALL filters
       for (fliCur = filters.begin(); fliCur != filters.end(); fliCur++)
       {
             // finalize the data in the current filter
-         (*fliCur)->rejected.clear();
          rv2.clear();
          (*fliCur)->finalize(rv2);
          
@@ -97,28 +105,42 @@ namespace gpstk
             fliNxt = fliCur;
             fliNxt++;
                // cascade the data through the end.
-            rv1 = rv2;
+            rv1.swap(rv2);
             while ((fliNxt != filters.end()) && !rv1.empty())
             {
-               (*fliNxt)->rejected.clear();
                rv2.clear();
                (*fliNxt)->validate(rv1, rv2);
-               rv1 = rv2;
+               rv1.swap(rv2);
                fliNxt++;
             }
                // If the filter cascade got some data that passed all
                // filters, add it to the final return value.
-            if (!rv1.empty())
-            {
-               std::copy(rv1.begin(), rv1.end(),
-                         std::back_insert_iterator<NavFilter::NavMsgList>(rv));
-            }
+            rv.splice(rv.end(), rv1);
          }
       }
+      for (fliCur = filters.begin(); fliCur != filters.end(); fliCur++)
+      {
+         if (!(*fliCur)->rejected.empty())
+            rejected.insert(*fliCur);
+      }
       return rv;
    }
 
 
+   void NavFilterMgr ::
+   recycleRejected()
+   {
+      for (FilterSet::iterator fsi = rejected.begin(); fsi != rejected.end();
+           fsi++)
+      {
+         if (pool)
+            pool->release((*fsi)->rejected);
+         (*fsi)->rejected.clear();
+      }
+      rejected.clear();
+   }
+
+
    unsigned NavFilterMgr ::
    processingDepth()
       const throw()
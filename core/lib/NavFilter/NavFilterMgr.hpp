@@ -45,6 +45,8 @@
 
 namespace gpstk
 {
+   class NavFilterKeyPool;
+
       /** @defgroup NavFilter Navigation Data Filtering
        *
        * The NavFilter classes provide a framework for applying
@@ -63,7 +65,9 @@ namespace gpstk
        * Filters for that particular navigation message structure are
        * instantiated and added to the manager using
        * NavFilterMgr::addFilter().  Data is processed and returned
-       * using NavFilterMgr::validate().
+       * using NavFilterMgr::validate().  ShardedNavFilterMgr applies
+       * the filters in several threads, one filter chain per group of
+       * satellites.
        *
        * Data is added to the NavFilterMgr using child classes of
        * NavFilterKey.  These child classes will have data members
@@ -101,6 +105,12 @@ namespace gpstk
        *      either rejected or accepted.  This approach is most
        *      useful when using filters of depth 2 and larger.
        *
+       *   3. Taking the messages from a NavFilterDataPool, which
+       *      recycles them instead of freeing them.  Accepted
+       *      messages are given back to the pool by the application
+       *      once used; rejected ones by NavFilterMgr, if told to via
+       *      NavFilterMgr::setPool().
+       *
        * @see NavFilterMgr for a list of examples.
        *
        * @section GPSLNAV GPS Legacy Nav Filters
@@ -224,6 +234,15 @@ namespace gpstk
           */
       unsigned processingDepth() const throw();
 
+         /** Give the messages rejected by the filters back to a pool
+          * when they are no longer needed, i.e. at the start of the
+          * next validate() or finalize() call.  Messages must then
+          * all come from this pool.
+          * @param[in] p The pool, or NULL (the default) to leave the
+          *   rejected messages to the caller. */
+      void setPool(NavFilterKeyPool* p) throw()
+      { pool = p; }
+
          /** This set contains any filters with rejected data after a
           * validate() or finalize() call.  The set will be cleared at
           * the beginning of the validate() or finalize() call so that
@@ -233,8 +252,14 @@ namespace gpstk
       FilterSet rejected;
 
    private:
+         /** Clear the rejected data of the previous call, giving it
+          * to the pool if there is one. */
+      void recycleRejected();
+
          /// The collection of navigation message filters to apply.
       FilterList filters;
+         /// Where rejected messages go, if not NULL.
+      NavFilterKeyPool *pool;
    };
 
       //@}
@@ -0,0 +1,389 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include "ShardedNavFilterMgr.hpp"
+#include "Exception.hpp"
+
+namespace gpstk
+{
+      /** Bounded ring buffer for exactly one producer thread and one
+       * consumer thread.  The producer owns tail, the consumer owns
+       * head; each only reads the other's index, so no lock is
+       * needed. */
+   template <class T>
+   class SpscRing
+   {
+   public:
+      explicit SpscRing(size_t size)
+            : head(0), tail(0)
+      {
+         size_t n = 2;
+         while (n < size)
+            n <<= 1;
+         buf.resize(n);
+         mask = n-1;
+      }
+         /// Producer: false if the ring is full.
+      bool full() const
+      {
+         return (tail.load(std::memory_order_relaxed) -
+                 head.load(std::memory_order_acquire)) > mask;
+      }
+         /// Producer: add an item, which must fit (!full()).
+      void push(T& item)
+      {
+         size_t t = tail.load(std::memory_order_relaxed);
+         std::swap(buf[t & mask], item);
+         tail.store(t+1, std::memory_order_release);
+      }
+         /// Consumer: the oldest item, or NULL if the ring is empty.
+      T* front()
+      {
+         size_t h = head.load(std::memory_order_relaxed);
+         if (h == tail.load(std::memory_order_acquire))
+            return NULL;
+         return &buf[h & mask];
+      }
+         /// Consumer: remove the oldest item (front() != NULL).
+      void pop()
+      {
+         head.store(head.load(std::memory_order_relaxed)+1,
+                    std::memory_order_release);
+      }
+   private:
+      std::vector<T> buf;
+      size_t mask;
+         // keep the two indices on separate cache lines
+      alignas(64) std::atomic<size_t> head;
+      alignas(64) std::atomic<size_t> tail;
+   };
+
+
+      /** A thread waits for a condition by spinning briefly, then
+       * sleeping until another thread that may have changed the
+       * condition calls ring().  ring() is cheap when nobody
+       * sleeps. */
+   class ShardedNavFilterMgr::Doorbell
+   {
+   public:
+      Doorbell()
+            : asleep(false)
+      {}
+      template <class Pred>
+      void wait(Pred ready)
+      {
+         for (unsigned i = 0; i < 64; i++)
+         {
+            if (ready())
+               return;
+            std::this_thread::yield();
+         }
+         std::unique_lock<std::mutex> lock(mtx);
+         asleep.store(true);
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+         while (!ready())
+            cv.wait(lock);
+         asleep.store(false);
+      }
+      void ring()
+      {
+         std::atomic_thread_fence(std::memory_order_seq_cst);
+         if (asleep.load())
+         {
+            std::lock_guard<std::mutex> lock(mtx);
+            cv.notify_all();
+         }
+      }
+   private:
+      std::mutex mtx;
+      std::condition_variable cv;
+      std::atomic<bool> asleep;
+   };
+
+
+      /// What a shard returns for each item queued.
+   struct ShardResult
+   {
+      NavFilter::NavMsgList accepted, rejected;
+      std::exception_ptr error;
+   };
+
+
+   class ShardedNavFilterMgr::Shard
+   {
+   public:
+      Shard(size_t queueSize, Doorbell& cb)
+            : in(queueSize), out(queueSize), callerBell(cb), stopping(false)
+      {}
+      ~Shard()
+      {
+         for (NavFilterMgr::FilterList::iterator i = filters.begin();
+              i != filters.end(); i++)
+         {
+            delete *i;
+         }
+      }
+         /// The worker thread.
+      void run();
+
+      NavFilterMgr mgr;
+      NavFilterMgr::FilterList filters;
+         /// Messages to validate; NULL means finalize.
+      SpscRing<NavFilterKey*> in;
+      SpscRing<ShardResult> out;
+         /// Rung by the caller when it has filled in or emptied out.
+      Doorbell bell;
+      Doorbell& callerBell;
+      std::atomic<bool> stopping;
+      std::thread thread;
+   };
+
+
+   void ShardedNavFilterMgr::Shard ::
+   run()
+   {
+      ShardResult result;
+      while (true)
+      {
+         bell.wait([this] { return in.front() || stopping.load(); });
+         NavFilterKey **item = in.front();
+         if (!item)
+            return;
+         NavFilterKey *msgBits = *item;
+         in.pop();
+         callerBell.ring();
+         try
+         {
+            if (msgBits)
+               result.accepted = mgr.validate(msgBits);
+            else
+               result.accepted = mgr.finalize();
+               // both validate() and finalize() may reject messages
+            for (NavFilterMgr::FilterSet::iterator fsi=mgr.rejected.begin();
+                 fsi != mgr.rejected.end(); fsi++)
+            {
+               result.rejected.insert(result.rejected.end(),
+                                      (*fsi)->rejected.begin(),
+                                      (*fsi)->rejected.end());
+            }
+         }
+         catch (...)
+         {
+            result.error = std::current_exception();
+         }
+         bell.wait([this] { return !out.full() || stopping.load(); });
+         if (out.full())
+            return;
+         out.push(result);
+         result = ShardResult();
+         callerBell.ring();
+      }
+   }
+
+
+   ShardedNavFilterMgr ::
+   ShardedNavFilterMgr(const ChainFactory& factory,
+                       unsigned numShards,
+                       size_t queueSize,
+                       ShardKey key)
+         : shardKey(key), callerBell(new Doorbell)
+   {
+      if (numShards == 0)
+         numShards = std::thread::hardware_concurrency();
+      if (numShards == 0)
+         numShards = 1;
+      try
+      {
+         for (unsigned s = 0; s < numShards; s++)
+         {
+            shards.push_back(new Shard(queueSize, *callerBell));
+            Shard *shard = shards.back();
+            shard->filters = factory(s);
+            for (NavFilterMgr::FilterList::iterator i = shard->filters.begin();
+                 i != shard->filters.end(); i++)
+            {
+               shard->mgr.addFilter(*i);
+            }
+         }
+         for (unsigned s = 0; s < shards.size(); s++)
+         {
+            shards[s]->thread = std::thread(&Shard::run, shards[s]);
+         }
+      }
+      catch (std::system_error& se)
+      {
+         stop();
+         Exception e(std::string("Could not start threads: ") + se.what());
+         GPSTK_THROW(e);
+      }
+      catch (...)
+      {
+         stop();
+         throw;
+      }
+   }
+
+
+   ShardedNavFilterMgr ::
+   ~ShardedNavFilterMgr()
+   {
+      stop();
+   }
+
+
+   void ShardedNavFilterMgr ::
+   stop()
+   {
+      for (unsigned s = 0; s < shards.size(); s++)
+      {
+         shards[s]->stopping.store(true);
+         shards[s]->bell.ring();
+      }
+      for (unsigned s = 0; s < shards.size(); s++)
+      {
+         if (shards[s]->thread.joinable())
+            shards[s]->thread.join();
+         delete shards[s];
+      }
+      shards.clear();
+      delete callerBell;
+      callerBell = NULL;
+   }
+
+
+   void ShardedNavFilterMgr ::
+   enqueue(unsigned s, NavFilterKey* msgBits)
+   {
+      Shard *shard = shards[s];
+      while (shard->in.full())
+      {
+            // Take the results that are ready so the workers, which
+            // may be waiting for room in their output queues, keep
+            // going.
+         merge(pendingAccepted, pendingRejected, false);
+         callerBell->wait([this, shard]
+                          {
+                             return !shard->in.full() ||
+                                (!order.empty() &&
+                                 shards[order.front()]->out.front());
+                          });
+      }
+      shard->in.push(msgBits);
+      order.push_back(s);
+      shard->bell.ring();
+   }
+
+
+   void ShardedNavFilterMgr ::
+   submit(NavFilterKey* msgBits)
+   {
+      size_t h = msgBits->prn;
+      if (shardKey == ShardBySignal)
+      {
+         h = h * 31 + static_cast<size_t>(msgBits->carrier);
+         h = h * 31 + static_cast<size_t>(msgBits->code);
+      }
+      enqueue(h % shards.size(), msgBits);
+   }
+
+
+   void ShardedNavFilterMgr ::
+   merge(NavFilter::NavMsgList& accepted,
+         NavFilter::NavMsgList& rejected,
+         bool wait)
+   {
+      while (!order.empty())
+      {
+         Shard *shard = shards[order.front()];
+         ShardResult *result = shard->out.front();
+         if (!result)
+         {
+            if (!wait)
+               return;
+            callerBell->wait([shard] { return shard->out.front() != NULL; });
+            continue;
+         }
+         accepted.splice(accepted.end(), result->accepted);
+         rejected.splice(rejected.end(), result->rejected);
+         std::exception_ptr error = result->error;
+         result->error = std::exception_ptr();
+         shard->out.pop();
+         order.pop_front();
+         shard->bell.ring();
+         if (error)
+            std::rethrow_exception(error);
+      }
+   }
+
+
+   void ShardedNavFilterMgr ::
+   collect(NavFilter::NavMsgList& accepted,
+           NavFilter::NavMsgList& rejected,
+           bool wait)
+   {
+      accepted.splice(accepted.end(), pendingAccepted);
+      rejected.splice(rejected.end(), pendingRejected);
+      merge(accepted, rejected, wait);
+   }
+
+
+   void ShardedNavFilterMgr ::
+   finalize(NavFilter::NavMsgList& accepted,
+            NavFilter::NavMsgList& rejected)
+   {
+      for (unsigned s = 0; s < shards.size(); s++)
+      {
+         enqueue(s, NULL);
+      }
+      collect(accepted, rejected, true);
+   }
+
+
+   unsigned ShardedNavFilterMgr ::
+   processingDepth()
+      const throw()
+   {
+      return shards.empty() ? 1 : shards[0]->mgr.processingDepth();
+   }
+}
@@ -0,0 +1,212 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef SHARDEDNAVFILTERMGR_HPP
+#define SHARDEDNAVFILTERMGR_HPP
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include "NavFilterMgr.hpp"
+
+namespace gpstk
+{
+      /// @ingroup NavFilter
+      //@{
+
+      /** Apply a chain of navigation data filters using several
+       * threads.  Messages are distributed by PRN, or by PRN and
+       * signal, over a number of shards, each of which has its own chain of filter objects (as
+       * would be added to a NavFilterMgr) and a worker thread.
+       * Messages are handed to the workers through lock-free
+       * single-producer/single-consumer queues, and the results are
+       * merged back into the order in which the messages were
+       * submitted.
+       *
+       * By default (ShardByPRN) all the messages for a given PRN go
+       * to the same shard, so filters that compare a satellite's
+       * messages from several sources, i.e. codes or receivers
+       * (e.g. LNavCrossSourceFilter), or from successive epochs see
+       * the same data they would with a single NavFilterMgr.  With
+       * ShardBySignal the key is the PRN, carrier and code, which
+       * spreads the load of a few satellites tracked on many signals
+       * over more shards; use it only with chains whose filters do
+       * not compare signals.  Filters whose state spans satellites
+       * (e.g. NavOrderFilter) see only the satellites of their own
+       * shard.
+       *
+       * The filters are created by a user-supplied function, called
+       * once for each shard, and are deleted by this class.
+       *
+       * @code
+       * NavFilterMgr::FilterList makeChain(unsigned shard)
+       * {
+       *    NavFilterMgr::FilterList rv;
+       *    rv.push_back(new LNavParityFilter);
+       *    rv.push_back(new LNavCrossSourceFilter);
+       *    return rv;
+       * }
+       * ...
+       * ShardedNavFilterMgr mgr(makeChain);
+       * NavFilter::NavMsgList accepted, rejected;
+       * while (...)
+       * {
+       *    mgr.submit(msg);
+       *    mgr.collect(accepted, rejected);
+       *    ...
+       * }
+       * mgr.finalize(accepted, rejected);
+       * @endcode
+       *
+       * The submit(), collect() and finalize() methods are to be
+       * called from a single thread.
+       */
+   class ShardedNavFilterMgr
+   {
+   public:
+         /** Function that creates the filters for one shard, in the
+          * order they are to be applied.  The argument is the shard
+          * number, 0 to numShards()-1. */
+      typedef std::function<NavFilterMgr::FilterList (unsigned)> ChainFactory;
+
+         /// How messages are assigned to shards.
+      enum ShardKey
+      {
+         ShardByPRN,    ///< All the messages of a satellite together.
+         ShardBySignal  ///< By PRN, carrier and code.
+      };
+
+         /** Create the filter chains and start the worker threads.
+          * @param[in] factory Creates the filters for each shard.
+          * @param[in] numShards The number of shards (and threads);
+          *   0 means one for each processor core.
+          * @param[in] queueSize The number of messages that may be
+          *   waiting in each shard's input and output queues; this is
+          *   rounded up to a power of 2.
+          * @param[in] key How messages are assigned to shards.
+          * @throw Exception if the threads cannot be started. */
+      ShardedNavFilterMgr(const ChainFactory& factory,
+                          unsigned numShards = 0,
+                          size_t queueSize = 1024,
+                          ShardKey key = ShardByPRN);
+
+         /// Stop the worker threads and delete the filters.
+      ~ShardedNavFilterMgr();
+
+         /// Return the number of shards (worker threads).
+      unsigned numShards() const throw()
+      { return shards.size(); }
+
+         /** Queue a single navigation message for validation.  If the
+          * shard's queue is full, this waits for its worker to catch
+          * up; results completed meanwhile are kept for the next
+          * collect().
+          * @param[in] msgBits The navigation message to
+          *   validate/filter, as for NavFilterMgr::validate().  It
+          *   must not be changed or freed until it has been returned
+          *   by collect() or finalize().
+          * @throw Exception if a filter threw while processing an
+          *   earlier message. */
+      void submit(NavFilterKey* msgBits);
+
+         /** Get the results for messages submitted so far.  Results
+          * are appended in the order in which the messages were
+          * submitted; for each message, those messages accepted or
+          * rejected by its shard's filters in response to it, as
+          * NavFilterMgr::validate() would return them.
+          * @param[out] accepted Messages passing all the filters are
+          *   appended here.
+          * @param[out] rejected Messages rejected by any filter are
+          *   appended here.
+          * @param[in] wait If true, wait until all the messages
+          *   submitted have been processed; otherwise return only
+          *   those results already available.
+          * @throw Exception (or whatever was thrown) if a filter threw
+          *   while processing a message.  The results for the
+          *   messages before it have been appended. */
+      void collect(NavFilter::NavMsgList& accepted,
+                   NavFilter::NavMsgList& rejected,
+                   bool wait = false);
+
+         /** Process all the messages submitted, then flush the stored
+          * data for all the filters, as NavFilterMgr::finalize().
+          * @param[out] accepted Messages passing all the filters are
+          *   appended here.
+          * @param[out] rejected Messages rejected by any filter are
+          *   appended here.
+          * @throw Exception as collect(). */
+      void finalize(NavFilter::NavMsgList& accepted,
+                    NavFilter::NavMsgList& rejected);
+
+         /// Get the effective buffer size of one shard's filter chain.
+      unsigned processingDepth() const throw();
+
+   private:
+         /// The filters, queues and thread of one shard.
+      class Shard;
+         /// Lets a thread sleep until another has made progress.
+      class Doorbell;
+
+         /// Move the available results, in order, to the lists.
+      void merge(NavFilter::NavMsgList& accepted,
+                 NavFilter::NavMsgList& rejected,
+                 bool wait);
+         /// Queue an item (NULL to finalize) for shard s.
+      void enqueue(unsigned s, NavFilterKey* msgBits);
+         /// Stop and join the worker threads.
+      void stop();
+
+      std::vector<Shard*> shards;
+         /// How messages are assigned to shards.
+      ShardKey shardKey;
+         /// The shard of each message submitted and not yet merged.
+      std::deque<unsigned> order;
+         /// Results merged during submit(), returned by collect().
+      NavFilter::NavMsgList pendingAccepted, pendingRejected;
+         /// Rung by the workers whenever they make progress.
+      Doorbell *callerBell;
+
+         // not copyable
+      ShardedNavFilterMgr(const ShardedNavFilterMgr&);
+      ShardedNavFilterMgr& operator=(const ShardedNavFilterMgr&);
+   };
+
+      //@}
+}
+
+#endif // SHARDEDNAVFILTERMGR_HPP
@@ -38,9 +38,12 @@
 
 #include <typeinfo>
 #include <vector>
+#include <thread>
 #include "ord.hpp"
 #include "GPSEllipsoid.hpp"
 #include "GNSSconstants.hpp"
+#include "StringUtils.hpp"
+#include "TimeString.hpp"
 
 using std::vector;
 using std::cout;
@@ -118,6 +121,17 @@ double IonosphereModelCorrection(const gpstk::IonoModelStore& ionoModel,
     return -iono;
 }
 
+// The light-time loops below look up the ephemeris with tryGetXvt(), which
+// does not throw inside the store, and report a failure once, here.
+//
+static void noEphemeris(const gpstk::SatID& satId,
+        const gpstk::CommonTime& time) {
+    InvalidRequest e("No ephemeris for satellite "
+            + gpstk::StringUtils::asString(satId) + " at "
+            + gpstk::printTime(time, "%Y/%02m/%02d %02H:%02M:%06.3f %P"));
+    GPSTK_THROW(e);
+}
+
 gpstk::Xvt getSvXvt(const gpstk::SatID& satId, const gpstk::CommonTime& time,
         const gpstk::XvtStore<gpstk::SatID>& ephemeris) {
     return ephemeris.getXvt(satId, time);
@@ -142,10 +156,8 @@ double RawRange1(const gpstk::Position& rxLoc, const gpstk::SatID& satId,
             transmit -= tof;
             tof_old = tof;
             // get SV position
-            try {
-                svPosVel = ephemeris.getXvt(satId, transmit);
-            } catch (InvalidRequest& e) {
-                GPSTK_RETHROW(e);
+            if (!ephemeris.tryGetXvt(satId, transmit, svPosVel)) {
+                noEphemeris(satId, transmit);
             }
 
             svPosVel = rotateEarth(rxLoc, svPosVel, ellipsoid);
@@ -180,10 +192,8 @@ double RawRange2(double pseudorange, const gpstk::Position& rxLoc,
         // correct for SV clock
         for (int i = 0; i < 2; i++) {
             // get SV position
-            try {
-                svPosVel = ephemeris.getXvt(satId, tt);
-            } catch (InvalidRequest& e) {
-                GPSTK_RETHROW(e);
+            if (!ephemeris.tryGetXvt(satId, tt, svPosVel)) {
+                noEphemeris(satId, tt);
             }
             tt = transmit;
             // remove clock bias and relativity correction
@@ -272,6 +282,182 @@ double TroposphereCorrection(const gpstk::TropModel& tropModel,
     return trop;
 }
 
+// The receiver position and local frame, set up once per epoch by
+// EpochObservedRanges(). The elevation and azimuth of each satellite are then
+// found with the same arithmetic as Position::elevation() and azimuth()
+// (i.e. Triple::elvAngle() and azAngle()), without converting positions.
+//
+class ReceiverFrame {
+public:
+    explicit ReceiverFrame(const Position& rxLoc) : rx(rxLoc) {
+        rx.asECEF();
+        rr = rx.dot(rx);
+        double xy = rx[0] * rx[0] + rx[1] * rx[1];
+        double xyz = ::sqrt(xy + rx[2] * rx[2]);
+        xy = ::sqrt(xy);
+        frameOK = (xy > 1e-14 && xyz > 1e-14);
+        if (frameOK) {
+            double cosl = rx[0] / xy;
+            double sinl = rx[1] / xy;
+            double sint = rx[2] / xyz;
+            xn1 = -sint * cosl;
+            xn2 = -sint * sinl;
+            xn3 = xy / xyz;
+            xe1 = -sinl;
+            xe2 = cosl;
+        }
+    }
+
+    // Elevation and azimuth (degrees) of sv; false where Position would throw
+    bool elevationAzimuth(const Triple& sv, double& elev, double& azim) const {
+        Triple z(sv[0] - rx[0], sv[1] - rx[1], sv[2] - rx[2]);
+        double zz = z.dot(z);
+        if (!frameOK || zz <= 1e-14 || rr <= 1e-14) {
+            return false;
+        }
+        double c = z.dot(rx) / ::sqrt(zz * rr);
+        if (fabs(c) > 1.0e0) {
+            c = fabs(c) / c;
+        }
+        elev = 90.0 - ::acos(c) * RAD_TO_DEG;
+
+        double p1 = (xn1 * z[0]) + (xn2 * z[1]) + (xn3 * z[2]);
+        double p2 = (xe1 * z[0]) + (xe2 * z[1]);
+        if (fabs(p1) + fabs(p2) < 1.0e-14) {
+            return false;
+        }
+        azim = 90 - ::atan2(p1, p2) * RAD_TO_DEG;
+        if (azim < 0) {
+            azim += 360;
+        }
+        return true;
+    }
+
+    Position rx;     // receiver, ECEF
+    double rr;       // rx.dot(rx)
+    bool frameOK;    // false at the center of the Earth
+    double xn1, xn2, xn3, xe1, xe2;  // north and east unit vectors
+};
+
+// The work of EpochObservedRanges() for satellites [begin,end).
+//
+static void epochRanges(const ReceiverFrame& frame, const Position& rxLoc,
+        const EllipsoidModel& ellipsoid, const CommonTime& timeReceived,
+        const vector<SatID>& satIds, const XvtStore<SatID>& ephemeris,
+        const vector<double> *pseudoranges, const TropModel *tropModel,
+        const IonoModelStore *ionoModel, CarrierBand band,
+        vector<RangeTerms>& terms, size_t begin, size_t end) {
+    const Position& rx(frame.rx);
+    for (size_t i = begin; i < end; i++) {
+        RangeTerms& rt(terms[i]);
+        rt = RangeTerms();
+        rt.satId = satIds[i];
+
+        // light-time iteration of RawRange1()
+        int nit = 0;
+        double tof = 0.07, tof_old, rawrange;
+        CommonTime transmit(timeReceived);
+        Xvt svPosVel;
+        bool ok = true;
+        do {
+            transmit = timeReceived;
+            transmit -= tof;
+            tof_old = tof;
+            if (!ephemeris.tryGetXvt(satIds[i], transmit, svPosVel)) {
+                ok = false;
+                break;
+            }
+            svPosVel = rotateEarth(rx, svPosVel, ellipsoid);
+            rawrange = RSS(svPosVel.x[0] - rx[0], svPosVel.x[1] - rx[1],
+                    svPosVel.x[2] - rx[2]);
+            tof = rawrange / ellipsoid.c();
+        } while (ABS(tof-tof_old) > 1.e-13 && ++nit < 5);
+        if (!ok || !frame.elevationAzimuth(svPosVel.x, rt.elevation,
+                rt.azimuth)) {
+            continue;
+        }
+
+        rt.svXvt = svPosVel;
+        rt.rawRange = rawrange;
+        rt.svClockBias = SvClockBiasCorrection(svPosVel);
+        rt.svRelativity = SvRelativityCorrection(svPosVel);
+        try {
+            if (tropModel) {
+                rt.troposphere = tropModel->correction(rt.elevation);
+            }
+            if (ionoModel) {
+                rt.ionosphere = -ionoModel->getCorrection(timeReceived, rxLoc,
+                        rt.elevation, rt.azimuth, band);
+            }
+        } catch (gpstk::Exception& e) {
+            continue;
+        }
+        if (pseudoranges) {
+            rt.ord = (*pseudoranges)[i] - (rt.rawRange + rt.svRelativity
+                    + rt.svClockBias + rt.troposphere + rt.ionosphere);
+        }
+        rt.valid = true;
+    }
+}
+
+unsigned EpochObservedRanges(const gpstk::Position& rxLoc,
+        const gpstk::CommonTime& timeReceived,
+        const std::vector<gpstk::SatID>& satIds,
+        const gpstk::XvtStore<gpstk::SatID>& ephemeris,
+        std::vector<RangeTerms>& terms,
+        const std::vector<double> *pseudoranges,
+        const gpstk::TropModel *tropModel,
+        const gpstk::IonoModelStore *ionoModel,
+        CarrierBand band,
+        unsigned numThreads) {
+    if (pseudoranges && pseudoranges->size() != satIds.size()) {
+        InvalidRequest e("Mismatch between satellite and pseudorange array size");
+        GPSTK_THROW(e);
+    }
+
+    // shared by all satellites
+    GPSEllipsoid ellipsoid;
+    ReceiverFrame frame(rxLoc);
+    terms.resize(satIds.size());
+
+    if (numThreads == 0) {
+        numThreads = std::thread::hardware_concurrency();
+    }
+    if (numThreads > satIds.size()) {
+        numThreads = satIds.size();
+    }
+    if (numThreads <= 1) {
+        epochRanges(frame, rxLoc, ellipsoid, timeReceived, satIds, ephemeris,
+                pseudoranges, tropModel, ionoModel, band, terms,
+                0, satIds.size());
+    } else {
+        // contiguous blocks of satellites; each thread writes only its own
+        // entries of terms
+        vector<std::thread> threads;
+        size_t begin = 0;
+        for (unsigned t = 0; t < numThreads; t++) {
+            size_t end = begin + (satIds.size() - begin) / (numThreads - t);
+            threads.push_back(std::thread(epochRanges, std::cref(frame),
+                    std::cref(rxLoc), std::cref(ellipsoid),
+                    std::cref(timeReceived), std::cref(satIds),
+                    std::cref(ephemeris), pseudoranges, tropModel, ionoModel,
+                    band, std::ref(terms), begin, end));
+            begin = end;
+        }
+        for (size_t t = 0; t < threads.size(); t++) {
+            threads[t].join();
+        }
+    }
+
+    unsigned nvalid = 0;
+    for (size_t i = 0; i < terms.size(); i++) {
+        if (terms[i].valid) {
+            nvalid++;
+        }
+    }
+    return nvalid;
+}
+
 /*
  * Example not fully fleshed-out.  If dual-band data given, for example,
  * then the last IonosphereModelCorrection call must not be made.
@@ -161,6 +161,66 @@ double SvRelativityCorrection(gpstk::Xvt& svXvt);
 double TroposphereCorrection(const gpstk::TropModel& trop_model,
         const gpstk::Position& rx_loc, const gpstk::Xvt& sv_xvt);
 
+/// Observed range deviation and the terms it is computed from, for one
+/// satellite at one epoch, as computed by EpochObservedRanges(). Each term is
+/// the value the corresponding per-satellite function above would return.
+struct RangeTerms {
+    gpstk::SatID satId;   ///< Identifier for the satellite
+    bool valid;           ///< false if any term could not be computed
+    gpstk::Xvt svXvt;     ///< SV position/velocity, as from RawRange1()
+    double rawRange;      ///< RawRange1(), meters
+    double elevation;     ///< elevation of the SV at the receiver, degrees
+    double azimuth;       ///< azimuth of the SV at the receiver, degrees
+    double svClockBias;   ///< SvClockBiasCorrection(), meters
+    double svRelativity;  ///< SvRelativityCorrection(), meters
+    double troposphere;   ///< TroposphereCorrection(), 0 if no model
+    double ionosphere;    ///< IonosphereModelCorrection(), 0 if no model
+    double ord;           ///< pseudorange minus the corrected raw range,
+                          ///< 0 if no pseudoranges are given
+
+    RangeTerms() : valid(false), rawRange(0), elevation(0), azimuth(0),
+        svClockBias(0), svRelativity(0), troposphere(0), ionosphere(0),
+        ord(0) {}
+};
+
+/// Calculate the raw ranges at RECEIVE time per RECEIVER clock (as
+/// RawRange1()), the SV clock, relativity, troposphere and ionosphere
+/// corrections and the observed range deviations for all the satellites in
+/// view at one epoch. The receiver position is converted, and the ellipsoid
+/// and local frame of the receiver are set up, once for all satellites, and
+/// the ephemeris is queried with XvtStore::tryGetXvt(). The results are the
+/// same as those of the per-satellite functions.
+/// The satellites may be divided among several threads. The threads call only
+/// XvtStore::tryGetXvt(), TropModel::correction(elevation) and
+/// IonoModelStore::getCorrection(), all const, so these must be safe to call
+/// concurrently, and nothing may modify the ephemeris or models meanwhile.
+/// This makes no claim for other calls: TropModel::correction(RX,SV,tt), for
+/// one, changes the model's state and cannot be shared among threads.
+/// @param[in] rxLoc The location of the receiver.
+/// @param[in] timeReceived The nominal receive time.
+/// @param[in] satIds Identifiers of the satellites.
+/// @param[in] ephemeris The ephemeris to query against.
+/// @param[out] terms Results, parallel to satIds; entries for which the
+///   ephemeris, or a model, has no data are not valid.
+/// @param[in] pseudoranges If not NULL, pseudoranges (meters) parallel to
+///   satIds, from which the ORDs are computed.
+/// @param[in] tropModel If not NULL, troposphere model to apply.
+/// @param[in] ionoModel If not NULL, ionosphere model to apply.
+/// @param[in] band Signal band of the pseudoranges, for the ionosphere model.
+/// @param[in] numThreads Number of threads to use; 0 for one per core.
+/// @return Number of valid entries in terms.
+/// @throw InvalidRequest if pseudoranges is not parallel to satIds.
+unsigned EpochObservedRanges(const gpstk::Position& rxLoc,
+        const gpstk::CommonTime& timeReceived,
+        const std::vector<gpstk::SatID>& satIds,
+        const gpstk::XvtStore<gpstk::SatID>& ephemeris,
+        std::vector<RangeTerms>& terms,
+        const std::vector<double> *pseudoranges = NULL,
+        const gpstk::TropModel *tropModel = NULL,
+        const gpstk::IonoModelStore *ionoModel = NULL,
+        CarrierBand band = CarrierBand::L1,
+        unsigned numThreads = 1);
+
 /// Example method that applies _all_ corrections to generate an Observed Range Deviation.
 /// This is intended to be a sample showing how the above methods will be used.
 /// The example is not fully developed, just a general sketch of a generic approach.
@@ -42,11 +42,17 @@
 
 #include "MathBase.hpp"
 #include "PRSolution.hpp"
+#include "FixedMatrix.hpp"
 #include "GPSEllipsoid.hpp"
 #include "Combinations.hpp"
 #include "TimeString.hpp"
 #include "logstream.hpp"
 
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+
 using namespace std;
 using namespace gpstk;
 
@@ -119,32 +125,21 @@ namespace gpstk
          // convert time system of tx to that of Sats[i]
 
          tx -= Pseudorange[i]/C_MPS;
-         try {
-            LOG(DEBUG) << " go to getXvt with time " << printTime(tx,timfmt);
-            PVT = pEph->getXvt(Sats[i], tx);          // get ephemeris range, etc
-            LOG(DEBUG) << " returned from getXvt";
-         }
-         catch(InvalidRequest& e) {
+         LOG(DEBUG) << " go to tryGetXvt with time " << printTime(tx,timfmt);
+         if(!pEph->tryGetXvt(Sats[i], tx, PVT)) {     // get ephemeris range, etc
             LOG(DEBUG) << "Warning - PRSolution ignores satellite (no ephemeris) "
-               << RinexSatID(Sats[i]) << " at time " << printTime(tx,timfmt)
-               << " [" << e.getText() << "]";
+               << RinexSatID(Sats[i]) << " at time " << printTime(tx,timfmt);
             Sats[i].id = -::abs(Sats[i].id);
             ++noeph;
             continue;
          }
-         catch(Exception& e) {
-            LOG(DEBUG) << "Oops - Exception " << e.getText();
-         }
+         LOG(DEBUG) << " returned from tryGetXvt";
 
          // update transmit time and get ephemeris range again
          tx -= PVT.clkbias + PVT.relcorr;
-         try {
-            PVT = pEph->getXvt(Sats[i], tx);
-         }
-         catch(InvalidRequest& e) {                   // unnecessary....you'd think!
+         if(!pEph->tryGetXvt(Sats[i], tx, PVT)) {     // unnecessary....you'd think!
             LOG(DEBUG) << "Warning - PRSolution ignores satellite (no ephemeris 2) "
-               << RinexSatID(Sats[i]) << " at time " << printTime(tx,timfmt)
-               << " [" << e.getText() << "]";
+               << RinexSatID(Sats[i]) << " at time " << printTime(tx,timfmt);
             Sats[i].id = -::abs(Sats[i].id);
             ++noeph;
             continue;
@@ -170,6 +165,60 @@ namespace gpstk
    } // end PreparePRSolution
 
 
+   // -------------------------------------------------------------------------
+   // For SimplePRSolution(): invert the information matrix PT*W*P, of dimension
+   // D, into Cov and form the generalized inverse G = Cov*PT*W, where W is iMC,
+   // or unity if iMC is empty. The D x D work is done in FixedMatrix, so that
+   // nothing is allocated. Return false if the information matrix is not
+   // clearly positive definite (a pivot of its Cholesky factor is small
+   // relative to the diagonal), so that the caller falls back to the
+   // pseudo-inverse (inverseSVD()); Cov is then unchanged.
+   template <size_t D>
+   static bool fixedGeneralizedInverse(const Matrix<double>& P,
+                                       const Matrix<double>& iMC,
+                                       Matrix<double>& Cov,
+                                       Matrix<double>& G)
+   {
+      const size_t N(P.rows());
+      size_t a,b,m,n;
+
+      // G = PT*W, then the information matrix is G*P
+      for(a=0; a<D; a++) {
+         for(m=0; m<N; m++) {
+            if(iMC.rows() == 0) { G(a,m) = P(m,a); continue; }
+            double sum(0.0);
+            for(n=0; n<N; n++) sum += P(n,a)*iMC(n,m);
+            G(a,m) = sum;
+         }
+      }
+      FixedMatrix<double,D,D> info, L, C;
+      for(a=0; a<D; a++) {
+         for(b=0; b<D; b++) {
+            double sum(0.0);
+            for(m=0; m<N; m++) sum += G(a,m)*P(m,b);
+            info(a,b) = sum;
+         }
+      }
+
+      try { L = cholesky(info); }
+      catch(MatrixException&) { return false; }
+      for(a=0; a<D; a++)
+         if(L(a,a)*L(a,a) < 1.e-8*info(a,a)) return false;
+      C = inverseChol(info);
+
+      // Cov = C, G = C*G
+      FixedVector<double,D> col;
+      for(a=0; a<D; a++)
+         for(b=0; b<D; b++) Cov(a,b) = C(a,b);
+      for(m=0; m<N; m++) {
+         for(a=0; a<D; a++) col(a) = G(a,m);
+         col = C * col;
+         for(a=0; a<D; a++) G(a,m) = col(a);
+      }
+
+      return true;
+   }
+
    // -------------------------------------------------------------------------
    // Compute a straightforward solution using all the unmarked data.
    // Call PreparePRSolution first.
@@ -259,8 +308,8 @@ namespace gpstk
 
          // -----------------------------------------------------------
          // define for computation
-         Vector<double> CRange(Nsvs),dX(dim);
-         Matrix<double> P(Nsvs,dim,0.0),PT,G(dim,Nsvs),PG(Nsvs,Nsvs),Rotation;
+         Vector<double> CRange(Nsvs),dX(dim),PGdiag(Nsvs);
+         Matrix<double> P(Nsvs,dim,0.0),PT,G(dim,Nsvs),Rotation;
          Triple dirCos;
          Xvt SV,RX;
 
@@ -390,35 +439,56 @@ namespace gpstk
                << fixed << setprecision(3) << Resids;
 
             // ------------------------------------------------------
-            // compute information matrix (inverse covariance) and generalized inverse
-            PT = transpose(P);
+            // compute information matrix (inverse covariance) and generalized
+            // inverse; the common dimensions are done without allocating
+            bool fixedInverse(false);
+            switch(dim) {
+               case 4: fixedInverse = fixedGeneralizedInverse<4>(P,iMC,Covariance,G);
+                       break;
+               case 5: fixedInverse = fixedGeneralizedInverse<5>(P,iMC,Covariance,G);
+                       break;
+               case 6: fixedInverse = fixedGeneralizedInverse<6>(P,iMC,Covariance,G);
+                       break;
+               case 7: fixedInverse = fixedGeneralizedInverse<7>(P,iMC,Covariance,G);
+                       break;
+            }
 
-            // weight matrix = measurement covariance inverse
-            if(invMC.rows() > 0) Covariance = PT * iMC * P;
-            else                 Covariance = PT * P;
+            if(!fixedInverse) {
+               PT = transpose(P);
 
-            // invert using SVD
-            try {
-               Covariance = inverseSVD(Covariance);
+               // weight matrix = measurement covariance inverse
+               if(invMC.rows() > 0) Covariance = PT * iMC * P;
+               else                 Covariance = PT * P;
+
+               // invert using SVD
+               try {
+                  Covariance = inverseSVD(Covariance);
+               }
+               catch(SingularMatrixException& sme) { return -2; }
+
+               // generalized inverse
+               if(invMC.rows() > 0) G = Covariance * PT * iMC;
+               else                 G = Covariance * PT;
             }
-            catch(SingularMatrixException& sme) { return -2; }
             LOG(DEBUG) << "InvCov (" << Covariance.rows() << "x" << Covariance.cols()
                << ")\n" << fixed << setprecision(4) << Covariance;
 
-            // generalized inverse
-            if(invMC.rows() > 0) G = Covariance * PT * iMC;
-            else                 G = Covariance * PT;
-
-            // PG is used for Slope computation
-            PG = P * G;
-            LOG(DEBUG) << "PG (" << PG.rows() << "x" << PG.cols()
-               << ")\n" << fixed << setprecision(4) << PG;
+            // the diagonal of PG = P*G is used for Slope computation
+            for(i=0; i<Nsvs; i++) {
+               PGdiag(i) = 0.0;
+               for(j=0; j<dim; j++) PGdiag(i) += P(i,j)*G(j,i);
+            }
+            LOG(DEBUG) << "PG (" << Nsvs << "x" << Nsvs
+               << ")\n" << fixed << setprecision(4) << P*G;
 
             n_iterate++;                        // increment number iterations
 
             // ------------------------------------------------------
             // compute solution
-            dX = G * Resids;
+            for(j=0; j<dim; j++) {
+               dX(j) = 0.0;
+               for(i=0; i<Nsvs; i++) dX(j) += G(j,i)*Resids(i);
+            }
             LOG(DEBUG) << "Computed dX(" << dX.size() << ")";
             Solution += dX;
 
@@ -448,10 +518,10 @@ namespace gpstk
 
             // NB when one (few) sats have their own clock, PG(j,j) = 1 (nearly 1)
             // and slope is inf (large)
-            if(::fabs(1.0-PG(j,j)) < 1.e-8) continue;
+            if(::fabs(1.0-PGdiag(j)) < 1.e-8) continue;
 
             for(int k=0; k<dim; k++) Slopes(j) += G(k,j)*G(k,j); // TD dim=4 here?
-            Slopes(j) = SQRT(Slopes(j)*double(n-dim)/(1.0-PG(j,j)));
+            Slopes(j) = SQRT(Slopes(j)*double(n-dim)/(1.0-PGdiag(j)));
             if(Slopes(j) > MaxSlope) MaxSlope = Slopes(j);
             j++;
          }
@@ -501,6 +571,268 @@ namespace gpstk
    }  // end PRSolution::RAIMComputeUnweighted()
 
 
+   namespace
+   {
+      // A TropModel that forwards to another, one caller at a time. Models are
+      // not thread-safe (correction() sets the receiver position, etc.), so the
+      // threads in RAIMComboSolutions() each use their own copy (clone()) of the
+      // caller's model; this lets them share a model that cannot be copied.
+      class LockedTropModel : public TropModel
+      {
+      public:
+         LockedTropModel(TropModel *p) : ptm(p) {}
+
+         virtual string name(void)
+         { lock_guard<mutex> lock(mtx); return ptm->name(); }
+         virtual double correction(double elevation) const
+         { lock_guard<mutex> lock(mtx); return ptm->correction(elevation); }
+         virtual double correction(const Position& RX, const Position& SV,
+                                   const CommonTime& tt)
+         { lock_guard<mutex> lock(mtx); return ptm->correction(RX,SV,tt); }
+         virtual double correction(const Xvt& RX, const Xvt& SV,
+                                   const CommonTime& tt)
+         { lock_guard<mutex> lock(mtx); return ptm->correction(RX,SV,tt); }
+         virtual double dry_zenith_delay(void) const
+         { lock_guard<mutex> lock(mtx); return ptm->dry_zenith_delay(); }
+         virtual double wet_zenith_delay(void) const
+         { lock_guard<mutex> lock(mtx); return ptm->wet_zenith_delay(); }
+         virtual double dry_mapping_function(double elevation) const
+         { lock_guard<mutex> lock(mtx); return ptm->dry_mapping_function(elevation);}
+         virtual double wet_mapping_function(double elevation) const
+         { lock_guard<mutex> lock(mtx); return ptm->wet_mapping_function(elevation);}
+
+      private:
+         TropModel *ptm;
+         mutable mutex mtx;
+      };
+   }
+
+   // -------------------------------------------------------------------------
+   // Compute SimplePRSolution() for each set of satellites, in parallel.
+   void PRSolution::RAIMComboSolutions(const CommonTime& Tr,
+                                       const vector< vector<SatID> >& SatSets,
+                                       const Matrix<double>& SVP,
+                                       const Matrix<double>& invMC,
+                                       TropModel *pTropModel,
+                                       vector<int>& irets,
+                                       vector<double>& RMSs,
+                                       vector<exception_ptr>& excepts) const
+   {
+      const size_t N(SatSets.size());
+      irets.assign(N,-99);
+      RMSs.assign(N,0.0);
+      excepts.assign(N,exception_ptr());
+
+      size_t nthr(NThreads > 0 ? NThreads : thread::hardware_concurrency());
+      if(nthr < 1) nthr = 1;
+      if(nthr > N) nthr = N;
+
+      // one trop model per thread, copied before any thread starts, since the
+      // copy reads the caller's model; fall back to a shared, locked model.
+      LockedTropModel lockedTrop(pTropModel);
+      vector< unique_ptr<TropModel> > tropModels(nthr);
+      for(size_t i=0; i<nthr; i++) {
+         tropModels[i].reset(pTropModel->clone());
+         if(!tropModels[i]) { tropModels.clear(); break; }
+      }
+
+      // each thread takes the next set in order; stop is the index of the first
+      // set (so far) that ends the stage, and no set beyond it is started.
+      atomic<size_t> next(0), stop(N);
+
+      auto worker = [&](size_t ithr) {
+         TropModel *ptm(tropModels.empty() ? &lockedTrop
+                                           : tropModels[ithr].get());
+         PRSolution prs(*this);
+         Vector<double> Resids,Slopes;
+         size_t k;
+         while((k = next++) < stop) {
+            try {
+               irets[k] = prs.SimplePRSolution(Tr, SatSets[k], SVP, invMC,
+                                  ptm, MaxNIterations, ConvergenceLimit,
+                                  Resids, Slopes);
+               RMSs[k] = prs.RMSResidual;
+               if(irets[k] != -3 && irets[k] != -4) continue;
+            }
+            catch(...) { excepts[k] = current_exception(); }
+
+            size_t s(stop);
+            while(k < s && !stop.compare_exchange_weak(s,k)) ;
+         }
+      };
+
+      // if a thread cannot be started, stop and join those that were
+      vector<thread> threads;
+      try {
+         for(size_t i=1; i<nthr; i++)
+            threads.push_back(thread(worker,i));
+      }
+      catch(...) {
+         stop = 0;
+         for(size_t i=0; i<threads.size(); i++)
+            threads[i].join();
+         throw;
+      }
+      worker(0);
+      for(size_t i=0; i<threads.size(); i++)
+         threads[i].join();
+   }
+
+   // -------------------------------------------------------------------------
+   // The work of RAIMComboRankUpdate(), for a normal matrix L and vector b of
+   // type MatrixT and VectorT; these are zero on input and of dimension
+   // RefP.cols(). FixedMatrix and FixedVector are used for the common small
+   // dimensions, so that the copies and the downdate for each of the many sets
+   // are done without allocating.
+   template <class MatrixT, class VectorT>
+   static void comboRankUpdate(const vector< vector<SatID> >& SatSets,
+                               const vector<int>& GoodIndexes,
+                               const Matrix<double>& RefP,
+                               const Vector<double>& RefR,
+                               const vector<double>& wt,
+                               const vector<size_t>& clk,
+                               MatrixT L, VectorT b,
+                               vector<int>& irets,
+                               vector<double>& RMSs)
+   {
+      const size_t N(SatSets.size()), n(RefP.rows()), dim(RefP.cols());
+      size_t i,j,k,m;
+
+      // normal equations N = PT*W*P and b = PT*W*R
+      for(i=0; i<n; i++) {
+         for(j=0; j<dim; j++) {
+            b(j) += RefP(i,j)*wt[i]*RefR(i);
+            for(k=0; k<=j; k++) L(j,k) += RefP(i,j)*wt[i]*RefP(i,k);
+         }
+      }
+
+      // factor in place, N = L*LT with L lower triangular
+      for(j=0; j<dim; j++) {
+         for(k=0; k<j; k++) L(j,j) -= L(j,k)*L(j,k);
+         if(L(j,j) <= 0.0) return;        // all sets are left to the caller
+         L(j,j) = SQRT(L(j,j));
+         for(i=j+1; i<dim; i++) {
+            for(k=0; k<j; k++) L(i,j) -= L(i,k)*L(j,k);
+            L(i,j) /= L(j,j);
+         }
+      }
+
+      MatrixT LS(L);
+      VectorT bS(b),x(b),dX(b);
+      vector<bool> rejected(n);
+      vector<size_t> nclk(dim);
+      for(m=0; m<N; m++) {
+         // find the rejected satellites, and count the rest by clock
+         size_t nsvs(0),nsys(0);
+         nclk.assign(dim,0);
+         for(i=0; i<n; i++) {
+            rejected[i] = (SatSets[m][GoodIndexes[i]].id <= 0);
+            if(!rejected[i]) { nsvs++; nclk[clk[i]]++; }
+         }
+         for(j=3; j<dim; j++) if(nclk[j] > 0) nsys++;
+
+         // as SimplePRSolution()
+         if(nsvs < 3+nsys) { irets[m] = -3; continue; }
+         // the dimension changes - leave it to the caller
+         if(3+nsys != dim) continue;
+
+         // downdate LS*LST = L*LT - w*p*pT and bS = b - p*w*r for each rejected
+         LS = L;
+         bS = b;
+         bool ok(true);
+         for(i=0; ok && i<n; i++) {
+            if(!rejected[i]) continue;
+            const double sw(SQRT(wt[i]));
+            for(j=0; j<dim; j++) {
+               x(j) = sw*RefP(i,j);
+               bS(j) -= RefP(i,j)*wt[i]*RefR(i);
+            }
+            for(k=0; k<dim; k++) {
+               const double r2(LS(k,k)*LS(k,k) - x(k)*x(k));
+               if(r2 <= 1.e-12*LS(k,k)*LS(k,k)) { ok = false; break; }
+               const double r(SQRT(r2)), c(r/LS(k,k)), s(x(k)/LS(k,k));
+               LS(k,k) = r;
+               for(j=k+1; j<dim; j++) {
+                  LS(j,k) = (LS(j,k) - s*x(j))/c;
+                  x(j) = c*x(j) - s*LS(j,k);
+               }
+            }
+         }
+         if(!ok) continue;
+
+         // solve LS*LST*dX = bS
+         for(j=0; j<dim; j++) {
+            x(j) = bS(j);
+            for(k=0; k<j; k++) x(j) -= LS(j,k)*x(k);
+            x(j) /= LS(j,j);
+         }
+         for(j=dim; j-- > 0; ) {
+            dX(j) = x(j);
+            for(k=j+1; k<dim; k++) dX(j) -= LS(k,j)*dX(k);
+            dX(j) /= LS(j,j);
+         }
+
+         // RMS of the residuals after the update
+         double sumsq(0.0);
+         for(i=0; i<n; i++) {
+            if(rejected[i]) continue;
+            double res(RefR(i));
+            for(j=0; j<dim; j++) res -= RefP(i,j)*dX(j);
+            sumsq += res*res;
+         }
+         RMSs[m] = SQRT(sumsq/nsvs);
+      }
+   }
+
+   // -------------------------------------------------------------------------
+   // Compute the RMS residual for each set of satellites, by downdating the
+   // Cholesky factor of the all-satellite normal equations.
+   void PRSolution::RAIMComboRankUpdate(const vector< vector<SatID> >& SatSets,
+                                        const vector<int>& GoodIndexes,
+                                        const Matrix<double>& RefP,
+                                        const Vector<double>& RefR,
+                                        const Matrix<double>& RefW,
+                                        vector<int>& irets,
+                                        vector<double>& RMSs) const
+   {
+      const size_t N(SatSets.size()), n(RefP.rows()), dim(RefP.cols());
+      size_t i,j;
+      irets.assign(N,0);
+      RMSs.assign(N,-1.0);
+
+      // weights, and the clock (column of the partials) of each satellite
+      vector<double> wt(n,1.0);
+      vector<size_t> clk(n,0);
+      for(i=0; i<n; i++) {
+         if(RefW.rows() > 0) wt[i] = RefW(i,i);
+         for(j=3; j<dim; j++) if(RefP(i,j) == 1.0) clk[i] = j;
+      }
+
+      // position + one clock for each of up to four systems
+      switch(dim) {
+         case 4:
+            comboRankUpdate(SatSets, GoodIndexes, RefP, RefR, wt, clk,
+                  FixedMatrix<double,4,4>(), FixedVector<double,4>(), irets, RMSs);
+            break;
+         case 5:
+            comboRankUpdate(SatSets, GoodIndexes, RefP, RefR, wt, clk,
+                  FixedMatrix<double,5,5>(), FixedVector<double,5>(), irets, RMSs);
+            break;
+         case 6:
+            comboRankUpdate(SatSets, GoodIndexes, RefP, RefR, wt, clk,
+                  FixedMatrix<double,6,6>(), FixedVector<double,6>(), irets, RMSs);
+            break;
+         case 7:
+            comboRankUpdate(SatSets, GoodIndexes, RefP, RefR, wt, clk,
+                  FixedMatrix<double,7,7>(), FixedVector<double,7>(), irets, RMSs);
+            break;
+         default:
+            comboRankUpdate(SatSets, GoodIndexes, RefP, RefR, wt, clk,
+                  Matrix<double>(dim,dim,0.0), Vector<double>(dim,0.0), irets, RMSs);
+            break;
+      }
+   }
+
    // -------------------------------------------------------------------------
    // Compute a solution using RAIM.
    int PRSolution::RAIMCompute(const CommonTime& Tr,
@@ -525,6 +857,10 @@ namespace gpstk
          int BestNIter(0),BestIret(-5);
          double BestRMS(-1.0),BestSL(0.0),BestConv(0.0);
          Vector<double> BestSol(3,0.0),BestPFR;
+         // the all-satellite problem, saved for RankUpdateRAIM
+         bool haveRef(false);
+         Matrix<double> RefP,RefW;
+         Vector<double> RefR;
          vector<SatID> BestSats,SaveSats;
          Matrix<double> SVP,BestCov,BestInvMCov,BestPartials;
          vector<SatelliteSystem> BestGNSS;
@@ -596,6 +932,38 @@ namespace gpstk
             // compute all the combinations of N satellites taken stage at a time
             Combinations Combo(N,stage);
 
+            // If threads, or rank updates, are used, compute the solutions for
+            // every combination first; the loop below then reviews them in order,
+            // as if they had been computed there, and computes again (in this
+            // object) only those that become the 'best' solution.
+            bool rankupdate(RankUpdateRAIM && haveRef && stage > 0);
+            bool parallel(rankupdate || (NThreads != 1 && stage > 0 &&
+                          LOGlevel < ConfigureLOG::Level("DEBUG")));
+            vector<int> comboIret;
+            vector<double> comboRMS;
+            vector<exception_ptr> comboExcept;
+            size_t ncombo(0);
+            if(parallel) {
+               vector< vector<SatID> > SatSets;
+               do {
+                  SatSets.push_back(SaveSats);
+                  for(i=0; i<GoodIndexes.size(); i++)
+                     if(Combo.isSelected(i))
+                        SatSets.back()[GoodIndexes[i]].id =
+                           -::abs(SatSets.back()[GoodIndexes[i]].id);
+               } while(Combo.Next() != -1);
+               Combo = Combinations(N,stage);
+
+               if(rankupdate) {
+                  RAIMComboRankUpdate(SatSets, GoodIndexes, RefP, RefR, RefW,
+                                      comboIret, comboRMS);
+                  comboExcept.assign(SatSets.size(),exception_ptr());
+               }
+               else
+                  RAIMComboSolutions(Tr, SatSets, SVP, invMC, pTropModel,
+                                     comboIret, comboRMS, comboExcept);
+            }
+
             // compute a solution for each combination of marked satellites
             do {
                // Mark the satellites for this combination
@@ -623,8 +991,20 @@ namespace gpstk
                //       -2  singular problem
                //       -3  not enough good data
                //       -4  no ephemeris
-               iret = SimplePRSolution(Tr, Sats, SVP, invMC, pTropModel,
-                       MaxNIterations, ConvergenceLimit, Resids, Slopes);
+               if(parallel) {
+                  // use the result already computed
+                  const size_t k(ncombo++);
+                  if(comboExcept[k]) rethrow_exception(comboExcept[k]);
+                  iret = comboIret[k];
+                  // if not the best, the details are not needed
+                  if(iret >= 0 && BestRMS >= 0.0 && !(comboRMS[k] < BestRMS)) {
+                     if(iret <= 0 && iret > BestIret) BestIret = iret;
+                     continue;
+                  }
+               }
+               if(!parallel || iret >= 0)
+                  iret = SimplePRSolution(Tr, Sats, SVP, invMC, pTropModel,
+                          MaxNIterations, ConvergenceLimit, Resids, Slopes);
 
                LOG(DEBUG) << " RAIM: SimplePRS returns " << iret;
                if(iret <= 0 && iret > BestIret) BestIret = iret;
@@ -650,6 +1030,20 @@ namespace gpstk
                   }
                }
 
+               // save the all-satellite problem for RankUpdateRAIM, if the
+               // weights are diagonal
+               if(RankUpdateRAIM && stage == 0 && iret == 0 &&
+                  Partials.rows() == GoodIndexes.size()) {
+                  haveRef = true;
+                  for(i=0; haveRef && i<invMeasCov.rows(); i++)
+                     for(j=0; j<invMeasCov.cols(); j++)
+                        if(i != j && invMeasCov(i,j) != 0.0)
+                           { haveRef = false; break; }
+                  RefP = Partials;
+                  RefR = Resids;
+                  RefW = invMeasCov;
+               }
+
                // ----------------------------------------------------------------
                // print solution with diagnostic information
                LOG(DEBUG) << outputString(string("RPS"),iret);
@@ -1023,6 +1417,9 @@ namespace gpstk
          << "\n   RMS residual limit " << fixed << RMSLimit
          << "\n   RAIM slope limit " << fixed << SlopeLimit << " meters"
          << "\n   Maximum number of satellites to reject is " << NSatsReject
+         << "\n   RAIM uses " << NThreads << (NThreads == 1 ? " thread":" threads")
+            << " (0=all cores)"
+         << "\n   RAIM rank updates ARE " << (RankUpdateRAIM ? "":"NOT ") << "used"
          << "\n   Memory information IS " << (hasMemory ? "":"NOT ") << "stored"
          ;
 
@@ -45,6 +45,7 @@
 
 #include <vector>
 #include <ostream>
+#include <exception>
 #include "stl_helpers.hpp"
 #include "GNSSconstants.hpp"
 #include "CommonTime.hpp"
@@ -220,6 +221,8 @@ namespace gpstk
                       NSatsReject(-1),
                       MaxNIterations(10),
                       ConvergenceLimit(3.e-7),
+                      NThreads(1),
+                      RankUpdateRAIM(false),
                       hasMemory(true),
                       fixedAPriori(false),
                       nsol(0), ndata(0), APV(0.0),
@@ -254,6 +257,25 @@ namespace gpstk
       /// solution exceeds this.
       double ConvergenceLimit;
 
+      /// Number of threads used by RAIMCompute() to compute the solutions for the
+      /// satellite combinations of each RAIM stage (after the first, all-satellite,
+      /// solution). 1 means compute them serially; 0 means use one thread per
+      /// hardware core. The result does not depend on this number. Threads are not
+      /// used while DEBUG output is enabled.
+      int NThreads;
+
+      /// If true, RAIMCompute() screens the satellite combinations of each RAIM
+      /// stage (after the first) without iterating: the all-satellite problem,
+      /// linearized at its solution, is factored (Cholesky) once and each
+      /// combination is evaluated by downdating that factor for the rejected
+      /// satellites. Only a combination that becomes the 'best' is then computed
+      /// with SimplePRSolution(). The RMS residuals so computed agree with the
+      /// iterated ones to second order in the change of position, so the chosen
+      /// combination can differ only between near-ties. Not used when the
+      /// measurement covariance is not diagonal, or the first solution does not
+      /// converge. Default false; when true, NThreads is not used.
+      bool RankUpdateRAIM;
+
       /// vector<SatelliteSystem> containing the satellite systems allowed
       /// in the solution. **This vector MUST be defined before computing solutions.**
       /// It is used to determine which clock biases are included in the solution,
@@ -628,6 +650,40 @@ namespace gpstk
 
    private:
 
+      /// Compute SimplePRSolution() for each of the sets of marked satellites
+      /// SatSets, using NThreads threads, each with its own copy of this object
+      /// and of the trop model (see TropModel::clone()). Save the return value
+      /// and RMS residual of each. Evaluation stops at (after) the first set, in
+      /// order, that returns -3 or -4 or throws; the exception is saved. Later
+      /// sets are not computed; their return values are left at -99. Other
+      /// arguments are as for SimplePRSolution().
+      void RAIMComboSolutions(const CommonTime& Tr,
+                              const std::vector< std::vector<SatID> >& SatSets,
+                              const Matrix<double>& SVP,
+                              const Matrix<double>& invMC,
+                              TropModel *pTropModel,
+                              std::vector<int>& irets,
+                              std::vector<double>& RMSs,
+                              std::vector<std::exception_ptr>& excepts) const;
+
+      /// Compute the RMS residual for each of the sets of marked satellites
+      /// SatSets, by removing the marked satellites from the all-satellite
+      /// linearized problem with partials RefP, post-fit residuals RefR and
+      /// weight matrix RefW (diagonal, or empty for no weighting); the rows of
+      /// RefP correspond to the satellites SatSets[k][GoodIndexes[.]]. The Cholesky
+      /// factor of the normal equations is computed once and downdated for
+      /// each rejected satellite. Sets with too few satellites return -3.
+      /// Sets that cannot be computed this way (a system loses all of its
+      /// satellites, or the downdate fails) return 0 with RMS -1, so that the
+      /// caller computes them with SimplePRSolution(); otherwise return 0.
+      void RAIMComboRankUpdate(const std::vector< std::vector<SatID> >& SatSets,
+                               const std::vector<int>& GoodIndexes,
+                               const Matrix<double>& RefP,
+                               const Vector<double>& RefR,
+                               const Matrix<double>& RefW,
+                               std::vector<int>& irets,
+                               std::vector<double>& RMSs) const;
+
       /// flag: output content is valid.
       bool Valid;
 
@@ -322,6 +322,41 @@ namespace gpstk
                                  unsigned long len,
                                  const CRCParam& params);
 
+         /// CRC-24Q of each byte value, used by crc24q() and crc24qBits()
+      extern const uint32_t crc24qTable[256];
+
+         /**
+          * Compute the CRC-24Q used by GPS CNAV and CNAV-2 and by
+          * RTCM 3 (polynomial 0x1864CFB, initial value and final XOR
+          * zero, no reflection), one byte at a time using a look-up
+          * table.  A message followed by its own CRC gives zero.
+          * @note This is not the CRC defined by the CRC24Q parameters
+          *   above, which are used with computeCRC().
+          * @param[in] data data to process CRC on.
+          * @param[in] len length of data to process (in bytes).
+          * @param[in] crc the CRC of any data preceding data, so that a
+          *   message may be processed in pieces.
+          * @return the CRC value
+          */
+      inline uint32_t crc24q(const unsigned char *data,
+                             unsigned long len,
+                             uint32_t crc = 0);
+
+         /**
+          * Continue a CRC-24Q computation (see crc24q()) with the
+          * numBits (at most 64) least significant bits of \a bits,
+          * most significant first.  Whole bytes use the look-up
+          * table, so messages that are not a whole number of bytes
+          * long, such as GPS CNAV, may be processed a word at a time.
+          * @param[in] bits the bits to process, right justified.
+          * @param[in] numBits the number of bits to process.
+          * @param[in] crc the CRC of the preceding bits.
+          * @return the CRC value
+          */
+      inline uint32_t crc24qBits(uint64_t bits,
+                                 unsigned numBits,
+                                 uint32_t crc = 0);
+
          /**
           * Calculate an Exclusive-OR Checksum on the string \a str.
           * @param[in] str The encoded data for which the checksum is
@@ -545,6 +580,42 @@ namespace gpstk
          return crc;
       }
 
+      inline uint32_t crc24q(const unsigned char *data,
+                             unsigned long len,
+                             uint32_t crc)
+      {
+         for (unsigned long i = 0; i < len; i++)
+         {
+            crc = ((crc << 8) & 0xffffff) ^
+               crc24qTable[((crc >> 16) ^ data[i]) & 0xff];
+         }
+         return crc;
+      }
+
+
+      inline uint32_t crc24qBits(uint64_t bits,
+                                 unsigned numBits,
+                                 uint32_t crc)
+      {
+            // leading bits that do not make a whole byte, one at a time
+         for (; numBits % 8; numBits--)
+         {
+            crc ^= (uint32_t)((bits >> (numBits - 1)) & 1) << 23;
+            crc <<= 1;
+            if (crc & 0x1000000)
+            {
+               crc ^= 0x1864cfb;
+            }
+         }
+         for (; numBits; numBits -= 8)
+         {
+            crc = ((crc << 8) & 0xffffff) ^
+               crc24qTable[((crc >> 16) ^ (bits >> (numBits - 8))) & 0xff];
+         }
+         return crc;
+      }
+
+
       std::string xorChecksum(const std::string& str, unsigned wordSize)
       {
          size_t strSize = str.size();
@@ -0,0 +1,339 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file FileFilterFrame_T.cpp
+/// Test the streaming merge and diff of FileFilterFrame against the in-memory
+/// sort(), unique() and diff(), and show the memory they use.
+
+#include "FileFilterFrameWithHeader.hpp"
+#include "RinexMetStream.hpp"
+#include "RinexMetFilterOperators.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+#include <iostream>
+#include <ctime>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace gpstk;
+
+class FileFilterFrame_T
+{
+public:
+   FileFilterFrame_T();
+
+      // mergeStreams() vs sort() and unique()
+   int testMerge();
+      // diffStreams() vs diff()
+   int testDiff();
+      // mergeStreams() on unsorted input
+   int testUnsorted();
+      // memory and time of the streaming and in-memory merges
+   int testMemory();
+
+private:
+   typedef FileFilterFrameWithHeader<RinexMetStream, RinexMetData,
+                                     RinexMetHeader> FFF;
+
+      // write the records k < n with k % mod == rem to a file, swapping
+      // the first two records if unsorted is true
+   string writeFile(const string& name, int n, int mod, int rem,
+                    bool unsorted = false);
+      // write three overlapping files of n records in all
+   vector<string> writeFiles(const string& name, int n);
+      // merge files in memory
+   list<RinexMetData> sortMerge(const vector<string>& files);
+      // merge files with mergeStreams()
+   list<RinexMetData> streamMerge(const vector<string>& files);
+      // true if the two lists hold the same times and data
+   static bool sameData(const list<RinexMetData>& l,
+                        const list<RinexMetData>& r);
+      // peak resident memory of the process in kB, 0 if not known
+   static long maxRSS();
+
+   RinexMetHeader header;
+   RinexMetData record;
+};
+
+FileFilterFrame_T::FileFilterFrame_T()
+{
+      // the header and first record of a real file are the pattern for
+      // the test files
+   string file = getPathData() + getFileSep() + "arlm200a.15m";
+   RinexMetStream s(file.c_str());
+   s >> header;
+   s >> record;
+}
+
+string FileFilterFrame_T::writeFile(const string& name, int n, int mod,
+                                    int rem, bool unsorted)
+{
+   string file = getPathTestTemp() + getFileSep() + name;
+   RinexMetStream s(file.c_str(), ios::out|ios::trunc);
+   s << header;
+   vector<int> k;
+   for (int i = 0; i < n; i++)
+      if (i % mod == rem)
+         k.push_back(i);
+   if (unsorted && k.size() > 1)
+      swap(k[0], k[1]);
+   for (size_t i = 0; i < k.size(); i++)
+   {
+      RinexMetData data(record);
+      data.time = record.time + 30.0*k[i];
+      RinexMetData::RinexMetMap::iterator itr;
+      for (itr = data.data.begin(); itr != data.data.end(); itr++)
+         itr->second += 0.1 * (k[i] % 100);
+      s << data;
+   }
+   return file;
+}
+
+vector<string> FileFilterFrame_T::writeFiles(const string& name, int n)
+{
+   vector<string> files;
+   files.push_back(writeFile(name + "_even.m", n, 2, 0));
+   files.push_back(writeFile(name + "_odd.m", n, 2, 1));
+   files.push_back(writeFile(name + "_three.m", n, 3, 0));
+   return files;
+}
+
+list<RinexMetData> FileFilterFrame_T::sortMerge(const vector<string>& files)
+{
+   FFF fff(files);
+   RinexMetHeaderTouchHeaderMerge merged;
+   fff.touchHeader(merged);
+   fff.sort(RinexMetDataOperatorLessThanFull(merged.obsSet));
+   fff.unique(RinexMetDataOperatorEqualsSimple());
+   return fff.getData();
+}
+
+list<RinexMetData> FileFilterFrame_T::streamMerge(const vector<string>& files)
+{
+   FFF::StreamList streams;
+   list<RinexMetHeader> headers;
+   FFF::openStreams(files, streams, headers);
+   RinexMetHeaderTouchHeaderMerge merged;
+   for (const auto& h : headers)
+      merged(h);
+
+   list<RinexMetData> out;
+   auto keep = [&out](const RinexMetData& d) { out.push_back(d); };
+   FFF::mergeStreams(streams, RinexMetDataOperatorLessThanFull(merged.obsSet),
+                     RinexMetDataOperatorEqualsSimple(), keep);
+   return out;
+}
+
+bool FileFilterFrame_T::sameData(const list<RinexMetData>& l,
+                                 const list<RinexMetData>& r)
+{
+   if (l.size() != r.size())
+      return false;
+   list<RinexMetData>::const_iterator li = l.begin(), ri = r.begin();
+   for (; li != l.end(); li++, ri++)
+      if (li->time != ri->time || li->data != ri->data)
+         return false;
+   return true;
+}
+
+long FileFilterFrame_T::maxRSS()
+{
+#ifndef _WIN32
+   struct rusage ru;
+   if (getrusage(RUSAGE_SELF, &ru) == 0)
+      return ru.ru_maxrss;
+#endif
+   return 0;
+}
+
+int FileFilterFrame_T::testMerge()
+{
+   TUDEF("FileFilterFrame", "mergeStreams");
+
+   vector<string> files = writeFiles("FileFilterFrame_merge", 600);
+   list<RinexMetData> expected = sortMerge(files);
+   TUASSERTE(size_t, 600, expected.size());
+
+      // same result whatever the order of the files
+   TUASSERT(sameData(expected, streamMerge(files)));
+   reverse(files.begin(), files.end());
+   TUASSERT(sameData(expected, streamMerge(files)));
+
+      // one file merged with itself is unchanged
+   vector<string> same(2, files[0]);
+   TUASSERT(sameData(sortMerge(same), streamMerge(same)));
+   TUASSERTE(size_t, 200, streamMerge(same).size());
+
+      // mergeFiles() writes the records without the header
+   string out = getPathTestTemp() + getFileSep() + "FileFilterFrame_merge.m";
+   {
+      RinexMetStream s(out.c_str(), ios::out|ios::trunc);
+      s << header;
+      unsigned long n = FFF::mergeFiles(files, s,
+                                        RinexMetDataOperatorLessThanSimple(),
+                                        RinexMetDataOperatorEqualsSimple());
+      TUASSERTE(unsigned long, 600, n);
+   }
+   FFF merged(out);
+   TUASSERT(sameData(expected, merged.getData()));
+
+   TURETURN();
+}
+
+int FileFilterFrame_T::testDiff()
+{
+   TUDEF("FileFilterFrame", "diffStreams");
+
+   string odd = writeFile("FileFilterFrame_diff_odd.m", 600, 2, 1);
+   string three = writeFile("FileFilterFrame_diff_three.m", 600, 3, 0);
+   set<RinexMetHeader::RinexMetType> obsSet(header.obsTypeList.begin(),
+                                            header.obsTypeList.end());
+   RinexMetDataOperatorLessThanFull comp(obsSet);
+
+      // in memory
+   FFF ff1(odd), ff2(three);
+   pair< list<RinexMetData>, list<RinexMetData> > expected =
+      ff1.diff(ff2, comp);
+
+      // streaming
+   RinexMetStream s1(odd.c_str()), s2(three.c_str());
+   RinexMetHeader h1, h2;
+   s1 >> h1;
+   s2 >> h2;
+   list<RinexMetData> left, right;
+   auto leftOnly = [&left](const RinexMetData& d) { left.push_back(d); };
+   auto rightOnly = [&right](const RinexMetData& d) { right.push_back(d); };
+   unsigned long n = FFF::diffStreams(s1, s2, comp, leftOnly, rightOnly);
+
+   TUASSERTE(size_t, 200, expected.first.size());
+   TUASSERTE(size_t, 100, expected.second.size());
+   TUASSERTE(unsigned long, 300, n);
+   TUASSERT(sameData(expected.first, left));
+   TUASSERT(sameData(expected.second, right));
+
+   TURETURN();
+}
+
+int FileFilterFrame_T::testUnsorted()
+{
+   TUDEF("FileFilterFrame", "mergeStreams");
+
+   vector<string> files;
+   files.push_back(writeFile("FileFilterFrame_unsorted.m", 100, 1, 0, true));
+   TUTHROW(streamMerge(files));
+
+      // with the sorted flag the merge stops without an exception
+   for (int pass = 0; pass < 2; pass++)
+   {
+      vector<string> inputs(files);
+      if (pass)
+         inputs = writeFiles("FileFilterFrame_sorted", 100);
+      FFF::StreamList streams;
+      list<RinexMetHeader> headers;
+      FFF::openStreams(inputs, streams, headers);
+      unsigned long n = 0;
+      auto count = [&n](const RinexMetData& d) { n++; };
+      bool sorted = !pass;
+      unsigned long rv = FFF::mergeStreams(
+         streams, RinexMetDataOperatorLessThanSimple(),
+         RinexMetDataOperatorEqualsSimple(), count, sorted);
+      TUASSERTE(bool, pass == 1, sorted);
+      TUASSERTE(unsigned long, n, rv);
+      if (pass)
+         TUASSERTE(unsigned long, 100UL, n);
+   }
+
+   TURETURN();
+}
+
+int FileFilterFrame_T::testMemory()
+{
+   TUDEF("FileFilterFrame", "mergeStreams");
+
+      // the streaming merge holds one record per file, so its peak
+      // memory does not grow with the size of the files
+   int sizes[] = { 4000, 16000, 64000 };
+   long rss[3];
+   for (int i = 0; i < 3; i++)
+   {
+      vector<string> files = writeFiles("FileFilterFrame_memory", sizes[i]);
+      clock_t start = clock();
+      FFF::StreamList streams;
+      list<RinexMetHeader> headers;
+      FFF::openStreams(files, streams, headers);
+      unsigned long n = 0;
+      auto count = [&n](const RinexMetData& d) { n++; };
+      FFF::mergeStreams(streams, RinexMetDataOperatorLessThanSimple(),
+                        RinexMetDataOperatorEqualsSimple(), count);
+      rss[i] = maxRSS();
+      cout << "streaming merge of " << sizes[i] << " records: "
+           << double(clock()-start)/CLOCKS_PER_SEC << " s, peak memory "
+           << rss[i] << " kB" << endl;
+      TUASSERTE(unsigned long, (unsigned long)sizes[i], n);
+   }
+
+      // the in-memory merge, for comparison
+   vector<string> files = writeFiles("FileFilterFrame_memory", sizes[2]);
+   clock_t start = clock();
+   TUASSERTE(size_t, (size_t)sizes[2], sortMerge(files).size());
+   cout << "in-memory merge of " << sizes[2] << " records: "
+        << double(clock()-start)/CLOCKS_PER_SEC << " s, peak memory "
+        << maxRSS() << " kB" << endl;
+
+   if (rss[0] > 0)
+      TUASSERT(rss[2] - rss[0] < 2048);
+
+   TURETURN();
+}
+
+int main()
+{
+   int errorTotal = 0;
+   FileFilterFrame_T testClass;
+
+   errorTotal += testClass.testMerge();
+   errorTotal += testClass.testDiff();
+   errorTotal += testClass.testUnsorted();
+   errorTotal += testClass.testMemory();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
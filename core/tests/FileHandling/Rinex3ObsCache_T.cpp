@@ -0,0 +1,397 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "Rinex3ObsCache.hpp"
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsCache_T
+{
+public:
+   Rinex3ObsCache_T();
+
+      /// write caches, read them back and compare with the text
+   int roundTripTest();
+      /// seekTime() and rewind()
+   int seekTest();
+      /// corrupt and misused cache files
+   int errorTest();
+      /// report the speed of reading the text and the cache
+   int speedTest();
+
+private:
+      /// Read all the records of fn with a Rinex3ObsStream.
+   void readAll(const string& fn, Rinex3ObsHeader& hdr,
+                vector<Rinex3ObsData>& recs);
+      /// Count the differences between two records.
+   int countDiffs(const Rinex3ObsData& a, const Rinex3ObsData& b);
+      /** Copy the RINEX file fn to a temporary file, with an event
+       * record (epoch flag 4) inserted before its second epoch.
+       * @return the name of the new file */
+   string addEvent(const string& fn, const string& tempName);
+      /// Return the contents of a file.
+   string slurp(const string& fn);
+
+   string dataPath, tempPath;
+   vector<string> files;
+};
+
+
+Rinex3ObsCache_T ::
+Rinex3ObsCache_T()
+{
+   dataPath = getPathData() + getFileSep();
+   tempPath = getPathTestTemp() + getFileSep();
+   files.push_back(dataPath + "test_input_rinex3_76193040.14o");
+   files.push_back(dataPath + "arlm200a.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_RinexObsFile.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_SystemMixed.15o");
+   files.push_back(dataPath + "test_input_rinex2_obs_RinexObsFile.06o");
+   files.push_back(dataPath + "test_input_rinex2_obs_SystemGlonass.06o");
+   files.push_back(addEvent(files[2], "Rinex3ObsCache_event.15o"));
+   files.push_back(addEvent(files[4], "Rinex3ObsCache_event.06o"));
+}
+
+
+string Rinex3ObsCache_T ::
+slurp(const string& fn)
+{
+   ifstream ifs(fn.c_str(), ios::in | ios::binary);
+   stringstream ss;
+   ss << ifs.rdbuf();
+   return ss.str();
+}
+
+
+string Rinex3ObsCache_T ::
+addEvent(const string& fn, const string& tempName)
+{
+   string text(slurp(fn)), out(tempPath + tempName);
+   bool v3(text.find("> ") != string::npos);
+   size_t pos = text.find('\n', text.find("END OF HEADER")) + 1;
+      // second epoch line; copy the time of the first
+   string first(text.substr(pos, text.find('\n', pos) - pos));
+   pos = v3 ? text.find("\n>", pos) + 1 : text.find("\n" + first.substr(0,3),
+                                                    pos + 1) + 1;
+   ostringstream event;
+   event << first.substr(0, v3 ? 31 : 28) << "4  1" << endl
+         << left << setw(60) << "cache test event" << "COMMENT" << endl;
+   ofstream ofs(out.c_str(), ios::out | ios::binary);
+   ofs << text.substr(0, pos) << event.str() << text.substr(pos);
+   return out;
+}
+
+
+void Rinex3ObsCache_T ::
+readAll(const string& fn, Rinex3ObsHeader& hdr, vector<Rinex3ObsData>& recs)
+{
+   recs.clear();
+   Rinex3ObsStream strm(fn.c_str());
+   strm.exceptions(fstream::failbit);
+   strm >> hdr;
+   Rinex3ObsData rod;
+   while(strm >> rod)
+      recs.push_back(rod);
+}
+
+
+int Rinex3ObsCache_T ::
+countDiffs(const Rinex3ObsData& a, const Rinex3ObsData& b)
+{
+   int n(0);
+   if(a.time != b.time || a.time.getTimeSystem() != b.time.getTimeSystem())
+      n++;
+   if(a.epochFlag != b.epochFlag || a.numSVs != b.numSVs ||
+      a.clockOffset != b.clockOffset || a.obs.size() != b.obs.size())
+      n++;
+   Rinex3ObsData::DataMap::const_iterator ia, ib;
+   for(ia = a.obs.begin(), ib = b.obs.begin();
+       n == 0 && ia != a.obs.end(); ++ia, ++ib)
+   {
+      if(ia->first != ib->first || ia->second.size() != ib->second.size())
+      {
+         n++;
+         break;
+      }
+      for(size_t i = 0; i < ia->second.size(); i++)
+      {
+         const RinexDatum& da(ia->second[i]), db(ib->second[i]);
+         if(da.data != db.data || da.lli != db.lli || da.ssi != db.ssi ||
+            da.dataBlank != db.dataBlank || da.lliBlank != db.lliBlank ||
+            da.ssiBlank != db.ssiBlank)
+            n++;
+      }
+   }
+   if(a.auxHeader.valid != b.auxHeader.valid ||
+      a.auxHeader.commentList != b.auxHeader.commentList)
+      n++;
+   return n;
+}
+
+
+int Rinex3ObsCache_T ::
+roundTripTest()
+{
+   TUDEF("Rinex3ObsCache", "write");
+   for(size_t f = 0; f < files.size(); f++)
+   {
+      try
+      {
+         Rinex3ObsHeader textHdr, cacheHdr;
+         vector<Rinex3ObsData> textRecs, cacheRecs;
+         readAll(files[f], textHdr, textRecs);
+
+         string cfn(tempPath + "Rinex3ObsCache_" +
+                    StringUtils::asString(f) + ".bin");
+         TUASSERTE(size_t, textRecs.size(),
+                   Rinex3ObsCache::convert(files[f], cfn));
+
+         TUCSM("getRecord");
+         readAll(cfn, cacheHdr, cacheRecs);
+         TUASSERTE(double, textHdr.version, cacheHdr.version);
+         TUASSERTE(string, textHdr.markerName, cacheHdr.markerName);
+         TUASSERT(textHdr.mapObsTypes == cacheHdr.mapObsTypes);
+         TUASSERTE(size_t, textRecs.size(), cacheRecs.size());
+         int nDiff(0);
+         for(size_t i = 0; i < textRecs.size() && i < cacheRecs.size(); i++)
+            nDiff += countDiffs(textRecs[i], cacheRecs[i]);
+         TUASSERTE(int, 0, nDiff);
+
+            // the cache is attached by reading the header
+         Rinex3ObsStream strm(cfn.c_str());
+         Rinex3ObsData rod;
+         strm >> strm.header;
+         TUASSERT(bool(strm.obsCache));
+         strm >> rod;
+         TUASSERTE(size_t, textRecs.size(), strm.obsCache->size());
+         Rinex3ObsStream text(files[f].c_str());
+         text >> text.header;
+         TUASSERT(!text.obsCache);
+         TUCSM("write");
+      }
+      catch(Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception for " + files[f]);
+      }
+   }
+
+      // the event records were kept
+   try
+   {
+      Rinex3ObsHeader hdr;
+      vector<Rinex3ObsData> recs;
+      readAll(tempPath + "Rinex3ObsCache_6.bin", hdr, recs);
+      TUASSERT(recs.size() > 2);
+      TUASSERTE(short, 4, recs[1].epochFlag);
+      TUASSERTE(size_t, 1, recs[1].auxHeader.commentList.size());
+
+         // blank fields are not stored
+      size_t textSize(slurp(files[1]).size()),
+         cacheSize(slurp(tempPath + "Rinex3ObsCache_1.bin").size());
+      TUASSERT(cacheSize < textSize);
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsCache_T ::
+seekTest()
+{
+   TUDEF("Rinex3ObsCache", "seekTime");
+   try
+   {
+      string cfn(tempPath + "Rinex3ObsCache_seek.bin");
+      Rinex3ObsCache::convert(files[6], cfn);
+      Rinex3ObsHeader hdr;
+      vector<Rinex3ObsData> recs;
+      readAll(files[6], hdr, recs);
+
+      Rinex3ObsStream strm(cfn.c_str());
+      strm.exceptions(fstream::failbit);
+      strm >> strm.header;
+      Rinex3ObsData rod;
+      for(size_t i = recs.size(); i > 0; i--)
+      {
+            // the event shares the time of the first epoch
+         size_t first(i-1 == 1 ? 0 : i-1);
+         TUASSERT(strm.obsCache->seekTime(strm, recs[i-1].time));
+         int nDiff(0), nRec(0);
+         for(size_t j = first; strm >> rod; j++, nRec++)
+            nDiff += countDiffs(recs[j], rod);
+         TUASSERTE(int, recs.size() - first, nRec);
+         TUASSERTE(int, 0, nDiff);
+      }
+
+      TUASSERT(!strm.obsCache->seekTime(strm,
+                                        recs.back().time + 1));
+      TUASSERT(!(strm >> rod));
+
+      TUCSM("rewind");
+      strm.obsCache->rewind();
+      strm.clear();
+      int nRec(0);
+      while(strm >> rod)
+         nRec++;
+      TUASSERTE(int, recs.size(), nRec);
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsCache_T ::
+errorTest()
+{
+   TUDEF("Rinex3ObsCache", "getRecord");
+   try
+   {
+      string cfn(tempPath + "Rinex3ObsCache_0.bin"),
+         bad(tempPath + "Rinex3ObsCache_bad.bin");
+      string data(slurp(cfn));
+      {
+         ofstream ofs(bad.c_str(), ios::out | ios::binary);
+         ofs << data.substr(0, data.size() - 100);
+      }
+
+         // a truncated table is an error, not the end of the file
+      Rinex3ObsStream strm(bad.c_str());
+      strm.exceptions(fstream::failbit);
+      strm >> strm.header;
+      Rinex3ObsData rod;
+      TUTHROW(strm >> rod);
+
+         // the mapped reader is for text only
+      TUCSM("Rinex3ObsMappedReader");
+      TUTHROW(Rinex3ObsMappedReader rdr(cfn));
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsCache_T ::
+speedTest()
+{
+   TUDEF("Rinex3ObsCache", "getRecord");
+   try
+   {
+         // a day's worth of a file
+      string text(slurp(files[0]));
+      size_t pos = text.find('\n', text.find("END OF HEADER")) + 1;
+      string fn(tempPath + "Rinex3ObsCache_speed.14o"),
+         cfn(tempPath + "Rinex3ObsCache_speed.bin");
+      {
+         ofstream ofs(fn.c_str(), ios::out | ios::binary);
+         ofs << text.substr(0, pos);
+         for(int j = 0; j < 20; j++)
+            ofs << text.substr(pos);
+      }
+      Rinex3ObsCache::convert(fn, cfn);
+
+      const string *fns[] = { &fn, &cfn };
+      double secs[2];
+      size_t nrecs[2];
+      for(int t = 0; t < 2; t++)
+      {
+         chrono::steady_clock::time_point start(chrono::steady_clock::now());
+         Rinex3ObsStream strm(fns[t]->c_str());
+         Rinex3ObsData rod;
+         strm >> strm.header;
+         for(nrecs[t] = 0; strm >> rod; nrecs[t]++)
+            ;
+         secs[t] = chrono::duration<double>(chrono::steady_clock::now()
+                                            - start).count();
+      }
+
+      TUASSERTE(size_t, nrecs[0], nrecs[1]);
+      cout << "Read " << nrecs[0] << " records: text " << secs[0]
+           << " s (" << slurp(fn).size() << " bytes), cache " << secs[1]
+           << " s (" << slurp(cfn).size() << " bytes)" << endl;
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorTotal = 0;
+   Rinex3ObsCache_T testClass;
+
+   errorTotal += testClass.roundTripTest();
+   errorTotal += testClass.seekTest();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.speedTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
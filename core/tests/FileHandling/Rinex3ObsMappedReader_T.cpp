@@ -0,0 +1,393 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+
+#include "Rinex3ObsMappedReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <ctime>
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsMappedReader_T
+{
+public:
+   Rinex3ObsMappedReader_T();
+
+      /// read files with both readers and compare every record
+   int compareTest();
+      /// findEpochs(), seek() and rewind()
+   int seekTest();
+      /// invalid files and records
+   int exceptionTest();
+      /// report the throughput of both readers on a large file
+   int throughputTest();
+
+private:
+      /// Read all the records of fn with a Rinex3ObsStream.
+   void readStream(const string& fn, vector<Rinex3ObsData>& recs);
+      /// Count the differences between two records.
+   int countDiffs(const Rinex3ObsData& a, const Rinex3ObsData& b);
+      /// Split the text of fn into header and data.
+   void splitFile(const string& fn, string& hdr, string& data);
+
+   string dataPath, tempPath;
+   vector<string> files;
+};
+
+
+Rinex3ObsMappedReader_T ::
+Rinex3ObsMappedReader_T()
+{
+   dataPath = getPathData() + getFileSep();
+   tempPath = getPathTestTemp() + getFileSep();
+   files.push_back(dataPath + "test_input_rinex3_76193040.14o");
+   files.push_back(dataPath + "test_input_rinex3_obs_RinexObsFile.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_SystemMixed.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_FilterTest2.15o");
+}
+
+
+void Rinex3ObsMappedReader_T ::
+readStream(const string& fn, vector<Rinex3ObsData>& recs)
+{
+   Rinex3ObsStream strm(fn.c_str());
+   Rinex3ObsData rod;
+   strm >> strm.header;
+   recs.clear();
+   while(strm >> rod)
+      recs.push_back(rod);
+}
+
+
+int Rinex3ObsMappedReader_T ::
+countDiffs(const Rinex3ObsData& a, const Rinex3ObsData& b)
+{
+   int n(0);
+   if(a.time != b.time || a.time.getTimeSystem() != b.time.getTimeSystem())
+      n++;
+   if(a.epochFlag != b.epochFlag || a.numSVs != b.numSVs ||
+      a.clockOffset != b.clockOffset || a.obs.size() != b.obs.size())
+      n++;
+   Rinex3ObsData::DataMap::const_iterator ia, ib;
+   for(ia = a.obs.begin(), ib = b.obs.begin();
+       n == 0 && ia != a.obs.end(); ++ia, ++ib)
+   {
+      if(ia->first != ib->first || ia->second.size() != ib->second.size())
+      {
+         n++;
+         break;
+      }
+      for(size_t i = 0; i < ia->second.size(); i++)
+      {
+         const RinexDatum& da(ia->second[i]), db(ib->second[i]);
+         if(da.data != db.data || da.lli != db.lli || da.ssi != db.ssi ||
+            da.dataBlank != db.dataBlank || da.lliBlank != db.lliBlank ||
+            da.ssiBlank != db.ssiBlank)
+            n++;
+      }
+   }
+   if(a.auxHeader.valid != b.auxHeader.valid ||
+      a.auxHeader.commentList != b.auxHeader.commentList)
+      n++;
+   return n;
+}
+
+
+void Rinex3ObsMappedReader_T ::
+splitFile(const string& fn, string& hdr, string& data)
+{
+   ifstream ifs(fn.c_str(), ios::in | ios::binary);
+   stringstream ss;
+   ss << ifs.rdbuf();
+   string text(ss.str());
+   size_t pos = text.find("END OF HEADER");
+   pos = text.find('\n', pos) + 1;
+   hdr = text.substr(0, pos);
+   data = text.substr(pos);
+}
+
+
+int Rinex3ObsMappedReader_T ::
+compareTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "getRecord");
+   try
+   {
+      vector<string> fns(files);
+
+         // add an event record with an auxiliary header, and a file
+         // with DOS line endings and no final newline
+      string hdr, data;
+      splitFile(files[1], hdr, data);
+      string fnAux(tempPath + "Rinex3ObsMappedReader_Aux.15o");
+      {
+         ofstream ofs(fnAux.c_str(), ios::out | ios::binary);
+         ofs << hdr << data
+             << ">                              4  1\n"
+             << left << setw(60) << "mapped reader test" << "COMMENT\n"
+             << data;
+      }
+      fns.push_back(fnAux);
+
+      string fnDOS(tempPath + "Rinex3ObsMappedReader_DOS.15o");
+      {
+         string text(hdr + data), dos;
+         for(size_t i = 0; i < text.size(); i++)
+         {
+            if(text[i] == '\n') dos += '\r';
+            dos += text[i];
+         }
+         dos.erase(dos.size()-2);
+         ofstream ofs(fnDOS.c_str(), ios::out | ios::binary);
+         ofs << dos;
+      }
+      fns.push_back(fnDOS);
+
+      for(size_t f = 0; f < fns.size(); f++)
+      {
+         vector<Rinex3ObsData> recs;
+         readStream(fns[f], recs);
+         TUASSERT(recs.size() > 0);
+
+         Rinex3ObsMappedReader rdr(fns[f]);
+         Rinex3ObsStream strm(fns[f].c_str());
+         strm >> strm.header;
+         TUASSERTE(double, strm.header.version, rdr.header.version);
+         TUASSERT(strm.header.mapObsTypes == rdr.header.mapObsTypes);
+         TUASSERTE(TimeSystem, strm.timesystem, rdr.timesystem);
+
+         Rinex3ObsData rod;
+         size_t n(0);
+         int nDiff(0);
+         while(rdr.getRecord(rod))
+         {
+            if(n < recs.size())
+               nDiff += countDiffs(recs[n], rod);
+            n++;
+         }
+         TUASSERTE(size_t, recs.size(), n);
+         TUASSERTE(int, 0, nDiff);
+         TUASSERTE(size_t, rdr.size(), rdr.tell());
+      }
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsMappedReader_T ::
+seekTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "findEpochs");
+   try
+   {
+      vector<Rinex3ObsData> recs;
+      readStream(files[0], recs);
+
+      Rinex3ObsMappedReader rdr(files[0]);
+      vector<size_t> epochs(rdr.findEpochs());
+      TUASSERTE(size_t, recs.size(), epochs.size());
+      TUASSERTE(size_t, rdr.tell(), epochs[0]);
+
+         // read backwards
+      Rinex3ObsData rod;
+      int nDiff(0);
+      for(size_t i = epochs.size(); i-- > 0; )
+      {
+         rdr.seek(epochs[i]);
+         TUASSERT(rdr.getRecord(rod));
+         nDiff += countDiffs(recs[i], rod);
+         TUASSERTE(size_t, (i+1 < epochs.size() ? epochs[i+1] : rdr.size()),
+                   rdr.tell());
+      }
+      TUASSERTE(int, 0, nDiff);
+
+      rdr.rewind();
+      TUASSERT(rdr.getRecord(rod));
+      TUASSERTE(int, 0, countDiffs(recs[0], rod));
+
+      TUCSM("seek");
+      TUTHROW(rdr.seek(0));
+      TUTHROW(rdr.seek(rdr.size()+1));
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsMappedReader_T ::
+exceptionTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "open");
+
+   TUTHROW(Rinex3ObsMappedReader(dataPath + "no_such_file.15o"));
+      // RINEX 2
+   TUTHROW(Rinex3ObsMappedReader(dataPath + "arlm200a.15o"));
+   TUTHROW(Rinex3ObsMappedReader(dataPath +
+                                 "test_input_rinex3_obs_IncompleteHeader.15o"));
+
+   TUCSM("getRecord");
+   const char *bad[] = { "test_input_rinex3_obs_BadEpochFlag.15o",
+                         "test_input_rinex3_obs_InvalidTimeFormat.15o" };
+   for(size_t f = 0; f < 2; f++)
+   {
+      try
+      {
+         string fn(dataPath + bad[f]);
+
+            // the stream stops at the same record
+         vector<Rinex3ObsData> recs;
+         readStream(fn, recs);
+
+         Rinex3ObsMappedReader rdr(fn);
+         Rinex3ObsData rod;
+         size_t n(0), pos(0);
+         try
+         {
+            while(rdr.getRecord(rod))
+               n++;
+            TUFAIL("Bad record was read");
+         }
+         catch(FFStreamError& e)
+         {
+            TUPASS("Bad record");
+         }
+         TUASSERTE(size_t, recs.size(), n);
+
+            // the read position is unchanged
+         pos = rdr.tell();
+         TUTHROW(rdr.getRecord(rod));
+         TUASSERTE(size_t, pos, rdr.tell());
+      }
+      catch(Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsMappedReader_T ::
+throughputTest()
+{
+   TUDEF("Rinex3ObsMappedReader", "getRecord");
+   try
+   {
+         // a large file: the data repeated
+      string hdr, data;
+      splitFile(files[0], hdr, data);
+      string fn(tempPath + "Rinex3ObsMappedReader_Large.14o");
+      {
+         ofstream ofs(fn.c_str(), ios::out | ios::binary);
+         ofs << hdr;
+         for(int i = 0; i < 50; i++)
+            ofs << data;
+      }
+
+      Rinex3ObsData rod;
+      size_t nstrm(0), nmap(0);
+      double size;
+
+      clock_t start = clock();
+      {
+         Rinex3ObsStream strm(fn.c_str());
+         strm >> strm.header;
+         while(strm >> rod)
+            nstrm++;
+      }
+      double tstrm = double(clock()-start)/CLOCKS_PER_SEC;
+
+      start = clock();
+      {
+         Rinex3ObsMappedReader rdr(fn);
+         size = rdr.size()/1.e6;
+         while(rdr.getRecord(rod))
+            nmap++;
+      }
+      double tmap = double(clock()-start)/CLOCKS_PER_SEC;
+
+      TUASSERTE(size_t, nstrm, nmap);
+      cout << "Read " << size << " MB: Rinex3ObsStream "
+           << (tstrm > 0 ? size/tstrm : 0) << " MB/s, Rinex3ObsMappedReader "
+           << (tmap > 0 ? size/tmap : 0) << " MB/s" << endl;
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorTotal = 0;
+   Rinex3ObsMappedReader_T testClass;
+
+   errorTotal += testClass.compareTest();
+   errorTotal += testClass.seekTest();
+   errorTotal += testClass.exceptionTest();
+   errorTotal += testClass.throughputTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
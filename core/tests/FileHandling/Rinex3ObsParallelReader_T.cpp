@@ -0,0 +1,310 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "Rinex3ObsParallelReader.hpp"
+#include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsData.hpp"
+
+#include "build_config.h"
+
+#include "TestUtil.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsParallelReader_T
+{
+public:
+   Rinex3ObsParallelReader_T();
+
+      /// read files with threads and with a stream, and compare
+   int compareTest();
+      /// order of getFile(), and early destruction
+   int orderTest();
+      /// report the speed of reading many files with 1 and N threads
+   int throughputTest();
+
+private:
+      /** Read all the records of fn with a Rinex3ObsStream, as
+       * Rinex3ObsParallelReader promises to.
+       * @return 0 if not opened, 1 if the header failed, 2 if the
+       *   data failed, 3 if all was read */
+   int readStream(const string& fn, vector<Rinex3ObsData>& recs);
+      /// Count the differences between two records.
+   int countDiffs(const Rinex3ObsData& a, const Rinex3ObsData& b);
+
+   string dataPath, tempPath;
+   vector<string> files;
+};
+
+
+Rinex3ObsParallelReader_T ::
+Rinex3ObsParallelReader_T()
+{
+   dataPath = getPathData() + getFileSep();
+   tempPath = getPathTestTemp() + getFileSep();
+   files.push_back(dataPath + "test_input_rinex3_76193040.14o");
+   files.push_back(dataPath + "test_input_rinex3_obs_RinexObsFile.15o");
+   files.push_back(dataPath + "arlm200a.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_SystemMixed.15o");
+   files.push_back(dataPath + "no_such_file.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_BadEpochFlag.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_IncompleteHeader.15o");
+   files.push_back(dataPath + "test_input_rinex3_obs_FilterTest2.15o");
+}
+
+
+int Rinex3ObsParallelReader_T ::
+readStream(const string& fn, vector<Rinex3ObsData>& recs)
+{
+   recs.clear();
+   Rinex3ObsStream strm(fn.c_str());
+   if(!strm.is_open())
+      return 0;
+   strm.exceptions(fstream::failbit);
+   try
+   {
+      strm >> strm.header;
+   }
+   catch(Exception& e)
+   {
+      return 1;
+   }
+   try
+   {
+      Rinex3ObsData rod;
+      while(strm >> rod)
+         recs.push_back(rod);
+   }
+   catch(Exception& e)
+   {
+      return 2;
+   }
+   return 3;
+}
+
+
+int Rinex3ObsParallelReader_T ::
+countDiffs(const Rinex3ObsData& a, const Rinex3ObsData& b)
+{
+   int n(0);
+   if(a.time != b.time || a.time.getTimeSystem() != b.time.getTimeSystem())
+      n++;
+   if(a.epochFlag != b.epochFlag || a.numSVs != b.numSVs ||
+      a.clockOffset != b.clockOffset || a.obs.size() != b.obs.size())
+      n++;
+   Rinex3ObsData::DataMap::const_iterator ia, ib;
+   for(ia = a.obs.begin(), ib = b.obs.begin();
+       n == 0 && ia != a.obs.end(); ++ia, ++ib)
+   {
+      if(ia->first != ib->first || ia->second.size() != ib->second.size())
+      {
+         n++;
+         break;
+      }
+      for(size_t i = 0; i < ia->second.size(); i++)
+      {
+         const RinexDatum& da(ia->second[i]), db(ib->second[i]);
+         if(da.data != db.data || da.lli != db.lli || da.ssi != db.ssi ||
+            da.dataBlank != db.dataBlank || da.lliBlank != db.lliBlank ||
+            da.ssiBlank != db.ssiBlank)
+            n++;
+      }
+   }
+   if(a.auxHeader.valid != b.auxHeader.valid ||
+      a.auxHeader.commentList != b.auxHeader.commentList)
+      n++;
+   return n;
+}
+
+
+int Rinex3ObsParallelReader_T ::
+compareTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "getFile");
+
+      // small chunks, so that each file is split among the threads
+   const unsigned nthreads[] = { 1, 3, 8 };
+   const unsigned chunks[] = { 256, 7, 1 };
+   for(size_t t = 0; t < 3; t++)
+   {
+      try
+      {
+         Rinex3ObsParallelReader rdr(files, nthreads[t], chunks[t]);
+         TUASSERTE(size_t, files.size(), rdr.numFiles());
+         TUASSERTE(size_t, nthreads[t], rdr.numThreads());
+
+         for(size_t f = 0; f < files.size(); f++)
+         {
+            vector<Rinex3ObsData> recs;
+            int state(readStream(files[f], recs));
+
+            Rinex3ObsParallelReader::FileData& fd(rdr.getFile(f));
+            TUASSERTE(string, files[f], fd.fileName);
+            TUASSERTE(bool, state > 0, fd.opened);
+            TUASSERTE(bool, state > 1, fd.headerRead);
+            TUASSERTE(bool, state == 1 || state == 2, fd.failed);
+            TUASSERTE(size_t, recs.size(), fd.size());
+
+            int nDiff(0);
+            for(size_t i = 0; i < recs.size() && i < fd.size(); i++)
+               nDiff += countDiffs(recs[i], fd[i]);
+            TUASSERTE(int, 0, nDiff);
+         }
+      }
+      catch(Exception& e)
+      {
+         cerr << e << endl;
+         TUFAIL("Unexpected exception");
+      }
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsParallelReader_T ::
+orderTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "getFile");
+   try
+   {
+      vector<Rinex3ObsData> recs;
+      readStream(files[3], recs);
+
+      Rinex3ObsParallelReader rdr(files, 4, 16);
+         // skip some files
+      Rinex3ObsParallelReader::FileData& fd(rdr.getFile(3));
+      TUASSERTE(size_t, recs.size(), fd.size());
+      TUASSERT(&fd == &rdr.getFile(3));
+      TUTHROW(rdr.getFile(1));
+      TUTHROW(rdr.getFile(files.size()));
+
+         // destroy the reader while files remain
+      {
+         Rinex3ObsParallelReader early(files, 4, 1);
+         early.getFile(0);
+      }
+      TUPASS("destroyed early");
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsParallelReader_T ::
+throughputTest()
+{
+   TUDEF("Rinex3ObsParallelReader", "getFile");
+   try
+   {
+         // many copies of a file, as for a network of stations
+      ifstream ifs(files[0].c_str(), ios::in | ios::binary);
+      stringstream ss;
+      ss << ifs.rdbuf();
+      string text(ss.str());
+      size_t pos = text.find("END OF HEADER");
+      pos = text.find('\n', pos) + 1;
+      string hdr(text.substr(0, pos)), data(text.substr(pos));
+
+      vector<string> fns;
+      for(int i = 0; i < 16; i++)
+      {
+         ostringstream oss;
+         oss << tempPath << "Rinex3ObsParallelReader_" << i << ".14o";
+         fns.push_back(oss.str());
+         ofstream ofs(oss.str().c_str(), ios::out | ios::binary);
+         ofs << hdr;
+         for(int j = 0; j < 5; j++)
+            ofs << data;
+      }
+
+      unsigned ncores(thread::hardware_concurrency());
+      if(ncores < 2)
+         ncores = 2;
+      const unsigned nthreads[] = { 1, ncores };
+      double secs[2];
+      size_t nrecs[2];
+      for(int t = 0; t < 2; t++)
+      {
+         chrono::steady_clock::time_point start(chrono::steady_clock::now());
+         Rinex3ObsParallelReader rdr(fns, nthreads[t]);
+         nrecs[t] = 0;
+         for(size_t f = 0; f < fns.size(); f++)
+            nrecs[t] += rdr.getFile(f).size();
+         secs[t] = chrono::duration<double>(chrono::steady_clock::now()
+                                            - start).count();
+      }
+
+      TUASSERTE(size_t, nrecs[0], nrecs[1]);
+      cout << "Read " << fns.size() << " files, " << nrecs[0]
+           << " records: 1 thread " << secs[0] << " s, " << nthreads[1]
+           << " threads " << secs[1] << " s" << endl;
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorTotal = 0;
+   Rinex3ObsParallelReader_T testClass;
+
+   errorTotal += testClass.compareTest();
+   errorTotal += testClass.orderTest();
+   errorTotal += testClass.throughputTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
@@ -46,7 +46,12 @@
 
 #include "TestUtil.hpp"
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
 #include <string>
+#include <vector>
+#include <thread>
 
 using namespace std;
 using namespace gpstk;
@@ -83,6 +88,9 @@ public:
 
    int embeddedHeadersTest();
 
+      /// decode files in many threads at once, compare with serial
+   int concurrencyTest( void );
+
 private:
 
    string dataFilePath;
@@ -1102,6 +1110,140 @@ A 9080                                                      MARKER NAME
    TURETURN();
 }
 
+//------------------------------------------------------------
+// Read a whole file with a Rinex3ObsStream, and return the dump
+// of the header and every record.
+//------------------------------------------------------------
+static string decodeFile( const string& fn )
+{
+   ostringstream oss;
+   try
+   {
+      Rinex3ObsStream strm(fn.c_str());
+      strm.exceptions(fstream::failbit);
+      Rinex3ObsData rod;
+      strm >> strm.header;
+      strm.header.dump(oss);
+      while(strm >> rod)
+      {
+         oss << rod.epochFlag << " " << rod.time << " ";
+         rod.dump(oss);
+      }
+   }
+   catch(Exception& e)
+   {
+      oss << "exception " << e.getText(0) << endl;
+   }
+   return oss.str();
+}
+
+//------------------------------------------------------------
+// This test decodes many files in several threads at once and
+// compares the results with decoding them serially; stream
+// parsing must keep no state outside the stream.
+//------------------------------------------------------------
+int Rinex3Obs_T :: concurrencyTest( void )
+{
+   TUDEF("Rinex3ObsStream", "operator>>");
+   try
+   {
+      vector<string> fns;
+      fns.push_back(dataFilePath + file_sep + "test_input_rinex3_76193040.14o");
+      fns.push_back(dataFilePath + file_sep +
+                    "test_input_rinex3_obs_RinexObsFile.15o");
+      fns.push_back(dataFilePath + file_sep +
+                    "test_input_rinex3_obs_BadEpochFlag.15o");
+      fns.push_back(dataHeaderTest);
+
+         // RINEX 2 files at different times, beginning and ending with
+         // event records with no epoch, which take the epoch of the
+         // previous record in the same file
+      const char *v2[] = { "arlm200a.15o", "arlm200b.15o", "arlm200z.15o" };
+      for(int i = 0; i < 3; i++)
+      {
+         ifstream ifs((dataFilePath + file_sep + v2[i]).c_str());
+         stringstream ss;
+         ss << ifs.rdbuf();
+         string text(ss.str());
+         size_t pos(text.find("END OF HEADER"));
+         pos = text.find('\n', pos) + 1;
+
+         ostringstream event;
+         event << string(26, ' ') << "  4  1" << endl
+               << left << setw(60) << "concurrency test" << "COMMENT" << endl;
+
+         string fn(tempFilePath + file_sep + "Rinex3Obs_Concurrency_" + v2[i]);
+         ofstream ofs(fn.c_str());
+         ofs << text.substr(0, pos) << event.str() << text.substr(pos)
+             << event.str();
+         fns.push_back(fn);
+      }
+
+      vector<string> serial;
+      for(size_t f = 0; f < fns.size(); f++)
+         serial.push_back(decodeFile(fns[f]));
+
+         // each thread decodes all the files, starting at a different one
+      const int nthreads(8), npasses(3);
+      vector< vector<string> > results(nthreads, vector<string>(fns.size()));
+      vector<thread> threads;
+      for(int t = 0; t < nthreads; t++)
+      {
+         threads.push_back(thread([&fns, &results, t, npasses]()
+         {
+            for(int p = 0; p < npasses; p++)
+            {
+               for(size_t i = 0; i < fns.size(); i++)
+               {
+                  size_t f((i + t) % fns.size());
+                  results[t][f] = decodeFile(fns[f]);
+               }
+            }
+         }));
+      }
+      for(int t = 0; t < nthreads; t++)
+         threads[t].join();
+
+      int nDiff(0);
+      for(int t = 0; t < nthreads; t++)
+      {
+         for(size_t f = 0; f < fns.size(); f++)
+         {
+            if(results[t][f] != serial[f])
+               nDiff++;
+         }
+      }
+      TUASSERTE(int, 0, nDiff);
+
+         // the leading event record has no previous epoch, and the
+         // trailing one has the last epoch of its own file
+      for(int i = 0; i < 3; i++)
+      {
+         Rinex3ObsStream strm(fns[4+i].c_str());
+         Rinex3ObsData rod;
+         CommonTime last;
+         strm >> strm.header;
+         strm >> rod;
+         TUASSERTE(short, 4, rod.epochFlag);
+         TUASSERTE(CommonTime, CommonTime::BEGINNING_OF_TIME, rod.time);
+         while(strm >> rod)
+         {
+            if(rod.epochFlag == 4)
+               break;
+            last = rod.time;
+         }
+         TUASSERTE(short, 4, rod.epochFlag);
+         TUASSERTE(CommonTime, last, rod.time);
+      }
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
 int main()
 {
    int errorTotal = 0;
@@ -1113,6 +1255,7 @@ int main()
    errorTotal += testClass.filterOperatorsTest();
    errorTotal += testClass.roundTripTest();
    errorTotal += testClass.embeddedHeadersTest();
+   errorTotal += testClass.concurrencyTest();
 
       //Change to test v.3
    testClass.toRinex3();
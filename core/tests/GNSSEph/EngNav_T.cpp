@@ -41,6 +41,8 @@
 #include "TimeString.hpp"
 #include "GPSWeekSecond.hpp"
 #include <math.h>
+#include <cstdlib>
+#include "BinUtils.hpp"
 #include <iostream>
 
 using namespace std;
@@ -116,6 +118,42 @@ public:
       TURETURN();
    }
 
+      // Compare the table-driven parity with the bit counts of
+      // IS-GPS-200 table 20-XIV for many words and both values of
+      // D29* and D30*
+   unsigned computeParityWordsTest(void)
+   {
+      TUDEF("EngNav", "Compute Parity");
+
+      const uint32_t bmask[6] = { 0x3B1F3480, 0x1D8F9A40, 0x2EC7CD00,
+                                  0x1763E680, 0x2BB1F340, 0x0B7A89C0 };
+      srand(2020);
+      int bad = 0;
+      for (int n=0; n<20000; n++)
+      {
+         uint32_t sfword = ((uint32_t)rand() << 15 ^ rand()) & 0x3fffffff;
+         uint32_t psfword = n & 3;
+         for (int upright=0; upright<2; upright++)
+         {
+            uint32_t d29 = (psfword >> 1) & 1, d30 = psfword & 1;
+            uint32_t d = (d30 && !upright) ? ~sfword : sfword;
+            uint32_t expect = 0;
+            for (int k=0; k<6; k++)
+            {
+               uint32_t dstar = (k==1 || k==3 || k==4) ? d30 : d29;
+               expect |= ((dstar + gpstk::BinUtils::countBits(bmask[k] & d))
+                          % 2) << (5-k);
+            }
+            if (gpstk::EngNav::computeParity(sfword, psfword, upright!=0)
+                != expect)
+               bad++;
+         }
+      }
+      TUASSERTE(int, 0, bad);
+
+      TURETURN();
+   }
+
    unsigned fixParityTest(void)
    {
       TUDEF("EngNav", "Fix Parity");
@@ -450,6 +488,7 @@ int main() //Main function to initialize and run all tests above
    unsigned errorTotal = 0;
 
    errorTotal += testClass.computeParityTest();
+   errorTotal += testClass.computeParityWordsTest();
    errorTotal += testClass.fixParityTest();
    errorTotal += testClass.getHOWTimeTest();
    errorTotal += testClass.getSFIDTest();
@@ -45,6 +45,10 @@
 #include "Rinex3NavStream.hpp"
 #include "Rinex3NavData.hpp"
 #include "SatelliteSystem.hpp"
+#include <list>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
 
 using namespace std;
 
@@ -197,6 +201,276 @@ public:
    }
 
 
+      /** Compare getXvtBatch() with getXvt(), for sorted and
+       * unsorted times that run off both ends of the store. */
+   unsigned getXvtBatchTest()
+   {
+      TUDEF("GloEphemerisStore", "getXvtBatch");
+      try
+      {
+         gpstk::GloEphemerisStore store;
+         loadNav(store, testFramework, false);
+         vector<gpstk::CommonTime> times;
+         for (gpstk::CommonTime t = store.getInitialTime() - 1800.;
+              t <= store.getFinalTime() + 1800.; t += 450.)
+         {
+            times.push_back(t);
+         }
+         vector<gpstk::CommonTime> rtimes(times.rbegin(), times.rend());
+         set<gpstk::SatID> sats = store.getIndexSet();
+         sats.insert(gpstk::SatID(933, gpstk::SatelliteSystem::Glonass));
+
+         unsigned nTotal = 0;
+         vector<gpstk::Xvt> batch;
+         for (set<gpstk::SatID>::const_iterator it = sats.begin();
+              it != sats.end(); ++it)
+         {
+            unsigned n = store.getXvtBatch(*it, times, batch);
+            TUASSERTE(size_t, times.size(), batch.size());
+            TUASSERTE(unsigned, 0, countBatchErrors(store, *it, times, batch));
+            TUASSERTE(unsigned, countGood(store, *it, times), n);
+            nTotal += n;
+            n = store.getXvtBatch(*it, rtimes, batch);
+            TUASSERTE(unsigned, 0, countBatchErrors(store, *it, rtimes, batch));
+            TUASSERTE(unsigned, countGood(store, *it, rtimes), n);
+         }
+         TUASSERT(nTotal > 0);
+         TUASSERT(nTotal < sats.size() * times.size());
+
+         vector<gpstk::SatID> satv(sats.begin(), sats.end());
+         for (size_t i = 0; i < times.size(); i++)
+         {
+            unsigned nOK = 0;
+            unsigned n = store.getXvtBatch(satv, times[i], batch);
+            TUASSERTE(size_t, satv.size(), batch.size());
+            for (size_t j = 0; j < satv.size(); j++)
+            {
+               vector<gpstk::CommonTime> one(1, times[i]);
+               vector<gpstk::Xvt> single(1, batch[j]);
+               TUASSERTE(unsigned, 0,
+                         countBatchErrors(store, satv[j], one, single));
+               nOK += countGood(store, satv[j], one);
+            }
+            TUASSERTE(unsigned, nOK, n);
+         }
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /** Compare tryGetXvt() with getXvt(): it must fail exactly
+       * where getXvt() throws, and otherwise return the same Xvt. */
+   unsigned tryGetXvtTest()
+   {
+      TUDEF("GloEphemerisStore", "tryGetXvt");
+      try
+      {
+         gpstk::GloEphemerisStore store;
+         loadNav(store, testFramework, false);
+         vector<gpstk::CommonTime> times;
+         for (gpstk::CommonTime t = store.getInitialTime() - 1800.;
+              t <= store.getFinalTime() + 1800.; t += 450.)
+         {
+            times.push_back(t);
+         }
+         set<gpstk::SatID> sats = store.getIndexSet();
+         sats.insert(gpstk::SatID(933, gpstk::SatelliteSystem::Glonass));
+
+         unsigned nTotal = 0;
+         for (set<gpstk::SatID>::const_iterator it = sats.begin();
+              it != sats.end(); ++it)
+         {
+            vector<gpstk::Xvt> xvt(times.size());
+            unsigned n = 0;
+            for (size_t i = 0; i < times.size(); i++)
+            {
+               if (store.tryGetXvt(*it, times[i], xvt[i]))
+               {
+                  n++;
+               }
+               else
+               {
+                  xvt[i].health = gpstk::Xvt::HealthStatus::Unavailable;
+               }
+            }
+            TUASSERTE(unsigned, 0, countBatchErrors(store, *it, times, xvt));
+            TUASSERTE(unsigned, countGood(store, *it, times), n);
+            nTotal += n;
+         }
+         TUASSERT(nTotal > 0);
+         TUASSERT(nTotal < sats.size() * times.size());
+
+            // GLONASS time only, as getXvt()
+         gpstk::CommonTime t = store.getInitialTime() + 900.;
+         t.setTimeSystem(gpstk::TimeSystem::GPS);
+         gpstk::Xvt xvt;
+         TUASSERT(!store.tryGetXvt(*store.getIndexSet().begin(), t, xvt));
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /** Compare the orbit interpolated by svXvt() with the direct
+       * integration of svXvtOverrideFit() over the fit interval of every
+       * ephemeris, and time the two. */
+   unsigned denseOrbitTest()
+   {
+      TUDEF("GloEphemeris", "svXvt");
+      try
+      {
+         gpstk::GloEphemerisStore store;
+         loadNav(store, testFramework, false);
+         list<gpstk::GloEphemeris> ephs;
+         TUASSERT(store.addToList(ephs) > 0);
+
+         double maxPos = 0, maxVel = 0, maxClk = 0;
+         unsigned n = 0;
+         for (list<gpstk::GloEphemeris>::const_iterator it = ephs.begin();
+              it != ephs.end(); ++it)
+         {
+            gpstk::CommonTime t0 = it->getEphemerisEpoch();
+            for (double dt = -900.0; dt < 900.0; dt += 7.3)
+            {
+               gpstk::CommonTime t = t0 + dt;
+               gpstk::Xvt dense = it->svXvt(t);
+               gpstk::Xvt direct = it->svXvtOverrideFit(t);
+               maxPos = std::max(maxPos, range(dense.x, direct.x));
+               maxVel = std::max(maxVel, range(dense.v, direct.v));
+               maxClk = std::max(maxClk,
+                                 std::fabs(dense.clkbias - direct.clkbias));
+               n++;
+            }
+         }
+         cout << "GloEphemeris svXvt() vs integration at " << n
+              << " epochs: max diff " << maxPos << " m, " << maxVel
+              << " m/s, " << maxClk << " s" << endl;
+         TUASSERT(maxPos < 1e-4);
+         TUASSERT(maxVel < 1e-6);
+         TUASSERT(maxClk < 1e-15);
+
+            // the cache follows changes to the ephemeris data
+         gpstk::GloEphemeris eph(ephs.front());
+         gpstk::CommonTime t = eph.getEphemerisEpoch() + 450.;
+         gpstk::Xvt before = eph.svXvt(t);
+         gpstk::Triple pos(eph.x), vel(eph.v);
+         pos[0] += 1.0;
+         eph.setRecord(eph.getSatSys(), eph.getPRNID(), eph.getEpochTime(),
+                       pos, vel, eph.getAcc(), eph.getTauN(), eph.getGammaN(),
+                       eph.getMFtime(), eph.getHealth(), eph.getfreqNum(),
+                       eph.getAgeOfInfo(), eph.getIntegrationStep());
+         gpstk::Xvt after = eph.svXvt(t);
+         TUASSERT(range(before.x, after.x) > 100.);
+         TUASSERT(range(after.x, eph.svXvtOverrideFit(t).x) < 1e-4);
+         TUASSERT(range(ephs.front().svXvt(t).x, before.x) == 0.);
+
+            // 1 Hz over one fit interval, through the store
+         gpstk::SatID sat(ephs.front().getPRNID(),
+                          gpstk::SatelliteSystem::Glonass);
+         gpstk::CommonTime t0 = ephs.front().getEphemerisEpoch() - 900.;
+         clock_t c0 = clock();
+         for (int i = 0; i < 1800; i++)
+         {
+            ephs.front().svXvtOverrideFit(t0 + double(i));
+         }
+         double dtDirect = double(clock()-c0)/CLOCKS_PER_SEC;
+         c0 = clock();
+         for (int i = 0; i < 1800; i++)
+         {
+            store.getXvt(sat, t0 + double(i));
+         }
+         double dtStore = double(clock()-c0)/CLOCKS_PER_SEC;
+         cout << "GLONASS 1800 epochs at 1 Hz: integration " << dtDirect
+              << " s, GloEphemerisStore::getXvt " << dtStore << " s" << endl;
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /// Distance between two Triples
+   static double range(const gpstk::Triple& a, const gpstk::Triple& b)
+   {
+      return (a - b).mag();
+   }
+
+
+      /** Count the elements of batch that differ from what getXvt()
+       * returns, or that are not Unavailable where getXvt() throws. */
+   unsigned countBatchErrors(const gpstk::GloEphemerisStore& store,
+                             const gpstk::SatID& sat,
+                             const vector<gpstk::CommonTime>& times,
+                             const vector<gpstk::Xvt>& batch)
+   {
+      unsigned nBad = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         try
+         {
+            gpstk::Xvt xvt = store.getXvt(sat, times[i]);
+            if (!(xvt.x == batch[i].x) || !(xvt.v == batch[i].v) ||
+                xvt.clkbias != batch[i].clkbias ||
+                xvt.clkdrift != batch[i].clkdrift ||
+                xvt.relcorr != batch[i].relcorr ||
+                xvt.health != batch[i].health)
+            {
+               nBad++;
+            }
+         }
+         catch (gpstk::InvalidRequest& e)
+         {
+            if (batch[i].health != gpstk::Xvt::HealthStatus::Unavailable)
+            {
+               nBad++;
+            }
+         }
+      }
+      return nBad;
+   }
+
+
+      /// Count the times at which getXvt() succeeds.
+   unsigned countGood(const gpstk::GloEphemerisStore& store,
+                      const gpstk::SatID& sat,
+                      const vector<gpstk::CommonTime>& times)
+   {
+      unsigned n = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         try
+         {
+            store.getXvt(sat, times[i]);
+            n++;
+         }
+         catch (gpstk::InvalidRequest& e)
+         {
+         }
+      }
+      return n;
+   }
+
+
    gpstk::Rinex3NavData loadNav(gpstk::GloEphemerisStore& store,
                                 gpstk::TestUtil& testFramework,
                                 bool firstOnly)
@@ -246,6 +520,9 @@ int main(int argc, char *argv[])
    total += testClass.doFindEphEmptyTests();
    total += testClass.computeXvtTest();
    total += testClass.getSVHealthTest();
+   total += testClass.getXvtBatchTest();
+   total += testClass.tryGetXvtTest();
+   total += testClass.denseOrbitTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << total << endl;
    return total;
@@ -41,6 +41,12 @@
 #include "TimeString.hpp"
 #include "TestUtil.hpp"
 #include "GPSWeekSecond.hpp"
+#include "GPSEphemerisStore.hpp"
+#include "Rinex3NavStream.hpp"
+#include "Rinex3NavData.hpp"
+#include <ctime>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -241,6 +247,368 @@ public:
       }
       TURETURN();
    }    
+
+
+      /** Count the elements of batch that differ from what getXvt()
+       * returns, or that are not Unavailable where getXvt() throws. */
+   unsigned countBatchErrors(const gpstk::OrbitEphStore& store,
+                             const gpstk::SatID& sat,
+                             const vector<gpstk::CommonTime>& times,
+                             const vector<gpstk::Xvt>& batch,
+                             unsigned& nGood)
+   {
+      unsigned nBad = 0;
+      nGood = 0;
+      for (size_t i = 0; i < times.size(); i++)
+      {
+         try
+         {
+            gpstk::Xvt xvt = store.getXvt(sat, times[i]);
+            nGood++;
+            if (!(xvt.x == batch[i].x) || !(xvt.v == batch[i].v) ||
+                xvt.clkbias != batch[i].clkbias ||
+                xvt.clkdrift != batch[i].clkdrift ||
+                xvt.relcorr != batch[i].relcorr ||
+                xvt.health != batch[i].health)
+               nBad++;
+         }
+         catch (gpstk::InvalidRequest& e)
+         {
+            if (batch[i].health != gpstk::Xvt::HealthStatus::Unavailable)
+               nBad++;
+         }
+      }
+      return nBad;
+   }
+
+
+      /// Load all the GPS ephemerides in a nav file.
+   void loadNav(gpstk::GPSEphemerisStore& store, const string& file)
+   {
+      gpstk::Rinex3NavStream ns(file.c_str());
+      gpstk::Rinex3NavHeader nh;
+      gpstk::Rinex3NavData nd;
+      ns >> nh;
+      while (ns >> nd)
+      {
+         if (nd.sat.system == gpstk::SatelliteSystem::GPS)
+            store.addEphemeris(gpstk::GPSEphemeris(nd));
+      }
+   }
+
+
+      /** Compare getXvtBatch() with getXvt() for both search methods,
+       * for sorted and unsorted times that run off both ends of the
+       * store, and with onlyHealthy set. */
+   unsigned batchTests()
+   {
+      TUDEF("OrbitEphStore","getXvtBatch");
+      try
+      {
+         string file = gpstk::getPathData() + gpstk::getFileSep() +
+            "arlm200a.15n";
+         for (int near = 0; near < 2; near++)
+         {
+            gpstk::GPSEphemerisStore store;
+            if (near)
+               store.SearchNear();
+            loadNav(store, file);
+            TUASSERT(store.size() > 0);
+
+            vector<gpstk::CommonTime> times;
+            for (gpstk::CommonTime t = store.getInitialTime() - 3600.;
+                 t <= store.getFinalTime() + 3600.; t += 30.)
+               times.push_back(t);
+            vector<gpstk::CommonTime> rtimes(times.rbegin(), times.rend());
+
+            set<gpstk::SatID> sats = store.getIndexSet();
+            gpstk::SatID bogus(33, gpstk::SatelliteSystem::GPS);
+            sats.insert(bogus);
+            unsigned nBad, nGood, nTotal = 0;
+            vector<gpstk::Xvt> batch;
+            for (set<gpstk::SatID>::const_iterator it = sats.begin();
+                 it != sats.end(); ++it)
+            {
+               unsigned n = store.getXvtBatch(*it, times, batch);
+               TUASSERTE(size_t, times.size(), batch.size());
+               nBad = countBatchErrors(store, *it, times, batch, nGood);
+               TUASSERTE(unsigned, 0, nBad);
+               TUASSERTE(unsigned, nGood, n);
+               nTotal += n;
+
+               n = store.getXvtBatch(*it, rtimes, batch);
+               nBad = countBatchErrors(store, *it, rtimes, batch, nGood);
+               TUASSERTE(unsigned, 0, nBad);
+               TUASSERTE(unsigned, nGood, n);
+
+               store.setOnlyHealthyFlag(true);
+               n = store.getXvtBatch(*it, times, batch);
+               nBad = countBatchErrors(store, *it, times, batch, nGood);
+               TUASSERTE(unsigned, 0, nBad);
+               TUASSERTE(unsigned, nGood, n);
+               store.setOnlyHealthyFlag(false);
+            }
+               // something must have been computed, and not everything
+            TUASSERT(nTotal > 0);
+            TUASSERT(nTotal < sats.size() * times.size());
+
+               // all satellites at once
+            vector<gpstk::SatID> satv(sats.begin(), sats.end());
+            for (size_t i = 0; i < times.size(); i += 37)
+            {
+               unsigned n = store.getXvtBatch(satv, times[i], batch);
+               TUASSERTE(size_t, satv.size(), batch.size());
+               unsigned nOK = 0;
+               for (size_t j = 0; j < satv.size(); j++)
+               {
+                  vector<gpstk::CommonTime> one(1, times[i]);
+                  vector<gpstk::Xvt> single(1, batch[j]);
+                  nBad = countBatchErrors(store, satv[j], one, single, nGood);
+                  TUASSERTE(unsigned, 0, nBad);
+                  nOK += nGood;
+               }
+               TUASSERTE(unsigned, nOK, n);
+            }
+
+            if (!near)
+            {
+                  // report the cost per epoch of each interface
+               gpstk::SatID sat = *store.getIndexSet().begin();
+               clock_t start = clock();
+               for (size_t i = 0; i < times.size(); i++)
+               {
+                  try { store.getXvt(sat, times[i]); }
+                  catch (gpstk::InvalidRequest& e) {}
+               }
+               double tone = double(clock()-start)/CLOCKS_PER_SEC;
+               start = clock();
+               store.getXvtBatch(sat, times, batch);
+               double tbatch = double(clock()-start)/CLOCKS_PER_SEC;
+               cout << "getXvt " << 1.e9*tone/times.size()
+                    << " ns/epoch, getXvtBatch "
+                    << 1.e9*tbatch/times.size() << " ns/epoch" << endl;
+            }
+         }
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /** Compare tryGetXvt() with getXvt() for both search methods,
+       * with and without onlyHealthy: it must fail exactly where
+       * getXvt() throws, and otherwise return the same Xvt. */
+   unsigned tryGetXvtTests()
+   {
+      TUDEF("OrbitEphStore","tryGetXvt");
+      try
+      {
+         string file = gpstk::getPathData() + gpstk::getFileSep() +
+            "arlm200a.15n";
+         for (int near = 0; near < 2; near++)
+         {
+            gpstk::GPSEphemerisStore store;
+            if (near)
+               store.SearchNear();
+            loadNav(store, file);
+
+            set<gpstk::SatID> sats = store.getIndexSet();
+            sats.insert(gpstk::SatID(33, gpstk::SatelliteSystem::GPS));
+            for (int healthy = 0; healthy < 2; healthy++)
+            {
+               store.setOnlyHealthyFlag(healthy != 0);
+               unsigned nBad = 0, nGood = 0, nFail = 0;
+               for (set<gpstk::SatID>::const_iterator it = sats.begin();
+                    it != sats.end(); ++it)
+               {
+                  for (gpstk::CommonTime t = store.getInitialTime() - 3600.;
+                       t <= store.getFinalTime() + 3600.; t += 300.)
+                  {
+                     gpstk::Xvt xvt, xt;
+                     bool threw = false;
+                     try { xvt = store.getXvt(*it, t); }
+                     catch (gpstk::InvalidRequest& e) { threw = true; }
+                     bool ok = store.tryGetXvt(*it, t, xt);
+                     if (ok == threw)
+                        nBad++;
+                     else if (!ok)
+                        nFail++;
+                     else
+                     {
+                        nGood++;
+                        if (!(xvt.x == xt.x) || !(xvt.v == xt.v) ||
+                            xvt.clkbias != xt.clkbias ||
+                            xvt.clkdrift != xt.clkdrift ||
+                            xvt.relcorr != xt.relcorr ||
+                            xvt.health != xt.health)
+                           nBad++;
+                     }
+                  }
+               }
+               TUASSERTE(unsigned, 0, nBad);
+               TUASSERT(nGood > 0);
+               TUASSERT(nFail > 0);
+            }
+
+               // a conflicting time system fails rather than throws
+            gpstk::CommonTime t = store.getInitialTime() + 3600.;
+            t.setTimeSystem(gpstk::TimeSystem::GLO);
+            gpstk::Xvt xt;
+            TUASSERT(!store.tryGetXvt(*store.getIndexSet().begin(), t, xt));
+         }
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
+
+
+      /** Compare the ephemerides found with and without the flat
+       * index, for both search methods, in several query orders and
+       * from several threads at once. */
+   unsigned flatIndexTests()
+   {
+      TUDEF("OrbitEphStore","setFlatIndex");
+      try
+      {
+         string file = gpstk::getPathData() + gpstk::getFileSep() +
+            "arlm200a.15n";
+         for (int near = 0; near < 2; near++)
+         {
+            gpstk::GPSEphemerisStore store;
+            if (near)
+               store.SearchNear();
+            loadNav(store, file);
+            TUASSERT(store.getFlatIndex());
+
+            vector<gpstk::CommonTime> times;
+            for (gpstk::CommonTime t = store.getInitialTime() - 3600.;
+                 t <= store.getFinalTime() + 3600.; t += 30.)
+               times.push_back(t);
+               // forward, backward and jumping about
+            vector<size_t> order;
+            for (size_t i = 0; i < times.size(); i++)
+               order.push_back(i);
+            for (size_t i = times.size(); i > 0; i--)
+               order.push_back(i-1);
+            srand(15);
+            for (size_t i = 0; i < times.size(); i++)
+               order.push_back(rand() % times.size());
+            set<gpstk::SatID> sats = store.getIndexSet();
+            sats.insert(gpstk::SatID(33, gpstk::SatelliteSystem::GPS));
+            vector<gpstk::SatID> satv(sats.begin(), sats.end());
+
+               // Search the tables, then the index, before and after
+               // rationalize() changes the keys (rationalize() assumes
+               // the keys of SearchUser()).
+            for (int rat = 0; rat < (near ? 1 : 2); rat++)
+            {
+               if (rat)
+                  store.rationalize();
+               vector<const gpstk::OrbitEph*> expect;
+               store.setFlatIndex(false);
+               for (size_t s = 0; s < satv.size(); s++)
+                  for (size_t i = 0; i < order.size(); i++)
+                     expect.push_back(store.findOrbitEph(satv[s],
+                                                         times[order[i]]));
+               store.setFlatIndex(true);
+               unsigned nBad = 0, nFound = 0;
+               size_t k = 0;
+               for (size_t s = 0; s < satv.size(); s++)
+                  for (size_t i = 0; i < order.size(); i++, k++)
+                  {
+                     const gpstk::OrbitEph *eph =
+                        store.findOrbitEph(satv[s], times[order[i]]);
+                     nBad += (eph != expect[k]);
+                     nFound += (eph != NULL);
+                  }
+               TUASSERTE(unsigned, 0, nBad);
+               TUASSERT(nFound > 0);
+
+                  // concurrent readers, each in its own order
+               std::atomic<unsigned> nBadThreads(0);
+               vector<std::thread> threads;
+               for (unsigned th = 0; th < 4; th++)
+               {
+                  threads.push_back(std::thread(
+                     [&, th]()
+                     {
+                        size_t n = order.size();
+                        for (size_t s = 0; s < satv.size(); s++)
+                           for (size_t j = 0; j < n; j++)
+                           {
+                              size_t i = (j + th*n/4) % n;
+                              if (store.findOrbitEph(satv[s], times[order[i]])
+                                  != expect[s*n+i])
+                                 nBadThreads++;
+                           }
+                     }));
+               }
+               for (size_t th = 0; th < threads.size(); th++)
+                  threads[th].join();
+               TUASSERTE(unsigned, 0, nBadThreads.load());
+            }
+
+               // adding an ephemeris makes it visible
+            store.setFlatIndex(true);
+            gpstk::SatID sat = *store.getIndexSet().begin();
+            gpstk::CommonTime late = store.getFinalTime() + 86400.;
+            TUASSERT(store.findOrbitEph(sat, late) == NULL);
+            gpstk::GPSEphemeris eph(
+               *dynamic_cast<const gpstk::GPSEphemeris*>(
+                  store.findOrbitEph(sat, times[times.size()/2])));
+            eph.ctToe += 86400.;
+            eph.ctToc += 86400.;
+            eph.beginValid += 86400.;
+            eph.endValid += 86400.;
+            const gpstk::OrbitEph *added = store.addEphemeris(eph);
+            TUASSERT(added != NULL);
+            TUASSERT(store.findOrbitEph(sat, added->ctToe) == added);
+
+            if (!near)
+            {
+                  // report the cost of a search each way
+               clock_t start = clock();
+               for (size_t i = 0; i < times.size(); i++)
+                  store.findOrbitEph(sat, times[i]);
+               double tflat = double(clock()-start)/CLOCKS_PER_SEC;
+               store.setFlatIndex(false);
+               start = clock();
+               for (size_t i = 0; i < times.size(); i++)
+                  store.findOrbitEph(sat, times[i]);
+               double tmap = double(clock()-start)/CLOCKS_PER_SEC;
+               cout << "findOrbitEph " << 1.e9*tmap/times.size()
+                    << " ns/epoch, with flat index "
+                    << 1.e9*tflat/times.size() << " ns/epoch" << endl;
+            }
+         }
+      }
+      catch (gpstk::Exception &exc)
+      {
+         cerr << exc << endl;
+         TUFAIL("Unexpected exception");
+      }
+      catch (...)
+      {
+         TUFAIL("Unexpected exception");
+      }
+      TURETURN();
+   }
 };
 
 
@@ -250,6 +618,9 @@ int main(int argc, char *argv[])
    OrbitEphStore_T testClass;
    total += testClass.doFindEphEmptyTests();
    total += testClass.basicTests();
+   total += testClass.batchTests();
+   total += testClass.flatIndexTests();
+   total += testClass.tryGetXvtTests();
 
    cout << "Total Failures for " << __FILE__ << ": " << total << endl;
    return total;
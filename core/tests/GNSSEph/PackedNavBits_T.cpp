@@ -40,6 +40,9 @@
  * @file PackedNavBits_T.cpp
  * Tests for gpstk/ext/lib/GNSSEph/PackedNavBits
  */
+#include <ctime>
+#include <cstdlib>
+#include <vector>
 #include "CivilTime.hpp"
 #include "CommonTime.hpp"
 #include "GNSSconstants.hpp"
@@ -64,6 +67,8 @@ public:
    unsigned realDataTest();
    unsigned equalityTest();
    unsigned ancillaryMethods();
+   unsigned wordBoundaryTest();
+   unsigned timingTest();
 
    double eps; 
 };
@@ -836,6 +841,200 @@ ancillaryMethods()
    TURETURN();
 }
 
+   // Fields of every length at every offset are packed and unpacked,
+   // so that fields straddling two storage words are covered, and the
+   // results are compared with a bit-by-bit model of the same message.
+unsigned PackedNavBits_T::
+wordBoundaryTest()
+{
+   TUDEF("PackedNavBits", "word boundaries");
+
+   srand(20200101);
+   PackedNavBits pnb;
+   vector<bool> model;
+   vector<int> start, len;
+   vector<unsigned long> value;
+   while (model.size() < 1500)
+   {
+      int n = 1 + rand()%32;
+      unsigned long v = ((unsigned long)rand() << 8 ^ rand()) &
+                        ((1UL << n) - 1);
+      start.push_back(model.size());
+      len.push_back(n);
+      value.push_back(v);
+      pnb.addUnsignedLong(v, n, 1);
+      for (int i=n-1; i>=0; i--)
+         model.push_back((v >> i) & 1);
+   }
+   pnb.trimsize();
+   TUASSERTE(size_t, model.size(), pnb.getNumBits());
+
+   int bad = 0;
+   for (size_t i=0; i<start.size(); i++)
+   {
+      if (pnb.asUnsignedLong(start[i], len[i], 1) != value[i]) bad++;
+         // sign extension of the same bits
+      long sv = (long)value[i];
+      if (len[i] < 64 && (value[i] >> (len[i]-1)) & 1)
+         sv -= (long)(1UL << len[i]);
+      if (pnb.asLong(start[i], len[i], 1) != sv) bad++;
+   }
+   TUASSERTE(int, 0, bad);
+
+   bad = 0;
+   for (size_t i=0; i<model.size(); i++)
+      if (pnb.asBool(i) != model[i]) bad++;
+   TUASSERTE(int, 0, bad);
+   TUASSERTE(bool, true, pnb.getBits() == model);
+
+      // 64-bit fields at every offset
+   bad = 0;
+   for (size_t i=0; i+64<=model.size(); i++)
+   {
+      unsigned long v = 0;
+      for (int j=0; j<64; j++)
+         v = (v << 1) | model[i+j];
+      if (pnb.asUnsignedLong(i, 64, 1) != v) bad++;
+   }
+   TUASSERTE(int, 0, bad);
+
+      // overwrite fields in place, then compare ranges
+   PackedNavBits copy(pnb);
+   TUASSERTE(bool, true, copy.matchBits(pnb));
+      // getBits() keeps its copy until the bits change
+   const vector<bool>& cached(copy.getBits());
+   TUASSERTE(bool, true, cached == model);
+   TUASSERTE(bool, true, &cached == &copy.getBits());
+   copy.insertUnsignedLong(0x5A5A5, 61, 20, 1);
+   for (int i=19; i>=0; i--)
+      model[61+19-i] = (0x5A5A5 >> i) & 1;
+   TUASSERTE(unsigned long, 0x5A5A5, copy.asUnsignedLong(61, 20, 1));
+   TUASSERTE(bool, true, copy.getBits() == model);
+   TUASSERTE(bool, true, copy.matchBits(pnb, 0, 60));
+   TUASSERTE(bool, true, copy.matchBits(pnb, 81));
+   TUASSERTE(bool, (pnb.asUnsignedLong(61,20,1) == 0x5A5A5),
+             copy.matchBits(pnb, 50, 90));
+   TUASSERTE(bool, (pnb.asUnsignedLong(61,20,1) < 0x5A5A5), pnb < copy);
+   TUASSERTE(bool, (pnb.asUnsignedLong(61,20,1) > 0x5A5A5), copy < pnb);
+
+      // invert keeps the bits beyond the end clear
+   PackedNavBits inv(copy);
+   inv.invert();
+   inv.invert();
+   TUASSERTE(bool, true, inv.matchBits(copy));
+   TUASSERTE(bool, false, inv < copy);
+   TUASSERTE(bool, false, copy < inv);
+
+      // appending at an odd offset
+   PackedNavBits joined;
+   joined.addUnsignedLong(5, 3, 1);
+   joined.addPackedNavBits(copy);
+   TUASSERTE(size_t, copy.getNumBits()+3, joined.getNumBits());
+   TUASSERTE(unsigned long, 5, joined.asUnsignedLong(0, 3, 1));
+   bad = 0;
+   for (size_t i=0; i<model.size(); i++)
+      if (joined.asBool(i+3) != model[i]) bad++;
+   TUASSERTE(int, 0, bad);
+
+      // copyBits across word boundaries
+   PackedNavBits zeros(copy);
+   zeros.invert();
+   zeros.copyBits(copy, 30, 200);
+   TUASSERTE(bool, true, zeros.matchBits(copy, 30, 200));
+   TUASSERTE(bool, false, zeros.matchBits(copy, 29, 200));
+   TUASSERTE(bool, false, zeros.matchBits(copy, 30, 201));
+
+   TURETURN();
+}
+
+   // Time the accessors used when decoding and filtering nav messages.
+   // The reference is the same work done one bit at a time on a
+   // vector<bool>, which is how the bits were stored before.
+unsigned PackedNavBits_T::
+timingTest()
+{
+   TUDEF("PackedNavBits", "timing");
+
+      // fields of a GPS LNAV subframe 2
+   const int fstart[] = { 0, 30, 60, 68, 90, 106, 120, 150, 166, 180, 196,
+                          210, 226, 240, 270 };
+   const int flen[] = { 22, 17, 8, 16, 24, 16, 24, 16, 8, 16, 8, 16, 8,
+                        24, 16 };
+   const int nfield = sizeof(flen)/sizeof(flen[0]);
+   const int N = 20000;
+
+   PackedNavBits pnb;
+   srand(1);
+   for (int i=0; i<10; i++)
+      pnb.addUnsignedLong(rand() & 0x3FFFFFFF, 30, 1);
+   pnb.trimsize();
+   PackedNavBits other(pnb);
+   vector<bool> ref(pnb.getBits()), refOther(ref);
+
+   clock_t start = clock();
+   unsigned long sumRef = 0;
+   for (int n=0; n<N; n++)
+   {
+      for (int f=0; f<nfield; f++)
+      {
+         unsigned long v = 0;
+         for (int i=fstart[f]; i<fstart[f]+flen[f]; i++)
+            v = (v << 1) | ref[i];
+         sumRef += v;
+      }
+      for (int i=0; i<300; i+=7)
+         sumRef += ref[i];
+      bool same = true;
+      for (size_t i=0; i<ref.size() && same; i++)
+         same = (ref[i] == refOther[i]);
+      sumRef += same;
+   }
+   double tref = double(clock()-start)/CLOCKS_PER_SEC;
+
+   start = clock();
+   unsigned long sum = 0;
+   for (int n=0; n<N; n++)
+   {
+      for (int f=0; f<nfield; f++)
+         sum += pnb.asUnsignedLong(fstart[f], flen[f], 1);
+      for (int i=0; i<300; i+=7)
+         sum += pnb.asBool(i);
+      sum += pnb.matchBits(other);
+   }
+   double tnew = double(clock()-start)/CLOCKS_PER_SEC;
+   TUASSERTE(unsigned long, sumRef, sum);
+
+      // packing a subframe
+   start = clock();
+   for (int n=0; n<N/10; n++)
+   {
+      vector<bool> bits;
+      for (int f=0; f<nfield; f++)
+         for (int i=flen[f]-1; i>=0; i--)
+            bits.push_back((n >> (i%16)) & 1);
+      sumRef += bits.size();
+   }
+   double trefAdd = double(clock()-start)/CLOCKS_PER_SEC;
+
+   start = clock();
+   for (int n=0; n<N/10; n++)
+   {
+      PackedNavBits packed;
+      for (int f=0; f<nfield; f++)
+         packed.addUnsignedLong(n & ((1UL << flen[f]) - 1), flen[f], 1);
+      sum += packed.getNumBits();
+   }
+   double tadd = double(clock()-start)/CLOCKS_PER_SEC;
+
+   cout << "PackedNavBits timing for " << N << " subframes: unpack "
+        << tnew << " s (bit by bit " << tref << " s); pack " << N/10
+        << " subframes " << tadd << " s (bit by bit " << trefAdd << " s)"
+        << endl;
+   TUPASS("timing");
+
+   TURETURN();
+}
+
 int main()
 {
    unsigned errorTotal = 0;
@@ -846,6 +1045,8 @@ int main()
    errorTotal += testClass.realDataTest();
    errorTotal += testClass.equalityTest();
    errorTotal += testClass.ancillaryMethods();
+   errorTotal += testClass.wordBoundaryTest();
+   errorTotal += testClass.timingTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
@@ -0,0 +1,396 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <ctime>
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+#include "PositionSatStore.hpp"
+#include "GPSWeekSecond.hpp"
+#include "MiscMath.hpp"
+#include "TestUtil.hpp"
+
+using namespace gpstk;
+using namespace std;
+
+   // The interpolation in PositionSatStore::getValue() used to gather the
+   // interval into std::vectors and call the vector versions of
+   // LagrangeInterpolation().  That implementation is reproduced here,
+   // verbatim apart from names, as a reference so that the allocation-free
+   // version can be checked bit for bit and timed against it.
+namespace reference
+{
+   template <class T>
+   T lagrange(const vector<T>& X, const vector<T>& Y, const T& x, T& err)
+   {
+      size_t i,j,k;
+      T y,del;
+      vector<T> D,Q;
+
+      err = T(0);
+      k = X.size()/2;
+      if(x == X[k]) return Y[k];
+      if(x == X[k-1]) return Y[k-1];
+      if(ABS(x-X[k-1]) < ABS(x-X[k])) k=k-1;
+      for(i=0; i<X.size(); i++) {
+         Q.push_back(Y[i]);
+         D.push_back(Y[i]);
+      }
+      y = Y[k--];
+      for(j=1; j<X.size(); j++) {
+         for(i=0; i<X.size()-j; i++) {
+            del = (Q[i+1]-D[i])/(X[i]-X[i+j]);
+            D[i] = (X[i+j]-x)*del;
+            Q[i] = (X[i]-x)*del;
+         }
+         err = (2*(k+1) < X.size()-j ? Q[k+1] : D[k--]);
+         y += err;
+      }
+      return y;
+   }
+
+   template <class T>
+   void lagrange(const vector<T>& X, const vector<T>& Y,
+                 const T& x, T& y, T& dydx)
+   {
+      size_t i,j,k,N=X.size(),M;
+      M = (N*(N+1))/2;
+      vector<T> P(N,T(1)),Q(M,T(1)),D(N,T(1));
+      for(i=0; i<N; i++) {
+         for(j=0; j<N; j++) {
+            if(i != j) {
+               P[i] *= x-X[j];
+               D[i] *= X[i]-X[j];
+               if(i < j) {
+                  for(k=0; k<N; k++) {
+                     if(k == i || k == j) continue;
+                     Q[i+(j*(j+1))/2] *= (x-X[k]);
+                  }
+               }
+            }
+         }
+      }
+      y = dydx = T(0);
+      for(i=0; i<N; i++) {
+         y += Y[i]*(P[i]/D[i]);
+         T S(0);
+         for(k=0; k<N; k++) if(i != k) {
+               if(k<i) S += Q[k+(i*(i+1))/2]/D[i];
+               else    S += Q[i+(k*(k+1))/2]/D[i];
+            }
+         dydx += Y[i]*S;
+      }
+   }
+
+   PositionRecord getValue(const PositionSatStore& store, int nhalf,
+                           bool haveVelocity, bool haveAcceleration,
+                           const SatID& sat, const CommonTime& ttag)
+   {
+      bool isExact;
+      int i;
+      PositionRecord rec;
+      PositionSatStore::DataTable::const_iterator it1, it2, kt;
+
+      isExact = store.getTableInterval(sat, ttag, nhalf, it1, it2,
+                                       haveVelocity);
+      if(isExact && haveVelocity) {
+         rec = it1->second;
+         return rec;
+      }
+
+      size_t n,Nlow(nhalf-1),Nhi(nhalf),Nmatch(nhalf);
+      CommonTime ttag0(it1->first);
+      vector<double> times,P[3],V[3],A[3],sigP[3],sigV[3],sigA[3];
+
+      kt = it1; n=0;
+      while(1) {
+         if(isExact && ABS(kt->first - ttag) < 1.e-8)
+            Nmatch = n;
+         times.push_back(kt->first - ttag0);
+         for(i=0; i<3; i++) {
+            P[i].push_back(kt->second.Pos[i]);
+            V[i].push_back(kt->second.Vel[i]);
+            A[i].push_back(kt->second.Acc[i]);
+            sigP[i].push_back(kt->second.sigPos[i]);
+            sigV[i].push_back(kt->second.sigVel[i]);
+            sigA[i].push_back(kt->second.sigAcc[i]);
+         }
+         if(kt == it2) break;
+         ++kt;
+         ++n;
+      };
+
+      if(isExact && Nmatch == (size_t)(nhalf-1)) { Nlow++; Nhi++; }
+
+      rec.sigAcc = rec.Acc = Triple(0,0,0);
+      double dt(ttag-ttag0), err;
+      if(haveVelocity) {
+         for(i=0; i<3; i++) {
+            rec.Pos[i] = lagrange(times,P[i],dt,err);
+            if(haveAcceleration) {
+               rec.Vel[i] = lagrange(times,V[i],dt,err);
+               rec.Acc[i] = lagrange(times,A[i],dt,err);
+            }
+            else {
+               lagrange(times,V[i],dt,rec.Vel[i],rec.Acc[i]);
+               rec.Acc[i] *= 0.1;
+            }
+            if(isExact) {
+               rec.sigPos[i] = sigP[i][Nmatch];
+               rec.sigVel[i] = sigV[i][Nmatch];
+               if(haveAcceleration) rec.sigAcc[i] = sigA[i][Nmatch];
+            }
+            else {
+               rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
+               rec.sigVel[i] = RSS(sigV[i][Nhi],sigV[i][Nlow]);
+               if(haveAcceleration)
+                  rec.sigAcc[i] = RSS(sigA[i][Nhi],sigA[i][Nlow]);
+            }
+         }
+      }
+      else {
+         for(i=0; i<3; i++) {
+            lagrange(times,P[i],dt,rec.Pos[i],rec.Vel[i]);
+            rec.Vel[i] *= 10000.;
+            if(isExact)
+               rec.sigPos[i] = sigP[i][Nmatch];
+            else
+               rec.sigPos[i] = RSS(sigP[i][Nhi],sigP[i][Nlow]);
+            rec.sigVel[i] = 0.0;
+         }
+      }
+      return rec;
+   }
+}
+
+
+class PositionSatStore_T
+{
+public:
+   PositionSatStore_T()
+         : sat(5, SatelliteSystem::GPS), step(900.0), nepochs(96)
+   {
+      t0 = GPSWeekSecond(2000, 86400.0, TimeSystem::GPS);
+   }
+
+      /** Fill a store with a day of 15-minute records of a circular
+       * orbit, in SP3 units (km, dm/s, m/s/s), with non-trivial sigmas.
+       * @param[in] withVel include velocity data
+       * @param[in] withAcc include acceleration data
+       * @param[in] skip index of an epoch to leave out, if any */
+   void fill(PositionSatStore& store, bool withVel, bool withAcc,
+             int skip = -1)
+   {
+      const double R(26560.0), w(2*M_PI/43080.0), inc(0.96);
+      for(int n=0; n<nepochs; n++)
+      {
+         if(n == skip)
+            continue;
+         double t(n*step), c(::cos(w*t)), s(::sin(w*t));
+         PositionRecord rec;
+         rec.Pos = Triple(R*c, R*s*::cos(inc), R*s*::sin(inc));
+         rec.sigPos = Triple(1.e-3*(1+n%3), 2.e-3, 1.e-3*(1+n%5));
+         rec.Vel = rec.sigVel = rec.Acc = rec.sigAcc = Triple(0,0,0);
+         if(withVel)
+         {
+            double v(R*w*1.e4);
+            rec.Vel = Triple(-v*s, v*c*::cos(inc), v*c*::sin(inc));
+            rec.sigVel = Triple(1.e-2, 1.e-2*(1+n%2), 3.e-2);
+         }
+         if(withAcc)
+         {
+            double a(R*w*w*1.e3);
+            rec.Acc = Triple(-a*c, -a*s*::cos(inc), -a*s*::sin(inc));
+            rec.sigAcc = Triple(1.e-4, 2.e-4, 1.e-4*(1+n%4));
+         }
+         store.addPositionRecord(sat, t0 + n*step, rec);
+      }
+   }
+
+      /// True if the two records are identical, bit for bit
+   static bool same(const PositionRecord& a, const PositionRecord& b)
+   {
+      for(int i=0; i<3; i++)
+      {
+         if(a.Pos[i] != b.Pos[i] || a.sigPos[i] != b.sigPos[i] ||
+            a.Vel[i] != b.Vel[i] || a.sigVel[i] != b.sigVel[i] ||
+            a.Acc[i] != b.Acc[i] || a.sigAcc[i] != b.sigAcc[i])
+            return false;
+      }
+      return true;
+   }
+
+      /** Compare getValue() with the reference implementation at
+       * arbitrary times and exactly on table epochs, for each
+       * combination of available data and several orders. */
+   unsigned getValueTest()
+   {
+      TUDEF("PositionSatStore", "getValue");
+      bool vel[3] = { false, true, true };
+      bool acc[3] = { false, false, true };
+      unsigned orders[3] = { 8, 10, 12 };
+      for(int k=0; k<3; k++)
+      {
+         for(int m=0; m<3; m++)
+         {
+            PositionSatStore store;
+            fill(store, vel[k], acc[k]);
+            store.setInterpolationOrder(orders[m]);
+            int nhalf(orders[m]/2), nbad(0), ntest(0);
+            for(double dt=(nhalf+1)*step; dt<(nepochs-nhalf-1)*step; dt+=37.5)
+            {
+               CommonTime t(t0 + dt);
+               PositionRecord got(store.getValue(sat, t));
+               PositionRecord exp(reference::getValue(store, nhalf, vel[k],
+                                                      acc[k], sat, t));
+               ntest++;
+               if(!same(got, exp))
+                  nbad++;
+            }
+            TUASSERT(ntest > 0);
+            TUASSERTE(int, 0, nbad);
+         }
+      }
+      TURETURN();
+   }
+
+      /** Check that a frozen store gives the same results as the
+       * std::map tables, on a regular grid and on one with a gap. */
+   unsigned freezeTest()
+   {
+      TUDEF("PositionSatStore", "freeze");
+      for(int k=0; k<2; k++)
+      {
+            // second time, an irregular grid: one epoch is missing
+         PositionSatStore store;
+         fill(store, k==1, false, (k==1 ? 40 : -1));
+         PositionSatStore frozen(store);
+         frozen.freeze();
+         TUASSERT(frozen.isFrozen());
+         TUASSERT(!store.isFrozen());
+
+         int nbad(0), nthrow(0), ntest(0);
+         for(double dt=-step; dt<(nepochs+1)*step; dt+=112.5)
+         {
+            CommonTime t(t0 + dt);
+            PositionRecord r1, r2;
+            bool threw1(false), threw2(false);
+            try { r1 = store.getValue(sat, t); }
+            catch(InvalidRequest&) { threw1 = true; }
+            try { r2 = frozen.getValue(sat, t); }
+            catch(InvalidRequest&) { threw2 = true; }
+            ntest++;
+            if(threw1 != threw2)
+               nbad++;
+            else if(threw1)
+               nthrow++;
+            else if(!same(r1, r2))
+               nbad++;
+         }
+         TUASSERT(nthrow > 0);
+         TUASSERT(nthrow < ntest);
+         TUASSERTE(int, 0, nbad);
+
+            // adding data thaws the store
+         frozen.addPositionData(sat, t0 + nepochs*step, Triple(1,2,3));
+         TUASSERT(!frozen.isFrozen());
+      }
+      TURETURN();
+   }
+
+      /** Time getValue() against the reference implementation and
+       * report the per-call cost. This is informational; only the
+       * results are checked. */
+   unsigned timingTest()
+   {
+      TUDEF("PositionSatStore", "getValue timing");
+      PositionSatStore store;
+      fill(store, false, false);
+      const int ncalls(20000);
+      const double span((nepochs-12)*step);
+      PositionRecord got, exp;
+      double sumref(0), sumnew(0);
+
+      clock_t start(clock());
+      for(int n=0; n<ncalls; n++)
+      {
+         exp = reference::getValue(store, 5, false, false, sat,
+                                   t0 + (6*step + ::fmod(n*7.3, span)));
+         sumref += exp.Pos[0];
+      }
+      double tref(double(clock()-start)/CLOCKS_PER_SEC);
+
+      start = clock();
+      for(int n=0; n<ncalls; n++)
+      {
+         got = store.getValue(sat, t0 + (6*step + ::fmod(n*7.3, span)));
+         sumnew += got.Pos[0];
+      }
+      double tnew(double(clock()-start)/CLOCKS_PER_SEC);
+
+      cout << fixed << setprecision(3)
+           << "PositionSatStore::getValue per call: reference "
+           << 1.e9*tref/ncalls << " ns, current "
+           << 1.e9*tnew/ncalls << " ns" << endl;
+      TUASSERTE(double, sumref, sumnew);
+      TURETURN();
+   }
+
+private:
+   SatID sat;
+   CommonTime t0;
+   double step;
+   int nepochs;
+};
+
+
+int main()
+{
+   unsigned errorTotal = 0;
+   PositionSatStore_T testClass;
+
+   errorTotal += testClass.getValueTest();
+   errorTotal += testClass.freezeTest();
+   errorTotal += testClass.timingTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
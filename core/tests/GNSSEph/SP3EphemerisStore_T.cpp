@@ -36,6 +36,7 @@
 //
 //==============================================================================
 
+#include <algorithm>
 #include <list>
 #include <string>
 #include <iostream>
@@ -696,6 +697,270 @@ public:
       TURETURN();
    }
 
+//=============================================================================
+// Test that freezing the tables (compacting them into arrays) does not
+// change any result, including which requests throw
+//=============================================================================
+   unsigned freezeTest()
+   {
+      TUDEF("SP3EphemerisStore", "freeze");
+
+      try
+      {
+            // loading freezes the tables; an edit that removes
+            // nothing leaves the std::map tables in use instead
+         SP3EphemerisStore store, frozen;
+         store.loadFile(inputSP3Data);
+         store.edit(CommonTime::BEGINNING_OF_TIME, CommonTime::END_OF_TIME);
+         frozen.loadFile(inputSP3Data);
+
+         vector<SatID> sats(store.getSatList());
+         sats.push_back(SatID(32,SatelliteSystem::GPS)); // not in the file
+         CommonTime tbeg(store.getInitialTime()), tend(store.getFinalTime());
+         vector<CommonTime> times(checkTimes(store));
+         int nbad(0), nthrow(0), ntest(0);
+         for(size_t i=0; i<sats.size(); i++)
+         {
+            for(size_t j=0; j<times.size(); j++)
+            {
+               const CommonTime& t(times[j]);
+               Xvt x1, x2;
+               bool threw1(false), threw2(false);
+               try { x1 = store.getXvt(sats[i],t); }
+               catch(InvalidRequest&) { threw1 = true; }
+               try { x2 = frozen.getXvt(sats[i],t); }
+               catch(InvalidRequest&) { threw2 = true; }
+               ntest++;
+               if(threw1 != threw2)
+                  nbad++;
+               else if(threw1)
+                  nthrow++;
+               else if(x1.x[0] != x2.x[0] || x1.x[1] != x2.x[1] ||
+                       x1.x[2] != x2.x[2] || x1.v[0] != x2.v[0] ||
+                       x1.v[1] != x2.v[1] || x1.v[2] != x2.v[2] ||
+                       x1.clkbias != x2.clkbias || x1.clkdrift != x2.clkdrift)
+                  nbad++;
+            }
+               // exactly on a table epoch
+            CommonTime t(tbeg + 900.*10);
+            TUASSERTE(Triple, store.getPosition(sats[0],t),
+                      frozen.getPosition(sats[0],t));
+         }
+         TUASSERT(nthrow > 0);
+         TUASSERT(nthrow < ntest);
+         TUASSERTE(int, 0, nbad);
+
+            // loading freezes data added before it as well
+         SP3EphemerisStore reload;
+         reload.addPositionData(sats[0], tend+900., Triple(1.,2.,3.), Triple());
+         reload.loadFile(inputSP3Data);
+         CommonTime t(tbeg + 4567.);
+         TUASSERTE(Triple, store.getXvt(sats[0],t).x, reload.getXvt(sats[0],t).x);
+         TUASSERTE(CommonTime, tend+900., reload.getFinalTime());
+      }
+      catch (Exception& e)
+      {
+         cout << e;
+         TUFAIL("Unexpected exception");
+      }
+
+      TURETURN();
+   }
+
+      /* Compare getXvtBatch() with getXvt(), for sorted and
+       * unsorted times running off both ends of the store, for
+       * normal and frozen tables, one satellite at a time and all
+       * satellites at once */
+   unsigned getXvtBatchTest()
+   {
+      TUDEF("SP3EphemerisStore", "getXvtBatch");
+
+      try
+      {
+         SP3EphemerisStore store;
+         store.loadFile(inputSP3Data);
+         vector<SatID> sats(store.getSatList());
+         sats.push_back(SatID(32,SatelliteSystem::GPS)); // not in the file
+
+         vector<CommonTime> unsorted(checkTimes(store)), sorted(unsorted);
+         std::sort(sorted.begin(), sorted.end());
+
+            // passes 0 and 1 use the frozen tables, 2 and 3 the maps
+         for(int pass=0; pass<4; pass++)
+         {
+            const vector<CommonTime>& times(pass%2 ? sorted : unsorted);
+            if(pass == 2)
+               store.edit(CommonTime::BEGINNING_OF_TIME,
+                          CommonTime::END_OF_TIME);
+
+            int nbad(0), ngood(0), nbatch(0);
+            vector<Xvt> batch;
+            for(size_t i=0; i<sats.size(); i++)
+            {
+               nbatch += store.getXvtBatch(sats[i], times, batch);
+               TUASSERTE(size_t, times.size(), batch.size());
+               for(size_t j=0; j<times.size(); j++)
+                  compareBatch(store, sats[i], times[j], batch[j], nbad, ngood);
+            }
+            TUASSERTE(int, ngood, nbatch);
+            TUASSERT(ngood > 0);
+            TUASSERT(ngood < int(sats.size()*times.size()));
+
+            ngood = nbatch = 0;
+            for(size_t j=0; j<times.size(); j++)
+            {
+               nbatch += store.getXvtBatch(sats, times[j], batch);
+               TUASSERTE(size_t, sats.size(), batch.size());
+               for(size_t i=0; i<sats.size(); i++)
+                  compareBatch(store, sats[i], times[j], batch[i], nbad, ngood);
+            }
+            TUASSERTE(int, ngood, nbatch);
+            TUASSERTE(int, 0, nbad);
+         }
+      }
+      catch (Exception& e)
+      {
+         cout << e;
+         TUFAIL("Unexpected exception");
+      }
+
+      TURETURN();
+   }
+
+      /* Compare tryGetXvt() with getXvt(): it must fail exactly
+       * where getXvt() throws, and otherwise give the same Xvt.
+       * The passes enable gap and interval checking and thaw the
+       * tables, so that each way for the interpolation to fail is
+       * exercised. */
+   unsigned tryGetXvtTest()
+   {
+      TUDEF("SP3EphemerisStore", "tryGetXvt");
+
+      try
+      {
+         SP3EphemerisStore store;
+         store.loadFile(inputSP3Data);
+         vector<SatID> sats(store.getSatList());
+         sats.push_back(SatID(32,SatelliteSystem::GPS)); // not in the file
+         vector<CommonTime> times(checkTimes(store));
+         int nfail0(0);
+
+         for(int pass=0; pass<4; pass++)
+         {
+            SP3EphemerisStore check(store);
+            if(pass == 1) check.setClockGapInterval(800.);
+            if(pass == 2) check.setPosMaxInterval(8000.);
+            if(pass == 3)
+               check.edit(CommonTime::BEGINNING_OF_TIME,
+                          CommonTime::END_OF_TIME);
+
+            int nbad(0), ngood(0), nfail(0);
+            for(size_t i=0; i<sats.size(); i++)
+            {
+               for(size_t j=0; j<times.size(); j++)
+               {
+                  const CommonTime& t(times[j]);
+                  Xvt x, xt;
+                  bool threw(false);
+                  try { x = check.getXvt(sats[i],t); }
+                  catch(InvalidRequest&) { threw = true; }
+                  bool ok(check.tryGetXvt(sats[i],t,xt));
+                  if(ok == threw)
+                     nbad++;
+                  else if(!ok)
+                     nfail++;
+                  else
+                  {
+                     ngood++;
+                     if(!(x.x == xt.x) || !(x.v == xt.v) ||
+                        x.clkbias != xt.clkbias || x.clkdrift != xt.clkdrift ||
+                        x.relcorr != xt.relcorr || x.health != xt.health)
+                        nbad++;
+                  }
+               }
+            }
+            TUASSERTE(int, 0, nbad);
+            TUASSERT(nfail > 0);
+               // the checks reject interpolations that pass 0 accepts
+            if(pass == 0) {
+               TUASSERT(ngood > 0);
+               nfail0 = nfail;
+            }
+            else if(pass < 3) {
+               TUASSERT(nfail > nfail0);
+            }
+            else {
+               TUASSERTE(int, nfail0, nfail);
+            }
+         }
+
+            // a conflicting time system fails rather than throws
+         SP3EphemerisStore sp3c;
+         sp3c.loadFile(inputSP3cData);
+         SatID sat(sp3c.getSatList()[0]);
+         CommonTime tglo(sp3c.getInitialTime() + 4567.);
+         tglo.setTimeSystem(TimeSystem::GLO);
+         Xvt xt;
+         TUASSERT(sp3c.getTimeSystem() != TimeSystem::GLO);
+         TUASSERT(!sp3c.tryGetXvt(sat, tglo, xt));
+         try {
+            sp3c.getXvt(sat, tglo);
+            TUFAIL("getXvt() did not throw");
+         }
+         catch(InvalidRequest&) { TUPASS("getXvt() threw"); }
+      }
+      catch (Exception& e)
+      {
+         cout << e;
+         TUFAIL("Unexpected exception");
+      }
+
+      TURETURN();
+   }
+
+      // A few times at which to compare results, not in order: off
+      // both ends of the store, at its ends, on a table epoch and
+      // between epochs
+   vector<CommonTime> checkTimes(const SP3EphemerisStore& store)
+   {
+      CommonTime tbeg(store.getInitialTime()), tend(store.getFinalTime());
+      CommonTime tmid(tbeg + 900.*long((tend-tbeg)/1800.));
+      vector<CommonTime> times;
+      times.push_back(tbeg + 4567.);
+      times.push_back(tbeg - 3600.);
+      times.push_back(tbeg - 1.);
+      times.push_back(tbeg);
+      times.push_back(tbeg + 137.5);
+      times.push_back(tbeg + 900.*10);
+      times.push_back(tmid + 450.25);
+      times.push_back(tmid);
+      times.push_back(tend - 137.5);
+      times.push_back(tend);
+      times.push_back(tend + 1.);
+      times.push_back(tend + 3600.);
+      return times;
+   }
+
+      // Compare one element of a batch with getXvt(); count it in
+      // nbad if it differs, and in ngood if getXvt() succeeds
+   void compareBatch(const SP3EphemerisStore& store, const SatID& sat,
+                     const CommonTime& t, const Xvt& xb, int& nbad, int& ngood)
+   {
+      Xvt x;
+      try { x = store.getXvt(sat,t); }
+      catch(InvalidRequest&)
+      {
+         if(xb.health != Xvt::HealthStatus::Unavailable)
+            nbad++;
+         return;
+      }
+      ngood++;
+      if(!(x.x == xb.x) || !(x.v == xb.v) || x.clkbias != xb.clkbias ||
+         x.clkdrift != xb.clkdrift || x.relcorr != xb.relcorr ||
+         x.health != xb.health)
+         nbad++;
+   }
+
 private:
    double epsilon; // Floating point error threshold
    std::string dataFilePath;
@@ -730,6 +995,9 @@ int main() // Main function to initialize and run all tests above
    errorTotal += testClass.getFinalTimeTest();
    errorTotal += testClass.getPositionTest();
    errorTotal += testClass.getVelocityTest();
+   errorTotal += testClass.freezeTest();
+   errorTotal += testClass.getXvtBatchTest();
+   errorTotal += testClass.tryGetXvtTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
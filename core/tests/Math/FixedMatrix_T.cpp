@@ -0,0 +1,286 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include "FixedMatrix.hpp"
+#include "TestUtil.hpp"
+#include <iostream>
+#include <cmath>
+#include <ctime>
+
+using namespace std;
+using namespace gpstk;
+
+class FixedMatrix_T
+{
+public:
+   FixedMatrix_T() : eps(1.e-12) {}
+
+      /// fill m with reproducible, well conditioned values
+   template <class M>
+   static void fill(M& m, double seed)
+   {
+      for(size_t i=0; i<m.rows(); i++)
+         for(size_t j=0; j<m.cols(); j++)
+            m(i,j) = ::sin(seed + 1.7*i + 0.3*j*j) + (i==j ? 4.0 : 0.0);
+   }
+
+      /// count elements of a and b that differ by more than tol
+   template <class M1, class M2>
+   static int countDiffs(const M1& a, const M2& b, double tol)
+   {
+      if(a.rows() != b.rows() || a.cols() != b.cols()) return -1;
+      int bad(0);
+      for(size_t i=0; i<a.rows(); i++)
+         for(size_t j=0; j<a.cols(); j++)
+            if(::fabs(a(i,j)-b(i,j)) > tol) bad++;
+      return bad;
+   }
+
+   int constructTest()
+   {
+      TUDEF("FixedMatrix", "Construct");
+
+      FixedMatrix<double,2,3> Z;
+      TUASSERTE(size_t, 2, Z.rows());
+      TUASSERTE(size_t, 3, Z.cols());
+      TUASSERTE(size_t, 6, Z.size());
+      TUASSERTE(double, 0.0, Z(1,2));
+
+      FixedMatrix<double,3,3> I(FixedMatrix<double,3,3>::identity());
+      TUASSERTE(int, 0, countDiffs(I, ident<double>(3), 0.0));
+
+         // to and from Matrix
+      Matrix<double> D(3,4);
+      fill(D, 0.5);
+      FixedMatrix<double,3,4> F(D);
+      TUASSERTE(int, 0, countDiffs(F, D, 0.0));
+      Matrix<double> B(F);
+      TUASSERTE(int, 0, countDiffs(B, D, 0.0));
+      Matrix<double> C;
+      C = F;
+      TUASSERTE(int, 0, countDiffs(C, D, 0.0));
+
+         // wrong dimensions
+      try {
+         FixedMatrix<double,4,3> G(D);
+         TUFAIL("FixedMatrix from wrong dimension Matrix should throw");
+      }
+      catch(MatrixException& e) { TUPASS("MatrixException"); }
+
+      Vector<double> v(3);
+      v(0) = 1.0; v(1) = -2.0; v(2) = 3.5;
+      FixedVector<double,3> fv(v);
+      TUASSERTE(double, -2.0, fv[1]);
+      TUASSERTE(double, 3.5, fv(2));
+      Vector<double> w(fv);
+      TUASSERTE(size_t, 3, w.size());
+      TUASSERTE(double, 3.5, w[2]);
+      try {
+         FixedVector<double,4> fw(v);
+         TUFAIL("FixedVector from wrong size Vector should throw");
+      }
+      catch(VectorException& e) { TUPASS("VectorException"); }
+
+      TURETURN();
+   }
+
+   int operatorTest()
+   {
+      TUDEF("FixedMatrix", "Operators");
+
+      Matrix<double> A(3,4), B(4,2), C(3,4);
+      Vector<double> v(4), u(3);
+      fill(A, 0.1);
+      fill(B, 1.2);
+      fill(C, 2.3);
+      for(size_t i=0; i<4; i++) v(i) = ::cos(0.7*i);
+      for(size_t i=0; i<3; i++) u(i) = ::cos(1.3*i);
+
+      FixedMatrix<double,3,4> fA(A), fC(C);
+      FixedMatrix<double,4,2> fB(B);
+      FixedVector<double,4> fv(v);
+      FixedVector<double,3> fu(u);
+
+         // same arithmetic in the same order, so the results are identical
+      FixedMatrix<double,3,2> fAB(fA*fB);
+      TUASSERTE(int, 0, countDiffs(fAB, A*B, 0.0));
+      TUASSERTE(int, 0, countDiffs(fA+fC, A+C, 0.0));
+      TUASSERTE(int, 0, countDiffs(fA-fC, A-C, 0.0));
+      TUASSERTE(int, 0, countDiffs(fA*2.5, A*2.5, 0.0));
+      TUASSERTE(int, 0, countDiffs(2.5*fA, 2.5*A, 0.0));
+      FixedMatrix<double,4,3> fAT(transpose(fA));
+      TUASSERTE(int, 0, countDiffs(fAT, transpose(A), 0.0));
+
+      FixedVector<double,3> fAv(fA*fv);
+      Vector<double> Av(A*v), uA(u*A);
+      FixedVector<double,4> fuA(fu*fA);
+      int bad(0);
+      for(size_t i=0; i<3; i++) if(fAv[i] != Av[i]) bad++;
+      for(size_t i=0; i<4; i++) if(fuA[i] != uA[i]) bad++;
+      TUASSERTE(int, 0, bad);
+
+         // the generic operators still apply, and return Matrix
+      Matrix<double> mixed(fA*B);
+      TUASSERTE(int, 0, countDiffs(mixed, A*B, 0.0));
+      Vector<double> fvv(fv + v);
+      TUASSERTE(double, 2.0*v(3), fvv(3));
+
+         // rotations
+      for(int axis=1; axis<=3; axis++) {
+         TUASSERTE(int, 0, countDiffs(fixedRotation(0.3*axis,axis),
+                                      rotation(0.3*axis,axis), 0.0));
+      }
+      try {
+         fixedRotation(0.1,4);
+         TUFAIL("fixedRotation with axis 4 should throw");
+      }
+      catch(MatrixException& e) { TUPASS("MatrixException"); }
+
+      FixedVector<double,3> x(1.0), y;
+      y[1] = 1.0;
+      FixedVector<double,3> z(cross(x,y));
+      TUASSERTE(double, -1.0, z[0]);
+      TUASSERTE(double,  0.0, z[1]);
+      TUASSERTE(double,  1.0, z[2]);
+
+      TURETURN();
+   }
+
+   template <size_t N>
+   void inverseTest(TestUtil& testFramework)
+   {
+      Matrix<double> A(N,N);
+      fill(A, 0.01*N);
+      FixedMatrix<double,N,N> fA(A);
+      FixedMatrix<double,N,N> fAI(inverse(fA));
+      TUASSERTE(int, 0, countDiffs(fAI, inverse(A), eps));
+      TUASSERTE(int, 0, countDiffs(fAI*fA, FixedMatrix<double,N,N>::identity(),
+                                   eps));
+
+         // symmetric positive definite
+      FixedMatrix<double,N,N> S(transpose(fA)*fA);
+      Matrix<double> SD(S);
+      Cholesky<double> ch;
+      ch(SD);
+      FixedMatrix<double,N,N> L(cholesky(S));
+      TUASSERTE(int, 0, countDiffs(L, ch.L, eps));
+      TUASSERTE(int, 0, countDiffs(L*transpose(L), S, eps));
+      TUASSERTE(int, 0, countDiffs(inverseChol(S), inverse(SD), 1.e-10));
+
+      FixedVector<double,N> b, x;
+      for(size_t i=0; i<N; i++) b[i] = 1.0 + i;
+      x = choleskySolve(L, b);
+      FixedVector<double,N> r(S*x - b);
+      TUASSERTFEPS(0.0, ::sqrt(dot(r,r)), 1.e-10);
+   }
+
+   int inverseTests()
+   {
+      TUDEF("FixedMatrix", "Inverse");
+
+      inverseTest<2>(testFramework);
+      inverseTest<3>(testFramework);
+      inverseTest<4>(testFramework);
+      inverseTest<6>(testFramework);
+
+         // singular matrices
+      FixedMatrix<double,2,2> S2(1.0);
+      FixedMatrix<double,3,3> S3(1.0);
+      FixedMatrix<double,5,5> S5(1.0);
+      try { inverse(S2); TUFAIL("singular 2x2 should throw"); }
+      catch(SingularMatrixException& e) { TUPASS("SingularMatrixException"); }
+      try { inverse(S3); TUFAIL("singular 3x3 should throw"); }
+      catch(SingularMatrixException& e) { TUPASS("SingularMatrixException"); }
+      try { inverse(S5); TUFAIL("singular 5x5 should throw"); }
+      catch(SingularMatrixException& e) { TUPASS("SingularMatrixException"); }
+      try {
+         cholesky(FixedMatrix<double,3,3>(-1.0));
+         TUFAIL("cholesky of a non-positive definite matrix should throw");
+      }
+      catch(MatrixException& e) { TUPASS("MatrixException"); }
+
+      TURETURN();
+   }
+
+      /// time a chain of 3x3 rotations, as in EarthOrientation
+   int timingTest()
+   {
+      TUDEF("FixedMatrix", "Timing");
+
+      const int n(200000);
+      double sumD(0.0), sumF(0.0);
+      clock_t t0(clock());
+      for(int i=0; i<n; i++) {
+         double a(1.e-6*i);
+         Matrix<double> R(transpose(rotation(-a,1) * rotation(a,3) *
+                                    rotation(2*a,1) * rotation(-a,3)));
+         sumD += R(2,0);
+      }
+      clock_t t1(clock());
+      for(int i=0; i<n; i++) {
+         double a(1.e-6*i);
+         FixedMatrix<double,3,3> R(transpose(fixedRotation(-a,1) *
+                  fixedRotation(a,3) * fixedRotation(2*a,1) * fixedRotation(-a,3)));
+         sumF += R(2,0);
+      }
+      clock_t t2(clock());
+      TUASSERTE(double, sumD, sumF);
+      cout << "Timing " << n << " rotation products: Matrix "
+           << double(t1-t0)/CLOCKS_PER_SEC << " s, FixedMatrix "
+           << double(t2-t1)/CLOCKS_PER_SEC << " s" << endl;
+
+      TURETURN();
+   }
+
+   double eps;
+};
+
+int main()
+{
+   int errorTotal = 0;
+   FixedMatrix_T testClass;
+
+   errorTotal += testClass.constructTest();
+   errorTotal += testClass.operatorTest();
+   errorTotal += testClass.inverseTests();
+   errorTotal += testClass.timingTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -38,6 +38,8 @@
 
 #include "TestUtil.hpp"
 #include "NavFilterMgr.hpp"
+#include "ShardedNavFilterMgr.hpp"
+#include "NavFilterDataPool.hpp"
 #include "LNavFilterData.hpp"
 #include "LNavParityFilter.hpp"
 #include "LNavCookFilter.hpp"
@@ -48,6 +50,7 @@
 #include "NavOrderFilter.hpp"
 #include "CommonTime.hpp"
 #include "TimeString.hpp"
+#include <algorithm>
 
 using namespace std;
 using namespace gpstk;
@@ -71,6 +74,33 @@ unsigned long expLNavEphs = 5210;
 typedef std::set<gpstk::CommonTime> TimeSet;
 
 // define some classes for exercising NavFilterMgr
+// throws on a given subframe
+class ThrowFilter : public NavFilter
+{
+public:
+   ThrowFilter(NavFilterKey *bad) : badMsg(bad) {}
+   virtual void validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
+   {
+      NavMsgList::iterator nmli;
+      for (nmli = msgBitsIn.begin(); nmli != msgBitsIn.end(); nmli++)
+      {
+         if (*nmli == badMsg)
+         {
+            InvalidRequest exc("bad subframe");
+            GPSTK_THROW(exc);
+         }
+         msgBitsOut.push_back(*nmli);
+      }
+   }
+   virtual void finalize(NavMsgList& msgBitsOut)
+   {}
+   virtual unsigned processingDepth() const throw()
+   { return 0; }
+   virtual std::string filterName() const throw()
+   { return "Throw"; }
+   NavFilterKey *badMsg;
+};
+
 class BunkFilterData : public NavFilterKey
 {
 public:
@@ -131,6 +161,26 @@ public:
    NavMsgList cache;
 };
 
+// holds every subframe and rejects them all in finalize
+class FinalRejectFilter : public NavFilter
+{
+public:
+   virtual void validate(NavMsgList& msgBitsIn, NavMsgList& msgBitsOut)
+   {
+      held.splice(held.end(), msgBitsIn);
+   }
+   virtual void finalize(NavMsgList& msgBitsOut)
+   {
+      reject(held);
+      held.clear();
+   }
+   virtual unsigned processingDepth() const throw()
+   { return 1; }
+   virtual std::string filterName() const throw()
+   { return "FinalReject"; }
+   NavMsgList held;
+};
+
 class NavFilterMgr_T
 {
 public:
@@ -154,6 +204,11 @@ public:
    unsigned testLNavEphMaker();
       /// Test the combination of parity, empty and TLM/HOW filters
    unsigned testLNavCombined();
+      /** Test that ShardedNavFilterMgr gives the same results as
+       * NavFilterMgr. */
+   unsigned testSharded();
+      /// Test NavFilterDataPool and NavFilterMgr::setPool().
+   unsigned testPool();
       /** Test that the processingDepth() method returns a correct
        * value for any given NavFilter class. */
    template <class Filter>
@@ -553,6 +608,289 @@ testLNavCombined()
 }
 
 
+// filter chains for ShardedNavFilterMgr
+NavFilterMgr::FilterList makeCombinedChain(unsigned shard)
+{
+   NavFilterMgr::FilterList rv;
+   rv.push_back(new LNavParityFilter);
+   rv.push_back(new LNavEmptyFilter);
+   rv.push_back(new LNavTLMHOWFilter);
+   return rv;
+}
+
+NavFilterMgr::FilterList makeCrossSourceChain(unsigned shard)
+{
+   NavFilterMgr::FilterList rv;
+   rv.push_back(new LNavParityFilter);
+   rv.push_back(new LNavCrossSourceFilter);
+   return rv;
+}
+
+
+unsigned NavFilterMgr_T ::
+testSharded()
+{
+   TUDEF("ShardedNavFilterMgr", "validate");
+
+   try
+   {
+         // Filters of depth 0 give exactly the same results, in the
+         // same order, as NavFilterMgr.
+      NavFilterMgr mgr;
+      LNavParityFilter filtParity;
+      LNavEmptyFilter filtEmpty;
+      LNavTLMHOWFilter filtTLMHOW;
+      mgr.addFilter(&filtParity);
+      mgr.addFilter(&filtEmpty);
+      mgr.addFilter(&filtTLMHOW);
+      NavFilter::NavMsgList expAccepted, l;
+      unsigned long expRejected = 0;
+      clock_t start = clock();
+      for (unsigned i = 0; i < dataIdxLNAV; i++)
+      {
+         l = mgr.validate(&dataLNAV[i]);
+         expAccepted.splice(expAccepted.end(), l);
+         NavFilterMgr::FilterSet::iterator fsi;
+         for (fsi = mgr.rejected.begin(); fsi != mgr.rejected.end(); fsi++)
+            expRejected += (*fsi)->rejected.size();
+      }
+      double serialTime = double(clock() - start) / CLOCKS_PER_SEC;
+      TUASSERTE(unsigned long, expLNavCombined, expRejected);
+
+         // small queues, so that submit() must wait for the workers
+      ShardedNavFilterMgr smgr(makeCombinedChain, 4, 16);
+      TUASSERTE(unsigned, 4, smgr.numShards());
+      TUASSERTE(unsigned, mgr.processingDepth(), smgr.processingDepth());
+      NavFilter::NavMsgList accepted, rejected;
+      start = clock();
+      for (unsigned i = 0; i < dataIdxLNAV; i++)
+      {
+         smgr.submit(&dataLNAV[i]);
+         if ((i % 100) == 0)
+            smgr.collect(accepted, rejected);
+      }
+      smgr.finalize(accepted, rejected);
+      double shardedTime = double(clock() - start) / CLOCKS_PER_SEC;
+      TUASSERTE(unsigned long, expLNavCombined, rejected.size());
+      TUASSERT(expAccepted == accepted);
+      cout << "Filtered " << dataIdxLNAV << " subframes in " << serialTime
+           << " s (NavFilterMgr), " << shardedTime
+           << " s CPU (ShardedNavFilterMgr, 4 shards)" << endl;
+
+         // the same, with messages sharded by PRN and signal
+      ShardedNavFilterMgr ssmgr(makeCombinedChain, 4, 16,
+                                ShardedNavFilterMgr::ShardBySignal);
+      accepted.clear();
+      rejected.clear();
+      for (unsigned i = 0; i < dataIdxLNAV; i++)
+         ssmgr.submit(&dataLNAV[i]);
+      ssmgr.finalize(accepted, rejected);
+      TUASSERTE(unsigned long, expLNavCombined, rejected.size());
+      TUASSERT(expAccepted == accepted);
+
+         // LNavCrossSourceFilter holds data until the time changes;
+         // the same subframes are accepted and rejected, but not
+         // necessarily in the same order.
+      NavFilterMgr xmgr;
+      LNavParityFilter xfiltParity;
+      LNavCrossSourceFilter xfiltCross;
+      xmgr.addFilter(&xfiltParity);
+      xmgr.addFilter(&xfiltCross);
+      vector<NavFilterKey*> expAcc, expRej, acc, rej;
+      for (unsigned i = 0; i < dataIdxLNAV; i++)
+      {
+         l = xmgr.validate(&dataLNAV[i]);
+         expAcc.insert(expAcc.end(), l.begin(), l.end());
+         NavFilterMgr::FilterSet::iterator fsi;
+         for (fsi = xmgr.rejected.begin(); fsi != xmgr.rejected.end(); fsi++)
+            expRej.insert(expRej.end(), (*fsi)->rejected.begin(),
+                          (*fsi)->rejected.end());
+      }
+      l = xmgr.finalize();
+      expAcc.insert(expAcc.end(), l.begin(), l.end());
+      expRej.insert(expRej.end(), xfiltCross.rejected.begin(),
+                    xfiltCross.rejected.end());
+      ShardedNavFilterMgr xsmgr(makeCrossSourceChain, 3);
+      accepted.clear();
+      rejected.clear();
+      for (unsigned i = 0; i < dataIdxLNAV; i++)
+         xsmgr.submit(&dataLNAV[i]);
+      xsmgr.finalize(accepted, rejected);
+      acc.assign(accepted.begin(), accepted.end());
+      rej.assign(rejected.begin(), rejected.end());
+      sort(expAcc.begin(), expAcc.end());
+      sort(expRej.begin(), expRej.end());
+      sort(acc.begin(), acc.end());
+      sort(rej.begin(), rej.end());
+      TUASSERTE(size_t, expAcc.size(), acc.size());
+      TUASSERTE(size_t, expRej.size(), rej.size());
+      TUASSERT(expAcc == acc);
+      TUASSERT(expRej == rej);
+   }
+   catch (...)
+   {
+      TUFAIL("Exception");
+   }
+
+      // An exception thrown by a filter is passed to the caller, in
+      // order, after the results for the earlier subframes.
+   testFramework.changeSourceMethod("collect");
+   unsigned bad = 1000;
+   ShardedNavFilterMgr::ChainFactory throwChain =
+      [this, bad](unsigned shard)
+      {
+         NavFilterMgr::FilterList rv;
+         rv.push_back(new ThrowFilter(&dataLNAV[bad]));
+         return rv;
+      };
+   ShardedNavFilterMgr tsmgr(throwChain, 2);
+   NavFilter::NavMsgList accepted, rejected;
+   for (unsigned i = 0; i < 2*bad; i++)
+      tsmgr.submit(&dataLNAV[i]);
+   try
+   {
+      tsmgr.collect(accepted, rejected, true);
+      TUFAIL("Expected an exception");
+   }
+   catch (InvalidRequest& exc)
+   {
+      TUPASS("exception");
+   }
+   TUASSERTE(size_t, bad, accepted.size());
+   tsmgr.collect(accepted, rejected, true);
+   TUASSERTE(size_t, 2*bad-1, accepted.size());
+
+      // Messages rejected by finalize() are returned too.
+   testFramework.changeSourceMethod("finalize");
+   ShardedNavFilterMgr::ChainFactory finalChain =
+      [](unsigned shard)
+      {
+         NavFilterMgr::FilterList rv;
+         rv.push_back(new FinalRejectFilter);
+         return rv;
+      };
+   ShardedNavFilterMgr fsmgr(finalChain, 3);
+   accepted.clear();
+   rejected.clear();
+   for (unsigned i = 0; i < 100; i++)
+      fsmgr.submit(&dataLNAV[i]);
+   fsmgr.collect(accepted, rejected, true);
+   TUASSERTE(size_t, 0, accepted.size());
+   TUASSERTE(size_t, 0, rejected.size());
+   fsmgr.finalize(accepted, rejected);
+   TUASSERTE(size_t, 0, accepted.size());
+   TUASSERTE(size_t, 100, rejected.size());
+
+   TURETURN();
+}
+
+
+unsigned NavFilterMgr_T ::
+testPool()
+{
+   TUDEF("NavFilterDataPool", "get");
+
+   NavFilterDataPool<LNavPoolData> pool;
+   NavFilterMgr mgr;
+   LNavParityFilter filtParity;
+   LNavEmptyFilter filtEmpty;
+   LNavTLMHOWFilter filtTLMHOW;
+   LNavCrossSourceFilter filtCross;
+   mgr.addFilter(&filtParity);
+   mgr.addFilter(&filtEmpty);
+   mgr.addFilter(&filtTLMHOW);
+   mgr.addFilter(&filtCross);
+   mgr.setPool(&pool);
+
+      // the same filters without the pool, for reference
+   NavFilterMgr refMgr;
+   LNavParityFilter refParity;
+   LNavEmptyFilter refEmpty;
+   LNavTLMHOWFilter refTLMHOW;
+   LNavCrossSourceFilter refCross;
+   refMgr.addFilter(&refParity);
+   refMgr.addFilter(&refEmpty);
+   refMgr.addFilter(&refTLMHOW);
+   refMgr.addFilter(&refCross);
+
+   unsigned long accepted = 0, refAccepted = 0, badCopy = 0;
+   NavFilter::NavMsgList l;
+   NavFilter::NavMsgList::iterator nmli;
+   for (unsigned i = 0; i < dataIdxLNAV; i++)
+   {
+      LNavPoolData *fd = pool.get();
+      fd->timeStamp = dataLNAV[i].timeStamp;
+      fd->prn = dataLNAV[i].prn;
+      fd->carrier = dataLNAV[i].carrier;
+      fd->code = dataLNAV[i].code;
+      std::copy(dataLNAV[i].sf, dataLNAV[i].sf+10, fd->words);
+      l = mgr.validate(fd);
+      accepted += l.size();
+      for (nmli = l.begin(); nmli != l.end(); nmli++)
+      {
+         LNavPoolData *ofd = dynamic_cast<LNavPoolData*>(*nmli);
+         if ((ofd == NULL) || (ofd->sf != ofd->words))
+            badCopy++;
+      }
+      pool.release(l);
+      refAccepted += refMgr.validate(&dataLNAV[i]).size();
+   }
+   l = mgr.finalize();
+   accepted += l.size();
+   pool.release(l);
+   refAccepted += refMgr.finalize().size();
+   TUASSERTE(unsigned long, refAccepted, accepted);
+   TUASSERTE(unsigned long, 0, badCopy);
+      // All but the rejected messages of the last call are back in
+      // the pool, which only had to hold about one epoch of data.
+   size_t held = 0;
+   NavFilterMgr::FilterSet::iterator fsi;
+   for (fsi = mgr.rejected.begin(); fsi != mgr.rejected.end(); fsi++)
+      held += (*fsi)->rejected.size();
+   TUASSERTE(size_t, pool.size(), pool.available() + held);
+   TUASSERT(pool.size() < 100);
+      // recycle the remaining rejects
+   mgr.finalize();
+   TUASSERTE(size_t, pool.size(), pool.available());
+
+      // copies point to their own data
+   LNavPoolData lcopy(*pool.get());
+   TUASSERT(lcopy.sf == lcopy.words);
+   NavFilterDataPool<CNavPoolData> cpool;
+   CNavPoolData *cfd = cpool.get();
+   TUASSERT(cfd->pnb == &cfd->bits);
+   CNavPoolData ccopy(*cfd);
+   TUASSERT(ccopy.pnb == &ccopy.bits);
+   cpool.release(cfd);
+   TUASSERTE(CNavPoolData*, cfd, cpool.get());
+
+      // compare with allocating each subframe
+   const unsigned N = 200000;
+   clock_t start = clock();
+   for (unsigned i = 0; i < N; i++)
+   {
+      LNavFilterData *fd = new LNavFilterData;
+      fd->sf = new uint32_t[10];
+      fd->prn = i;
+      delete [] fd->sf;
+      delete fd;
+   }
+   double heapTime = double(clock() - start) / CLOCKS_PER_SEC;
+   start = clock();
+   for (unsigned i = 0; i < N; i++)
+   {
+      LNavPoolData *fd = pool.get();
+      fd->prn = i;
+      pool.release(fd);
+   }
+   double poolTime = double(clock() - start) / CLOCKS_PER_SEC;
+   cout << N << " subframes allocated in " << heapTime << " s (new/delete), "
+        << poolTime << " s (NavFilterDataPool)" << endl;
+
+   TURETURN();
+}
+
+
 template <class Filter>
 unsigned NavFilterMgr_T ::
 testProcessingDepth(const std::string& filterName)
@@ -811,6 +1149,8 @@ int main()
    errorTotal += testClass.testLNavTLMHOW();
    errorTotal += testClass.testLNavEphMaker();
    errorTotal += testClass.testLNavCombined();
+   errorTotal += testClass.testSharded();
+   errorTotal += testClass.testPool();
    errorTotal += testClass.testProcessingDepths();
    errorTotal += testClass.testBunk1();
    errorTotal += testClass.testBunk2();
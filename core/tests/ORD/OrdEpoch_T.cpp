@@ -0,0 +1,292 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file OrdEpoch_T.cpp
+/// Test ord::EpochObservedRanges() against the per-satellite ORD functions,
+/// with real broadcast ephemerides; unlike the other ORD tests this one does
+/// not need GMock.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <ctime>
+
+#include "Exception.hpp"
+#include "CivilTime.hpp"
+#include "RinexEphemerisStore.hpp"
+#include "SimpleTropModel.hpp"
+#include "IonoModelStore.hpp"
+#include "ord.hpp"
+
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class OrdEpoch_T
+{
+public:
+   OrdEpoch_T();
+
+      /// all terms against the per-satellite functions, in 1 and 4 threads
+   int epochTest();
+      /// missing satellites, models without data, bad input
+   int errorTest();
+      /// time of the batch and per-satellite paths
+   int timingTest();
+
+private:
+   RinexEphemerisStore ephemStore;
+   Position receiverPos;
+   CommonTime timeReceived;
+   vector<SatID> sats;
+   vector<double> pseudoranges;
+   SimpleTropModel tropModel;
+   IonoModelStore ionoModel;
+
+      /// the per-satellite path for sats[i]; false if it throws
+   bool perSatellite(size_t i, ord::RangeTerms& rt);
+};
+
+OrdEpoch_T::OrdEpoch_T()
+      : tropModel(18.8889, 1021.2176, 77.7777)
+{
+   ephemStore.loadFile(getPathData() + getFileSep()
+                       + "test_input_rinex_nav_ephemerisData.031");
+   receiverPos.setGeodetic(30.387577, -97.727607, 240);
+   timeReceived = CivilTime(2006, 1, 31, 4, 0, 0, TimeSystem::GPS);
+
+   double a[] = {1,2,3,4}, b[] = {4,3,2,1};
+   ionoModel.addIonoModel(CivilTime(2006, 1, 31, 0, 0, 0, TimeSystem::GPS),
+                          IonoModel(a,b));
+
+   for(int prn=1; prn<=32; prn++) {
+      sats.push_back(SatID(prn, SatelliteSystem::GPS));
+      pseudoranges.push_back(2.1e7 + 1.0e5*prn);
+   }
+}
+
+bool OrdEpoch_T::perSatellite(size_t i, ord::RangeTerms& rt)
+{
+   try {
+      Xvt svXvt;
+      rt.satId = sats[i];
+      rt.rawRange = ord::RawRange1(receiverPos, sats[i], timeReceived,
+                                   ephemStore, svXvt);
+      rt.svXvt = svXvt;
+      rt.svClockBias = ord::SvClockBiasCorrection(svXvt);
+      rt.svRelativity = ord::SvRelativityCorrection(svXvt);
+      rt.elevation = receiverPos.elevation(Position(svXvt));
+      rt.azimuth = receiverPos.azimuth(Position(svXvt));
+      rt.troposphere = ord::TroposphereCorrection(tropModel, receiverPos,
+                                                  svXvt);
+      rt.ionosphere = ord::IonosphereModelCorrection(ionoModel, timeReceived,
+                                                     CarrierBand::L1,
+                                                     receiverPos, svXvt);
+      rt.ord = pseudoranges[i] - (rt.rawRange + rt.svRelativity
+                                  + rt.svClockBias + rt.troposphere
+                                  + rt.ionosphere);
+      rt.valid = true;
+   }
+   catch(Exception& e) {
+      rt.valid = false;
+   }
+   return rt.valid;
+}
+
+//------------------------------------------------------------------------------------
+int OrdEpoch_T::epochTest()
+{
+   TUDEF("ord", "EpochObservedRanges");
+
+   for(unsigned nthreads = 1; nthreads <= 4; nthreads += 3) {
+      vector<ord::RangeTerms> terms;
+      unsigned nvalid = ord::EpochObservedRanges(receiverPos, timeReceived,
+                                                 sats, ephemStore, terms,
+                                                 &pseudoranges, &tropModel,
+                                                 &ionoModel, CarrierBand::L1,
+                                                 nthreads);
+      TUASSERTE(size_t, sats.size(), terms.size());
+      unsigned nexp = 0;
+      for(size_t i=0; i<sats.size(); i++) {
+         ord::RangeTerms rt;
+         TUASSERTE(SatID, sats[i], terms[i].satId);
+         TUASSERTE(bool, perSatellite(i, rt), terms[i].valid);
+         if(!rt.valid)
+            continue;
+         nexp++;
+         for(int k=0; k<3; k++) {
+            TUASSERTE(double, rt.svXvt.x[k], terms[i].svXvt.x[k]);
+            TUASSERTE(double, rt.svXvt.v[k], terms[i].svXvt.v[k]);
+         }
+         TUASSERTE(double, rt.rawRange, terms[i].rawRange);
+         TUASSERTE(double, rt.elevation, terms[i].elevation);
+         TUASSERTE(double, rt.azimuth, terms[i].azimuth);
+         TUASSERTE(double, rt.svClockBias, terms[i].svClockBias);
+         TUASSERTE(double, rt.svRelativity, terms[i].svRelativity);
+         TUASSERTE(double, rt.troposphere, terms[i].troposphere);
+         TUASSERTE(double, rt.ionosphere, terms[i].ionosphere);
+         TUASSERTE(double, rt.ord, terms[i].ord);
+      }
+      TUASSERTE(unsigned, nexp, nvalid);
+      TUASSERTE(unsigned, 3, nvalid);   // PRNs 1, 15 and 32 in the file
+   }
+
+   // without pseudoranges or models, the geometric terms only
+   vector<ord::RangeTerms> terms;
+   ord::EpochObservedRanges(receiverPos, timeReceived, sats, ephemStore, terms);
+   for(size_t i=0; i<sats.size(); i++) {
+      ord::RangeTerms rt;
+      if(!perSatellite(i, rt))
+         continue;
+      TUASSERTE(double, rt.rawRange, terms[i].rawRange);
+      TUASSERTE(double, 0.0, terms[i].troposphere);
+      TUASSERTE(double, 0.0, terms[i].ionosphere);
+      TUASSERTE(double, 0.0, terms[i].ord);
+   }
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int OrdEpoch_T::errorTest()
+{
+   TUDEF("ord", "EpochObservedRanges");
+
+   vector<ord::RangeTerms> terms;
+
+   // no ephemeris: a satellite not in the store, and a time outside it
+   vector<SatID> none(1, SatID(5, SatelliteSystem::Glonass));
+   TUASSERTE(unsigned, 0,
+             ord::EpochObservedRanges(receiverPos, timeReceived, none,
+                                      ephemStore, terms));
+   TUASSERT(!terms[0].valid);
+   CommonTime later(CivilTime(2007, 1, 1, 0, 0, 0, TimeSystem::GPS));
+   TUASSERTE(unsigned, 0,
+             ord::EpochObservedRanges(receiverPos, later, sats, ephemStore,
+                                      terms, NULL, NULL, NULL,
+                                      CarrierBand::L1, 0));
+   TUASSERTE(size_t, sats.size(), terms.size());
+
+   // an ionosphere model with no data at the time
+   IonoModelStore emptyIono;
+   TUASSERTE(unsigned, 0,
+             ord::EpochObservedRanges(receiverPos, timeReceived, sats,
+                                      ephemStore, terms, NULL, NULL,
+                                      &emptyIono));
+
+   // no satellites
+   vector<SatID> empty;
+   TUASSERTE(unsigned, 0,
+             ord::EpochObservedRanges(receiverPos, timeReceived, empty,
+                                      ephemStore, terms, NULL, NULL, NULL,
+                                      CarrierBand::L1, 4));
+   TUASSERTE(size_t, 0, terms.size());
+
+   // pseudoranges not parallel to the satellites
+   vector<double> prs(3, 2.1e7);
+   try {
+      ord::EpochObservedRanges(receiverPos, timeReceived, sats, ephemStore,
+                               terms, &prs);
+      TUFAIL("No exception for mismatched pseudoranges");
+   }
+   catch(InvalidRequest& e) { TUPASS("Exception for mismatched pseudoranges"); }
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int OrdEpoch_T::timingTest()
+{
+   TUDEF("ord", "EpochObservedRanges");
+
+   // only the satellites with ephemerides, so that both paths do the same work
+   vector<SatID> have;
+   vector<double> prs;
+   vector<ord::RangeTerms> terms;
+   ord::EpochObservedRanges(receiverPos, timeReceived, sats, ephemStore, terms);
+   for(size_t i=0; i<sats.size(); i++) {
+      if(terms[i].valid) {
+         have.push_back(sats[i]);
+         prs.push_back(pseudoranges[i]);
+      }
+   }
+   sats.swap(have);
+   pseudoranges.swap(prs);
+
+   const int N(2000);
+   clock_t t0 = clock();
+   for(int n=0; n<N; n++) {
+      terms.resize(sats.size());
+      for(size_t i=0; i<sats.size(); i++)
+         perSatellite(i, terms[i]);
+   }
+   double dtSat = double(clock()-t0)/CLOCKS_PER_SEC;
+
+   t0 = clock();
+   for(int n=0; n<N; n++)
+      ord::EpochObservedRanges(receiverPos, timeReceived, sats, ephemStore,
+                               terms, &pseudoranges, &tropModel, &ionoModel);
+   double dtEpoch = double(clock()-t0)/CLOCKS_PER_SEC;
+
+   sats.swap(have);
+   pseudoranges.swap(prs);
+
+   cout << "ORD " << N << " epochs of " << have.size() << " satellites:"
+        << " per satellite " << dtSat << " s, per epoch " << dtEpoch << " s"
+        << endl;
+   TUPASS("timing");
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int main()
+{
+   OrdEpoch_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.epochTest();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.timingTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
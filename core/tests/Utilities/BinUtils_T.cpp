@@ -41,6 +41,8 @@
 #include "Exception.hpp"
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace std;
 
@@ -589,6 +591,64 @@ public:
       return testFramework.countFails();
    }
 
+      //==========================================================
+      //        Test Suite: crc24qTest()
+      //==========================================================
+      //
+      //        Compares the table-driven CRC-24Q with a bit-by-bit
+      //        computation, whole bytes and odd numbers of bits
+      //
+      //==========================================================
+   int crc24qTest(void)
+   {
+      TUDEF("BinUtils", "crc24q");
+
+         // check value for "123456789"
+      const unsigned char check[] = "123456789";
+      TUASSERTE(uint32_t, 0xcde703, gpstk::BinUtils::crc24q(check, 9));
+
+         // the same message, in pieces
+      uint32_t crc = gpstk::BinUtils::crc24q(check, 4);
+      TUASSERTE(uint32_t, 0xcde703, gpstk::BinUtils::crc24q(check+4, 5, crc));
+      crc = gpstk::BinUtils::crc24qBits(0x31323334353637ULL, 56);
+      TUASSERTE(uint32_t, 0xcde703,
+                gpstk::BinUtils::crc24qBits(0x3839, 16, crc));
+
+         // 300-bit messages, as GPS CNAV, in pieces of 1 to 64 bits
+      srand(300);
+      int bad = 0;
+      for (int m=0; m<200; m++)
+      {
+         unsigned char bits[300];
+         uint32_t ref = 0;
+         for (int i=0; i<276; i++)
+         {
+            bits[i] = rand() & 1;
+            ref ^= (uint32_t)bits[i] << 23;
+            ref <<= 1;
+            if (ref & 0x1000000)
+               ref ^= 0x1864cfb;
+         }
+         crc = 0;
+         for (int i=0; i<276; )
+         {
+            int n = std::min(276-i, 1 + rand()%64);
+            uint64_t word = 0;
+            for (int j=0; j<n; j++)
+               word = (word << 1) | bits[i+j];
+            crc = gpstk::BinUtils::crc24qBits(word, n, crc);
+            i += n;
+         }
+         if (crc != ref) bad++;
+
+            // a message followed by its CRC gives zero
+         if (gpstk::BinUtils::crc24qBits(crc, 24, crc) != 0) bad++;
+      }
+      TUASSERTE(int, 0, bad);
+
+      return testFramework.countFails();
+   }
+
 };
 
 
@@ -608,6 +668,7 @@ int main (void)
    errorTotal += testClass.computeCRCTest();
    errorTotal += testClass.xorChecksumTest();
    errorTotal += testClass.countBitsTest();
+   errorTotal += testClass.crc24qTest();
 
    cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
 
@@ -0,0 +1,216 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <algorithm>
+#include <thread>
+#include "MultiSVPCodeGen.hpp"
+#include "SVPCodeGen.hpp"
+#include "X1Sequence.hpp"
+#include "X2Sequence.hpp"
+#include "GPSWeekZcount.hpp"
+#include "Exception.hpp"
+
+using namespace std;
+namespace gpstk
+{
+   const long MultiSVPCodeGen::NUM_6SEC_WORDS64;
+
+      /*
+         Generate words [first,last) of the interval for all the
+         satellites.  X2count[k] is the X2 position of the first chip of
+         the interval for satellite k (see SVPCodeGen::initialX2Count).
+      */
+   static void generateWords( const uint32_t* X1Words,
+                              const uint64_t* X2Words,
+                              const vector<long>& X2count,
+                              long firstWord, long first, long last,
+                              vector< vector<uint64_t> >& codes )
+   {
+      const size_t numSVs = X2count.size();
+      const long WORD_BITS = 2*MAX_BIT;
+
+         // Position in the X2 table (X2 position + BOW delay) of the
+         // first chip of word 'first', for each satellite.  The interval
+         // is shorter than an X2 cycle, so there is at most one wrap.
+      vector<long> X2pos( numSVs );
+      for (size_t k=0; k<numSVs; ++k)
+      {
+         long X2c = X2count[k] + first*WORD_BITS;
+         if (X2c>=MAX_X2_TEST) X2c -= MAX_X2_TEST;
+         X2pos[k] = X2c + X2A_EPOCH_DELAY;
+      }
+
+      for (long i=first; i<last; ++i)
+      {
+         const uint64_t X1 = (uint64_t(X1Words[2*i]) << MAX_BIT) |
+                              X1Words[2*i+1];
+         for (size_t k=0; k<numSVs; ++k)
+         {
+            const long pos = X2pos[k];
+            const long ndx = pos / WORD_BITS;
+            const int offset = int(pos - ndx*WORD_BITS);
+            uint64_t X2 = X2Words[ndx];
+            if (offset!=0)
+               X2 = (X2 << offset) | (X2Words[ndx+1] >> (WORD_BITS-offset));
+            codes[k][i-firstWord] = X1 ^ X2;
+
+            X2pos[k] = pos + WORD_BITS;
+            if (X2pos[k]>=MAX_X2_COUNT) X2pos[k] -= MAX_X2_TEST;
+         }
+      }
+
+         // The final word of the interval holds only 32 chips.
+      if (last==MultiSVPCodeGen::NUM_6SEC_WORDS64)
+      {
+         for (size_t k=0; k<numSVs; ++k)
+            codes[k][last-1-firstWord] &= ~uint64_t(0) << MAX_BIT;
+      }
+   }
+
+   MultiSVPCodeGen::MultiSVPCodeGen( const vector<int>& SVPRNIDs,
+                                     const gpstk::CommonTime& dt )
+      : PRNIDs(SVPRNIDs), currentZTime(dt)
+   {
+      for (size_t k=0; k<PRNIDs.size(); ++k)
+      {
+         if (PRNIDs[k] < 0 || PRNIDs[k] > 210)
+         {
+            gpstk::Exception e("Must provide a prn between 0 and 210");
+            GPSTK_THROW(e);
+         }
+      }
+   }
+
+   void MultiSVPCodeGen::getCurrentSixSeconds(
+      vector< vector<uint64_t> >& codes, unsigned numThreads ) const
+   {
+      getWords( 0, NUM_6SEC_WORDS64, codes, numThreads );
+   }
+
+   void MultiSVPCodeGen::getWords( long firstWord, long numWords,
+                                   vector< vector<uint64_t> >& codes,
+                                   unsigned numThreads ) const
+   {
+      if (firstWord < 0 || numWords < 0 ||
+          firstWord + numWords > NUM_6SEC_WORDS64)
+      {
+         gpstk::Exception e("Words requested are outside the six seconds");
+         GPSTK_THROW(e);
+      }
+
+         // The X2 start, and the X2 table, for each satellite; all of
+         // them use the same table except at the end of the week, when
+         // satellites with PRN above 37 have already started a new week.
+      vector<long> X2count( PRNIDs.size() );
+      vector<bool> isEOW( PRNIDs.size() );
+      bool anyEOW = false, allEOW = true;
+      for (size_t k=0; k<PRNIDs.size(); ++k)
+      {
+         bool eow;
+         X2count[k] = SVPCodeGen::initialX2Count( PRNIDs[k], currentZTime, eow );
+         isEOW[k] = eow;
+         anyEOW |= eow;
+         allEOW &= eow;
+      }
+
+      codes.resize( PRNIDs.size() );
+      for (size_t k=0; k<codes.size(); ++k)
+         codes[k].resize( numWords );
+      if (PRNIDs.empty() || numWords==0) return;
+
+      const uint32_t* X1Words = X1Sequence::words();
+      if (anyEOW && !allEOW)
+      {
+            // Mixed; generate the two groups separately.
+         for (int eow=0; eow<2; ++eow)
+         {
+            vector<long> X2group;
+            vector<size_t> index;
+            for (size_t k=0; k<PRNIDs.size(); ++k)
+            {
+               if (isEOW[k] != (eow==1)) continue;
+               X2group.push_back( X2count[k] );
+               index.push_back( k );
+            }
+            vector< vector<uint64_t> > group( index.size() );
+            for (size_t k=0; k<index.size(); ++k) group[k].swap( codes[index[k]] );
+            generateWords( X1Words, X2Sequence::words64(eow==1), X2group,
+                           firstWord, firstWord, firstWord+numWords, group );
+            for (size_t k=0; k<index.size(); ++k) group[k].swap( codes[index[k]] );
+         }
+         return;
+      }
+      const uint64_t* X2Words = X2Sequence::words64( anyEOW );
+
+      if (numThreads == 0)
+         numThreads = std::thread::hardware_concurrency();
+      if (numThreads < 1)
+         numThreads = 1;
+      if (long(numThreads) > numWords)
+         numThreads = unsigned(numWords);
+
+         // contiguous blocks of words; each thread writes only its own
+         // elements of the output
+      vector<std::thread> threads;
+      long block = (numWords + numThreads - 1) / numThreads;
+      for (long first = firstWord + block; first < firstWord + numWords;
+           first += block)
+      {
+         long last = first + block;
+         if (last > firstWord + numWords) last = firstWord + numWords;
+         threads.push_back(std::thread(generateWords, X1Words, X2Words,
+                                       std::cref(X2count), firstWord,
+                                       first, last, std::ref(codes)));
+      }
+      generateWords( X1Words, X2Words, X2count, firstWord, firstWord,
+                     std::min(firstWord+block, firstWord+numWords), codes );
+      for (size_t t=0; t<threads.size(); ++t)
+         threads[t].join();
+   }
+
+   void MultiSVPCodeGen::increment4ZCounts( )
+   {
+      currentZTime += 6;    // 6 seconds == 4 Zcounts.
+   }
+   
+   void MultiSVPCodeGen::setCurrentZCount(const gpstk::GPSZcount& z)
+   {
+      GPSZcount z2 = z - z%4;
+      currentZTime = GPSWeekZcount(z2.getWeek(), z2.getZcount());
+   }
+}     // end of namespace
@@ -0,0 +1,130 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#ifndef MULTISVPCODEGEN_HPP
+#define MULTISVPCODEGEN_HPP
+
+#include <vector>
+#include "CommonTime.hpp"
+#include "GPSZcount.hpp"
+#include "PCodeConst.hpp"
+#include "gpstkplatform.h"
+
+namespace gpstk 
+{
+/// @ingroup code
+//@{
+   /**
+    *  Multi-SV P-code Generator.
+    *
+    *  MultiSVPCodeGen produces the same P-code chips as SVPCodeGen, for
+    *  several satellites at once.  The code is packed 64 chips per
+    *  64-bit word, time order starting with the MSB of word 0, rather
+    *  than 32 per word as in CodeBuffer.  Six seconds of code are
+    *  NUM_6SEC_WORDS64 words; since NUM_6SEC_WORDS is odd, the low 32
+    *  bits of the final word are zero.
+    *
+    *  The generator works from the shared, immutable X1 and 64-bit X2
+    *  tables (X1Sequence::words() and X2Sequence::words64()), so each
+    *  output word is two X1 words, read once for all satellites, XOR'd
+    *  with 64 bits of X2 read from two adjacent words without any wrap
+    *  test.  allocateMemory() is not needed, and the tables may be used
+    *  by generators in several threads at once.  The words of an
+    *  interval may also be generated in pieces (getWords()) so that the
+    *  code for many satellites need not be held in memory at once.
+    *
+    *  As for SVPCodeGen, the time must be on a four Z-count boundary,
+    *  and is advanced with increment4ZCounts().
+    */
+   class MultiSVPCodeGen
+   {
+   public:
+         /// Number of 64-bit words holding six seconds of P-code
+      static const long NUM_6SEC_WORDS64 = (NUM_6SEC_WORDS+1)/2;
+
+      /**
+       *  Instantiate a generator for the satellites PRNIDs starting at
+       *  time dt.
+       *  @throw Exception if any PRN is not between 0 and 210.
+       */
+      MultiSVPCodeGen( const std::vector<int>& PRNIDs,
+                       const gpstk::CommonTime& dt );
+      ~MultiSVPCodeGen( ) {};
+
+      /**
+       *  Generate the six seconds of P-code at the current time for each
+       *  of the satellites; codes is resized to the number of satellites,
+       *  and codes[k], for the satellite getPRNIDs()[k], to
+       *  NUM_6SEC_WORDS64.
+       *  @param numThreads number of threads among which the words are
+       *     divided; 0 means use std::thread::hardware_concurrency().
+       */
+      void getCurrentSixSeconds( std::vector< std::vector<uint64_t> >& codes,
+                                 unsigned numThreads = 1 ) const;
+
+      /**
+       *  Generate numWords 64-bit words of P-code, starting with word
+       *  firstWord of the six seconds at the current time, for each of
+       *  the satellites; codes is resized to the number of satellites,
+       *  and codes[k] to numWords.
+       *  @param numThreads as for getCurrentSixSeconds()
+       *  @throw Exception if the words are not within the six seconds
+       */
+      void getWords( long firstWord, long numWords,
+                     std::vector< std::vector<uint64_t> >& codes,
+                     unsigned numThreads = 1 ) const;
+
+         /// Advance the current time by 4 Z-counts.
+      void increment4ZCounts();
+
+         /// Return the current time.
+      const gpstk::CommonTime& getCurrentZCount() const {return currentZTime;}
+
+         /// Set the current time; as SVPCodeGen::setCurrentZCount()
+      void setCurrentZCount(const gpstk::GPSZcount& z);
+
+         /// Return the satellites, in the order of the output codes.
+      const std::vector<int>& getPRNIDs() const {return PRNIDs;}
+
+   private:
+      std::vector<int> PRNIDs;
+      gpstk::CommonTime currentZTime;
+   };
+   //@}
+}     // end of namespace
+#endif // MULTISVPCODEGEN_HPP
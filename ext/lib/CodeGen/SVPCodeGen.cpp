@@ -57,12 +57,14 @@ namespace gpstk
       PRNID = SVPRNID;
    }
 
-   void SVPCodeGen::getCurrentSixSeconds( CodeBuffer& pcb )
+   long SVPCodeGen::initialX2Count( const int PRNID,
+                                    const gpstk::CommonTime& dt,
+                                    bool& isEOW )
    {
          // Compute appropriate X2A offset
       int dayAdvance = (PRNID - 1) / 37;
       int EffPRNID = PRNID - dayAdvance * 37;
-      long X1count = GPSWeekZcount(currentZTime + dayAdvance*86400.0).zcount;
+      long X1count = GPSWeekZcount(dt + dayAdvance*86400.0).zcount;
       long X2count;
    
          /*
@@ -91,11 +93,20 @@ namespace gpstk
 
          /*
             If this if the final six-second interval of the week, 
-            signal the X2 bit sequence generator to use the "end of week"
-            sequence.  Otherwise, use the "regular" sequence.
+            the "end of week" X2 sequence must be used.  Otherwise, use
+            the "regular" sequence.
          */
-      if ( X1count==LAST_6SEC_ZCOUNT_OF_WEEK) X2Seq.setEOWX2Epoch(true);
-       else X2Seq.setEOWX2Epoch(false);
+      isEOW = (X1count==LAST_6SEC_ZCOUNT_OF_WEEK);
+      return(X2count);
+   }
+
+   void SVPCodeGen::getCurrentSixSeconds( CodeBuffer& pcb )
+   {
+      bool isEOW;
+      long X2count = initialX2Count( PRNID, currentZTime, isEOW );
+
+         // Signal the X2 bit sequence generator which sequence to use.
+      X2Seq.setEOWX2Epoch(isEOW);
    
          // Update the time and code state in the CodeBuffer object
       pcb.updateBufferStatus( currentZTime, P_CODE );
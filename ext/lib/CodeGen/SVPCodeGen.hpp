@@ -138,6 +138,16 @@ namespace gpstk
           time.
       **/
       void setCurrentZCount(const gpstk::GPSZcount& z);
+
+      /**
+       * Return the position in the X2 sequence (see X2Sequence::operator[])
+       * of the first chip of the six seconds of P-code starting at time
+       * dt for the satellite PRNID, and set isEOW true if the "end of
+       * week" X2 sequence applies to those six seconds.
+       */
+      static long initialX2Count( const int PRNID,
+                                  const gpstk::CommonTime& dt,
+                                  bool& isEOW );
      
    private:
       gpstk::X1Sequence X1Seq;
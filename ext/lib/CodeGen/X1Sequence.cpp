@@ -53,7 +53,7 @@ namespace gpstk
 {
       //   Static Variable Definition
    bool X1Sequence::isInit = false;
-   uint32_t* X1Sequence::X1Bits = 0;
+   const uint32_t* X1Sequence::X1Bits = 0;
 
    X1Sequence::X1Sequence(  )
    {
@@ -67,27 +67,47 @@ namespace gpstk
    
    void X1Sequence::allocateMemory( )
    {
-      int X1Aepoch;
-      int X1Acount;
-      int X1Bepoch;
-      int X1Bcount;
-      int X1epoch = 1;
-      long X1Word = 0;
-      int lengthOfX1BSequence;
-   
       if (isInit==true)
       {
          gpstk::Exception e ("X1Sequence::allocateMemory() called multiple times");
          GPSTK_THROW(e);
       }
       
-      X1Bits = new uint32_t[NUM_6SEC_WORDS];
-      if (X1Bits==0) 
+      X1Bits = words();
+      isInit = true;
+   }
+
+   void X1Sequence::deAllocateMemory()
+   {
+      if (isInit!=true || X1Bits==0)
       {
-         gpstk::Exception e ("X1Sequence::allocateMemory() - allocation failed.");
+         gpstk::Exception e("X1Sequence::deAllocateMemory() called when no memory allocated.");
          GPSTK_THROW(e);
       }
+      X1Bits = 0;
+      isInit = false;
+   }
+
+   const uint32_t* X1Sequence::words( )
+   {
+         // Initialization of a function-local static happens once, and
+         // other threads wait for it to complete.
+      static const std::vector<uint32_t> X1Words( generate() );
+      return(&X1Words[0]);
+   }
+
+   std::vector<uint32_t> X1Sequence::generate( )
+   {
+      int X1Aepoch;
+      int X1Acount;
+      int X1Bepoch;
+      int X1Bcount;
+      int X1epoch = 1;
+      long X1Word = 0;
+      int lengthOfX1BSequence;
    
+      std::vector<uint32_t> bits( NUM_6SEC_WORDS+1, 0 );
+
          // Generate the X1A and X1B sequences.
       gpstk::GenXSequence X1A( X1A_INIT, X1A_TAPS, XA_COUNT, XA_EPOCH_DELAY);
       gpstk::GenXSequence X1B( X1B_INIT, X1B_TAPS, XB_COUNT, XB_EPOCH_DELAY);
@@ -135,21 +155,10 @@ namespace gpstk
             X1B.setLengthOfSequence( lengthOfX1BSequence );
          }
          
-         X1Bits[X1Word++] = X1Abits ^ X1Bbits;
+         bits[X1Word++] = X1Abits ^ X1Bbits;
       }   
    
-      isInit = true;
-   }
-
-   void X1Sequence::deAllocateMemory()
-   {
-      if (isInit!=true || X1Bits==0)
-      {
-         gpstk::Exception e("X1Sequence::deAllocateMemory() called when no memory allocated.");
-         GPSTK_THROW(e);
-      }
-      delete [] X1Bits;
-      isInit = false;
+      return(bits);
    }
    
 }     // end of namespace
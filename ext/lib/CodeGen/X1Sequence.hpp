@@ -41,6 +41,9 @@
 #ifndef X1SEQUENCE_HPP
 #define X1SEQUENCE_HPP
 
+   // Language headers
+#include <vector>
+
    // Project headers
 #include "gpstkplatform.h"
 #include "PCodeConst.hpp"
@@ -86,8 +89,8 @@ namespace gpstk
             /**  The X1 sequence requires a 6-second buffer of 10MBit/sec 
              *   samples.  This comes to approximately 2 million four-byte
              *   unsigned integers.  These data are the same for all PRN codes
-             *   To minimize the memory footprint, these data are stored
-             *   in a dynamically-allocated static array.  It is 
+             *   and are held in a single immutable table (see words()),
+             *   built on first use.  For compatibility, it is still
              *     - - - - NECESSARY - - - -
              *   that the calling method call X1Sequence::allocateMemory()
              *   PRIOR to instantiating the first X1Sequence object. 
@@ -96,30 +99,39 @@ namespace gpstk
              *   gpstk::Exception thrown from either X1Sequence::X1Sequence()
              *   or X1Sequence::allocateMemory().
              *
-             *   The X1Sequence::deAllocateMemory() method may be called to
-             *   release the memory (if desired) but it should only be called
-             *   after all X1Sequence objects have been "destroyed".
+             *   The X1Sequence::deAllocateMemory() method may be called
+             *   after all X1Sequence objects have been "destroyed"; it
+             *   undoes allocateMemory(), but the shared table is kept
+             *   for the life of the process.
              */
          static void allocateMemory( );
          static void deAllocateMemory( );
          
-         uint32_t & operator[]( int i );
             /**
              *  Given a word number from 0 to NUM_6SEC_WORDS, return the 
-             *  requested word.
+             *  requested word.  The words are in the shared table (see
+             *  words()), which cannot be modified.
              */
          const uint32_t & operator[] ( int i ) const;
+
+            /**
+             *  Return the six seconds of X1 bits as NUM_6SEC_WORDS+1
+             *  32-bit words, time order starting with the MSB of word 0;
+             *  the last word is zero padding.  The table is generated on
+             *  the first call, which is thread safe, and is never
+             *  modified or released afterwards, so it may be shared
+             *  freely between threads.
+             */
+         static const uint32_t* words( );
      
       private:
-         static uint32_t* X1Bits;
+            /// Generate the X1 bits returned by words().
+         static std::vector<uint32_t> generate( );
+
+         static const uint32_t* X1Bits;
          static bool isInit; 
    };
 
-   inline uint32_t & X1Sequence::operator[] ( int i )
-   {
-      return(X1Bits[i]); 
-   }
-
    inline const uint32_t & X1Sequence::operator[] ( int i ) const
    {
       return(X1Bits[i]);
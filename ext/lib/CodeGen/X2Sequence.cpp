@@ -47,6 +47,7 @@
 #include <cstring>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
    // Project headers
 #include "Exception.hpp"
@@ -87,16 +88,6 @@ namespace gpstk
    
    void X2Sequence::allocateMemory( )
    {
-      int X2Aepoch;
-      int X2Acount;
-      int X2Bepoch;
-      int X2Bcount;
-      int X2epoch = 1;
-      long X2Word = 0;
-      long X2Count = 0;
-      int lengthOfX2ASequence;
-      int lengthOfX2BSequence;
-
       if (isInit==true)
       {
          gpstk::Exception e ("X2Sequence::allocateMemory() called multiple times");
@@ -110,7 +101,23 @@ namespace gpstk
          gpstk::Exception e ("X2Sequence::allocateMemory() - allocation failed.");
          GPSTK_THROW(e);
       }
+      generate( X2Bits, X2BitsEOW );
    
+      isInit = true;
+   }
+
+   void X2Sequence::generate( uint32_t* X2Bits, uint32_t* X2BitsEOW )
+   {
+      int X2Aepoch;
+      int X2Acount;
+      int X2Bepoch;
+      int X2Bcount;
+      int X2epoch = 1;
+      long X2Word = 0;
+      long X2Count = 0;
+      int lengthOfX2ASequence;
+      int lengthOfX2BSequence;
+
       for (long ndx = 0; ndx < NUM_X2_WORDS; ndx++)
       {
          X2Bits[ndx] = 0x00000000;
@@ -213,8 +220,47 @@ namespace gpstk
       std::memcpy( X2BitsEOW, X2Bits, numBytes );
       numBytes = LENGTH_OF_EOW_OVERLAP * numBytesPerWord;
       memcpy( (void *) &X2BitsEOW[OVERLAP_WORD_POSITION], EOWEndOfSequence, numBytes );
-   
-      isInit = true;
+   }
+
+   const uint64_t* X2Sequence::words64( const bool eow )
+   {
+         // Initialization of a function-local static happens once, and
+         // other threads wait for it to complete.
+      static const std::vector<uint64_t> words( generate64() );
+      return(&words[eow ? NUM_X2_WORDS64 : 0]);
+   }
+
+   std::vector<uint64_t> X2Sequence::generate64( )
+   {
+      std::vector<uint32_t> bits( NUM_X2_WORDS ), bitsEOW( NUM_X2_WORDS );
+      generate( &bits[0], &bitsEOW[0] );
+
+         // The regular table followed by the EOW table
+      std::vector<uint64_t> words( 2*NUM_X2_WORDS64, 0 );
+      for (int table = 0; table < 2; table++)
+      {
+         const std::vector<uint32_t>& X2 = (table==0 ? bits : bitsEOW);
+         uint64_t *X2Words = &words[table*NUM_X2_WORDS64];
+
+            // Pack pairs of words, then clear the unused bits at the end
+            // of the final X2 word (it holds 25 X2 bits).
+         long nbits;
+         for (long ndx = 0; ndx < NUM_X2_WORDS; ndx++)
+            X2Words[ndx/2] |= uint64_t(X2[ndx]) << ((ndx & 1) ? 0 : MAX_BIT);
+         for (nbits = MAX_X2_COUNT; nbits < (MAX_X2_COUNT/64+1)*64; nbits++)
+            X2Words[nbits/64] &= ~(uint64_t(1) << (63 - nbits%64));
+
+            // Beyond the end, the sequence wraps to the start of the X2
+            // cycle which, as in operator[], is bit 37 (after the beginning
+            // of week delay chips).
+         for (nbits = MAX_X2_COUNT; nbits < NUM_X2_WORDS64*64; nbits++)
+         {
+            long from = nbits - MAX_X2_COUNT + X2A_EPOCH_DELAY;
+            if ( (X2Words[from/64] >> (63 - from%64)) & 1 )
+               X2Words[nbits/64] |= uint64_t(1) << (63 - nbits%64);
+         }
+      }
+      return(words);
    }
 
    void X2Sequence::deAllocateMemory()
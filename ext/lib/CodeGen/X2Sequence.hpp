@@ -41,6 +41,9 @@
 #ifndef X2SEQUENCE_HPP
 #define X2SEQUENCE_HPP
 
+   // Language headers
+#include <vector>
+
    // Local headers
 #include "gpstkplatform.h"
 #include "PCodeConst.hpp"
@@ -61,6 +64,8 @@ namespace gpstk
    const long MAX_X2_TEST = 4 * ((XA_COUNT * XA_MAX_EPOCH) + X2A_EPOCH_DELAY); 
       // Maximum number of X2 chips
    const long MAX_X2_COUNT = X2A_EPOCH_DELAY + MAX_X2_TEST;
+      // Number of 64-bit words in each table returned by X2Sequence::words64()
+   const long NUM_X2_WORDS64 = (MAX_X2_COUNT-1)/64 + 2;
 
       /**
        *     GPS X2 Sequencer.
@@ -183,7 +188,27 @@ namespace gpstk
              */
          void setEOWX2Epoch( const bool tf );
 
+            /**  Return the X2 bits, regular (eow false) or for the final X2
+             *   epoch of the week (eow true), packed into NUM_X2_WORDS64
+             *   64-bit words.  Bit numbering is as for operator[] plus 37
+             *   (the beginning of week delay), starting with the MSB of
+             *   word 0.  The bits past the end of the sequence continue
+             *   with the start of the next X2 cycle, so that any 64 bits
+             *   starting at a bit before MAX_X2_COUNT may be read from two
+             *   adjacent words without a wrap test.  The tables are
+             *   generated on the first call, which is thread safe, and are
+             *   never modified or released afterwards.  They are
+             *   independent of allocateMemory().
+             */
+         static const uint64_t* words64( const bool eow );
+
       private:
+            /// Generate the X2 bit sequences into the given arrays of
+            /// NUM_X2_WORDS words.
+         static void generate( uint32_t* X2Bits, uint32_t* X2BitsEOW );
+            /// Generate the tables returned by words64(), regular then EOW.
+         static std::vector<uint64_t> generate64( );
+
          uint32_t *bitsP;
          static uint32_t* X2Bits;
          static uint32_t* X2BitsEOW;
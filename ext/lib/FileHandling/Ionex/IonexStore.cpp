@@ -44,6 +44,9 @@
  */
 
 
+#include <algorithm>
+#include <limits>
+
 #include "IonexStore.hpp"
 
 using namespace gpstk::StringUtils;
@@ -58,6 +61,10 @@ namespace gpstk
    static const double C2_FACT   = 40.3e+16;
 
 
+      // seconds of time to degree (360.0 / 86400.0), for rotated maps
+   static const double SEC2DEG   = 4.16666666666667e-3;
+
+
       // Load the given IONEX file
    void IonexStore::loadFile( const std::string& filename )
    {
@@ -125,6 +132,7 @@ namespace gpstk
       if (type != IonexData::UN)
       {
          inxMaps[t][type] = iod;
+         gridsValid = false;
       }
 
       if (t < initialTime)
@@ -245,6 +253,14 @@ namespace gpstk
 
       inxMaps.clear();
 
+      gridsValid = false;
+      gridEpochs.clear();
+      gridOffsets.clear();
+      tecGrid.values.clear();
+      tecGrid.present.clear();
+      rmsGrid.values.clear();
+      rmsGrid.present.clear();
+
       initialTime = CommonTime::END_OF_TIME;
       finalTime = CommonTime::BEGINNING_OF_TIME;
 
@@ -321,6 +337,15 @@ namespace gpstk
          GPSTK_THROW(e);
       }
 
+         // use the dense grids if they are built
+      if (gridsValid)
+      {
+         int k[2];
+         double f[2], dlon[2];
+         nmap = findGridMaps(t, strategy, k, f, dlon);
+         return gridIonexValue(RX, nmap, k, f, dlon);
+      }
+
          // let's look for valid Ionex maps
       CommonTime T[2];
          // iterator
@@ -442,6 +467,375 @@ namespace gpstk
 
 
 
+      // Get IONEX TEC, RMS and ionosphere height values at one epoch for
+      // many positions.
+   void IonexStore::getIonexValues( const CommonTime& t,
+                                    const std::vector<Position>& RX,
+                                    std::vector<Triple>& values,
+                                    int strategy ) const
+   {
+
+      values.resize(RX.size());
+
+      if (!gridsValid)
+      {
+         for (size_t i = 0; i < RX.size(); i++)
+         {
+            values[i] = getIonexValue(t, RX[i], strategy);
+         }
+         return;
+      }
+
+         // current time check
+      if (t < getInitialTime())
+      {
+         InvalidRequest e("Inadequate data before requested time");
+         GPSTK_THROW(e);
+      }
+
+      if (t > getFinalTime() )
+      {
+         InvalidRequest e("Inadequate data after requested time");
+         GPSTK_THROW(e);
+      }
+
+         // maps, factors and rotations are the same for every position
+      int k[2];
+      double f[2], dlon[2];
+      int nmap = findGridMaps(t, strategy, k, f, dlon);
+
+      for (size_t i = 0; i < RX.size(); i++)
+      {
+         values[i] = gridIonexValue(RX[i], nmap, k, f, dlon);
+      }
+
+   }  // End of method 'IonexStore::getIonexValues()'
+
+
+
+      // Copy the stored TEC and RMS maps into dense grids.
+   bool IonexStore::buildGrids()
+   {
+
+      gridsValid = false;
+
+      gridEpochs.clear();
+      gridOffsets.clear();
+      for (IonexMap::const_iterator it = inxMaps.begin();
+           it != inxMaps.end();
+           it++)
+      {
+         gridEpochs.push_back(it->first);
+         gridOffsets.push_back(it->first - gridEpochs[0]);
+      }
+
+         // interpolation needs at least two maps
+      if ( gridEpochs.size() < 2 ||
+           !fillGrid(IonexData::TEC, tecGrid) ||
+           !fillGrid(IonexData::RMS, rmsGrid) )
+      {
+         tecGrid.values.clear();
+         rmsGrid.values.clear();
+         return false;
+      }
+
+      gridsValid = true;
+
+      return true;
+
+   }  // End of method 'IonexStore::buildGrids()'
+
+
+
+      // Copy the maps of the given type into grid; return false if the maps
+      // do not share a single 2D grid.
+   bool IonexStore::fillGrid( const IonexData::IonexValType& type,
+                              DenseGrid& grid )
+   {
+
+      const float undefined( std::numeric_limits<float>::quiet_NaN() );
+      bool first(true);
+
+      grid.values.clear();
+      grid.present.assign(gridEpochs.size(), false);
+
+      int k(0);
+      for (IonexMap::const_iterator it = inxMaps.begin();
+           it != inxMaps.end();
+           it++, k++)
+      {
+
+         IonexValTypeMap::const_iterator jt( it->second.find(type) );
+         if (jt == it->second.end())
+         {
+            continue;
+         }
+
+         const IonexData& iod(jt->second);
+
+            // only 2D maps, as getIndex() uses a single height when
+            // hgt[2] is zero
+         if (iod.hgt[2] != 0 || iod.dim[2] != 1)
+         {
+            return false;
+         }
+
+         if (first)
+         {
+            for (int i = 0; i < 3; i++)
+            {
+               grid.lat[i] = iod.lat[i];
+               grid.lon[i] = iod.lon[i];
+            }
+            grid.nlat = iod.dim[0];
+            grid.nlon = iod.dim[1];
+            grid.ncyc = static_cast<int>( ( 360.0 / std::abs(grid.lon[2]) )
+                                          + 0.5 );
+            grid.latStride = grid.nlon;
+            grid.timeStride = grid.nlat * grid.nlon;
+            grid.values.assign(gridEpochs.size() * grid.timeStride, undefined);
+            first = false;
+         }
+         else
+         {
+            for (int i = 0; i < 3; i++)
+            {
+               if (iod.lat[i] != grid.lat[i] || iod.lon[i] != grid.lon[i])
+               {
+                  return false;
+               }
+            }
+            if (iod.dim[0] != grid.nlat || iod.dim[1] != grid.nlon)
+            {
+               return false;
+            }
+         }
+
+         if (static_cast<int>(iod.data.size()) != grid.timeStride)
+         {
+            return false;
+         }
+
+         float *val = &grid.values[k * grid.timeStride];
+         for (int i = 0; i < grid.timeStride; i++)
+         {
+            val[i] = (iod.data[i] != 999.9) ?
+                     static_cast<float>(iod.data[i]) : undefined;
+         }
+         grid.present[k] = true;
+
+      }  // End of 'for (it=inxMaps.begin(); it != inxMaps.end(); ...'
+
+      return true;
+
+   }  // End of method 'IonexStore::fillGrid()'
+
+
+
+      // Find the grid epochs, interpolation factors and longitude rotations
+      // used at time t; this follows getIonexValue(), and at the last epoch
+      // uses the last interval.
+   int IonexStore::findGridMaps( const CommonTime& t,
+                                 int strategy,
+                                 int k[2],
+                                 double f[2],
+                                 double dlon[2] ) const
+   {
+
+      int nmap;
+      if      (strategy == 1 || strategy == 4) nmap = 1;
+      else if (strategy == 2 || strategy == 3) nmap = 2;
+      else
+      {
+         InvalidRequest e("Invalid interpolation stategy");
+         GPSTK_THROW(e);
+      }
+
+         // the map at or before t, and the next one
+      double dt(t - gridEpochs[0]);
+      int nepoch( static_cast<int>(gridEpochs.size()) );
+      k[0] = static_cast<int>( std::upper_bound( gridOffsets.begin(),
+                                                 gridOffsets.end(),
+                                                 dt )
+                               - gridOffsets.begin() ) - 1;
+      if (k[0] < 0)
+      {
+         InvalidRequest e("IonexStore::getIonexValue() ... Invalid time!");
+         GPSTK_THROW(e);
+      }
+      if (k[0] > nepoch-2)
+      {
+         k[0] = nepoch-2;
+      }
+      k[1] = k[0] + 1;
+
+         // factors (As in Eq.(3), pag.2 of the manual)
+      const CommonTime& T0(gridEpochs[k[0]]);
+      const CommonTime& T1(gridEpochs[k[1]]);
+      f[0] = (T1-t ) / (T1-T0);
+      f[1] = (t -T0) / (T1-T0);
+
+         // if only one map, then we have to use the neareast
+      if (nmap == 1)
+      {
+         if (f[1] > f[0])
+         {
+            k[0] = k[1];
+         }
+         f[0] = 1.0;
+      }
+
+         // rotation of the maps, the same for every position
+      for (int imap = 0; imap < nmap; imap++)
+      {
+         dlon[imap] = (strategy == 1 || strategy == 2) ?
+                      0.0 : (t - gridEpochs[k[imap]]) * SEC2DEG;
+      }
+
+      return nmap;
+
+   }  // End of method 'IonexStore::findGridMaps()'
+
+
+
+      // Compute TEC, RMS and ionosphere height at RX from the dense grids.
+   Triple IonexStore::gridIonexValue( const Position& RX,
+                                      int nmap,
+                                      const int k[2],
+                                      const double f[2],
+                                      const double dlon[2] ) const
+   {
+
+      if ( RX.getCoordinateSystem() != Position::Geocentric )
+      {
+         InvalidRequest e("Position object is not in GEOCENTRIC coordinates");
+         GPSTK_THROW(e);
+      }
+
+      Triple tecval(0.0,0.0,0.0);
+
+      for (int imap = 0; imap < nmap; imap++)
+      {
+
+            // IONEX longitudes are within [-180 180]; cf. IonexData
+         double lambda( RX.theArray[1] + dlon[imap] );
+         if (lambda > 180.0)
+         {
+            lambda = lambda - 360.0;
+         }
+
+         if (tecGrid.present[k[imap]])
+         {
+            tecval[0] = tecval[0] + f[imap] *
+               gridValue(tecGrid, k[imap], RX.theArray[0], lambda);
+         }
+
+         if (rmsGrid.present[k[imap]])
+         {
+            tecval[1] = tecval[1] + f[imap] *
+               gridValue(rmsGrid, k[imap], RX.theArray[0], lambda);
+         }
+
+      }  // End of 'for (int imap = 0; imap < nmap; imap++)...'
+
+         // ionosphere height in meters
+      tecval[2] = RX.theArray[2];
+
+      return tecval;
+
+   }  // End of method 'IonexStore::gridIonexValue()'
+
+
+
+      // Interpolate one dense grid at epoch index k, latitude beta and
+      // longitude lambda; the grid points and their checks are those of
+      // IonexData::getIndex() and IonexData::getValue().
+   double IonexStore::gridValue( const DenseGrid& grid,
+                                 int k,
+                                 double beta,
+                                 double lambda )
+   {
+
+         // lower left hand grid point E00
+      int ilat( static_cast<int>( (beta - grid.lat[0]) / grid.lat[2] + 1.0 ) );
+      if (ilat < 1 || ilat > grid.nlat)
+      {
+         InvalidRequest e( "Irregular latitude. Latitude "
+                           + asString(beta) + " DEG" );
+         GPSTK_THROW(e);
+      }
+
+      int ilon( static_cast<int>( (lambda - grid.lon[0]) / grid.lon[2] + 1.0 ) );
+      if (ilon < 1)
+      {
+         ilon = ilon + grid.ncyc;
+      }
+      else if (ilon > grid.nlon)
+      {
+         ilon = ilon - grid.ncyc;
+      }
+      if (ilon < 1 || ilon > grid.nlon)
+      {
+         InvalidRequest e( "Irregular longitude. Longitude: "
+                           + asString(lambda) + " DEG" );
+         GPSTK_THROW(e);
+      }
+
+         // compute factors P and Q
+      double xp( (lambda - (grid.lon[0] + (ilon-1)*grid.lon[2])) / grid.lon[2] );
+      double xq( (beta   - (grid.lat[0] + (ilat-1)*grid.lat[2])) / grid.lat[2] );
+      if ( (xp < 0) || (xp > 1) || (xq < 0) || (xq > 1) )
+      {
+         GPSTK_THROW(Exception("IonexStore::gridValue(): Wrong xp and xq factors!!!"));
+      }
+
+         // next latitude (E01) and longitude (E10) grid points
+      int jlat(ilat + 1);
+      if (jlat > grid.nlat)
+      {
+         InvalidRequest e( "Irregular latitude. Latitude "
+                           + asString(grid.lat[0] + ilat*grid.lat[2]) + " DEG" );
+         GPSTK_THROW(e);
+      }
+
+      int jlon(ilon + 1);
+      if (jlon > grid.nlon)
+      {
+         jlon = jlon - grid.ncyc;
+      }
+      if (jlon < 1 || jlon > grid.nlon)
+      {
+         InvalidRequest e( "Irregular longitude. Longitude: "
+                           + asString(grid.lon[0] + ilon*grid.lon[2]) + " DEG" );
+         GPSTK_THROW(e);
+      }
+
+         // let's fetch the values
+      const float *val = &grid.values[k * grid.timeStride];
+      double pntval[4];
+      pntval[0] = val[(ilat-1)*grid.latStride + (ilon-1)];
+      pntval[1] = val[(ilat-1)*grid.latStride + (jlon-1)];
+      pntval[2] = val[(jlat-1)*grid.latStride + (ilon-1)];
+      pntval[3] = val[(jlat-1)*grid.latStride + (jlon-1)];
+      for (int i = 0; i < 4; i++)
+      {
+         if (pntval[i] != pntval[i])            // NaN, undefined
+         {
+            FFStreamError e("Undefined TEC/RMS value(s).");
+            GPSTK_THROW(e);
+         }
+      }
+
+         // bivariate interpolation (pag.3, IONEX manual)
+      return (1.0-xp) * (1.0-xq) * pntval[0] +
+                  xp  * (1.0-xq) * pntval[1] +
+             (1.0-xp) *      xq  * pntval[2] +
+                  xp  *      xq  * pntval[3];
+
+   }  // End of method 'IonexStore::gridValue()'
+
+
+
       /** Get slant total electron content (STEC) in TECU
        *
        * @param elevation     Time tag of signal (CommonTime object)
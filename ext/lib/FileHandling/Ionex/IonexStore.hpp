@@ -47,6 +47,7 @@
 #define GPSTK_IONEXSTORE_HPP
 
 #include <map>
+#include <vector>
 
 #include "FileStore.hpp"
 #include "IonexData.hpp"
@@ -85,7 +86,8 @@ namespace gpstk
       IonexStore()
          throw()
          : initialTime(CommonTime::END_OF_TIME),
-           finalTime(CommonTime::BEGINNING_OF_TIME)
+           finalTime(CommonTime::BEGINNING_OF_TIME),
+           gridsValid(false)
       {};
 
 
@@ -93,17 +95,43 @@ namespace gpstk
       virtual ~IonexStore() {};
 
 
-         /** Load the given IONEX file
+         /** Load the given IONEX file. This adds the file's maps but does
+          *  not build the dense grids, so that loading many files stays
+          *  linear; call buildGrids() once after the last file is loaded.
           * @throw FileMissingException
           */
       virtual void loadFile(const std::string& filename);
 
 
-         /// Insert a new IonexData object into the store
+         /** Insert a new IonexData object into the store. This discards the
+          *  dense grids; call buildGrids() after adding maps to use them.
+          */
       void addMap(const IonexData& iod)
          throw();
 
 
+         /** Copy the stored TEC and RMS maps into dense grids, one contiguous
+          *  array of float values per type, indexed by epoch, latitude and
+          *  longitude with fixed strides. getIonexValue() and
+          *  getIonexValues() use the grids when they exist, and the maps
+          *  otherwise. The grids are built only if all the maps of a type
+          *  share one latitude/longitude grid and have a single height;
+          *  otherwise the store keeps using the maps.
+          *
+          *  The maps are kept, so the grids add about half again the memory
+          *  of the stored values; each call copies every map, so call this
+          *  once after all the maps are loaded.
+          *
+          * @return true if the grids were built.
+          */
+      bool buildGrids();
+
+
+         /// Return true if the dense grids exist; see buildGrids()
+      bool hasGrids() const throw()
+      { return gridsValid; }
+
+
          /** Dump the store to the provided std::ostream (std::cout by default).
           *
           * @param s       std::ostream object to dump the data to.
@@ -150,6 +178,25 @@ namespace gpstk
                             int strategy = 3 ) const;
 
 
+         /** Get IONEX TEC, RMS and ionosphere height values at one epoch for
+          *  many positions, e.g. all the ionospheric pierce points of an
+          *  epoch. This is the same as calling getIonexValue() for each
+          *  position, but the maps, interpolation factors and map rotations
+          *  are found only once.
+          *
+          * @param t          Time tag of signal (CommonTime object)
+          * @param RX         Positions in GEOCENTRIC coordinates
+          * @param values     Output TEC, RMS and ionosphere height values,
+          *                   parallel to RX; see getIonexValue()
+          * @param strategy   Interpolation strategy; see getIonexValue()
+          * @throw InvalidRequest
+          */
+      void getIonexValues( const CommonTime& t,
+                           const std::vector<Position>& RX,
+                           std::vector<Triple>& values,
+                           int strategy = 3 ) const;
+
+
 
       /** Get slant total electron content (STEC) in TECU
        *
@@ -370,6 +417,82 @@ namespace gpstk
       IonexDCBMap inxDCBMap;
 
 
+         /** Dense copy of all the maps of one type (TEC or RMS), built by
+          *  buildGrids(). The value at epoch index k and 0-based grid indexes
+          *  ilat, ilon is values[k*timeStride + ilat*latStride + ilon];
+          *  undefined values are NaN.
+          */
+      struct DenseGrid
+      {
+         double lat[3];                ///< latitude grid, as in IonexData
+         double lon[3];                ///< longitude grid, as in IonexData
+         int nlat;                     ///< number of latitudes
+         int nlon;                     ///< number of longitudes
+         int ncyc;                     ///< number of longitudes in 360 deg
+         int latStride;                ///< stride between latitudes
+         int timeStride;               ///< stride between epochs
+         std::vector<float> values;    ///< grid values
+         std::vector<bool> present;    ///< maps present, parallel to epochs
+      };
+
+
+         /// Epochs of the dense grids, and their offsets (s) from the first
+      std::vector<CommonTime> gridEpochs;
+      std::vector<double> gridOffsets;
+
+
+         /// Dense TEC and RMS grids
+      DenseGrid tecGrid, rmsGrid;
+
+
+         /// True when the dense grids are built and current
+      bool gridsValid;
+
+
+         /** Find the (one or two) grid epochs, interpolation factors and
+          *  longitude rotations (deg) used at time t with the given
+          *  strategy; cf. getIonexValue().
+          * @return the number of maps used
+          * @throw InvalidRequest
+          */
+      int findGridMaps( const CommonTime& t,
+                        int strategy,
+                        int k[2],
+                        double f[2],
+                        double dlon[2] ) const;
+
+
+         /** Compute TEC, RMS and ionosphere height at RX from the dense
+          *  grids, given the output of findGridMaps().
+          * @throw InvalidRequest
+          * @throw FFStreamError if a grid value is undefined
+          */
+      Triple gridIonexValue( const Position& RX,
+                             int nmap,
+                             const int k[2],
+                             const double f[2],
+                             const double dlon[2] ) const;
+
+
+         /** Interpolate one dense grid at epoch index k, latitude beta and
+          *  longitude lambda (deg, within [-180, 180]), as
+          *  IonexData::getValue() does.
+          * @throw InvalidRequest
+          * @throw FFStreamError if a grid value is undefined
+          */
+      static double gridValue( const DenseGrid& grid,
+                               int k,
+                               double beta,
+                               double lambda );
+
+
+         /** Copy the maps of the given type into grid.
+          * @return false if the maps do not share a single 2D grid
+          */
+      bool fillGrid( const IonexData::IonexValType& type,
+                     DenseGrid& grid );
+
+
    }; // End of class 'IonexStore'
 
       //@}
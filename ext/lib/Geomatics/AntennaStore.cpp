@@ -63,14 +63,106 @@ namespace gpstk
          GPSTK_THROW(e);
       }
 
-      // is the name already in the store?
+      // is the name already in the store? if it was an indexed satellite, the
+      // index must be rebuilt, as another antenna may take its place there
+      bool reindex(false);
       map<string, AntexData>::iterator it;
       it = antennaMap.find(name);
-      if(it != antennaMap.end())       // erase it
+      if(it != antennaMap.end()) {     // erase it
+         if(!it->second.isRxAntenna) reindex = true;
          antennaMap.erase(it);
+      }
+
+      // add the new data, with its PCVs compiled for fast lookup
+      it = antennaMap.insert(make_pair(name, AntexData())).first;
+      AntexData& stored(it->second);
+      stored = antdata;
+      if(!stored.hasGrids()) stored.compileGrids();
+
+      if(reindex) buildSatelliteIndex();
+      else if(!stored.isRxAntenna) indexSatellite(it);
+   }
+
+   // Rebuild the (system,PRN) index of satellite antennas. The map is scanned in
+   // name order and the first antenna found is kept, as getSatelliteAntenna().
+   void AntennaStore::buildSatelliteIndex(void) throw()
+   {
+      satIndex.clear();
+      map<string, AntexData>::const_iterator it;
+      for(it = antennaMap.begin(); it != antennaMap.end(); it++) {
+         if(it->second.isRxAntenna) continue;
+         satIndex.insert(make_pair(
+            make_pair(it->second.systemChar, it->second.PRN), it));
+      }
+   }
+
+   // Add one satellite antenna to the index, keeping the first by name
+   void AntennaStore::indexSatellite(map<string, AntexData>::const_iterator it)
+      throw()
+   {
+      pair<map<pair<char,int>, map<string, AntexData>::const_iterator>::iterator,
+           bool> ins(satIndex.insert(make_pair(
+               make_pair(it->second.systemChar, it->second.PRN), it)));
+      if(!ins.second && it->first < ins.first->second->first)
+         ins.first->second = it;
+   }
+
+   // Find the antenna data for the given satellite PRN in the store
+   const AntexData *AntennaStore::findSatelliteAntenna(const char sys,
+                                                       const int n)
+      const throw()
+   {
+      map<pair<char,int>, map<string, AntexData>::const_iterator>::const_iterator
+         jt = satIndex.find(make_pair(sys,n));
+      if(jt == satIndex.end()) return NULL;
+      return &(jt->second->second);
+   }
+
+   // ANTEX system character of a satellite system
+   char AntennaStore::systemChar(const SatID& sat) throw()
+   {
+      switch(sat.system)
+      {
+         case SatelliteSystem::GPS:     return 'G';
+         case SatelliteSystem::Glonass: return 'R';
+         case SatelliteSystem::Galileo: return 'E';
+         case SatelliteSystem::BeiDou:  return 'C';
+         case SatelliteSystem::QZSS:    return 'J';
+         default:                       return 0;
+      }
+   }
+
+   // Compute the PCV of each of a list of satellites at one epoch
+   unsigned AntennaStore::getSatellitePCVs(const vector<SatID>& sats,
+                                           const int freqNum,
+                                           const vector<double>& azim,
+                                           const vector<double>& nadir,
+                                           vector<double>& pcv,
+                                           vector<bool>& found) const
+   {
+      if(azim.size() != sats.size() || nadir.size() != sats.size()) {
+         InvalidRequest ir("AntennaStore::getSatellitePCVs: input sizes differ");
+         GPSTK_THROW(ir);
+      }
+
+      unsigned nfound(0);
+      pcv.assign(sats.size(), 0.0);
+      found.assign(sats.size(), false);
+      for(size_t i=0; i<sats.size(); i++) {
+         const char sys(systemChar(sats[i]));
+         const int ifreq(AntexData::freqIndex(sys, freqNum));
+         if(ifreq < 0) continue;
+         const AntexData *ant(findSatelliteAntenna(sys, sats[i].id));
+         if(!ant) continue;
+         try {
+            pcv[i] = ant->getPhaseCenterVariation(ifreq, azim[i], nadir[i]);
+            found[i] = true;
+            nfound++;
+         }
+         catch(Exception&) { }         // frequency absent, or bad angle
+      }
 
-      // add the new data
-      antennaMap[name] = antdata;
+      return nfound;
    }
 
    // Get the antenna data for the given name from the store.
@@ -106,6 +198,14 @@ namespace gpstk
                             bool inputPRN) const throw()
    {
       map<string, AntexData>::const_iterator it;
+      if(inputPRN) {
+         map<pair<char,int>, map<string, AntexData>::const_iterator>
+            ::const_iterator jt = satIndex.find(make_pair(sys,n));
+         if(jt == satIndex.end()) return false;
+         name = jt->second->first;
+         data = jt->second->second;
+         return true;
+      }
       for(it = antennaMap.begin(); it != antennaMap.end(); it++) {
          if(it->second.isRxAntenna) continue;
          if(it->second.systemChar != sys) continue;
@@ -285,13 +385,20 @@ namespace gpstk
                                       const Triple& satVector, 
                                       bool inputPRN) const
    {
-      AntexData antenna;
+      AntexData svnAntenna;
+      const AntexData *pant(NULL);
       string name;
       bool dualFrequency = true;
       try
       {
-         if (getSatelliteAntenna(sys, n, name, antenna))
+         if(inputPRN)
+            pant = findSatelliteAntenna(sys, n);
+         else if(getSatelliteAntenna(sys, n, name, svnAntenna, false))
+            pant = &svnAntenna;
+
+         if (pant)
          {
+            const AntexData& antenna(*pant);
 
             // tracking, and future expansion. 
             double fact1 = 1.0;
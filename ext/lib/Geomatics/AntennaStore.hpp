@@ -95,9 +95,27 @@ namespace gpstk
       /// Empty constructor
       AntennaStore() : includeSats(0) {}
 
+      /// Copy constructor; the satellite index refers into this object's map
+      AntennaStore(const AntennaStore& right)
+         : namesToInclude(right.namesToInclude), includeSats(right.includeSats),
+           antennaMap(right.antennaMap)
+      { buildSatelliteIndex(); }
+
       /// Destructor
       ~AntennaStore() {}
 
+      /// Assignment; the satellite index refers into this object's map
+      AntennaStore& operator=(const AntennaStore& right)
+      {
+         if(this != &right) {
+            namesToInclude = right.namesToInclude;
+            includeSats = right.includeSats;
+            antennaMap = right.antennaMap;
+            buildSatelliteIndex();
+         }
+         return *this;
+      }
+
       /// Add the given name, AntexData pair. If the name already exists in the store,
       /// replace the data for it with the input object.
       /// @throw Exception if the AntexData is invalid.
@@ -126,6 +144,36 @@ namespace gpstk
                                std::string& name, AntexData& data,
                                bool inputPRN=true) const throw();
 
+      /// Same as getSatelliteAntenna(sys,n,name,data,true), but return a pointer
+      /// to the data in the store rather than a copy, found in an index by
+      /// system and PRN. The pointer is valid until the store is next modified.
+      /// @return pointer to the data, or NULL if the satellite was not found
+      const AntexData *findSatelliteAntenna(const char sys, const int n)
+         const throw();
+
+      /// Compute the phase center variation, for one frequency, of each of a
+      /// list of satellites at one epoch; each satellite is looked up in the
+      /// index of findSatelliteAntenna() and its compiled PCV grid is
+      /// interpolated (see AntexData::compileGrids()), without copying antennas
+      /// or handling frequency strings.
+      /// @param sats  satellites of interest; GPS, GLONASS, Galileo, BeiDou
+      ///                and QZSS are recognized
+      /// @param freqNum ANTEX frequency number n, as in G0n, R0n etc.
+      /// @param azim  azimuth (deg) of the receiver as seen from each satellite,
+      ///                in the satellite body frame, parallel to sats
+      /// @param nadir nadir angle (deg) of the receiver for each satellite,
+      ///                parallel to sats
+      /// @param pcv   output PCV (mm) for each satellite, 0 if not found
+      /// @param found output flag for each satellite, true if pcv was computed
+      /// @return the number of satellites for which pcv was computed
+      /// @throw InvalidRequest if the input vectors differ in length
+      unsigned getSatellitePCVs(const std::vector<SatID>& sats,
+                                const int freqNum,
+                                const std::vector<double>& azim,
+                                const std::vector<double>& nadir,
+                                std::vector<double>& pcv,
+                                std::vector<bool>& found) const;
+
       /// Get a vector of all antenna names in the store
       void getNames(std::vector<std::string>& names) throw();
 
@@ -136,7 +184,7 @@ namespace gpstk
       unsigned int size(void) const throw() { return antennaMap.size(); }
 
       /// clear the store of all information
-      void clear(void) throw() { antennaMap.clear(); }
+      void clear(void) throw() { antennaMap.clear(); satIndex.clear(); }
 
       /// call to have satellite antennas included in store
       /// NB. call before addAntenna() or addANTEXfile()
@@ -211,6 +259,22 @@ namespace gpstk
 
       /// map from name of antenna to AntexData object
       std::map<std::string, AntexData> antennaMap;
+
+      /// index of the satellite antennas in antennaMap by (system, PRN);
+      /// where there are several, the first by name, as getSatelliteAntenna()
+      std::map<std::pair<char,int>,
+               std::map<std::string, AntexData>::const_iterator> satIndex;
+
+      /// rebuild satIndex from antennaMap
+      void buildSatelliteIndex(void) throw();
+
+      /// add the satellite antenna at it to satIndex, unless one earlier by
+      /// name is already there for its (system, PRN)
+      void indexSatellite(std::map<std::string, AntexData>::const_iterator it)
+         throw();
+
+      /// @return the ANTEX system character of sat's system, or 0 if none
+      static char systemChar(const SatID& sat) throw();
       
    }; // end class AntennaStore
    
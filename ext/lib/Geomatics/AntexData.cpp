@@ -42,6 +42,8 @@
 /// satellite antennas based on system, PRN and time, and computation of phase center
 /// offsets and variations.
 
+#include <cctype>
+
 #include "AntexData.hpp"
 #include "AntexStream.hpp"
 #include "StringUtils.hpp"
@@ -179,6 +181,30 @@ namespace gpstk
       catch(Exception& e) { GPSTK_RETHROW(e); }
    }
 
+   double AntexData::getTotalPhaseCenterOffset(const int ifreq,
+                                               const double azim,
+                                               const double elev_nadir) const
+   {
+      try {
+         double pcv = getPhaseCenterVariation(ifreq, azim, elev_nadir);
+         Triple pco = getPhaseCenterOffset(ifreq);
+
+         double elev = elev_nadir;
+         if(!isRxAntenna)
+            elev = 90. - elev_nadir;
+
+         double cosel = ::cos(elev * DEG_TO_RAD);
+         double sinel = ::sin(elev * DEG_TO_RAD);
+         double cosaz = ::cos(azim * DEG_TO_RAD);
+         double sinaz = ::sin(azim * DEG_TO_RAD);
+
+         return (-pcv + pco[0]*cosel*cosaz
+                      + pco[1]*cosel*sinaz
+                      + pco[2]*sinel);
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
    // Access the PCO (only) values in the antenna coordinate system
    // (This does NOT include the phase center variations, which should
    // be computed using getPhaseCenterVariation() and added to the PCOs to get
@@ -190,6 +216,10 @@ namespace gpstk
          GPSTK_THROW(e);
       }
 
+      const PCVGrid *grid = findGrid(freqIndex(freq));
+      if(grid)
+         return Triple(grid->PCOvalue[0], grid->PCOvalue[1], grid->PCOvalue[2]);
+
       // get the antennaPCOandPCVData for this frequency
       map<string, antennaPCOandPCVData>::const_iterator it = freqPCVmap.find(freq);
       if(it == freqPCVmap.end()) {
@@ -206,11 +236,53 @@ namespace gpstk
       return retval;
    }
 
+   Triple AntexData::getPhaseCenterOffset(const int ifreq) const
+   {
+      if(!isValid()) {
+         gpstk::Exception e("Invalid AntexData object");
+         GPSTK_THROW(e);
+      }
+
+      const PCVGrid *grid = findGrid(ifreq);
+      if(grid)
+         return Triple(grid->PCOvalue[0], grid->PCOvalue[1], grid->PCOvalue[2]);
+
+      try { return getPhaseCenterOffset(freqString(ifreq)); }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
    // Compute the phase center variation (only) at the given azimuth and elevation
    // (receiver) or nadir (satellite) angles
    double AntexData::getPhaseCenterVariation(const string freq,
                                              const double azimuth,
                                              const double elev_nadir) const
+   {
+      double azim, zen;
+      checkAngles(azimuth, elev_nadir, azim, zen);
+
+      const PCVGrid *grid = findGrid(freqIndex(freq));
+      if(grid)
+         return interpolateGrid(*grid, azim, zen);
+
+      return interpolateMap(freq, azim, zen);
+   }
+
+   double AntexData::getPhaseCenterVariation(const int ifreq,
+                                             const double azimuth,
+                                             const double elev_nadir) const
+   {
+      double azim, zen;
+      checkAngles(azimuth, elev_nadir, azim, zen);
+
+      const PCVGrid *grid = findGrid(ifreq);
+      if(grid)
+         return interpolateGrid(*grid, azim, zen);
+
+      return interpolateMap(freqString(ifreq), azim, zen);
+   }
+
+   void AntexData::checkAngles(const double azimuth, const double elev_nadir,
+                               double& azim, double& zen) const
    {
       if(!isValid()) {
          Exception e("Invalid AntexData object");
@@ -221,7 +293,6 @@ namespace gpstk
          GPSTK_THROW(e);
       }
 
-      double retpco, azim, zen;
       zen = elev_nadir;             // satellite: elev_nadir is a zenith (nadir) angle
       if(isRxAntenna)               // receiver: elev_nadir is an elevation
          zen = 90. - elev_nadir;
@@ -231,6 +302,12 @@ namespace gpstk
       azim = azimuth;
       while(azim < 0.0) azim += 360.0;
       while(azim >= 360.0) azim -= 360.0;
+   }
+
+   double AntexData::interpolateMap(const string& freq,
+                                    const double azim, const double zen) const
+   {
+      double retpco;
 
       // find four points bracketing the point (azim,zen)
       //       zen
@@ -252,7 +329,6 @@ namespace gpstk
                + " not found! System not supported or data corrupted.");
          GPSTK_THROW(e);
       }
-
       const antennaPCOandPCVData& antpco = it->second;
       const azimZenMap& azzenmap = antpco.PCVvalue;      // map<double, zenOffsetMap>
 
@@ -326,6 +402,173 @@ namespace gpstk
       return retpco;
    }
 
+   // ----------------------------------------------------------------------------
+   const string AntexData::freqSystems("GRECJSI");
+   const int AntexData::numFreqIndexes = 10*AntexData::freqSystems.size();
+
+   int AntexData::freqIndex(const char sys, const int n) throw()
+   {
+      string::size_type i = freqSystems.find(sys);
+      if(i == string::npos || n < 0 || n > 9)
+         return -1;
+      return 10*int(i) + n;
+   }
+
+   int AntexData::freqIndex(const string& freq) throw()
+   {
+      if(freq.size() != 3 || freq[1] != '0' || !isdigit(freq[2]))
+         return -1;
+      return freqIndex(freq[0], freq[2]-'0');
+   }
+
+   string AntexData::freqString(const int ifreq)
+   {
+      if(ifreq < 0 || ifreq >= numFreqIndexes)
+         return string();
+      string freq("x0x");
+      freq[0] = freqSystems[ifreq/10];
+      freq[2] = char('0' + ifreq%10);
+      return freq;
+   }
+
+   void AntexData::compileGrids(void)
+   {
+      grids.clear();
+      gridOfFreq.assign(numFreqIndexes, -1);
+
+      map<string, antennaPCOandPCVData>::const_iterator it;
+      for(it = freqPCVmap.begin(); it != freqPCVmap.end(); ++it) {
+         const int ifreq = freqIndex(it->first);
+         const azimZenMap& azzenmap = it->second.PCVvalue;
+         if(ifreq < 0 || azzenmap.empty() || azzenmap.begin()->second.empty())
+            continue;
+
+         PCVGrid grid;
+         for(int i=0; i<3; i++)
+            grid.PCOvalue[i] = it->second.PCOvalue[i];
+
+         // the zenith angles of the first row, which all rows must share
+         const zenOffsetMap& first = azzenmap.begin()->second;
+         for(zenOffsetMap::const_iterator kt = first.begin(); kt != first.end();
+             ++kt)
+            grid.zen.push_back(kt->first);
+
+         // without azimuth dependence only the first row is used
+         bool regular(true);
+         azimZenMap::const_iterator jt, jtend(azzenmap.end());
+         if(!it->second.hasAzimuth) { jtend = azzenmap.begin(); ++jtend; }
+         for(jt = azzenmap.begin(); regular && jt != jtend; ++jt) {
+            if(it->second.hasAzimuth)
+               grid.azim.push_back(jt->first);
+            if(jt->second.size() != grid.zen.size()) { regular = false; break; }
+            size_t k(0);
+            zenOffsetMap::const_iterator kt;
+            for(kt = jt->second.begin(); kt != jt->second.end(); ++kt, ++k) {
+               if(kt->first != grid.zen[k]) { regular = false; break; }
+               grid.value.push_back(kt->second);
+            }
+         }
+         if(!regular)
+            continue;
+
+         const size_t nz(grid.zen.size()), na(grid.azim.size());
+         grid.zenStep = (nz > 1 ? (grid.zen[nz-1]-grid.zen[0])/(nz-1) : 1.0);
+         grid.azimStep = (na > 1 ? (grid.azim[na-1]-grid.azim[0])/(na-1) : 1.0);
+
+         gridOfFreq[ifreq] = grids.size();
+         grids.push_back(grid);
+      }
+   }
+
+   // Find the index k with x[k] <= v < x[k+1], for x increasing with mean
+   // spacing step, given x[0] < v < x[n-1]. The first guess is from the spacing,
+   // which on a regular grid is correct or off by one.
+   static size_t gridIndex(const vector<double>& x, const double step,
+                           const double v) throw()
+   {
+      const size_t n(x.size());
+      double g((v - x[0])/step);
+      size_t k(g < 0.0 ? 0 : (g > n-2 ? n-2 : size_t(g)));
+      while(k > 0 && v < x[k]) k--;
+      while(k < n-2 && v >= x[k+1]) k++;
+      return k;
+   }
+
+   // Same as AntexData::evaluateZenithMap() but on one row of a grid, returning
+   // indexes; klo == khi when the value at zen is that at klo.
+   static void bracketZenith(const vector<double>& zgrid, const double step,
+                             const double zen, size_t& klo, size_t& khi) throw()
+   {
+      const size_t n(zgrid.size());
+      if(!(zen > zgrid[0]))               // at or below the first value
+         klo = khi = 0;
+      else if(!(zen < zgrid[n-1]))        // at or above the last value
+         klo = khi = n-1;
+      else {
+         klo = gridIndex(zgrid, step, zen);
+         khi = (zen == zgrid[klo] ? klo : klo+1);
+      }
+   }
+
+   double AntexData::interpolateGrid(const PCVGrid& grid,
+                                     const double azim, const double zen) throw()
+   {
+      // the arithmetic is that of interpolateMap(), with the map iterators
+      // replaced by indexes into the grid
+      const size_t nz(grid.zen.size());
+      size_t klo, khi;
+      bracketZenith(grid.zen, grid.zenStep, zen, klo, khi);
+      const double zn_lo(grid.zen[klo]), zn_hi(grid.zen[khi]);
+
+      // find the rows bracketing azim; row == row_hi on an exact match
+      size_t row, row_lo;
+      double az_lo(0.0), az_hi(0.0);
+      const size_t na(grid.azim.size());
+      if(na == 0)
+         row = row_lo = 0;
+      else if(azim < grid.azim[0]) {      // before the first value
+         row = 0;
+         az_hi = grid.azim[0];
+         row_lo = na-1;                   // wrap around to end
+         az_lo = grid.azim[na-1] - 360.;
+      }
+      else if(azim > grid.azim[na-1]) {   // beyond the last value
+         row_lo = na-1;
+         az_lo = grid.azim[na-1];
+         row = 0;                         // wrap around to beginning
+         az_hi = grid.azim[0] + 360.;
+      }
+      else if(azim == grid.azim[na-1])
+         row = row_lo = na-1;
+      else {
+         row_lo = gridIndex(grid.azim, grid.azimStep, azim);
+         if(azim == grid.azim[row_lo])
+            row = row_lo;
+         else {
+            row = row_lo+1;
+            az_lo = grid.azim[row_lo];
+            az_hi = grid.azim[row];
+         }
+      }
+
+      const double *hi(&grid.value[row*nz]);
+      if(row == row_lo) {                 // no azimuth dependence or exact match
+         if(klo == khi)
+            return hi[klo];
+         return (hi[khi]*(zen - zn_lo) + hi[klo]*(zn_hi - zen))/(zn_hi - zn_lo);
+      }
+
+      const double *lo(&grid.value[row_lo*nz]);
+      if(klo == khi)
+         return (lo[klo]*(az_hi - azim) + hi[klo]*(azim - az_lo))/(az_hi - az_lo);
+
+      return ( lo[khi] * (az_hi - azim)*(zen - zn_lo)
+             + hi[khi] * (azim - az_lo)*(zen - zn_lo)
+             + lo[klo] * (az_hi - azim)*(zn_hi - zen)
+             + hi[klo] * (azim - az_lo)*(zn_hi - zen) )
+                  / ( (az_hi - az_lo)*(zn_hi - zn_lo) );
+   }
+
    void AntexData::dump(ostream& s, int detail) const
    {
       map<string, antennaPCOandPCVData>::const_iterator it;
@@ -695,6 +938,8 @@ namespace gpstk
             GPSTK_THROW(e);
          }
       }
+
+      compileGrids();
       
    } // end of reallyGetRecord()
 
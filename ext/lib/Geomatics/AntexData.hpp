@@ -104,6 +104,8 @@ namespace gpstk
       /// NB. the PCV data is stored in a map <zenith angle, value> and the
       /// getPhaseCenterVariation() routine simply interpolates this map WITHOUT
       /// changing the sign of the value - it is the same as that in the ANTEX file.
+      /// The maps are compiled into arrays (see compileGrids()) when the data is
+      /// read, and these are what the 'get' routines actually interpolate.
       ///
       /// @sa gpstk::AntexStream and gpstk::AntexHeader.
    class AntexData : public AntexBase
@@ -192,6 +194,13 @@ namespace gpstk
 
       }; // end of class antennaPCOandPCVData
 
+      /// System characters of the ANTEX frequency codes, in the order used by
+      /// freqIndex(): "GRECJSI".
+      static const std::string freqSystems;
+
+      /// Number of distinct frequency indexes, 10 per system in freqSystems.
+      static const int numFreqIndexes;
+
       // member data
       /// Bits of valid are set when corresponding labels are found and data defined
       unsigned long valid;
@@ -278,6 +287,38 @@ namespace gpstk
       /// Generate a name from type and serial number
       std::string name(void) const throw();
 
+      /// Convert an ANTEX frequency code (e.g. G01, E05) to a small integer
+      /// index, 10*(position of the system character in freqSystems) + the
+      /// frequency number, which may be passed to the 'get' routines in place of
+      /// the string to avoid string handling in repeated calls.
+      /// @param freq frequency code, system character followed by 2 digits
+      /// @return the index, in [0,numFreqIndexes), or -1 if freq is not valid
+      static int freqIndex(const std::string& freq) throw();
+
+      /// Same as freqIndex(string), for the system character (G,R,E,C,J,S,I)
+      /// and frequency number (0-9); -1 if either is not valid.
+      static int freqIndex(const char sys, const int n) throw();
+
+      /// Inverse of freqIndex(); empty if ifreq is not a valid index.
+      static std::string freqString(const int ifreq);
+
+      /// Compile the PCO and PCV data of each frequency in freqPCVmap into
+      /// contiguous arrays, which are then used by the 'get' routines in place of
+      /// the maps: the zenith and azimuth angles are found by index arithmetic on
+      /// the regular ANTEX grid, and the results are identical to those from the
+      /// maps. Called by reallyGetRecord(); call it again after changing
+      /// freqPCVmap, or call clearGrids() to use the maps directly.
+      /// Frequencies whose PCV rows do not share the same zenith angles, or whose
+      /// codes are not valid for freqIndex(), are not compiled and use the maps.
+      void compileGrids(void);
+
+      /// Discard the arrays built by compileGrids(); the 'get' routines then use
+      /// freqPCVmap directly.
+      void clearGrids(void) throw() { grids.clear(); gridOfFreq.clear(); }
+
+      /// @return true if compileGrids() has been called and not cleared.
+      bool hasGrids(void) const throw() { return !gridOfFreq.empty(); }
+
       /// Compute the total phase center offset at the given azimuth and elev_nadir,
       /// including both nominal offset (PCO) and variation (PCV).
       /// NB. see documentation of the class for coordinates, signs and application.
@@ -320,6 +361,17 @@ namespace gpstk
                                      const double azimuth,
                                      const double elev_nadir) const;
 
+      /// Versions of getTotalPhaseCenterOffset(), getPhaseCenterOffset() and
+      /// getPhaseCenterVariation() taking the frequency index of freqIndex().
+      /// @throw Exception as the string versions, and if ifreq is not valid
+      double getTotalPhaseCenterOffset(const int ifreq,
+                                       const double azimuth,
+                                       const double elevation) const;
+      Triple getPhaseCenterOffset(const int ifreq) const;
+      double getPhaseCenterVariation(const int ifreq,
+                                     const double azimuth,
+                                     const double elev_nadir) const;
+
       /// Dump AntexData. Set detail = 0 for type, serial no., sat codes only;
       /// = 1 for all information except phase center offsets, = 2 for all data.
 #pragma clang diagnostic push
@@ -352,6 +404,58 @@ namespace gpstk
       virtual void reallyGetRecord(FFStream& s);
 
    private:
+      /// PCOs and PCVs of one frequency, compiled by compileGrids()
+      class PCVGrid {
+      public:
+         /// nominal phase center offsets in mm, as antennaPCOandPCVData
+         double PCOvalue[3];
+
+         /// azimuths (deg) of the rows of value, increasing, as the keys of
+         /// antennaPCOandPCVData::PCVvalue; empty if there is no azimuth
+         /// dependence, in which case value has one row.
+         std::vector<double> azim;
+
+         /// zenith angles (deg) of the columns of value, increasing
+         std::vector<double> zen;
+
+         /// PCVs in mm, value[row*zen.size() + column]
+         std::vector<double> value;
+
+         /// mean spacing of azim and zen, used to guess the index of an angle
+         double azimStep, zenStep;
+      };
+
+      /// grids compiled by compileGrids()
+      std::vector<PCVGrid> grids;
+
+      /// index into grids for each freqIndex(), or -1; empty if not compiled
+      std::vector<int> gridOfFreq;
+
+      /// @return the grid for freqIndex ifreq, or NULL if there is none
+      const PCVGrid* findGrid(const int ifreq) const throw()
+      {
+         if(ifreq < 0 || ifreq >= int(gridOfFreq.size()) || gridOfFreq[ifreq] < 0)
+            return NULL;
+         return &grids[gridOfFreq[ifreq]];
+      }
+
+      /// Interpolate grid at azimuth (in [0,360)) and zenith angle, exactly as
+      /// getPhaseCenterVariation() interpolates the maps.
+      static double interpolateGrid(const PCVGrid& grid,
+                                    const double azim, const double zen) throw();
+
+      /// Check the angles and convert them to an azimuth in [0,360) and a zenith
+      /// angle, as getPhaseCenterVariation() requires.
+      /// @throw Exception if this object is invalid or elev_nadir out of range
+      void checkAngles(const double azimuth, const double elev_nadir,
+                       double& azim, double& zen) const;
+
+      /// Interpolate freqPCVmap for freq; the uncompiled version of
+      /// getPhaseCenterVariation(), with azim and zen from checkAngles().
+      /// @throw Exception if frequency does not exist for this data
+      double interpolateMap(const std::string& freq,
+                            const double azim, const double zen) const;
+
       /// helper routine to throw when records are out of order
       /// throws if valid contains test (test & valid), otherwise does nothing
       void throwRecordOutOfOrder(unsigned long test, std::string& label);
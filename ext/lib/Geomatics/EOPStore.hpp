@@ -144,7 +144,8 @@ namespace gpstk {
       /// @throw InvalidRequest if the integer MJD falls outside the store,
       ///   or if the store contains fewer than 4 entries
       /// @return EarthOrientation EOPs at mjd.
-      EarthOrientation getEOP(const double& mjd, const IERSConvention& conv);
+      EarthOrientation getEOP(const double& mjd, const IERSConvention& conv)
+         const;
 
    };    // end class EOPStore
 
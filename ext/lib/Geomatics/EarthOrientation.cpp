@@ -45,6 +45,10 @@
 //------------------------------------------------------------------------------------
 // system includes
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <vector>
 // GPSTk
 #include "MiscMath.hpp"
 #include "logstream.hpp"
@@ -1116,10 +1120,22 @@ namespace gpstk
 
    //---------------------------------------------------------------------------------
    // Compute the nutation matrix, given coordinate transformation time T
-   Matrix<double> EarthOrientation::NutationMatrix(const EphTime& t)
+   Matrix<double> EarthOrientation::NutationMatrix(const EphTime& t) const
    {
       try {
          double T = CoordTransTime(t);
+         if(useCache && (convention == IERSConvention::IERS2003
+                         || convention == IERSConvention::IERS2010)) {
+            double X,Y,s,deps,dpsi,eps;
+            CachedSeries(T,X,Y,s,deps,dpsi);
+            if(convention == IERSConvention::IERS2003)   // cf. NutationMatrix2003()
+               eps = Obliquity1996(T) - 0.02524 * ARCSEC_TO_RAD * T;
+            else {                                      // cf. NutationMatrix2010()
+               NutationAdjust2010(T,deps,dpsi);
+               eps = Obliquity2010(T);
+            }
+            return NutationMatrix(eps,dpsi,deps);
+         }
          if(convention == IERSConvention::IERS1996)
             return NutationMatrix1996(T);
          else if(convention == IERSConvention::IERS2003)
@@ -1162,6 +1178,7 @@ namespace gpstk
    // xp and yp (arcseconds), and UT1-UTC (seconds) (as found in the IERS bulletin).
    // throw if convention is not defined
    Matrix<double> EarthOrientation::ECEFtoInertial(const EphTime& t, bool reduced)
+      const
    {
       try {
          if(convention == IERSConvention::IERS1996)
@@ -1178,6 +1195,24 @@ namespace gpstk
       catch(Exception& e) { GPSTK_RETHROW(e); }
    }
 
+   //---------------------------------------------------------------------------------
+   // Generate the full transformation matrix (3x3 rotation) relating the ECEF
+   // frame to the conventional inertial frame at each of the given times, using
+   // this object's EOPs for all of them.
+   // throw if convention is not defined
+   vector< Matrix<double> > EarthOrientation::ECEFtoInertial(
+                                 const vector<EphTime>& times, bool reduced) const
+   {
+      try {
+         vector< Matrix<double> > rots;
+         rots.reserve(times.size());
+         for(size_t i=0; i<times.size(); i++)
+            rots.push_back(ECEFtoInertial(times[i], reduced));
+         return rots;
+      }
+      catch(Exception& e) { GPSTK_RETHROW(e); }
+   }
+
    //------------------------------------------------------------------------------
    // Compute the transformation from ECEF to the J2000 dynamical (inertial)
    // frame. This differs from the ECEFtoInertial transformation only by the
@@ -1555,6 +1590,136 @@ namespace gpstk
       Y *= ARCSEC_TO_RAD;
    }
 
+   //------------------------------------------------------------------------------
+   // The grid used by CachedSeries(). Node k is at T = k*SeriesStep and holds
+   // SeriesNval values X, Y, s, deps, dpsi; nodes are stored in blocks of
+   // SeriesNblock nodes, which are computed when first needed and then never
+   // change. SeriesNpts nodes are used to interpolate.
+   // The largest short-period terms of the nutation series are the fortnightly
+   // ones; Lagrange interpolation of order 8 on half-day nodes reproduces the
+   // series to better than 0.1 microarcsecond, and polynomial terms exactly.
+   // Blocks within about three centuries of J2000 are published through a
+   // directory of atomic pointers, so that finished blocks are read without
+   // locking; a missing block is computed without any lock, and if another
+   // thread publishes the same block first, that one is used. Blocks outside
+   // the directory are kept in a map, which is locked only to find or insert.
+   namespace {
+      const int SeriesNval(5), SeriesNpts(8), SeriesNblock(16);
+      const double SeriesStep(0.5/36525.0);      // half a day, in centuries
+      const long SeriesNdir(long(6.0/(SeriesNblock*SeriesStep)) + 1);
+      const long SeriesFirst(-SeriesNdir/2);     // block number of dir[0]
+
+      struct SeriesBlock
+      {
+         double values[SeriesNblock*SeriesNval];
+      };
+
+      struct SeriesGrid
+      {
+         SeriesGrid() : dir(SeriesNdir)
+         {
+            for(size_t i=0; i<dir.size(); i++) dir[i].store(0);
+         }
+         ~SeriesGrid()
+         {
+            for(size_t i=0; i<dir.size(); i++) delete dir[i].load();
+         }
+
+         vector< atomic<const SeriesBlock*> > dir;
+         mutex lock;                               // for outside only
+         map<long, SeriesBlock> outside;
+      };
+   }
+
+   //------------------------------------------------------------------------------
+   // Return block b of grid, computing it with compute(b, block) if it is not
+   // yet there.
+   template <class Compute>
+   static const SeriesBlock& GetSeriesBlock(SeriesGrid& grid, long b,
+                                            Compute compute)
+   {
+      if(b >= SeriesFirst && b < SeriesFirst+SeriesNdir) {
+         atomic<const SeriesBlock*>& slot(grid.dir[b-SeriesFirst]);
+         const SeriesBlock *pblock(slot.load(memory_order_acquire));
+         if(pblock) return *pblock;
+
+         SeriesBlock *pnew(new SeriesBlock);
+         compute(b, *pnew);
+         if(slot.compare_exchange_strong(pblock, pnew, memory_order_acq_rel))
+            return *pnew;
+         delete pnew;                              // another thread was first
+         return *pblock;
+      }
+
+      {
+         lock_guard<mutex> guard(grid.lock);
+         map<long, SeriesBlock>::const_iterator it(grid.outside.find(b));
+         if(it != grid.outside.end()) return it->second;
+      }
+      SeriesBlock block;
+      compute(b, block);
+      // map elements do not move, so the reference is good after unlocking
+      lock_guard<mutex> guard(grid.lock);
+      return grid.outside.insert(make_pair(b, block)).first->second;
+   }
+
+   //------------------------------------------------------------------------------
+   // Interpolate the IERS2010 CIO coordinates X,Y and locator s, and the IAU 2000A
+   // nutation angles of IERS2003, from the shared grid of nodes, at T.
+   void EarthOrientation::CachedSeries(double T, double& X, double& Y, double& s,
+                                       double& deps, double& dpsi)
+   {
+      static SeriesGrid grid;
+      int i,j;
+
+      // nodes k0 .. k0+Npts-1, with T between the middle two
+      double u(T/SeriesStep);
+      long k0(long(::floor(u)) - SeriesNpts/2 + 1);
+      double x(u - double(k0));
+
+      // the nodes of block b
+      auto compute = [](long b, SeriesBlock& block) {
+         for(int n=0; n<SeriesNblock; n++) {
+            double Tn(double(b*SeriesNblock + n) * SeriesStep);
+            double *v(&block.values[n*SeriesNval]);
+            XYCIO(Tn, v[0], v[1]);
+            v[2] = S(Tn, v[0], v[1], IERSConvention::IERS2010);
+            NutationAngles2003(Tn, v[3], v[4]);
+         }
+      };
+
+      // copy the node values; the nodes span at most two blocks
+      double val[SeriesNpts][SeriesNval];
+      long bcur(0);
+      const SeriesBlock *pblock(0);
+      for(i=0; i<SeriesNpts; i++) {
+         long k(k0+i);
+         long b(k >= 0 ? k/SeriesNblock : -((-k-1)/SeriesNblock) - 1);
+         if(!pblock || b != bcur) {
+            pblock = &GetSeriesBlock(grid, b, compute);
+            bcur = b;
+         }
+         const double *v(&pblock->values[(k - b*SeriesNblock)*SeriesNval]);
+         for(j=0; j<SeriesNval; j++) val[i][j] = v[j];
+      }
+
+      // Lagrange interpolation at x, on nodes at 0,1,...,Npts-1
+      double res[SeriesNval];
+      for(j=0; j<SeriesNval; j++) res[j] = 0.0;
+      for(i=0; i<SeriesNpts; i++) {
+         double w(1.0);
+         for(j=0; j<SeriesNpts; j++)
+            if(j != i) w *= (x - double(j)) / double(i - j);
+         for(j=0; j<SeriesNval; j++) res[j] += w * val[i][j];
+      }
+
+      X = res[0];
+      Y = res[1];
+      s = res[2];
+      deps = res[3];
+      dpsi = res[4];
+   }
+
    //---------------------------------------------------------------------------------
    // Starting with 2003 (and valid for 2010) conventions a new method for computing
    // the transformation fron ITRS to GCRS is provided by the Celestial Ephemeris
@@ -1997,7 +2162,7 @@ namespace gpstk
    double EarthOrientation::GAST2010(EphTime t, double UT1mUTC)
    {
       try {
-         Matrix<double> NutPreBias = PreciseEarthRotation2010(CoordTransTime(t));
+         Matrix3 NutPreBias = PreciseEarthRotation2010(CoordTransTime(t));
 
          // extract X and Y coords of the CIP from the matrix
          // cf. sofa bpn2xy.c
@@ -2034,15 +2199,16 @@ namespace gpstk
    // see class EarthOrientation.
    // param xp, Earth wobble in arcseconds, as found in the IERS bulletin.
    // param yp, Earth wobble in arcseconds, as found in the IERS bulletin.
-   // return Matrix<double>(3,3) rotation matrix
-   Matrix<double> EarthOrientation::PolarMotionMatrix1996(double xp, double yp)
+   // return Matrix3 rotation matrix
+   EarthOrientation::Matrix3
+      EarthOrientation::PolarMotionMatrix1996(double xp, double yp)
       throw()
    {
       xp *= ARCSEC_TO_RAD;
       yp *= ARCSEC_TO_RAD;
-      Matrix<double> R1,R2;
-      R1 = rotation(-yp,1);
-      R2 = rotation(-xp,2);
+      Matrix3 R1,R2;
+      R1 = fixedRotation(-yp,1);
+      R2 = fixedRotation(-xp,2);
       return (R2*R1);
    }
 
@@ -2054,8 +2220,8 @@ namespace gpstk
    // param t EphTime epoch of the rotation.
    // param xp, Earth wobble in arcseconds, as found in the IERS bulletin.
    // param yp, Earth wobble in arcseconds, as found in the IERS bulletin.
-   // return Matrix<double>(3,3) rotation matrix CIP -> TRS
-   Matrix<double> EarthOrientation::PolarMotionMatrix2003(EphTime t,
+   // return Matrix3 rotation matrix CIP -> TRS
+   EarthOrientation::Matrix3 EarthOrientation::PolarMotionMatrix2003(EphTime t,
                                                          double xp, double yp)
       throw()
    {
@@ -2064,10 +2230,10 @@ namespace gpstk
             << " with T = " << CoordTransTime(t);
       xp *= ARCSEC_TO_RAD;
       yp *= ARCSEC_TO_RAD;
-      Matrix<double> R1,R2,R3;
-      R3 = rotation(sp, 3);
-      R2 = rotation(-xp, 2);
-      R1 = rotation(-yp, 1);
+      Matrix3 R1,R2,R3;
+      R3 = fixedRotation(sp, 3);
+      R2 = fixedRotation(-xp, 2);
+      R1 = fixedRotation(-yp, 1);
       return (R1*R2*R3);
    }
 
@@ -2110,15 +2276,15 @@ namespace gpstk
    // param psib F-W angle
    // param epsa F-W angle, the obliquity
    // return 3x3 rotation matrix
-   Matrix<double> EarthOrientation::FukushimaWilliams(double gamb, double phib,
-                                                       double psib, double epsa)
+   EarthOrientation::Matrix3 EarthOrientation::FukushimaWilliams(double gamb,
+                                          double phib, double psib, double epsa)
       throw()
    {
-      Matrix<double> R;
-      R = rotation(-epsa,1) *
-          rotation(-psib,3) *
-          rotation(phib,1) *
-          rotation(gamb,3);
+      Matrix3 R;
+      R = fixedRotation(-epsa,1) *
+          fixedRotation(-psib,3) *
+          fixedRotation(phib,1) *
+          fixedRotation(gamb,3);
       return R;
    }
 
@@ -2317,6 +2483,14 @@ namespace gpstk
       throw()
    {
       NutationAngles2003(T,deps,dpsi);
+      NutationAdjust2010(T,deps,dpsi);
+   }
+
+   //---------------------------------------------------------------------------------
+   // Adjust the IERS2003 nutation angles to IERS2010; cf. NutationAngles2010()
+   void EarthOrientation::NutationAdjust2010(double T, double& deps, double& dpsi)
+      throw()
+   {
       double fj2(-2.7774e-6 * T);
       dpsi *= (1.0+0.4697e-6 + fj2);
       deps *= (1.0+fj2);
@@ -2327,21 +2501,21 @@ namespace gpstk
    // eps,  the obliquity of the ecliptic, in radians,
    // dpsi, the nutation in longitude (counted in the ecliptic), in radians
    // deps, the nutation in obliquity, in radians.
-   Matrix<double> EarthOrientation::NutationMatrix(double eps,
+   EarthOrientation::Matrix3 EarthOrientation::NutationMatrix(double eps,
                                                    double dpsi, double deps)
       throw()
    {
-      Matrix<double> R1 = rotation(eps, 1);
-      Matrix<double> R2 = rotation(-dpsi, 3);
-      Matrix<double> R3 = rotation(-(eps+deps), 1);
+      Matrix3 R1 = fixedRotation(eps, 1);
+      Matrix3 R2 = fixedRotation(-dpsi, 3);
+      Matrix3 R3 = fixedRotation(-(eps+deps), 1);
       return (R3*R2*R1);
    }
 
    //------------------------------------------------------------------------------
    // IERS1996 nutation matrix, a 3x3 rotation matrix, given
    // param T, the coordinate transformation time at the time of interest
-   // return nutation matrix Matrix<double>(3,3)
-   Matrix<double> EarthOrientation::NutationMatrix1996(double T)
+   // return nutation matrix Matrix3
+   EarthOrientation::Matrix3 EarthOrientation::NutationMatrix1996(double T)
       throw()
    {
       double eps(Obliquity1996(T)), deps, dpsi, om;
@@ -2354,8 +2528,8 @@ namespace gpstk
    // IERS2003 nutation matrix, a 3x3 rotation matrix
    // (including the frame bias matrix), given
    // param T, the coordinate transformation time at the time of interest
-   // return nutation matrix Matrix<double>(3,3)
-   Matrix<double> EarthOrientation::NutationMatrix2003(double T)
+   // return nutation matrix Matrix3
+   EarthOrientation::Matrix3 EarthOrientation::NutationMatrix2003(double T)
       throw()
    {
       double eps(Obliquity1996(T)), deps, dpsi;    // same as Obliquity2003
@@ -2373,8 +2547,8 @@ namespace gpstk
    // IERS2010 nutation matrix, a 3x3 rotation matrix, given
    // param T, the coordinate transformation time at the time of interest;
    // cf. FukushimaWilliams().
-   // return nutation matrix Matrix<double>(3,3)
-   Matrix<double> EarthOrientation::NutationMatrix2010(double T)
+   // return nutation matrix Matrix3
+   EarthOrientation::Matrix3 EarthOrientation::NutationMatrix2010(double T)
       throw()
    {
       double deps,dpsi,eps;
@@ -2388,10 +2562,10 @@ namespace gpstk
       //
       //// construct nutation x precession x frame bias matrix
       //// NB this is the same as PreciseEarthRotation2010(T)
-      //Matrix<double> NPB = FukushimaWilliams(gamb,phib,psib+dpsi,eps+deps);
+      //Matrix3 NPB = FukushimaWilliams(gamb,phib,psib+dpsi,eps+deps);
       //
       //// now get PB alone - see FukushimaWilliams()
-      //Matrix<double> PB = FukushimaWilliams(gamb,phib,psib,eps);
+      //Matrix3 PB = FukushimaWilliams(gamb,phib,psib,eps);
       //
       //return (NPB * transpose(PB));
 
@@ -2403,8 +2577,8 @@ namespace gpstk
    //------------------------------------------------------------------------------
    // Compute the IERS1996 precession matrix, a 3x3 rotation matrix, given
    // param T, the coordinate transformation time at the time of interest
-   // return precession matrix Matrix<double>(3,3)
-   Matrix<double> EarthOrientation::PrecessionMatrix1996(double T)
+   // return precession matrix Matrix3
+   EarthOrientation::Matrix3 EarthOrientation::PrecessionMatrix1996(double T)
       throw()
    {
          // IAU76 - ref McCarthy - seconds of arc
@@ -2414,10 +2588,10 @@ namespace gpstk
       double theta = TAR*(2004.3109 - T*(0.42665 + T*0.041833));
       double z     = TAR*(2306.2181 + T*(1.09468 + T*0.018203));
 
-      Matrix<double> R1 = rotation(-zeta, 3);
-      Matrix<double> R2 = rotation(theta, 2);
-      Matrix<double> R3 = rotation(-z, 3);
-      Matrix<double> P = R3*R2*R1;
+      Matrix3 R1 = fixedRotation(-zeta, 3);
+      Matrix3 R2 = fixedRotation(theta, 2);
+      Matrix3 R3 = fixedRotation(-z, 3);
+      Matrix3 P = R3*R2*R1;
 
       return P;
    }
@@ -2426,8 +2600,8 @@ namespace gpstk
    // Compute the IERS2003 precession matrix, a 3x3 rotation matrix, given
    // param T, the coordinate transformation time at the time of interest
    // Includes the frame bias matrix. cf sofa bp00.c
-   // return precession matrix Matrix<double>(3,3)
-   Matrix<double> EarthOrientation::PrecessionMatrix2003(double T)
+   // return precession matrix Matrix3
+   EarthOrientation::Matrix3 EarthOrientation::PrecessionMatrix2003(double T)
       throw()
    {
       // obliquity at the J2000.0 epoch
@@ -2470,19 +2644,19 @@ namespace gpstk
       epsa += depspr;
 
       // Frame bias matrix
-      Matrix<double> R1 = rotation(raeps0, 3);
-      Matrix<double> R2 = rotation(psibias * ::sin(eps0), 2);
-      Matrix<double> R3 = rotation(-epsbias, 1);
-      Matrix<double> FrameBias(R3*R2*R1);
+      Matrix3 R1 = fixedRotation(raeps0, 3);
+      Matrix3 R2 = fixedRotation(psibias * ::sin(eps0), 2);
+      Matrix3 R3 = fixedRotation(-epsbias, 1);
+      Matrix3 FrameBias(R3*R2*R1);
       LOG(DEBUG7) << "\nframe bias matrix:\n" << fixed << setprecision(15) << showpos
          << FrameBias;
 
       // Precession matrix
-      R1 = rotation(eps0, 1);
-      R2 = rotation(-psia, 3);
-      R3 = rotation(-epsa, 1);
-      Matrix<double> R4 = rotation(chia, 3);
-      Matrix<double> Precess(R4*R3*R2*R1);
+      R1 = fixedRotation(eps0, 1);
+      R2 = fixedRotation(-psia, 3);
+      R3 = fixedRotation(-epsa, 1);
+      Matrix3 R4 = fixedRotation(chia, 3);
+      Matrix3 Precess(R4*R3*R2*R1);
       LOG(DEBUG7) << "\nprecession matrix:\n" << fixed << setprecision(15) << showpos
          << Precess;
 
@@ -2508,8 +2682,8 @@ namespace gpstk
 
    //------------------------------------------------------------------------------
    // IERS2010 frame bias matrix, a 3x3 rotation matrix; cf. FukushimaWilliams().
-   // return frame bias matrix Matrix<double>(3,3)
-   Matrix<double> EarthOrientation::BiasMatrix2010(void)
+   // return frame bias matrix Matrix3
+   EarthOrientation::Matrix3 EarthOrientation::BiasMatrix2010(void)
       throw()
    {
       // get F-W angles at J2000
@@ -2524,21 +2698,21 @@ namespace gpstk
    // Compute the IERS2010 precession matrix, a 3x3 rotation matrix, given
    // param T, the coordinate transformation time at the time of interest
    // Does not include the frame bias matrix. Cf. FukushimaWilliams().
-   // return precession matrix Matrix<double>(3,3)
-   Matrix<double> EarthOrientation::PrecessionMatrix2010(double T)
+   // return precession matrix Matrix3
+   EarthOrientation::Matrix3 EarthOrientation::PrecessionMatrix2010(double T)
       throw()
    {
       // the F-W angles
       double gamb,phib,psib,epsa;
 
       // get frame bias matrix
-      Matrix<double> B = BiasMatrix2010();
+      Matrix3 B = BiasMatrix2010();
 
       // get F-W angles at epoch
       FukushimaWilliams(T, gamb, phib, psib, epsa);
 
       // precession x frame bias matrix
-      Matrix<double> PB = FukushimaWilliams(gamb, phib, psib, epsa);
+      Matrix3 PB = FukushimaWilliams(gamb, phib, psib, epsa);
 
       return (PB * transpose(B));
    }
@@ -2549,13 +2723,13 @@ namespace gpstk
    // for IERS 2003.
    // param T CoordTransTime of interest
    // return 3x3 rotation matrix
-   Matrix<double> EarthOrientation::PreciseEarthRotation2003(double T)
+   EarthOrientation::Matrix3 EarthOrientation::PreciseEarthRotation2003(double T)
    {
       try {
-         Matrix<double> N = NutationMatrix2003(T);
-         Matrix<double> P = PrecessionMatrix2003(T);     // includes bias
+         Matrix3 N = NutationMatrix2003(T);
+         Matrix3 P = PrecessionMatrix2003(T);     // includes bias
 
-         //Matrix<double> NPB(N*P);
+         //Matrix3 NPB(N*P);
          //LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
          //      << showpos << NPB;
 
@@ -2570,7 +2744,7 @@ namespace gpstk
    // for IERS 2010.
    // param T CoordTransTime of interest
    // return 3x3 rotation matrix
-   Matrix<double> EarthOrientation::PreciseEarthRotation2010(double T)
+   EarthOrientation::Matrix3 EarthOrientation::PreciseEarthRotation2010(double T)
    {
       try {
          double deps,dpsi,epsa;
@@ -2594,11 +2768,11 @@ namespace gpstk
    // Input is the time of interest, the polar motion angles xp and yp (arcsecs),
    // and UT1-UTC (sec) (xp,yp and UT1-UTC are just as found in the IERS bulletin;
    // see class EarthOrientation).
-   Matrix<double> EarthOrientation::ECEFtoInertial1996(EphTime t,
-                       double xp, double yp, double UT1mUTC, bool reduced)
+   EarthOrientation::Matrix3 EarthOrientation::ECEFtoInertial1996(EphTime t,
+                       double xp, double yp, double UT1mUTC, bool reduced) const
    {
       try {
-         Matrix<double> P,N,W,S;
+         Matrix3 P,N,W,S;
 
          double T=CoordTransTime(t);
 
@@ -2636,7 +2810,7 @@ namespace gpstk
          LOG(DEBUG7) << "\nGAST = " << fixed << setprecision(15)
                << showpos << g*RAD_TO_DEG;
 
-         S = rotation(g,3);
+         S = fixedRotation(g,3);
          LOG(DEBUG7) << "\ncelestial-to-terrestrial matrix (no polar motion):\n"
                << fixed << setprecision(15) << setw(18) << showpos << S*N*P;
 
@@ -2656,11 +2830,11 @@ namespace gpstk
    // Input is the time of interest, the polar motion angles xp and yp (arcsecs),
    // and UT1-UTC (sec) (xp,yp and UT1-UTC are just as found in the IERS bulletin;
    // see class EarthOrientation).
-   Matrix<double> EarthOrientation::ECEFtoInertial2003(EphTime t,
-                                                double xp, double yp, double UT1mUTC)
+   EarthOrientation::Matrix3 EarthOrientation::ECEFtoInertial2003(EphTime t,
+                                       double xp, double yp, double UT1mUTC) const
    {
       try {
-         Matrix<double> P,N,R,W;
+         Matrix3 P,N,R,W;
 
          double T(CoordTransTime(t));
 
@@ -2676,7 +2850,12 @@ namespace gpstk
 
          // nutation
          double deps, dpsi, dpsipr, depspr;
-         NutationAngles2003(T,deps,dpsi);
+         if(useCache) {
+            double X,Y,s;
+            CachedSeries(T,X,Y,s,deps,dpsi);
+         }
+         else
+            NutationAngles2003(T,deps,dpsi);
          LOG(DEBUG7) << "\nnutation angles psi eps " << fixed << setprecision(15)
             << showpos << dpsi << " " << deps;
 
@@ -2698,7 +2877,7 @@ namespace gpstk
          // precession
          P = PrecessionMatrix2003(T);
 
-         Matrix<double> NPB(N*P);
+         Matrix3 NPB(N*P);
          LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
                << showpos << NPB;
 
@@ -2706,10 +2885,10 @@ namespace gpstk
          double era(EarthRotationAngle(t,UT1mUTC));
          LOG(DEBUG7) << "\nERA = " << fixed << setprecision(15) << showpos
                         << era*RAD_TO_DEG;
-         R = rotation(era,3);
+         R = fixedRotation(era,3);
 
          //double gast = GAST2003(t, UT1mUTC);
-         //R = rotation(gast,3);
+         //R = fixedRotation(gast,3);
 
          // polar motion
          W = PolarMotionMatrix2003(t, xp, yp);
@@ -2727,8 +2906,8 @@ namespace gpstk
    // Input is the time of interest, the polar motion angles xp and yp (arcsecs),
    // and UT1-UTC (sec) (xp,yp and UT1-UTC are just as found in the IERS bulletin;
    // see class EarthOrientation).
-   Matrix<double> EarthOrientation::ECEFtoInertial2010(EphTime t,
-                       double xp, double yp, double UT1mUTC)
+   EarthOrientation::Matrix3 EarthOrientation::ECEFtoInertial2010(EphTime t,
+                       double xp, double yp, double UT1mUTC) const
    {
       try {
          double T(CoordTransTime(t));
@@ -2737,8 +2916,14 @@ namespace gpstk
          // note that X,Y could also be obtained as (2,0),(2,1) components
          // of FukushimaWilliams()
          double X,Y,s;
-         XYCIO(T, X, Y);
-         s = S(T,X,Y,IERSConvention::IERS2010);
+         if(useCache) {
+            double deps,dpsi;
+            CachedSeries(T,X,Y,s,deps,dpsi);
+         }
+         else {
+            XYCIO(T, X, Y);
+            s = S(T,X,Y,IERSConvention::IERS2010);
+         }
          LOG(DEBUG7) << "X = " << fixed << setprecision(15) << showpos << X;
          LOG(DEBUG7) << "Y = " << fixed << setprecision(15) << showpos << Y;
          LOG(DEBUG7) << "s\" = " << fixed << setprecision(15) << s/ARCSEC_TO_RAD;
@@ -2748,8 +2933,9 @@ namespace gpstk
          double r2(X*X+Y*Y);                          // squared radius
          double e(r2 != 0.0 ? ::atan2(Y, X) : 0.0);   // spherical angles
          double d(::atan(::sqrt(r2/(1.0-r2))));       //
-         Matrix<double> GCRStoCIRS;
-         GCRStoCIRS = rotation(-(e+s),3) * rotation(d, 2) * rotation(e, 3);
+         Matrix3 GCRStoCIRS;
+         GCRStoCIRS = fixedRotation(-(e+s),3) * fixedRotation(d, 2)
+                                              * fixedRotation(e, 3);
          LOG(DEBUG7) << "\nNPB matrix:\n" << fixed << setprecision(15) << setw(18)
                << showpos << GCRStoCIRS;
 
@@ -2761,20 +2947,20 @@ namespace gpstk
                      << showpos << era*RAD_TO_DEG;
 
          // compute transf. CIRS-to-TIRS or intermediate-celestial-to-terrestrial
-         Matrix<double> CIRStoTIRS;
-         CIRStoTIRS = rotation(era, 3);
+         Matrix3 CIRStoTIRS;
+         CIRStoTIRS = fixedRotation(era, 3);
          LOG(DEBUG7) << "\ncelestial-to-terrestrial matrix (no polar motion):\n"
                << fixed << setprecision(15) << setw(18) << showpos
                << CIRStoTIRS * GCRStoCIRS;
 
          // compute the polar motion matrix, TIRS-to-ITRS
          //double sprime(Sprime(T));
-         Matrix<double> PolarMotion(PolarMotionMatrix2003(t, xp, yp)); // 2010 == 2003
+         Matrix3 PolarMotion(PolarMotionMatrix2003(t, xp, yp)); // 2010 == 2003
          LOG(DEBUG7) << "\npolar motion matrix:\n" << fixed << setprecision(15)
                << setw(18) << showpos << PolarMotion;
 
          // combine to get GCRS-to-ITRS
-         Matrix<double> GCRStoITRS;
+         Matrix3 GCRStoITRS;
          GCRStoITRS = PolarMotion * CIRStoTIRS * GCRStoCIRS;
 
          // invert to get ITRS-to-GCRS or ECEFtoInertial
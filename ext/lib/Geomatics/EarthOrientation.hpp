@@ -56,6 +56,7 @@
 #include "Triple.hpp"
 #include "Position.hpp"
 #include "Matrix.hpp"
+#include "FixedMatrix.hpp"
 // geomatics
 #include "EphTime.hpp"
 #include "IERSConvention.hpp"
@@ -104,7 +105,8 @@ namespace gpstk {
       IERSConvention convention;
 
       /// Constructor
-      EarthOrientation() : xp(0),yp(0),UT1mUTC(0),convention(IERSConvention::Unknown)
+      EarthOrientation() : xp(0),yp(0),UT1mUTC(0),convention(IERSConvention::Unknown),
+                           useCache(false)
          { }
 
       /// append to output stream
@@ -349,7 +351,7 @@ namespace gpstk {
       /// @param t EphTime epoch of the rotation.
       /// @return nutation matrix Matrix<double>(3,3)
       /// @throw Exception if convention is not defined
-      Matrix<double> NutationMatrix(const EphTime& t);
+      Matrix<double> NutationMatrix(const EphTime& t) const;
 
       //------------------------------------------------------------------------------
       /// Generate precise transformation matrix (3X3 rotation) for Earth motion due
@@ -371,7 +373,31 @@ namespace gpstk {
       /// @return 3x3 rotation matrix
       /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
       /// @throw Exception if convention is not defined
-      Matrix<double> ECEFtoInertial(const EphTime& t, bool reduced=false);
+      Matrix<double> ECEFtoInertial(const EphTime& t, bool reduced=false) const;
+
+      /// Generate the full transformation matrix (3x3 rotation) relating the ECEF
+      /// frame to the conventional inertial frame at each of the given times, using
+      /// this object's EOPs for all of them; cf. ECEFtoInertial(t,reduced).
+      /// @param times vector<EphTime> epochs of the rotation.
+      /// @param reduced, bool true when UT1mUTC is 'reduced' (default=F).
+      /// @return vector of 3x3 rotation matrices, parallel to times
+      /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
+      /// @throw Exception if convention is not defined
+      std::vector< Matrix<double> > ECEFtoInertial(const std::vector<EphTime>& times,
+                                                   bool reduced=false) const;
+
+      //------------------------------------------------------------------------------
+      /// Choose how ECEFtoInertial() and NutationMatrix() evaluate the IAU 2000A
+      /// nutation series (IERS2003) and the IAU 2006/2000A CIO series (IERS2010).
+      /// By default the full series are summed at each time. With the cache, they
+      /// are instead interpolated from a grid of nodes, half a day apart, that is
+      /// computed as needed and shared by all objects and threads; the
+      /// interpolation error is well below 1 microarcsecond. Use the cache when
+      /// transformations are needed at many times, e.g. along an orbit at 1 Hz.
+      /// IERS1996 is not affected.
+      /// @param flag bool true to use the cache
+      void useSeriesCache(const bool flag) throw()
+         { useCache = flag; }
 
       //------------------------------------------------------------------------------
       /// Compute the transformation from ECEF to the J2000 dynamical (inertial)
@@ -382,6 +408,27 @@ namespace gpstk {
       Matrix<double> ECEFtoJ2000(const EphTime& t, bool reduced=false);
 
    private:
+      /// 3x3 rotation matrices are built and multiplied internally on the
+      /// stack; the public functions return them as Matrix<double>.
+      typedef FixedMatrix<double,3,3> Matrix3;
+
+      /// if true, interpolate the series with CachedSeries(); cf. useSeriesCache()
+      bool useCache;
+
+      //------------------------------------------------------------------------------
+      /// Interpolate, on a grid of nodes shared by all threads, the IERS2010 CIO
+      /// coordinates X,Y (cf. XYCIO()) and locator s (cf. S()), and the IAU 2000A
+      /// nutation angles of IERS2003 (cf. NutationAngles2003()). Nodes are computed
+      /// from the full series, in blocks, the first time they are needed.
+      /// @param T, the coordinate transformation time at the time of interest
+      /// @param X, x coordinate of CIO (output)
+      /// @param Y, y coordinate of CIO (output)
+      /// @param s, the CIO locator s in radians (output)
+      /// @param deps, IERS2003 nutation of the obliquity in radians (output)
+      /// @param dpsi, IERS2003 nutation of the longitude in radians (output)
+      static void CachedSeries(double T, double& X, double& Y, double& s,
+                               double& deps, double& dpsi);
+
       //------------------------------------------------------------------------------
       /// locator s which gives the position of the CIO on the equator of
       /// the CIP, given the coordinate transformation time T and the coordinates X,Y
@@ -573,8 +620,8 @@ namespace gpstk {
       /// angles xp and yp (arcseconds), as found in the IERS bulletin;
       /// @param xp, Earth wobble in arcseconds, as found in the IERS bulletin.
       /// @param yp, Earth wobble in arcseconds, as found in the IERS bulletin.
-      /// @return Matrix<double>(3,3) rotation matrix
-      static Matrix<double> PolarMotionMatrix1996(double xp, double yp)
+      /// @return Matrix3 rotation matrix
+      static Matrix3 PolarMotionMatrix1996(double xp, double yp)
          throw();
 
       //------------------------------------------------------------------------------
@@ -585,8 +632,8 @@ namespace gpstk {
       /// @param t EphTime epoch of the rotation.
       /// @param xp, Earth wobble in arcseconds, as found in the IERS bulletin.
       /// @param yp, Earth wobble in arcseconds, as found in the IERS bulletin.
-      /// @return Matrix<double>(3,3) rotation matrix CIP -> TRS
-      static Matrix<double> PolarMotionMatrix2003(EphTime t, double xp, double yp)
+      /// @return Matrix3 rotation matrix CIP -> TRS
+      static Matrix3 PolarMotionMatrix2003(EphTime t, double xp, double yp)
          throw();
 
       //------------------------------------------------------------------------------
@@ -616,7 +663,7 @@ namespace gpstk {
       /// @param psib F-W angle
       /// @param epsa F-W angle, the obliquity
       /// @return 3x3 rotation matrix B, PB or NPB
-      static Matrix<double> FukushimaWilliams(double gamb, double phib,
+      static Matrix3 FukushimaWilliams(double gamb, double phib,
                                               double psib, double epsa)
          throw();
 
@@ -646,51 +693,58 @@ namespace gpstk {
       static void NutationAngles2010(double T, double& deps, double& dpsi)
          throw();
 
+      /// Adjust the IERS2003 nutation angles to IERS2010; cf. NutationAngles2010()
+      /// @param T,    the coordinate transformation time at the time of interest
+      /// @param deps, nutation of the obliquity (input and output) in radians
+      /// @param dpsi, nutation of the longitude (input and output) in radians
+      static void NutationAdjust2010(double T, double& deps, double& dpsi)
+         throw();
+
       //------------------------------------------------------------------------------
       /// nutation matrix, a 3x3 rotation matrix, given
       /// @param eps, Obliquity(T), the obliquity of the ecliptic, in radians,
       /// @param dpsi, the nutation in longitude (counted in the ecliptic) in radians.
       /// @param deps, the nutation in obliquity, in radians.
-      /// @return nutation matrix Matrix<double>(3,3)
-      static Matrix<double> NutationMatrix(double eps, double dpsi, double deps)
+      /// @return nutation matrix Matrix3
+      static Matrix3 NutationMatrix(double eps, double dpsi, double deps)
          throw();
 
       //------------------------------------------------------------------------------
       /// IERS1996 nutation matrix, a 3x3 rotation matrix, given
       /// @param T, the coordinate transformation time at the time of interest
-      /// @return nutation matrix Matrix<double>(3,3)
-      static Matrix<double> NutationMatrix1996(double T)
+      /// @return nutation matrix Matrix3
+      static Matrix3 NutationMatrix1996(double T)
          throw();
 
       //------------------------------------------------------------------------------
       /// IERS2003 nutation matrix, a 3x3 rotation matrix
       /// (including the frame bias matrix), given
       /// @param T, the coordinate transformation time at the time of interest
-      /// @return nutation matrix Matrix<double>(3,3)
-      static Matrix<double> NutationMatrix2003(double T)
+      /// @return nutation matrix Matrix3
+      static Matrix3 NutationMatrix2003(double T)
          throw();
 
       //------------------------------------------------------------------------------
       /// IERS2010 nutation matrix, a 3x3 rotation matrix, given
       /// @param T, the coordinate transformation time at the time of interest;
       /// cf. FukushimaWilliams().
-      /// @return nutation matrix Matrix<double>(3,3)
-      static Matrix<double> NutationMatrix2010(double T)
+      /// @return nutation matrix Matrix3
+      static Matrix3 NutationMatrix2010(double T)
          throw();
 
       //------------------------------------------------------------------------------
       /// IERS1996 precession matrix, a 3x3 rotation matrix, given
       /// @param T, the coordinate transformation time at the time of interest
-      /// @return precession matrix Matrix<double>(3,3)
-      static Matrix<double> PrecessionMatrix1996(double T)
+      /// @return precession matrix Matrix3
+      static Matrix3 PrecessionMatrix1996(double T)
          throw();
 
       //------------------------------------------------------------------------------
       /// IERS2003 precession matrix, a 3x3 rotation matrix
       /// (including the frame bias matrix), given
       /// @param T, the coordinate transformation time at the time of interest
-      /// @return precession matrix Matrix<double>(3,3)
-      static Matrix<double> PrecessionMatrix2003(double T)
+      /// @return precession matrix Matrix3
+      static Matrix3 PrecessionMatrix2003(double T)
          throw();
 
       //------------------------------------------------------------------------------
@@ -702,16 +756,16 @@ namespace gpstk {
 
       //------------------------------------------------------------------------------
       /// IERS2010 frame bias matrix, a 3x3 rotation matrix; cf. FukushimaWilliams().
-      /// @return frame bias matrix Matrix<double>(3,3)
-      static Matrix<double> BiasMatrix2010(void)
+      /// @return frame bias matrix Matrix3
+      static Matrix3 BiasMatrix2010(void)
          throw();
 
       //------------------------------------------------------------------------------
       /// IERS2010 precession matrix, a 3x3 rotation matrix, given
       /// @param T, the coordinate transformation time at the time of interest
       /// Does not include the frame bias matrix; cf. FukushimaWilliams().
-      /// @return precession matrix Matrix<double>(3,3)
-      static Matrix<double> PrecessionMatrix2010(double T)
+      /// @return precession matrix Matrix3
+      static Matrix3 PrecessionMatrix2010(double T)
          throw();
 
       //------------------------------------------------------------------------------
@@ -721,7 +775,7 @@ namespace gpstk {
       /// @param T CoordTransTime(EphTime t) for time of interest
       /// @return 3x3 rotation matrix
       /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
-      static Matrix<double> PreciseEarthRotation2003(double T);
+      static Matrix3 PreciseEarthRotation2003(double T);
 
       //------------------------------------------------------------------------------
       /// Generate precise transformation matrix (3X3 rotation) for Earth motion due
@@ -730,7 +784,7 @@ namespace gpstk {
       /// @param T CoordTransTime(EphTime t) for time of interest
       /// @return 3x3 rotation matrix
       /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
-      static Matrix<double> PreciseEarthRotation2010(double T);
+      static Matrix3 PreciseEarthRotation2010(double T);
 
       //------------------------------------------------------------------------------
       /// Generate the full transformation matrix (3x3 rotation) relating the ECEF
@@ -745,8 +799,8 @@ namespace gpstk {
       ///                 'no tides', as is the case with the NGA EOPs (default=F).
       /// @return 3x3 rotation matrix
       /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
-      Matrix<double> ECEFtoInertial1996(EphTime t, double xp, double yp,
-                                        double UT1mUTC, bool reduced=false);
+      Matrix3 ECEFtoInertial1996(EphTime t, double xp, double yp,
+                                        double UT1mUTC, bool reduced=false) const;
 
       //------------------------------------------------------------------------------
       /// Generate the full transformation matrix (3x3 rotation) relating the ECEF
@@ -759,7 +813,7 @@ namespace gpstk {
       /// @param UT1mUTC, UT1-UTC in seconds, as found in the IERS bulletin.
       /// @return 3x3 rotation matrix
       /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
-      Matrix<double> ECEFtoInertial2003(EphTime t,double xp,double yp,double UT1mUTC);
+      Matrix3 ECEFtoInertial2003(EphTime t,double xp,double yp,double UT1mUTC) const;
 
       //------------------------------------------------------------------------------
       /// Generate the full transformation matrix (3x3 rotation) relating the ECEF
@@ -774,7 +828,7 @@ namespace gpstk {
       ///                 'no tides', as is the case with the NGA EOPs (default=F).
       /// @return 3x3 rotation matrix
       /// @throw Exception if the TimeSystem conversion fails (if TimeSystem is Unknown)
-      Matrix<double> ECEFtoInertial2010(EphTime t,double xp,double yp,double UT1mUTC);
+      Matrix3 ECEFtoInertial2010(EphTime t,double xp,double yp,double UT1mUTC) const;
 
    }; // end class EarthOrientation
 
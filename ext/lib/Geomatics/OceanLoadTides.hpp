@@ -127,6 +127,46 @@ public:
    ///                if there is corruption in the static arrays, or .
    Triple computeDisplacement(std::string site, EphTime t);
 
+   /// Compile the given site for the fast computeDisplacement() routines below:
+   /// derive the 342 tides from the site's 11 standard tides once, and store
+   /// them as in-phase and quadrature amplitudes for each component. The result
+   /// is the index of the site to be passed to those routines; compiling a site
+   /// a second time returns the same index.
+   /// The derived amplitudes depend (very weakly) on the Doodson frequencies,
+   /// which are evaluated at J2000; the difference from computeDisplacement(site,t)
+   /// is below 1 nanometer for any epoch within a century of J2000.
+   /// @param site  string Input name of the site; must be the same as previously
+   ///              successfully passed to initializeSites().
+   /// @return index of the compiled site.
+   /// @throw Exception if the site has not been initialized.
+   int compileSite(std::string site);
+
+   /// Return the number of compiled sites; site indexes run from 0 to this - 1.
+   int numCompiledSites() const throw()
+   { return compiledSites.size(); }
+
+   /// Compute the site displacement vector for a compiled site at each of the
+   /// given times. The tidal arguments are computed once per epoch and the
+   /// harmonic sums use the arrays built by compileSite(), so this is much faster
+   /// than calling computeDisplacement(site,t) for each time.
+   /// @param siteIdx  int Input index of the site, as returned by compileSite().
+   /// @param times    vector<EphTime> Input times of interest.
+   /// @return vector of Triple (parallel to times) containing the North, East and
+   ///                Up components of the site displacement in meters.
+   /// @throw Exception if the site index is invalid or the time system is unknown.
+   std::vector<Triple> computeDisplacement(int siteIdx,
+                                           const std::vector<EphTime>& times) const;
+
+   /// Compute the site displacement vectors for several compiled sites at a
+   /// single time; the tidal arguments are shared by all the sites.
+   /// @param siteIdxs vector<int> Input indexes of the sites, from compileSite().
+   /// @param t        EphTime Input time of interest.
+   /// @return vector of Triple (parallel to siteIdxs) containing the North, East
+   ///                and Up components of the site displacements in meters.
+   /// @throw Exception if a site index is invalid or the time system is unknown.
+   std::vector<Triple> computeDisplacements(const std::vector<int>& siteIdxs,
+                                            const EphTime& t) const;
+
    /// Return the recorded latitude, longitude and ht(=0) for the given site.
    /// Return value of (0.0,0.0,0.0) probably means the position was not found.
    Triple getPosition(std::string site) throw()
@@ -161,6 +201,39 @@ private:
    /// Number of derived tides computed by deriveTides()
    static const int NDER;
 
+   /// Cartwright-Tayler numbers of the 11 standard tides, in BLQ file order
+   static const NVector SchInd[];
+
+   /// Relative amplitudes and Cartwright-Tayler numbers of the NDER derived tides
+   static const double DerAmp[];
+   static const NVector DerInd[];
+
+   /// Compiled sites, indexed by the value returned by compileSite(). Each holds
+   /// 6*NDER values: for each component (up, south, west) NDER in-phase
+   /// amplitudes A*cos(phase) followed by NDER quadrature amplitudes A*sin(phase)
+   std::vector< std::vector<double> > compiledSites;
+
+   /// Names of the compiled sites, parallel to compiledSites
+   std::vector<std::string> compiledNames;
+
+   /// Compute the Doodson arguments (degrees) and frequencies (cycles/day) at
+   /// the given time. Called by computeDisplacement()
+   /// @throw Exception if the time system is unknown.
+   static void doodsonArguments(const EphTime& time,
+                                double Dood[], double freqDood[]);
+
+   /// Compute the cosine and sine of the argument of each of the NDER derived
+   /// tides at the given time, using powers of the six Doodson arguments rather
+   /// than a cosine and sine for each tide.
+   /// @throw Exception if the time system is unknown.
+   static void tideArguments(const EphTime& time,
+                             double cosArg[], double sinArg[]);
+
+   /// Sum up the harmonics of one compiled site, given the output of
+   /// tideArguments(), and return North, East, Up displacement in meters.
+   static Triple sumTides(const std::vector<double>& comp,
+                          const double cosArg[], const double sinArg[]);
+
    /// Derive the 342 tides from the standard 11 tides using cubic spline
    /// interpolation. Called by computeDisplacements()
    /// @param SchTides  array of 11 NVectors (int[6]) with for standard tides
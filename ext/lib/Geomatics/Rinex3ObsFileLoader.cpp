@@ -42,6 +42,7 @@
 //------------------------------------------------------------------------------------
 // system includes
 #include <iostream>
+#include <memory>
 
 // GPSTk
 #include "Exception.hpp"
@@ -51,6 +52,7 @@
 #include "Rinex3ObsHeader.hpp"
 #include "Rinex3ObsData.hpp"
 #include "Rinex3ObsStream.hpp"
+#include "Rinex3ObsParallelReader.hpp"
 #include "MostCommonValue.hpp"
 
 // geomatics
@@ -87,8 +89,9 @@ try {
    // roh = rinex obs header
    Rinex3ObsHeader roh;
    // Rinex3ObsData from Rinex3ObsData class in GPSTk
-   // rod = rinex obs data, and outrod = output rinex obs data?
-   Rinex3ObsData rod, outrod;
+   // rod = rinex obs data (strmrod when read from a stream), and
+   // outrod = output rinex obs data
+   Rinex3ObsData strmrod, outrod;
    vector<string>::const_iterator vit;
    map< RinexSatID, vector<int> >::iterator soit;     // SatObsCountMap
    ostringstream oss, ossx;
@@ -97,6 +100,18 @@ try {
    // setTimeSystem sets the method for internal variable m_timeSystem
    prevtime.setTimeSystem(TimeSystem::Any);
 
+   // when using threads, the files are decoded ahead of this loop
+   unique_ptr<Rinex3ObsParallelReader> pipeline;
+   if(nthreads != 1) {
+      vector<string> names(filenames);
+      for(i=0; i<names.size(); i++) {
+         StringUtils::stripLeading(names[i]);
+         StringUtils::stripTrailing(names[i]);
+      }
+      pipeline.reset(new Rinex3ObsParallelReader(names,
+                                                 nthreads < 0 ? 0 : nthreads));
+   }
+
    // read the files
    // initialize number read counter to zero
    int nread(0);
@@ -122,18 +137,30 @@ try {
       // read one file
       for(;;) {
          // open file ---------------------------------------------
-         // converts file name from a string to a vector of characters using c_str
-         Rinex3ObsStream strm(filename.c_str());
+         // either the decoded file from the pipeline, or a stream
+         Rinex3ObsStream strm;
+         Rinex3ObsParallelReader::FileData *pfd(0);
+         size_t nrec(0);                     // next record in *pfd
+         if(pipeline)
+            pfd = &pipeline->getFile(nf);
+         else
+            // converts file name from a string to a vector of characters using c_str
+            strm.open(filename.c_str(), ios::in);
          // if the obs stream is not successfully opened
-         if(!strm.is_open()) {
+         if(pfd ? !pfd->opened : !strm.is_open()) {
             oss << "Error - could not open file " << filename << endl;
             break;
          }
-         strm.exceptions(fstream::failbit);
+         if(!pfd) strm.exceptions(fstream::failbit);
 
          // read header -------------------------------------------
          try {
-            strm >> roh;
+            if(pfd) {
+               if(!pfd->headerRead) GPSTK_THROW(pfd->error);
+               roh = pfd->header;
+            }
+            else
+               strm >> roh;
 
             // update list of wanted obs types
             // create iterator for looping through roh.mapObsTypes
@@ -202,25 +229,39 @@ try {
          catch(Exception& e) {
             oss << "Error - failed to read header for file " << filename
                << " with exception " << e.getText(0) << endl;
-            strm.close();
+            if(!pfd) strm.close();
             break;
          }
 
          // loop over epochs --------------------------------------
          // while(1) always true, so only breaks out of loop with a break statement
          while(1) {
-            try {
-               strm >> rod;
-               rod.time.setTimeSystem(TimeSystem::Any);
+            if(pfd) {
+               // end of the records, which may have ended at an error
+               if(nrec >= pfd->size()) {
+                  if(pfd->failed)
+                     oss << "Error - failed to read data in file " << filename
+                        << " with exception " << pfd->error.getText(0) << endl;
+                  break;
+               }
             }
-            catch(Exception& e) {
-               oss << "Error - failed to read data in file " << filename
-                  << " with exception " << e.getText(0) << endl;
-               break;
+            else {
+               try {
+                  strm >> strmrod;
+               }
+               catch(Exception& e) {
+                  oss << "Error - failed to read data in file " << filename
+                     << " with exception " << e.getText(0) << endl;
+                  break;
+               }
+
+               // EOF or error; eof alone means a final record without its
+               // newline was read, and it is kept, as the threaded path does
+               if(!strm) break;
             }
 
-            // EOF or error
-            if(strm.eof() || !strm.good()) break;
+            Rinex3ObsData& rod(pfd ? (*pfd)[nrec++] : strmrod);
+            rod.time.setTimeSystem(TimeSystem::Any);
 
             // skip aux header, etc
             if(rod.epochFlag != 0 && rod.epochFlag != 1) continue;
@@ -348,7 +389,7 @@ try {
          rawdt = mcv.bestDT();
          nominalDT = (dtdec > 0.0 ? (dtdec > rawdt ? dtdec : rawdt) : rawdt);
 
-         strm.close();
+         if(!pfd) strm.close();
 
          break;      // mandatory
       }  // end for(;;)
@@ -85,6 +85,7 @@ private:
    int nepochsToRead;                     ///< number of epochs to read (default:all)
    bool saveData;                         ///< if true save the data (F)
    std::string timefmt;                   ///< format for time tags in output
+   int nthreads;                          ///< threads decoding the files (1)
    // editing
    double dtdec;                          ///< decimate to this time step
    CommonTime startTime, stopTime;        ///< edit to start and stop times
@@ -128,6 +129,7 @@ private:
    {
       saveData = false;
       nepochsToRead = -1;
+      nthreads = 1;
       timefmt = std::string("%04Y/%02m/%02d %02H:%02M:%02S");
       reset();
    }
@@ -138,6 +140,7 @@ public:
    /// empty constructor
    Rinex3ObsFileLoader(void)
    {
+      nthreads = 1;
       init();
    }
 
@@ -238,6 +241,13 @@ public:
    /// @return bool if true, then save the data, otherwise just the headers
    inline bool dataSaved(void) { return saveData; }
 
+   /// set the number of threads used to decode the files; with more than one,
+   /// files (and chunks of epochs within them) are decoded ahead of the loading
+   /// loop, which then consumes them in order.
+   /// @param[in] n number of threads; 1 (default) reads serially, 0 uses one
+   ///   per hardware core
+   inline void setNumThreads(int n) { nthreads = n; }
+
    /// set the start time
    /// @param[in] tt start time, ignore data before this time
    inline void setStartTime(const CommonTime& tt) { startTime = tt; }
@@ -75,7 +75,7 @@ namespace gpstk
    // param time  Time of interest (input)
    // return ECEF Position of the body in meters.
    Position SolarSystem::ECEFPosition(const SolarSystemEphemeris::Planet body,
-                                      const EphTime time)
+                                      const EphTime time) const
    {
       try {
          Position Pos, Vel;
@@ -94,7 +94,7 @@ namespace gpstk
    //  and velocity XYZ components (PV[3-5]) in m/sec.
    void SolarSystem::ECEFPositionVelocity(const SolarSystemEphemeris::Planet body,
                                           const EphTime time,
-                                          Position& Pos, Position& Vel)
+                                          Position& Pos, Position& Vel) const
    {
       try {
          int i;
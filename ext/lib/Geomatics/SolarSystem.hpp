@@ -219,7 +219,7 @@ public:
       /** Overload EOPStore::getEOP() to use the IERS convention of this object
        * @throw InvalidRequest
        */
-   EarthOrientation getEOP(const double& mjdutc)
+   EarthOrientation getEOP(const double& mjdutc) const
       { return EOPStore::getEOP(mjdutc, iersconv); }
 
    /// Return the ECEF (terrestrial frame, relative to Earth's center) position of a
@@ -228,7 +228,8 @@ public:
    /// @param tt    Time of interest (input)
    /// @return ECEF Position of the body in meters.
    /// @throw Exception
-   Position ECEFPosition(const SolarSystemEphemeris::Planet body, const EphTime tt);
+   Position ECEFPosition(const SolarSystemEphemeris::Planet body, const EphTime tt)
+      const;
 
    /// Return the ECEF (terrestrial frame, relative to Earth's center) position and
    /// velocity of a Solar System body at the input time, with units meters and m/s.
@@ -239,13 +240,13 @@ public:
    /// @throw Exception
    void ECEFPositionVelocity(const SolarSystemEphemeris::Planet body,
                              const EphTime tt,
-                             Position& Pos, Position& Vel);
+                             Position& Pos, Position& Vel) const;
 
    /// Convenience routine to get the ECEF position of the Sun
    /// @param tt    Time of interest (input)
    /// @return ECEF Position of the Sun in meters.
    /// @throw Exception
-   Position SolarPosition(const EphTime tt)
+   Position SolarPosition(const EphTime tt) const
    {
       try { return ECEFPosition(SolarSystemEphemeris::idSun, tt); }
       catch(Exception& e) { GPSTK_RETHROW(e); }
@@ -255,7 +256,7 @@ public:
    /// @param tt    Time of interest (input)
    /// @return ECEF Position of the Moon in meters.
    /// @throw Exception
-   Position LunarPosition(const EphTime tt)
+   Position LunarPosition(const EphTime tt) const
    {
       try { return ECEFPosition(SolarSystemEphemeris::idMoon, tt); }
       catch(Exception& e) { GPSTK_RETHROW(e); }
@@ -266,7 +267,7 @@ public:
    /// @param Pos   Position containing result for Solar position in m in XYZ
    /// @param Vel   Position containing result for Solar velocity in m/s in XYZ
    /// @throw Exception
-   void SolarPositionVelocity(const EphTime tt, Position& Pos, Position& Vel)
+   void SolarPositionVelocity(const EphTime tt, Position& Pos, Position& Vel) const
    {
       try {
          return ECEFPositionVelocity(SolarSystemEphemeris::idSun, tt, Pos, Vel);
@@ -279,7 +280,7 @@ public:
    /// @param Pos   Position containing result for Lunar position in m in XYZ
    /// @param Vel   Position containing result for Lunar velocity in m/s in XYZ
    /// @throw Exception
-   void LunarPositionVelocity(const EphTime tt, Position& Pos, Position& Vel)
+   void LunarPositionVelocity(const EphTime tt, Position& Pos, Position& Vel) const
    {
       try {
          return ECEFPositionVelocity(SolarSystemEphemeris::idMoon, tt, Pos, Vel);
@@ -301,7 +302,7 @@ public:
    /// @param SV Position          Satellite position
    /// @return Matrix<double>(3,3) Rotation matrix from XYZ to Satellite body frame.
    /// @throw Exception
-   Matrix<double> SatelliteAttitude(const EphTime& tt, const Position& SV)
+   Matrix<double> SatelliteAttitude(const EphTime& tt, const Position& SV) const
    {
       try {
          Position Sun = SolarSystem::SolarPosition(tt);
@@ -326,7 +327,7 @@ public:
    /// triangle with sesa opposite the right angle. Thus cos(sesa)=cos(beta)*cos(phi).
    /// @throw Exception
    void SunOrbitAngles(const EphTime& tt, const Position& Pos, const Position& Vel,
-                       double& beta, double& phi)
+                       double& beta, double& phi) const
    {
       try {
          Position Sun = SolarSystem::SolarPosition(tt);
@@ -350,7 +351,7 @@ public:
    /// @param tt EphTime   Time of interest.
    /// @return Triple      Displacement vector, ECEF XYZ in meters.
    /// @throw Exception
-   Triple computeSolidEarthTides(const Position site, const EphTime tt)
+   Triple computeSolidEarthTides(const Position site, const EphTime tt) const
    {
       try {
          const Position Sun = SolarSystem::SolarPosition(tt);
@@ -372,7 +373,7 @@ public:
    /// @param EphTime tt     Time of interest.
    /// @return Triple disp   Displacement vector, ECEF XYZ meters.
    /// @throw Exception
-   Triple computePolarTides(const Position site, const EphTime tt)
+   Triple computePolarTides(const Position site, const EphTime tt) const
    {
       try {
          EphTime ttag(tt);
@@ -47,6 +47,8 @@
 
 //------------------------------------------------------------------------------------
 #include "SolarSystemEphemeris.hpp"
+// system
+#include <cmath>
 // GPSTk
 #include "StringUtils.hpp"
 #include "TimeConverters.hpp"
@@ -635,7 +637,7 @@ int SolarSystemEphemeris::readBinaryFile(string filename)
 try {
    int iret;
    readBinaryHeader(filename);
-   iret = readBinaryData(true);  // true: store ALL the data in map
+   iret = readBinaryData();      // store ALL the data in map
 
    istrm.clear();
    istrm.close();
@@ -657,10 +659,11 @@ try {
    //   << ConfigureLOG::ToString(ConfigureLOG::ReportingLevel()) << endl;
 
    readBinaryHeader(filename);
-   iret = readBinaryData(false);    // false: don't store data in map
+   if(EphemerisNumber == -1) return -4;
+   iret = mapBinaryData(filename);  // don't store data in map
    if(iret == 0) {
       // EphemerisNumber == -1 means the header has not been read
-      // EphemerisNumber ==  0 means the fileposMap has not been read (binary)
+      // EphemerisNumber ==  0 means the data has not been mapped (binary)
       // EphemerisNumber == constants["DENUM"] means object has been initialized
       //                       (binary file), or header read (ASCII file)
       EphemerisNumber = int(constants["DENUM"]);
@@ -680,6 +683,7 @@ void SolarSystemEphemeris::RelativeInertialPositionVelocity(const double MJD,
                                                 SolarSystemEphemeris::Planet target,
                                                 SolarSystemEphemeris::Planet center,
                                                 double pv[6], bool kilometers)
+   const
 {
 try {
    int iret,i;
@@ -692,10 +696,10 @@ try {
 
    // get the right record from the file
    double JD(MJD + MJD_TO_JD);
-   iret = seekToJD(JD);
+   const double *coefficients;
+   iret = findRecord(JD, coefficients);
    // -1 out of range : input time is before the first time in file
-   // -2 out of range : input time is after the last time in file, or in a gap
-   // -3 stream is not open or not good, or EOF was found prematurely
+   // -2 out of range : input time is after the last time in file
    // -4 EphemerisNumber is not defined
    if(iret) {
       if(iret == -1 || iret == -2) {
@@ -704,10 +708,6 @@ try {
                   + string(" the range spanned by the ephemeris."));
          GPSTK_THROW(e);
       }
-      else if(iret == -3) {
-         Exception e(string("Stream error on ephemeris binary file"));
-         GPSTK_THROW(e);
-      }
       else if(iret == -4) {
          Exception e(string("Ephemeris not initialized"));
          GPSTK_THROW(e);
@@ -720,7 +720,8 @@ try {
 
    // compute Nutations or Librations
    if(target == idNutations || target == idLibrations) {
-      InertialPositionVelocity(MJD, target==idNutations ? NUTATIONS : LIBRATIONS, pv);
+      InertialPositionVelocity(MJD, target==idNutations ? NUTATIONS : LIBRATIONS,
+                               coefficients, pv);
       return;
    }
 
@@ -744,18 +745,18 @@ try {
 
    // special cases of Earth OR Moon, but not both:
    if((target==idEarth && center!=idMoon) || (center==idEarth && target!=idMoon)) {
-      Eratio = 1.0/(1.0 + constants["EMRAT"]);
-      InertialPositionVelocity(MJD, MOON, pvmoon);
+      Eratio = 1.0/(1.0 + getConstant("EMRAT"));
+      InertialPositionVelocity(MJD, MOON, coefficients, pvmoon);
    }
    if((target==idMoon && center!=idEarth) || (center==idMoon && target!=idEarth)) {
-      Mratio = constants["EMRAT"]/(1.0 + constants["EMRAT"]);
-      InertialPositionVelocity(MJD, EMBARY, pvembary);
+      Mratio = getConstant("EMRAT")/(1.0 + getConstant("EMRAT"));
+      InertialPositionVelocity(MJD, EMBARY, coefficients, pvembary);
    }
 
    // compute states for target and center
    double pvtarget[6],pvcenter[6];
-   InertialPositionVelocity(MJD, TARGET, pvtarget);
-   InertialPositionVelocity(MJD, CENTER, pvcenter);
+   InertialPositionVelocity(MJD, TARGET, coefficients, pvtarget);
+   InertialPositionVelocity(MJD, CENTER, coefficients, pvcenter);
 
    // handle the Earth/Moon special cases
    // convert from E-M barycenter to Earth
@@ -773,7 +774,7 @@ try {
    for(i=0; i<6; i++) pv[i] = pvtarget[i] - pvcenter[i];
    
    if(!kilometers) {
-      double AU = constants["AU"];
+      double AU = getConstant("AU");
       for(i=0; i<6; i++) pv[i] /= AU;
    }
 }
@@ -836,6 +837,9 @@ try {
    EphemerisNumber = -1;
    constants.clear();
    store.clear();
+   records = NULL;
+   Nrecords = 0;
+   binaryFile.close();
    recLength = 0;
 
    // ----------------------------------------------------------------
@@ -944,7 +948,7 @@ try {
       LOG(DEBUG) << "DENUM agrees " << denum;
 
       // EphemerisNumber == -1 means the header has not been read
-      // EphemerisNumber ==  0 means the fileposMap has not been read (binary)
+      // EphemerisNumber ==  0 means the data has not been mapped (binary)
       // EphemerisNumber == constants["DENUM"] means object has been initialized
       //                       (binary file), or header read (ASCII file)
       EphemerisNumber = 0;
@@ -965,32 +969,22 @@ catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 //------------------------------------------------------------------------------------
 // private
 // return 0 ok, or -4 EphemerisNumber is not defined
-int SolarSystemEphemeris ::readBinaryData(bool save)
+int SolarSystemEphemeris ::readBinaryData(void)
 {
 try {
    // has the header been read?
    if(EphemerisNumber == -1) return -4;
 
-   // read the data, optionally storing it all; fill the file position map
+   // read the data, storing it all
    int iret=-1,nrec=1;
    double prev=0.0;
    vector<double> data_vector;
    while(!istrm.eof() && istrm.good()) {
-      long filepos = istrm.tellg();
       iret = readBinaryRecord(data_vector);
       if(iret == -2) { iret = 0; break; }       // EOF
       if(iret) break;
 
-      // if saving all in store, add it here
-      if(save)
-         store[data_vector[0]] = data_vector;
-
-      // put the first record in coefficients array
-      if(nrec == 1)
-         coefficients = data_vector;
-
-      // build the positions map
-      fileposMap[data_vector[0]] = filepos;
+      store[data_vector[0]] = data_vector;
 
       if(nrec > 1 && data_vector[0] != prev) {
          ostringstream oss;
@@ -1049,37 +1043,57 @@ catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 //------------------------------------------------------------------------------------
 // private
 // return 0 ok, or
-// -1 out of range : input time is before the first time in file
-// -2 out of range : input time is after the last time in file, or in a gap
-// -3 stream is not open or not good, or EOF was found prematurely
-// -4 EphemerisNumber is not defined
-// For -3,-4 : initializeWithBinaryFile() has not been called, or reading failed.
-int SolarSystemEphemeris ::seekToJD(double JD)
+// -3 stream is not valid, or there are no records
+int SolarSystemEphemeris::mapBinaryData(string filename)
 {
 try {
-   if(!istrm) return -3;
-   if(istrm.eof() || !istrm.good()) return -3;
-   if(EphemerisNumber != int(constants["DENUM"])) return -4;
-
-   if(coefficients[0] <= JD && JD <= coefficients[1]) return 0;
-
-   map<double,long>::const_iterator it; // key >= input
-   it = fileposMap.lower_bound(JD); // it points to first element with JD <= time
-
-   if(it == fileposMap.begin() && JD < it->first)
-      return -1;                    // failure: JD is before the first record
+   // the data records follow the header
+   long dataStart = istrm.tellg();
+   istrm.clear();
+   istrm.close();
+   if(dataStart < 0 || Ncoeff < 3) return -3;
+
+   // a partial record at the end of the file is ignored
+   binaryFile.open(filename);
+   const size_t recLength = Ncoeff*sizeof(double);
+   if(binaryFile.size() < dataStart + recLength) {
+      binaryFile.close();
+      return -3;
+   }
 
-   if(it == fileposMap.end()        // if beyond the found record, go to previous;
-         || JD < it->first) it--;   // but beware the "lower_bound found the =" case
+   // the records are used in place, so they must be aligned; the header records
+   // are a whole number of doubles long
+   const char *ptr = binaryFile.data() + dataStart;
+   if(reinterpret_cast<size_t>(ptr) % sizeof(double) != 0) {
+      binaryFile.close();
+      Exception e("Data records in binary file " + filename + " are not aligned");
+      GPSTK_THROW(e);
+   }
+   const double *recs = reinterpret_cast<const double *>(ptr);
+   size_t nrecs = (binaryFile.size() - dataStart)/recLength;
+
+   // findRecord() computes the index of a record from the time, so the records
+   // must be contiguous and all span the same interval
+   const double span = recs[1] - recs[0];
+   for(size_t k=0; k<nrecs; k++) {
+      const double *rec = recs + k*Ncoeff;
+      ostringstream oss;
+      if(k > 0 && rec[0] != rec[1-Ncoeff])
+         oss << "ERROR: found gap in data at " << k+1 << fixed << setprecision(6)
+            << " : prev end = " << rec[1-Ncoeff] << " != new beg = " << rec[0];
+      else if(rec[1] - rec[0] != span)
+         oss << "ERROR: record " << k+1 << fixed << setprecision(6)
+            << " spans " << rec[1] - rec[0] << " days, not " << span;
+      if(!oss.str().empty()) {
+         binaryFile.close();
+         Exception e(oss.str());
+         GPSTK_THROW(e);
+      }
+   }
 
-   istrm.seekg(it->second,ios_base::beg);         // get the record
-   int iret = readBinaryRecord(coefficients);
-   if(iret == -2) iret = -3;        // this means EOF during data read
-   if(iret) return iret;            // reading failed
+   records = recs;
+   Nrecords = nrecs;
 
-   if(JD > coefficients[1])
-      return -2;                    // failure: JD is after the last record, or
-                                    // JD is in a gap between records
    return 0;
 }
 catch(Exception& e) { GPSTK_RETHROW(e); }
@@ -1087,10 +1101,40 @@ catch(exception& e) { Exception E("std except: "+string(e.what())); GPSTK_THROW(
 catch(...) { Exception e("Unknown exception"); GPSTK_THROW(e); }
 }
 
+//------------------------------------------------------------------------------------
+// private
+// return 0 ok, or
+// -1 out of range : input time is before the first time in file
+// -2 out of range : input time is after the last time in file
+// -4 EphemerisNumber is not defined
+// For -4 : initializeWithBinaryFile() has not been called, or reading failed.
+int SolarSystemEphemeris::findRecord(double JD, const double *& record) const
+{
+   // EphemerisNumber is set to DENUM only when the records have been mapped
+   if(records == NULL || EphemerisNumber <= 0) return -4;
+
+   if(JD < records[0]) return -1;   // failure: JD is before the first record
+
+   // all records span the same interval; a JD at the boundary between two records
+   // selects the later one, and rounding may put JD one record off
+   double k = std::floor((JD - records[0]) / (records[1] - records[0]));
+   size_t n = (k < double(Nrecords) ? size_t(k) : Nrecords-1);
+   record = records + n*Ncoeff;
+   if(JD < record[0] && n > 0)
+      record -= Ncoeff;
+   else if(JD > record[1] && n+1 < Nrecords)
+      record += Ncoeff;
+
+   if(JD > record[1])
+      return -2;                    // failure: JD is after the last record
+   return 0;
+}
+
 //------------------------------------------------------------------------------------
 // private
 void SolarSystemEphemeris::InertialPositionVelocity(const double MJD,
-                                  SolarSystemEphemeris::computeID which, double PV[6])
+                                  SolarSystemEphemeris::computeID which,
+                                  const double *coefficients, double PV[6]) const
 {
 try {
    int i,j,i0,ncomp,offset;
@@ -60,6 +60,7 @@
 // GPSTk
 #include "Exception.hpp"
 #include "TimeConstants.hpp"
+#include "MemoryMappedFile.hpp"
 
 namespace gpstk {
 
@@ -87,6 +88,11 @@ namespace gpstk {
 /// once, passing it the name of the binary file, then calling
 /// RelativeInertialPositionVelocity() any number of times, passing it the time and
 /// Planet of interest.
+/// The binary file is mapped into memory by initializeWithBinaryFile(), and each
+/// call to RelativeInertialPositionVelocity() finds its record there directly from
+/// the time, since all records span the same interval. Computing positions changes
+/// nothing in the object, so once it is initialized, any number of threads may
+/// compute positions at the same time.
 /// Time for this class is always Barycentric Dynamic Time (TDB), always as MJD.
 class SolarSystemEphemeris {
 public:
@@ -113,7 +119,8 @@ public:
 
    /// Constructor. Set EphemerisNumber to -1 to indicate that nothing has been
    /// read yet.
-   SolarSystemEphemeris(void) throw() : EphemerisNumber(-1) {};
+   SolarSystemEphemeris(void) throw()
+      : EphemerisNumber(-1), records(NULL), Nrecords(0) {};
 
    //------------------------------------------------------------------
    // reading and writing ASCII (JPL) files
@@ -177,7 +184,7 @@ public:
    int writeBinaryFile(std::string filename);
 
    /// clear the store map containing all the data read by
-   /// readASCIIdata() or readBinaryData(true).
+   /// readASCIIdata() or readBinaryFile().
    void clearStorage(void) throw() { store.clear(); }
 
    /// Read header and data from a binary file, storing ALL the data in store.
@@ -190,14 +197,16 @@ public:
    /// @throw Exception if a gap in time is found between consecutive records.
    int readBinaryFile(std::string filename);
 
-   /// Open the given binary file, read the header and prepare for reading data
-   /// records at random using seekToJD() and computing positions and velocities
-   /// with InertialPositionVelocity(). Does not store the data.
+   /// Open the given binary file, read the header and map the data records into
+   /// memory, for computing positions and velocities at random times with
+   /// RelativeInertialPositionVelocity(). Does not store the data.
    /// @param filename  name of binary file to be read.
    /// @return 0 success,
    ///        -3 input stream is not open or not valid
    ///        -4 header has not yet been read.
-   /// @throw Exception if a gap in time is found between consecutive records.
+   /// @throw Exception if the file cannot be mapped, if a gap in time is found
+   /// between consecutive records, or if the records do not all span the same
+   /// interval.
    int initializeWithBinaryFile(std::string filename);
 
    //------------------------------------------------------------------
@@ -227,19 +236,18 @@ public:
    /// @param km     boolean: if true (default), units are km, km/day; else AU, AU/day
    ///                  (but not Nutations or Librations - see above).
    /// @throw Exception if given time is before the first record in the file,
-   /// the given time is after the last record, or in a gap between records,
-   /// the input stream is not open or not valid, or EOF was found prematurely, or
-   /// the ephemeris is not initialized; most likely the last two happen because
+   /// the given time is after the last record, or the ephemeris is not
+   /// initialized; most likely the last happens because
    /// initializeWithBinaryFile() has not been called, or reading failed.
    void RelativeInertialPositionVelocity(const double MJD,
-                                         Planet target, Planet center, double PV[6], bool kilometers = true);
+                                         Planet target, Planet center, double PV[6], bool kilometers = true) const;
 
    /// Return the value of 1 AU (Astronomical Unit) in km. If the file header has not
    /// been read, return -1.0.
    /// @return the value of 1 AU in km;
    ///                return -1 if ephemeris has not been initialized.
-   double AU(void) throw()
-      { if(EphemerisNumber == -1) return -1.0; return constants["AU"]; }
+   double AU(void) const throw()
+      { if(EphemerisNumber == -1) return -1.0; return getConstant("AU"); }
 
    /// Return the ephemeris number.
    /// @return the 'DE' ephemeris number, e.g. 403,
@@ -249,18 +257,19 @@ public:
 
    /// @return the value of the contant with the given name. If the header
    /// has not been read, return -1. Return zero if the constant is not found.
-   double getConstant(std::string name) throw() {
+   double getConstant(std::string name) const throw() {
       if(EphemerisNumber == -1) return -1.0;
-      if(constants.find(name) != constants.end()) return constants[name];
+      std::map<std::string,double>::const_iterator it = constants.find(name);
+      if(it != constants.end()) return it->second;
       return 0.0;
    }
 
    /// Return the Earth-to-Moon mass ratio
-   double EarthToMoonMassRatio(void) throw()
+   double EarthToMoonMassRatio(void) const throw()
       { return getConstant(std::string("EMRAT")); }
 
    /// Return the Sun-to-Earth mass ratio
-   double SunToEarthMassRatio(void) throw() {
+   double SunToEarthMassRatio(void) const throw() {
       double em=getConstant(std::string("EMRAT"));
       double gms=getConstant(std::string("GMS"));
       double gmb=getConstant(std::string("GMB"));
@@ -296,35 +305,44 @@ private:
    /// @throw Exception if read error or premature EOF if found.
    void readBinaryHeader(std::string filename);
 
-   /// Read data from a binary file, already opened by readBinaryHeader.
-   /// Build the file position map, and store the first set of coefficients.
-   /// If calling argument is true, save all the coefficient data in a map.
-   /// @param save if true, save all the data in store, else clear the store.
+   /// Read data from a binary file, already opened by readBinaryHeader, and save
+   /// all the coefficient data in store.
    /// @return 0 success,
    ///        -3 input stream is not open or not valid
    ///        -4 header has not yet been read.
    /// @throw Exception if a gap in time is found between consecutive records.
-   int readBinaryData(bool save);
+   int readBinaryData(void);
+
+   /// Map the data records of the binary file, already opened by readBinaryHeader,
+   /// into memory, and check that they can be found by findRecord().
+   /// @param filename  name of the binary file.
+   /// @return 0 success,
+   ///        -3 input stream is not valid, or the file contains no records
+   /// @throw Exception if the file cannot be mapped, if a gap in time is found
+   /// between consecutive records, or if the records do not all span the same
+   /// interval.
+   int mapBinaryData(std::string filename);
 
    /// Read a single binary record (not a header record) at the current file
-   /// position, into the given vector. For use by readBinaryData() and seekToJD().
+   /// position, into the given vector. For use by readBinaryData().
    /// @param data_vector  vector<double> to hold coefficients.
    /// @return 0 success,
    ///        -2 EOF was reached
    ///        -3 input stream is not open or not valid
    int readBinaryRecord(std::vector<double>& data_vector);
 
-   /// Search the data records of the file opened by initializeWithBinaryFile() and
-   /// read the one whose time limits include the given time. May be called only
-   /// after initializeWithBinaryFile().
+   /// Find the data record, in the file mapped by initializeWithBinaryFile(),
+   /// whose time limits include the given time. The index of the record is
+   /// computed from the time, since all records span the same interval.
    /// @param JD the time (Julian Date) of interest
+   /// @param record set to the first of the Ncoeff doubles (times and
+   ///        coefficients) of the record, if successful.
    /// @return 0 success, or
    ///        -1 given time is before the first record in the file,
-   ///        -2 given time is after the last record, or in a gap between records,
-   ///        -3 input stream is not open or not valid, or EOF was found prematurely,
+   ///        -2 given time is after the last record,
    ///        -4 ephemeris (binary file) is not initialized
-   /// -3 or -4 => initializeWithBinaryFile() has not been called, or reading failed.
-   int seekToJD(double JD);
+   /// -4 => initializeWithBinaryFile() has not been called, or reading failed.
+   int findRecord(double JD, const double *& record) const;
 
    //------------------------------------------------------------------
    // define here for use in next function
@@ -350,8 +368,8 @@ private:
    };
 
    /// Compute inertial position and velocity of given body at given time, relative
-   /// to the solar system barycenter, using the current coefficient array.
-   /// NB caller MUST call seekToJD(time) BEFORE calling this.
+   /// to the solar system barycenter, using the given coefficient array.
+   /// NB caller MUST get the record for time from findRecord() BEFORE calling this.
    /// On successful return, PV[0-2] contains the three position components, in km,
    /// and PV[3-5] the velocity components in km/day (for regular bodies), relative
    /// to the solar system barycenter, except for the moon, which is relative to
@@ -360,9 +378,11 @@ private:
    /// are the three euler angles.
    /// @param  MJD    time (Modified Julian Date) of interest (system TDB).
    /// @param  which  computeID of the body of interest.
+   /// @param  coefficients the record (from findRecord()) that includes MJD.
    /// @param  PV     double(6) array containing the inertial position and velocity
    ///                 relative to the solar system barycenter.
-   void InertialPositionVelocity(const double MJD, computeID which, double PV[6]);
+   void InertialPositionVelocity(const double MJD, computeID which,
+                                 const double *coefficients, double PV[6]) const;
 
    //------------------------------------------------------------------
    // member data
@@ -370,11 +390,18 @@ private:
    // input stream, for use by readBinary...()
    std::ifstream istrm;  ///< input stream for binary files
 
+   /// The binary file given to initializeWithBinaryFile(), mapped into memory.
+   MemoryMappedFile binaryFile;
+   /// The first data record in binaryFile; the records are Ncoeff doubles each.
+   const double *records;
+   /// The number of data records in binaryFile.
+   size_t Nrecords;
+
    // header information
 
    // protected so it can be used by class SolarSystem
    /// -1 if the header has not been filled; also, for binary file input, 0 if
-   /// the file position map has not yet been filled; otherwise it equals the
+   /// the data records have not yet been mapped; otherwise it equals the
    /// number JPL assigns the ephemeris, e.g. 403, 405, which is identical to
    /// constants["DENUM"].
    int EphemerisNumber;
@@ -426,16 +453,6 @@ private:
    /// for the purpose of reading/writing files, NOT for ephemeris computation.
    std::map<double, std::vector<double> > store;
 
-   /// Hash of start times (JD) and file positions. This object is filled by
-   /// readBinaryData(), which is called by initializeWithBinaryFile(), and is
-   /// used by seekToJD() to read records in random order.
-   std::map<double, long> fileposMap;
-
-   /// One complete data record (Ncoeff doubles) consisting of times and coefficients.
-   /// seekToJD() stores the current record here, and InertialPositionVelocity()
-   /// uses it.
-   std::vector<double> coefficients;
-
 }; // end class SolarSystemEphemeris
 
 }  // end namespace gpstk
@@ -0,0 +1,209 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+#include <iostream>
+#include <vector>
+#include <ctime>
+#include <thread>
+#include <chrono>
+
+#include "MultiSVPCodeGen.hpp"
+#include "SVPCodeGen.hpp"
+#include "CodeBuffer.hpp"
+#include "GPSWeekZcount.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class MultiSVPCodeGen_T
+{
+public:
+   MultiSVPCodeGen_T()
+   {
+         // SVPCodeGen needs these
+      X1Sequence::allocateMemory();
+      X2Sequence::allocateMemory();
+   }
+   ~MultiSVPCodeGen_T()
+   {
+      X1Sequence::deAllocateMemory();
+      X2Sequence::deAllocateMemory();
+   }
+
+      /** Count the 32-bit words of codes[k] that differ from the
+       * SVPCodeGen code for the same satellite and time. */
+   static int compareToSVPCodeGen(const MultiSVPCodeGen& gen,
+                                  const vector< vector<uint64_t> >& codes,
+                                  CodeBuffer& pcb)
+   {
+      int bad(0);
+      for(size_t k=0; k<gen.getPRNIDs().size(); k++) {
+         SVPCodeGen svgen(gen.getPRNIDs()[k], gen.getCurrentZCount());
+         svgen.getCurrentSixSeconds(pcb);
+         for(long i=0; i<NUM_6SEC_WORDS; i++) {
+            uint32_t word = uint32_t(codes[k][i/2] >> ((i & 1) ? 0 : MAX_BIT));
+            if(word != uint32_t(pcb[i])) bad++;
+         }
+            // the pad bits at the end
+         if(uint32_t(codes[k][MultiSVPCodeGen::NUM_6SEC_WORDS64-1]) != 0)
+            bad++;
+      }
+      return bad;
+   }
+
+   int compareTest()
+   {
+      TUDEF("MultiSVPCodeGen", "getCurrentSixSeconds");
+
+      CodeBuffer pcb(1);
+      vector< vector<uint64_t> > codes;
+
+         // beginning of week, with the PRN delay chips
+      int prns1[] = { 1, 2, 37, 38, 45 };
+      MultiSVPCodeGen gen1(vector<int>(prns1, prns1+5),
+                           GPSWeekZcount(1800, 0));
+      gen1.getCurrentSixSeconds(codes, 2);
+      TUASSERTE(size_t, 5, codes.size());
+      TUASSERTE(size_t, size_t(MultiSVPCodeGen::NUM_6SEC_WORDS64),
+                codes[0].size());
+      TUASSERTE(int, 0, compareToSVPCodeGen(gen1, codes, pcb));
+
+         // mid week, where the X2 sequence wraps within the interval
+      int prns2[] = { 3, 20, 32 };
+      MultiSVPCodeGen gen2(vector<int>(prns2, prns2+3),
+                           GPSWeekZcount(1800, 4*12345));
+      gen2.getCurrentSixSeconds(codes, 3);
+      TUASSERTE(int, 0, compareToSVPCodeGen(gen2, codes, pcb));
+      gen2.increment4ZCounts();
+      gen2.getCurrentSixSeconds(codes);
+      TUASSERTE(int, 0, compareToSVPCodeGen(gen2, codes, pcb));
+
+         // end of week; PRN 38 uses the next day's code, so is not EOW
+      int prns3[] = { 1, 37, 38 };
+      MultiSVPCodeGen gen3(vector<int>(prns3, prns3+3),
+                           GPSWeekZcount(1800, 403200-4));
+      gen3.getCurrentSixSeconds(codes);
+      TUASSERTE(int, 0, compareToSVPCodeGen(gen3, codes, pcb));
+
+         // generating in pieces gives the same words
+      vector< vector<uint64_t> > piece;
+      int bad(0);
+      long first, num(100000);
+      for(first=0; first < MultiSVPCodeGen::NUM_6SEC_WORDS64; first += num) {
+         long n(std::min(num, MultiSVPCodeGen::NUM_6SEC_WORDS64-first));
+         gen3.getWords(first, n, piece, 2);
+         for(size_t k=0; k<piece.size(); k++)
+            for(long i=0; i<n; i++)
+               if(piece[k][i] != codes[k][first+i]) bad++;
+      }
+      TUASSERTE(int, 0, bad);
+
+      try {
+         gen3.getWords(MultiSVPCodeGen::NUM_6SEC_WORDS64-10, 11, piece);
+         TUFAIL("getWords past the end should throw");
+      }
+      catch(Exception& e) { TUPASS("getWords past the end"); }
+      try {
+         MultiSVPCodeGen bad(vector<int>(1, 211), GPSWeekZcount(1800, 0));
+         TUFAIL("PRN 211 should throw");
+      }
+      catch(Exception& e) { TUPASS("PRN 211"); }
+
+      TURETURN();
+   }
+
+      /// chips per second generated, one satellite with SVPCodeGen and
+      /// 32 satellites with MultiSVPCodeGen
+   int timingTest()
+   {
+      TUDEF("MultiSVPCodeGen", "Timing");
+
+      CodeBuffer pcb(1);
+      SVPCodeGen svgen(1, GPSWeekZcount(1800, 4*100));
+      clock_t t0(clock());
+      svgen.getCurrentSixSeconds(pcb);
+      double dt(double(clock()-t0)/CLOCKS_PER_SEC);
+      double chips(double(NUM_6SEC_WORDS)*MAX_BIT);
+      cout << "SVPCodeGen: 1 SV, " << chips/dt << " chips/s" << endl;
+
+      vector<int> prns;
+      for(int prn=1; prn<=32; prn++) prns.push_back(prn);
+      MultiSVPCodeGen gen(prns, GPSWeekZcount(1800, 4*100));
+      vector< vector<uint64_t> > codes;
+         // a quarter of the interval (one Z-count), so as to limit memory
+      const long num(MultiSVPCodeGen::NUM_6SEC_WORDS64/4);
+      chips = double(num)*2*MAX_BIT*prns.size();
+
+      unsigned nthr(std::thread::hardware_concurrency());
+      if(nthr < 1) nthr = 1;
+      unsigned threadCounts[] = { 1, nthr };
+      for(int j=0; j<2; j++) {
+            // wall clock, since clock() counts the time of all threads
+         std::chrono::steady_clock::time_point w0(
+                                          std::chrono::steady_clock::now());
+         int reps(0);
+         double wall;
+         do {
+            gen.getWords(0, num, codes, threadCounts[j]);
+            reps++;
+            wall = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - w0).count();
+         } while(wall < 1.0);
+         cout << "MultiSVPCodeGen: " << prns.size() << " SVs, "
+              << threadCounts[j] << " thread(s), " << reps*chips/wall
+              << " chips/s" << endl;
+      }
+      TUASSERTE(size_t, prns.size(), codes.size());
+
+      TURETURN();
+   }
+};
+
+int main()
+{
+   int errorTotal = 0;
+   MultiSVPCodeGen_T testClass;
+
+   errorTotal += testClass.compareTest();
+   errorTotal += testClass.timingTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
@@ -0,0 +1,278 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+/// @file IonexStore_T.cpp
+/// Test the dense TEC and RMS grids of IonexStore, which must give the values
+/// interpolated from the maps, and the batched getIonexValues().
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+#include "IonexStore.hpp"
+#include "CivilTime.hpp"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class IonexStore_T
+{
+public:
+   IonexStore_T();
+
+      /// dense grids vs the stored maps, for all strategies
+   int gridTest();
+      /// batch queries vs single queries
+   int batchTest();
+      /// grid state, last epoch and invalid strategies
+   int edgeTest();
+
+private:
+      /// make a synthetic global map of the given type at epoch n
+   IonexData makeMap(int n, const IonexData::IonexValType& type) const;
+      /// fill a store with the synthetic maps
+   void fill(IonexStore& store, bool grids) const;
+
+   CommonTime t0;
+   static const int nepoch = 13;    ///< maps every 2 hours for one day
+};
+
+IonexStore_T::IonexStore_T()
+{
+   t0 = CivilTime(2020,3,4,0,0,0.0,TimeSystem::GPS);
+}
+
+IonexData IonexStore_T::makeMap(int n, const IonexData::IonexValType& type)
+   const
+{
+   IonexData iod;
+   iod.mapID = n+1;
+   iod.time = t0 + 7200.0*n;
+   iod.type = type;
+   iod.exponent = -1;
+   iod.lat[0] = 87.5;  iod.lat[1] = -87.5; iod.lat[2] = -2.5;
+   iod.lon[0] = -180.; iod.lon[1] = 180.;  iod.lon[2] = 5.;
+   iod.hgt[0] = 450.;  iod.hgt[1] = 450.;  iod.hgt[2] = 0.;
+   iod.dim[0] = 71;    iod.dim[1] = 73;    iod.dim[2] = 1;
+   iod.data.resize(iod.dim[0]*iod.dim[1]);
+   double scale(type == IonexData::TEC ? 1.0 : 0.2);
+   for(int i=0; i<iod.dim[0]; i++)
+   {
+      double lat((iod.lat[0] + i*iod.lat[2]) * DEG_TO_RAD);
+      for(int j=0; j<iod.dim[1]; j++)
+      {
+         double lon((iod.lon[0] + j*iod.lon[2] - 30.0*n) * DEG_TO_RAD);
+         double v(scale * (20.0 + 15.0*::cos(lat)*::cos(lon)
+                                +  3.0*::sin(2*lat)));
+            // quantize as a file with exponent -1
+         iod.data[j + i*iod.dim[1]] = ::floor(10.0*v + 0.5) / 10.0;
+      }
+   }
+      // a few undefined values at 10h
+   if(n == 5)
+      for(int i=30; i<33; i++) iod.data[40 + i*iod.dim[1]] = 999.9;
+   iod.valid = true;
+   return iod;
+}
+
+void IonexStore_T::fill(IonexStore& store, bool grids) const
+{
+   for(int n=0; n<nepoch; n++)
+   {
+      store.addMap(makeMap(n, IonexData::TEC));
+      store.addMap(makeMap(n, IonexData::RMS));
+   }
+   if(grids) store.buildGrids();
+}
+
+int IonexStore_T::gridTest()
+{
+   TUDEF("IonexStore", "getIonexValue");
+
+   IonexStore grids, maps;
+   fill(grids, true);
+   fill(maps, false);
+   TUASSERT(grids.hasGrids());
+   TUASSERT(!maps.hasGrids());
+
+   srand(12345);
+   int nbad(0), nthrow(0), ncmp(0);
+   double maxdiff(0.0);
+   for(int i=0; i<250; i++)
+   {
+         // not the last epoch, which the maps alone do not handle
+      double dt(86399.0 * rand() / RAND_MAX);
+      double lat(-89.0 + 178.0 * rand() / RAND_MAX);
+      double lon(360.0 * rand() / RAND_MAX);
+      if(i % 20 == 0) dt = 7200.0 * (i/20 % 12);
+         // around the undefined values, near 10h
+      if(i % 7 == 0)
+      {
+         dt = 30000. + 12000. * rand() / RAND_MAX;
+         lat = 6.0 + 8.0 * rand() / RAND_MAX;
+         lon = 16.0 + 8.0 * rand() / RAND_MAX;
+      }
+      CommonTime t(t0 + dt);
+      Position RX(lat, lon, 6821000., Position::Geocentric);
+
+      for(int strategy=1; strategy<=4; strategy++)
+      {
+         Triple a, b;
+         bool athrow(false), bthrow(false);
+         try { a = grids.getIonexValue(t, RX, strategy); }
+         catch(Exception& e) { athrow = true; }
+         try { b = maps.getIonexValue(t, RX, strategy); }
+         catch(Exception& e) { bthrow = true; }
+         if(athrow != bthrow)
+            nbad++;
+         else if(athrow)
+            nthrow++;
+         else
+         {
+            ncmp++;
+            for(int j=0; j<3; j++)
+               maxdiff = max(maxdiff, ::fabs(a[j]-b[j]));
+         }
+      }
+   }
+
+   cout << "IonexStore grids vs maps: " << ncmp << " values, " << nthrow
+        << " rejected by both, max difference " << maxdiff << " TECU" << endl;
+   testFramework.assert(nbad == 0, "grids and maps differ in throwing",
+                        __LINE__);
+   testFramework.assert(nthrow > 0, "no rejected positions tested",
+                        __LINE__);
+   testFramework.assert(maxdiff < 1.e-4, "grids and maps differ", __LINE__);
+
+   TURETURN();
+}
+
+int IonexStore_T::batchTest()
+{
+   TUDEF("IonexStore", "getIonexValues");
+
+   IonexStore grids, maps;
+   fill(grids, true);
+   fill(maps, false);
+
+   const int npos(12);
+   vector<Position> RX;
+   srand(54321);
+   for(int i=0; i<npos; i++)
+      RX.push_back(Position(-80.0 + 160.0 * rand() / RAND_MAX,
+                            360.0 * rand() / RAND_MAX,
+                            6821000., Position::Geocentric));
+
+   CommonTime t(t0 + 3.3*3600.0);
+   for(int strategy=1; strategy<=4; strategy++)
+   {
+      vector<Triple> values;
+      grids.getIonexValues(t, RX, values, strategy);
+      TUASSERTE(size_t, RX.size(), values.size());
+      int nbad(0);
+      for(int i=0; i<npos; i++)
+      {
+         Triple v(grids.getIonexValue(t, RX[i], strategy));
+         for(int j=0; j<3; j++)
+            if(v[j] != values[i][j]) nbad++;
+      }
+      TUASSERTE(int, 0, nbad);
+
+         // without grids the batch falls back to the maps
+      vector<Triple> mvalues;
+      maps.getIonexValues(t, RX, mvalues, strategy);
+      TUASSERTE(size_t, RX.size(), mvalues.size());
+      double maxdiff(0.0);
+      for(size_t i=0; i<RX.size(); i++)
+         maxdiff = max(maxdiff, ::fabs(values[i][0]-mvalues[i][0]));
+      TUASSERT(maxdiff < 1.e-4);
+   }
+
+   TURETURN();
+}
+
+int IonexStore_T::edgeTest()
+{
+   TUDEF("IonexStore", "buildGrids");
+
+   IonexStore grids;
+   fill(grids, true);
+   TUASSERT(grids.hasGrids());
+
+      // the last epoch is the last map
+   IonexData last(makeMap(nepoch-1, IonexData::TEC));
+   Position RX(40.0, 10.0, 6821000., Position::Geocentric);
+   CommonTime tl(t0 + 7200.0*(nepoch-1));
+   TUASSERT(tl == grids.getFinalTime());
+   for(int strategy=1; strategy<=2; strategy++)
+   {
+      Triple v(grids.getIonexValue(tl, RX, strategy));
+      TUASSERTFEPS(last.data[38 + 19*73], v[0], 1.e-5);
+   }
+
+      // invalid strategy and times
+   Triple v;
+   vector<Triple> values;
+   vector<Position> RXs(3, RX);
+   TUCSM("getIonexValue");
+   TUTHROW(grids.getIonexValue(t0, RX, 0));
+   TUTHROW(grids.getIonexValue(t0, RX, 5));
+   TUTHROW(grids.getIonexValue(t0 - 1.0, RX, 2));
+   TUTHROW(grids.getIonexValue(tl + 1.0, RX, 2));
+   TUCSM("getIonexValues");
+   TUTHROW(grids.getIonexValues(t0, RXs, values, 5));
+   TUTHROW(grids.getIonexValues(tl + 1.0, RXs, values, 2));
+   TUTHROW(grids.getIonexValues(t0, vector<Position>(1, Position(RX.asECEF())),
+                                values, 2));
+
+      // a new map discards the grids, mixed grids are not built
+   TUCSM("buildGrids");
+   IonexData odd(makeMap(nepoch, IonexData::TEC));
+   odd.lon[2] = 2.5;
+   grids.addMap(odd);
+   TUASSERT(!grids.hasGrids());
+   TUASSERT(!grids.buildGrids());
+   TUASSERT(!grids.hasGrids());
+   grids.clear();
+   TUASSERT(!grids.buildGrids());
+
+   TURETURN();
+}
+
+int main()
+{
+   int errorTotal = 0;
+   IonexStore_T testClass;
+
+   errorTotal += testClass.gridTest();
+   errorTotal += testClass.batchTest();
+   errorTotal += testClass.edgeTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
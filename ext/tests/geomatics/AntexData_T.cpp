@@ -0,0 +1,286 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+/// @file AntexData_T.cpp
+/// Test the compiled PCV grids of AntexData, which must give exactly the values
+/// interpolated from the maps, and the satellite lookups of AntennaStore.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Exception.hpp"
+#include "AntexData.hpp"
+#include "AntennaStore.hpp"
+
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class AntexData_T
+{
+public:
+   AntexData_T();
+
+      /// conversions between frequency codes and indexes
+   int freqIndexTest();
+      /// PCOs and PCVs from the grids and from the maps, for every antenna
+   int gridTest();
+      /// satellite index and batch PCVs of AntennaStore
+   int storeTest();
+
+private:
+   string antexFile;
+   AntennaStore store;
+};
+
+AntexData_T::AntexData_T()
+{
+   antexFile = getPathSrc() + getFileSep() + "examples" + getFileSep()
+      + "igs05.atx";
+   store.includeAllSatellites();
+   store.addANTEXfile(antexFile);
+}
+
+//------------------------------------------------------------------------------------
+int AntexData_T::freqIndexTest()
+{
+   TUDEF("AntexData", "freqIndex");
+
+   TUASSERTE(int, 1, AntexData::freqIndex("G01"));
+   TUASSERTE(int, 12, AntexData::freqIndex("R02"));
+   TUASSERTE(int, 25, AntexData::freqIndex("E05"));
+   TUASSERTE(int, 12, AntexData::freqIndex('R', 2));
+   TUASSERTE(int, -1, AntexData::freqIndex("X01"));
+   TUASSERTE(int, -1, AntexData::freqIndex("G1"));
+   TUASSERTE(int, -1, AntexData::freqIndex("GA1"));
+   TUASSERTE(int, -1, AntexData::freqIndex('G', 10));
+   TUASSERTE(string, string(""), AntexData::freqString(-1));
+   TUASSERTE(string, string(""),
+             AntexData::freqString(AntexData::numFreqIndexes));
+
+   for(int i=0; i<AntexData::numFreqIndexes; i++)
+      TUASSERTE(int, i, AntexData::freqIndex(AntexData::freqString(i)));
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int AntexData_T::gridTest()
+{
+   TUDEF("AntexData", "getPhaseCenterVariation");
+
+   vector<string> names;
+   store.getNames(names);
+   TUASSERT(names.size() > 250);
+
+   unsigned ncomp(0), nazi(0);
+   for(size_t i=0; i<names.size(); i++) {
+      AntexData grid, ref;
+      TUASSERT(store.getAntenna(names[i], grid));
+      TUASSERT(grid.hasGrids());
+      ref = grid;
+      ref.clearGrids();
+      TUASSERT(!ref.hasGrids());
+
+      // nadir angles of satellites are limited to the grid by the maps too
+      const double maxAngle(grid.isRxAntenna ? 90.0 : grid.zenRange[1]);
+      map<string, AntexData::antennaPCOandPCVData>::const_iterator it;
+      for(it = grid.freqPCVmap.begin(); it != grid.freqPCVmap.end(); it++) {
+         const string& freq(it->first);
+         const int ifreq(AntexData::freqIndex(freq));
+         if(it->second.hasAzimuth) nazi++;
+         Triple pcoGrid(grid.getPhaseCenterOffset(freq));
+         Triple pcoMap(ref.getPhaseCenterOffset(freq));
+         Triple pcoInt(grid.getPhaseCenterOffset(ifreq));
+         for(int k=0; k<3; k++) {
+            TUASSERTE(double, pcoMap[k], pcoGrid[k]);
+            TUASSERTE(double, pcoMap[k], pcoInt[k]);
+         }
+
+         // on and between the grid points, at the ends of the zenith
+         // range and at the azimuth wraparound
+         const double azs[] = { -7.5, 0.0, 2.5, 5.0, 181.25, 357.5, 360.0, 367.5 };
+         const double els[] = { 0.0, 1.25, 2.5, maxAngle/3, maxAngle-1.25,
+                                maxAngle };
+         unsigned nbad(0);
+         for(size_t iaz = 0; iaz < sizeof(azs)/sizeof(azs[0]); iaz++) {
+            for(size_t iel = 0; iel < sizeof(els)/sizeof(els[0]); iel++) {
+               const double az(azs[iaz]), el(els[iel]);
+               double v(ref.getPhaseCenterVariation(freq, az, el));
+               if(grid.getPhaseCenterVariation(freq, az, el) != v ||
+                  grid.getPhaseCenterVariation(ifreq, az, el) != v ||
+                  grid.getTotalPhaseCenterOffset(ifreq, az, el) !=
+                     ref.getTotalPhaseCenterOffset(freq, az, el))
+                  nbad++;
+            }
+         }
+         TUASSERTE(unsigned, 0, nbad);
+         ncomp++;
+      }
+   }
+   TUASSERT(ncomp > 500);
+   TUASSERT(nazi > 50);
+
+   // errors are the same with and without grids
+   AntexData ant;
+   TUASSERT(store.getAntenna(names[0], ant));
+   try {
+      ant.getPhaseCenterVariation("X09", 0.0, 10.0);
+      TUFAIL("No exception for an unknown frequency");
+   }
+   catch(Exception& e) { TUPASS("Exception for an unknown frequency"); }
+   try {
+      ant.getPhaseCenterVariation(AntexData::numFreqIndexes, 0.0, 10.0);
+      TUFAIL("No exception for an invalid frequency index");
+   }
+   catch(Exception& e) { TUPASS("Exception for an invalid frequency index"); }
+   try {
+      ant.getPhaseCenterVariation(ant.freqPCVmap.begin()->first, 0.0, 91.0);
+      TUFAIL("No exception for an invalid angle");
+   }
+   catch(Exception& e) { TUPASS("Exception for an invalid angle"); }
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int AntexData_T::storeTest()
+{
+   TUDEF("AntennaStore", "getSatellitePCVs");
+
+   vector<SatID> sats;
+   vector<double> azim, nadir;
+   for(int prn=1; prn<=33; prn++) {
+      sats.push_back(SatID(prn, SatelliteSystem::GPS));
+      sats.push_back(SatID(prn, SatelliteSystem::Glonass));
+      sats.push_back(SatID(prn, SatelliteSystem::Galileo));
+   }
+   for(size_t i=0; i<sats.size(); i++) {
+      azim.push_back(11.0*i);
+      nadir.push_back(0.37*i - 14.0*int(0.37*i/14.0));
+   }
+
+   // each against getSatelliteAntenna(), for both frequencies
+   vector<double> pcv;
+   vector<bool> found;
+   for(int n=1; n<=2; n++) {
+      unsigned nfound = store.getSatellitePCVs(sats, n, azim, nadir, pcv, found);
+      unsigned nexp(0);
+      for(size_t i=0; i<sats.size(); i++) {
+         const char sys(sats[i].system == SatelliteSystem::GPS ? 'G' :
+                        (sats[i].system == SatelliteSystem::Glonass ? 'R':'E'));
+         string name;
+         AntexData ant;
+         bool have(store.getSatelliteAntenna(sys, sats[i].id, name, ant));
+         const AntexData *pant(store.findSatelliteAntenna(sys, sats[i].id));
+         TUASSERTE(bool, have, pant != NULL);
+         if(!have || !ant.freqPCVmap.count(string(1,sys) + (n==1 ? "01":"02"))) {
+            TUASSERT(!found[i]);
+            continue;
+         }
+         nexp++;
+         TUASSERT(found[i]);
+         TUASSERTE(string, name, pant->name());
+         TUASSERTE(double,
+            ant.getPhaseCenterVariation(string(1,sys) + (n==1 ? "01":"02"),
+                                        azim[i], nadir[i]), pcv[i]);
+      }
+      TUASSERTE(unsigned, nexp, nfound);
+      TUASSERT(nfound > 50);
+   }
+
+   // the index holds the first antenna, by name, for each satellite, however
+   // many there are (the file is loaded at no particular time)
+   {
+      vector<string> names;
+      store.getNames(names);
+      map<pair<char,int>, string> first;
+      for(size_t i=0; i<names.size(); i++) {
+         AntexData ant;
+         store.getAntenna(names[i], ant);
+         if(ant.isRxAntenna) continue;
+         pair<char,int> key(ant.systemChar, ant.PRN);
+         if(!first.count(key) || names[i] < first[key]) first[key] = names[i];
+      }
+      TUASSERT(first.size() < names.size());
+      int nbad(0);
+      map<pair<char,int>, string>::const_iterator it;
+      for(it = first.begin(); it != first.end(); ++it) {
+         const AntexData *pant(store.findSatelliteAntenna(it->first.first,
+                                                          it->first.second));
+         AntexData ant;
+         if(!pant || !store.getAntenna(it->second, ant) ||
+            pant->name() != ant.name())
+            nbad++;
+      }
+      TUASSERTE(int, 0, nbad);
+   }
+
+   // copies have their own index, which outlives the original
+   {
+      AntennaStore *orig = new AntennaStore(store);
+      AntennaStore copy(*orig), assigned;
+      assigned = *orig;
+      const AntexData *pant(orig->findSatelliteAntenna('G', sats[0].id));
+      TUASSERT(pant != NULL);
+      string name(pant->name());
+      delete orig;
+      pant = copy.findSatelliteAntenna('G', sats[0].id);
+      TUASSERT(pant != NULL && pant != store.findSatelliteAntenna('G', sats[0].id));
+      if(pant) TUASSERTE(string, name, pant->name());
+      pant = assigned.findSatelliteAntenna('G', sats[0].id);
+      TUASSERT(pant != NULL);
+      if(pant) TUASSERTE(string, name, pant->name());
+   }
+
+   // mismatched inputs
+   nadir.pop_back();
+   try {
+      store.getSatellitePCVs(sats, 1, azim, nadir, pcv, found);
+      TUFAIL("No exception for mismatched inputs");
+   }
+   catch(Exception& e) { TUPASS("Exception for mismatched inputs"); }
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int main()
+{
+   AntexData_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.freqIndexTest();
+   errorTotal += testClass.gridTest();
+   errorTotal += testClass.storeTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
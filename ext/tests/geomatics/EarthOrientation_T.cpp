@@ -0,0 +1,202 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+/// @file EarthOrientation_T.cpp
+/// Test the interpolated CIO and nutation series of EarthOrientation against
+/// the full series, and the batch ECEFtoInertial().
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <ctime>
+#include <cmath>
+
+#include "EarthOrientation.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class EarthOrientation_T
+{
+public:
+      /// cached series vs full series
+   int seriesCacheTest();
+      /// batch ECEFtoInertial, and timing at 1 Hz
+   int batchTest();
+      /// cached series filled and read by several threads at once
+   int threadsTest();
+
+private:
+      /// largest difference between elements of two 3x3 matrices
+   static double maxDiff(const Matrix<double>& A, const Matrix<double>& B);
+};
+
+double EarthOrientation_T::maxDiff(const Matrix<double>& A,
+                                   const Matrix<double>& B)
+{
+   double d(0.0);
+   for(int i=0; i<3; i++) for(int j=0; j<3; j++)
+      d = max(d, ::fabs(A(i,j)-B(i,j)));
+   return d;
+}
+
+//------------------------------------------------------------------------------------
+int EarthOrientation_T::seriesCacheTest()
+{
+   TUDEF("EarthOrientation", "useSeriesCache");
+
+      // 1 microarcsecond in radians; matrix elements differ by about the angle
+   const double uas(EarthOrientation::ARCSEC_TO_RAD*1.e-6);
+
+   EarthOrientation eo, eoc;
+   eo.xp = eoc.xp = 0.0234;
+   eo.yp = eoc.yp = 0.4187;
+   eo.UT1mUTC = eoc.UT1mUTC = -0.2113;
+   eoc.useSeriesCache(true);
+
+   IERSConvention convs[2] = { IERSConvention::IERS2003,
+                               IERSConvention::IERS2010 };
+   for(int c=0; c<2; c++) {
+      eo.convention = eoc.convention = convs[c];
+      double dmaxI(0.0), dmaxN(0.0);
+         // irregular times from 1995 to 2035, both sides of J2000
+      for(int k=0; k<300; k++) {
+         EphTime t(49800.0 + k*48.7654 + 0.00123*k*k, TimeSystem::UTC);
+         dmaxI = max(dmaxI, maxDiff(eo.ECEFtoInertial(t), eoc.ECEFtoInertial(t)));
+         dmaxN = max(dmaxN, maxDiff(eo.NutationMatrix(t), eoc.NutationMatrix(t)));
+      }
+      cout << "Cached series " << convs[c] << " max differences: ECEFtoInertial "
+           << dmaxI/uas << " uas, NutationMatrix " << dmaxN/uas << " uas" << endl;
+      TUASSERT(dmaxI < 0.1*uas);
+      TUASSERT(dmaxN < 0.1*uas);
+         // the cache is in use, so results are not identical
+      TUASSERT(dmaxI > 0.0);
+   }
+
+      // IERS1996 does not use the cache
+   eo.convention = eoc.convention = IERSConvention::IERS1996;
+   EphTime t(57000.25, TimeSystem::UTC);
+   TUASSERTE(double, 0.0, maxDiff(eo.ECEFtoInertial(t), eoc.ECEFtoInertial(t)));
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int EarthOrientation_T::batchTest()
+{
+   TUDEF("EarthOrientation", "ECEFtoInertial");
+
+   EarthOrientation eo;
+   eo.xp = 0.0234;
+   eo.yp = 0.4187;
+   eo.UT1mUTC = -0.2113;
+   eo.convention = IERSConvention::IERS2010;
+
+      // one hour at 1 Hz
+   vector<EphTime> times;
+   for(int k=0; k<3600; k++)
+      times.push_back(EphTime(57000, 43200.0+k, TimeSystem::GPS));
+
+   clock_t t0 = clock();
+   vector< Matrix<double> > rots(eo.ECEFtoInertial(times));
+   double dtFull = double(clock()-t0)/CLOCKS_PER_SEC;
+
+   TUASSERTE(size_t, times.size(), rots.size());
+   int nbad(0);
+   for(size_t k=0; k<times.size(); k+=61)
+      if(maxDiff(rots[k], eo.ECEFtoInertial(times[k])) != 0.0) nbad++;
+   TUASSERTE(int, 0, nbad);
+
+   eo.useSeriesCache(true);
+   t0 = clock();
+   vector< Matrix<double> > crots(eo.ECEFtoInertial(times));
+   double dtCache = double(clock()-t0)/CLOCKS_PER_SEC;
+   TUASSERTE(size_t, times.size(), crots.size());
+
+   cout << "ECEFtoInertial " << times.size() << " epochs at 1 Hz: full series "
+        << dtFull << " s, cached series " << dtCache << " s" << endl;
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int EarthOrientation_T::threadsTest()
+{
+   TUDEF("EarthOrientation", "useSeriesCache");
+
+   EarthOrientation eo;
+   eo.xp = 0.0234;
+   eo.yp = 0.4187;
+   eo.UT1mUTC = -0.2113;
+   eo.convention = IERSConvention::IERS2010;
+   eo.useSeriesCache(true);
+
+      // times not used by the other tests, so that the threads compute the
+      // blocks; 2040, and 1650, which is beyond the blocks kept in the
+      // directory of the cache
+   vector<EphTime> times;
+   for(int k=0; k<200; k++) {
+      times.push_back(EphTime(66000.0 + k*0.731, TimeSystem::UTC));
+      times.push_back(EphTime(-76000.0 + k*0.731, TimeSystem::UTC));
+   }
+
+   const int nthr(4);
+   vector< vector< Matrix<double> > > rots(nthr);
+   vector<thread> threads;
+   for(int n=0; n<nthr; n++)
+      threads.push_back(thread([&,n]() {
+         for(size_t k=0; k<times.size(); k++)
+            rots[n].push_back(eo.ECEFtoInertial(times[(k+n*37) % times.size()]));
+      }));
+   for(int n=0; n<nthr; n++)
+      threads[n].join();
+
+   int nbad(0);
+   for(int n=0; n<nthr; n++)
+      for(size_t k=0; k<times.size(); k++)
+         if(maxDiff(rots[n][k], eo.ECEFtoInertial(times[(k+n*37) % times.size()]))
+               != 0.0)
+            nbad++;
+   TUASSERTE(int, 0, nbad);
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int main()
+{
+   EarthOrientation_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.seriesCacheTest();
+   errorTotal += testClass.batchTest();
+   errorTotal += testClass.threadsTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
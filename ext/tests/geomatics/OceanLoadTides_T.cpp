@@ -0,0 +1,160 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+
+/// @file OceanLoadTides_T.cpp
+/// Test the compiled sites and batch displacements of OceanLoadTides, which
+/// must agree with computeDisplacement() for a single site and time.
+
+#include <iostream>
+#include <vector>
+
+#include "OceanLoadTides.hpp"
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class OceanLoadTides_T
+{
+public:
+   OceanLoadTides_T();
+
+      /// compiled sites vs computeDisplacement(site,t)
+   int compiledTest();
+      /// invalid sites and indexes
+   int errorTest();
+
+private:
+   OceanLoadTides olt;
+   vector<string> sites;
+};
+
+OceanLoadTides_T::OceanLoadTides_T()
+{
+   string blqFile = getPathData() + getFileSep() + "testocean.blq";
+   vector<string> want;
+   olt.initializeSites(want, blqFile);    // empty list means all sites
+   sites = want;
+}
+
+//------------------------------------------------------------------------------------
+int OceanLoadTides_T::compiledTest()
+{
+   TUDEF("OceanLoadTides", "computeDisplacement");
+
+   TUASSERTE(size_t, 2, sites.size());
+
+   vector<int> idx;
+   for(size_t i=0; i<sites.size(); i++)
+      idx.push_back(olt.compileSite(sites[i]));
+   TUASSERTE(int, 0, idx[0]);
+   TUASSERTE(int, 1, idx[1]);
+   TUASSERTE(int, 1, olt.compileSite(sites[1]));
+   TUASSERTE(int, 2, olt.numCompiledSites());
+
+      // one day, hourly, plus epochs far from J2000 and the data
+   vector<EphTime> times;
+   for(int k=0; k<24; k++)
+      times.push_back(EphTime(55000, 3600.0*k + 12.5, TimeSystem::GPS));
+   times.push_back(EphTime(47892, 1234.5, TimeSystem::UTC));
+   times.push_back(EphTime(62503, 86399.0, TimeSystem::UTC));
+
+   const double eps(1.e-9);
+   for(size_t i=0; i<sites.size(); i++) {
+      vector<Triple> disp(olt.computeDisplacement(idx[i], times));
+      TUASSERTE(size_t, times.size(), disp.size());
+      int nbad(0);
+      double maxdiff(0.0), maxdisp(0.0);
+      for(size_t k=0; k<times.size(); k++) {
+         Triple ref(olt.computeDisplacement(sites[i], times[k]));
+         for(int j=0; j<3; j++) {
+            double diff(::fabs(disp[k][j]-ref[j]));
+            if(diff > maxdiff) maxdiff = diff;
+            if(::fabs(ref[j]) > maxdisp) maxdisp = ::fabs(ref[j]);
+            if(diff > eps) nbad++;
+         }
+      }
+      testFramework.assert(nbad == 0, "compiled site " + sites[i]
+         + " differs from computeDisplacement(site,t), max "
+         + StringUtils::asString(maxdiff), __LINE__);
+         // the sums are not trivially zero
+      TUASSERT(maxdisp > 0.005);
+   }
+
+      // several sites at one epoch
+   for(size_t k=0; k<times.size(); k+=5) {
+      vector<Triple> disp(olt.computeDisplacements(idx, times[k]));
+      TUASSERTE(size_t, idx.size(), disp.size());
+      for(size_t i=0; i<sites.size(); i++) {
+         Triple ref(olt.computeDisplacement(sites[i], times[k]));
+         for(int j=0; j<3; j++)
+            TUASSERTFEPS(ref[j], disp[i][j], eps);
+      }
+   }
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int OceanLoadTides_T::errorTest()
+{
+   TUDEF("OceanLoadTides", "compileSite");
+
+   try {
+      olt.compileSite("NOSUCHSITE");
+      TUFAIL("No exception for an unknown site");
+   }
+   catch(Exception& e) { TUPASS("Exception for an unknown site"); }
+
+   vector<EphTime> times(1, EphTime(55000, 0.0, TimeSystem::GPS));
+   try {
+      olt.computeDisplacement(olt.numCompiledSites(), times);
+      TUFAIL("No exception for an invalid site index");
+   }
+   catch(Exception& e) { TUPASS("Exception for an invalid site index"); }
+
+   try {
+      olt.computeDisplacements(vector<int>(1,-1), times[0]);
+      TUFAIL("No exception for an invalid site index");
+   }
+   catch(Exception& e) { TUPASS("Exception for an invalid site index"); }
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int main()
+{
+   OceanLoadTides_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.compiledTest();
+   errorTotal += testClass.errorTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}
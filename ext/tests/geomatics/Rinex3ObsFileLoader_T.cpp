@@ -0,0 +1,264 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//  
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024 
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public 
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file Rinex3ObsFileLoader_T.cpp
+/// Test Rinex3ObsFileLoader: loading with threads must give the same store,
+/// counts and messages as loading serially.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#include "Exception.hpp"
+#include "StringUtils.hpp"
+#include "Rinex3ObsFileLoader.hpp"
+
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class Rinex3ObsFileLoader_T
+{
+public:
+   Rinex3ObsFileLoader_T();
+
+      /// load lists of files serially and with threads, and compare
+   int threadsTest();
+      /// load files whose final record lacks its newline
+   int noNewlineTest();
+      /// report the time to load many files with 1 and N threads
+   int throughputTest();
+
+private:
+      /// Everything output by loading files.
+   struct Result
+   {
+      int nread;
+      string errmsg, msg, summary, data;
+      double dt;
+   };
+
+      /// Load files with nthreads threads
+   Result load(const vector<string>& fns, int nthreads, int nepochs = -1);
+
+   string dataPath, tempPath;
+};
+
+
+Rinex3ObsFileLoader_T ::
+Rinex3ObsFileLoader_T()
+{
+   dataPath = getPathData() + getFileSep();
+   tempPath = getPathTestTemp() + getFileSep();
+}
+
+
+Rinex3ObsFileLoader_T::Result Rinex3ObsFileLoader_T ::
+load(const vector<string>& fns, int nthreads, int nepochs)
+{
+   Result res;
+   Rinex3ObsFileLoader rofl(fns);
+   const char *ids[] = { "GC1*", "GL1*", "GC2*", "GL2*", "RC1*", "EC1*" };
+   for(int i = 0; i < 6; i++)
+      rofl.loadObsID(ids[i]);
+   rofl.saveTheData(true);
+   rofl.nEpochsToRead(nepochs);
+   rofl.setNumThreads(nthreads);
+
+   res.nread = rofl.loadFiles(res.errmsg, res.msg);
+   res.dt = rofl.getDT();
+   res.summary = rofl.asString();
+   ostringstream oss;
+   rofl.dumpStoreData(oss);
+   res.data = oss.str();
+   return res;
+}
+
+
+int Rinex3ObsFileLoader_T ::
+threadsTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "loadFiles");
+   try
+   {
+      vector< vector<string> > lists(4);
+         // consecutive RINEX 2 files
+      lists[0].push_back(dataPath + "arlm200a.15o");
+      lists[0].push_back(dataPath + "arlm200b.15o");
+         // RINEX 3 files
+      lists[1].push_back(dataPath + "test_input_rinex3_76193040.14o");
+      lists[1].push_back(dataPath + "test_input_rinex3_obs_SystemMixed.15o");
+      lists[1].push_back(dataPath + "test_input_rinex3_obs_RinexObsFile.15o");
+         // with a blank name, and files that cannot be read
+      lists[2] = lists[1];
+      lists[2].insert(lists[2].begin()+1, "  ");
+      lists[2].insert(lists[2].begin()+2, dataPath + "no_such_file.15o");
+      lists[2].push_back(dataPath + "test_input_rinex3_obs_BadEpochFlag.15o");
+      lists[2].push_back(dataPath +"test_input_rinex3_obs_IncompleteHeader.15o");
+      lists[2].push_back(dataPath + "test_input_rinex3_obs_FilterTest1.15o");
+         // RINEX 2 and 3
+      lists[3].push_back(dataPath + "test_input_rinex3_obs_FilterTest1.15o");
+      lists[3].push_back(dataPath + "arlm200a.15o");
+      lists[3].push_back(dataPath + "test_input_rinex3_obs_FilterTest2.15o");
+
+      for(size_t l = 0; l < lists.size(); l++)
+      {
+         Result ser(load(lists[l], 1));
+         TUASSERT(!ser.data.empty());
+         for(int nthreads = 0; nthreads <= 4; nthreads += 2)
+         {
+            Result par(load(lists[l], nthreads));
+            TUASSERTE(int, ser.nread, par.nread);
+            TUASSERTE(string, ser.errmsg, par.errmsg);
+            TUASSERTE(string, ser.msg, par.msg);
+            TUASSERTE(string, ser.summary, par.summary);
+            TUASSERTFE(ser.dt, par.dt);
+            TUASSERT(ser.data == par.data);
+         }
+
+            // stopping early
+         Result ser10(load(lists[l], 1, 10)), par10(load(lists[l], 4, 10));
+         TUASSERTE(string, ser10.summary, par10.summary);
+         TUASSERT(ser10.data == par10.data);
+      }
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsFileLoader_T ::
+noNewlineTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "loadFiles");
+   try
+   {
+         // RINEX 3 (mapped when threaded) and RINEX 2 (always streamed)
+      const char *names[] = { "test_input_rinex3_obs_RinexObsFile.15o",
+                              "arlm200a.15o" };
+      for(int f = 0; f < 2; f++)
+      {
+         string fn(dataPath + names[f]), cut(tempPath + "cut_" + names[f]);
+         ifstream ifs(fn.c_str(), ios::binary);
+         string contents((istreambuf_iterator<char>(ifs)),
+                         istreambuf_iterator<char>());
+         TUASSERT(contents.size() > 1 && contents[contents.size()-1] == '\n');
+         contents.erase(contents.size()-1);
+         ofstream ofs(cut.c_str(), ios::binary);
+         ofs << contents;
+         ofs.close();
+
+            // the final record is kept, serially and with threads
+         Result whole(load(vector<string>(1,fn), 1));
+         for(int nthreads = 1; nthreads <= 4; nthreads += 3)
+         {
+            Result res(load(vector<string>(1,cut), nthreads));
+            TUASSERTE(int, whole.nread, res.nread);
+            TUASSERTE(string, whole.errmsg, res.errmsg);
+            TUASSERT(whole.data == res.data);
+         }
+      }
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int Rinex3ObsFileLoader_T ::
+throughputTest()
+{
+   TUDEF("Rinex3ObsFileLoader", "loadFiles");
+   try
+   {
+      vector<string> fns;
+      for(int i = 0; i < 24; i++)
+         fns.push_back(dataPath + "test_input_rinex3_76193040.14o");
+
+      unsigned ncores(thread::hardware_concurrency());
+      if(ncores < 2)
+         ncores = 2;
+      double secs[2];
+      int nthreads[2] = { 1, int(ncores) };
+      string data[2];
+      for(int t = 0; t < 2; t++)
+      {
+         chrono::steady_clock::time_point start(chrono::steady_clock::now());
+         data[t] = load(fns, nthreads[t]).data;
+         secs[t] = chrono::duration<double>(chrono::steady_clock::now()
+                                            - start).count();
+      }
+      TUASSERT(data[0] == data[1]);
+      cout << "Loaded " << fns.size() << " files: 1 thread " << secs[0]
+           << " s, " << nthreads[1] << " threads " << secs[1] << " s" << endl;
+   }
+   catch(Exception& e)
+   {
+      cerr << e << endl;
+      TUFAIL("Unexpected exception");
+   }
+   TURETURN();
+}
+
+
+int main()
+{
+   int errorTotal = 0;
+   Rinex3ObsFileLoader_T testClass;
+
+   errorTotal += testClass.threadsTest();
+   errorTotal += testClass.noNewlineTest();
+   errorTotal += testClass.throughputTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return( errorTotal );
+}
@@ -0,0 +1,421 @@
+//==============================================================================
+//
+//  This file is part of GPSTk, the GPS Toolkit.
+//
+//  The GPSTk is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU Lesser General Public License as published
+//  by the Free Software Foundation; either version 3.0 of the License, or
+//  any later version.
+//
+//  The GPSTk is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with GPSTk; if not, write to the Free Software Foundation,
+//  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110, USA
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin.
+//  Copyright 2004-2020, The Board of Regents of The University of Texas System
+//
+//==============================================================================
+
+//==============================================================================
+//
+//  This software was developed by Applied Research Laboratories at the
+//  University of Texas at Austin, under contract to an agency or agencies
+//  within the U.S. Department of Defense. The U.S. Government retains all
+//  rights to use, duplicate, distribute, disclose, or release this software.
+//
+//  Pursuant to DoD Directive 523024
+//
+//  DISTRIBUTION STATEMENT A: This software has been approved for public
+//                            release, distribution is unlimited.
+//
+//==============================================================================
+
+/// @file SolarSystemEphemeris_T.cpp
+/// Test SolarSystemEphemeris with a small synthetic JPL ephemeris: the memory
+/// mapped records must give the Chebyshev series in the file, and a const
+/// object must give the same results when shared by several threads.
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#include "Exception.hpp"
+#include "TimeConstants.hpp"
+#include "SolarSystemEphemeris.hpp"
+
+#include "build_config.h"
+#include "TestUtil.hpp"
+
+using namespace std;
+using namespace gpstk;
+
+class SolarSystemEphemeris_T
+{
+public:
+   SolarSystemEphemeris_T();
+
+      /// compare positions and velocities with the series in the file
+   int accuracyTest();
+      /// times outside the file, uninitialized objects and gaps
+   int errorTest();
+      /// compute with one const object in several threads
+   int threadTest();
+
+private:
+      /// Indexes of some bodies in GROUP 1050 of the header
+   enum { MARS=3, PLUTO=8, MOON=9, SUN=10, NUTATIONS=11 };
+
+      /// Write the ASCII header and data for a synthetic ephemeris with nrec
+      /// records, omitting record skip (if >= 0), then convert them to the
+      /// binary file fn.
+   void makeEphemeris(const string& fn, int nrec, int skip = -1);
+
+      /// Evaluate the Chebyshev series for body 'which' (index in GROUP 1050) and
+      /// component comp at MJD, directly from coef.
+   double series(int which, int comp, double MJD) const;
+
+      /// Random-looking but repeatable times within the ephemeris.
+   vector<double> testTimes(int n) const;
+
+   string tempPath;
+      /// layout of the synthetic ephemeris, as in GROUP 1050
+   int c_offset[13], c_ncoeff[13], c_nsets[13], Ncoeff;
+      /// the records of the synthetic ephemeris
+   vector< vector<double> > coef;
+      /// number of records, and the span of each in days
+   static const int Nrec = 400;
+   static const double Span;
+      /// JD of the start of the first record
+   static const double StartJD;
+};
+
+const double SolarSystemEphemeris_T::Span = 32.0;
+const double SolarSystemEphemeris_T::StartJD = 2451536.5;
+
+//------------------------------------------------------------------------------------
+SolarSystemEphemeris_T ::
+SolarSystemEphemeris_T()
+{
+   tempPath = getPathTestTemp() + getFileSep();
+
+   // 10 Chebyshev coefficients for every body; the Moon has 4 sets per record
+   Ncoeff = 2;
+   for(int i=0; i<13; i++) {
+      c_offset[i] = Ncoeff+1;
+      c_ncoeff[i] = 10;
+      c_nsets[i] = (i == MOON ? 4 : 1);
+      Ncoeff += c_nsets[i] * c_ncoeff[i] *
+                (i == NUTATIONS ? 2 : 3);
+   }
+}
+
+//------------------------------------------------------------------------------------
+void SolarSystemEphemeris_T ::
+makeEphemeris(const string& fn, int nrec, int skip)
+{
+   // Values written in the JPL format, e.g. 0.123456789012345678D+03
+   struct JPL
+   {
+      static string fmt(double d)
+      {
+         char buf[40];
+         snprintf(buf, sizeof(buf), "%26.18E", d);
+         string s(buf);
+         s[s.find('E')] = 'D';
+         return s;
+      }
+   };
+
+   // the coefficients: a large leading term and smaller higher terms, so the
+   // positions look like positions
+   coef.clear();
+   for(int k=0; k<nrec; k++) {
+      vector<double> rec(Ncoeff);
+      rec[0] = StartJD + k*Span;
+      rec[1] = rec[0] + Span;
+      for(int j=2; j<Ncoeff; j++)
+         rec[j] = 1.e8*sin(0.37*j + 0.011*k*j) / (1 + (j-2)%10) / (1 + (j-2)%10);
+      coef.push_back(rec);
+   }
+
+   string hdrfn(fn + ".header"), datfn(fn + ".asc");
+   ofstream ofs(hdrfn.c_str());
+   ofs << "KSIZE= " << 2*Ncoeff << "    NCOEFF= " << Ncoeff << "\n\n";
+   ofs << "GROUP   1010\n\n"
+       << "JPL Planetary Ephemeris DE999/LE999\n"
+       << "Start Epoch: JED=  " << StartJD << "\n"
+       << "Final Epoch: JED=  " << StartJD + nrec*Span << "\n\n";
+   ofs << "GROUP   1030\n\n"
+       << JPL::fmt(StartJD) << JPL::fmt(StartJD + nrec*Span) << JPL::fmt(Span)
+       << "\n\n";
+   ofs << "GROUP   1040\n\n     3\n  DENUM   EMRAT   AU\n\n";
+   ofs << "GROUP   1041\n\n     3\n"
+       << JPL::fmt(999.) << JPL::fmt(81.30056) << JPL::fmt(149597870.691)
+       << "\n\n";
+   ofs << "GROUP   1050\n\n";
+   for(int i=0; i<13; i++) ofs << " " << c_offset[i];
+   ofs << "\n";
+   for(int i=0; i<13; i++) ofs << " " << c_ncoeff[i];
+   ofs << "\n";
+   for(int i=0; i<13; i++) ofs << " " << c_nsets[i];
+   ofs << "\n\nGROUP   1070\n\n";
+   ofs.close();
+
+   ofs.open(datfn.c_str());
+   for(int k=0; k<nrec; k++) {
+      if(k == skip) continue;
+      ofs << "     " << k+1 << "  " << Ncoeff << "\n";
+      for(int j=0; j<Ncoeff; j+=3) {
+         for(int i=j; i<j+3; i++)
+            ofs << JPL::fmt(i < Ncoeff ? coef[k][i] : 0.0);
+         ofs << "\n";
+      }
+   }
+   ofs.close();
+
+   SolarSystemEphemeris sse;
+   sse.readASCIIheader(hdrfn);
+   sse.readASCIIdata(datfn);
+   sse.writeBinaryFile(fn);
+}
+
+//------------------------------------------------------------------------------------
+double SolarSystemEphemeris_T ::
+series(int which, int comp, double MJD) const
+{
+   double JD(MJD + MJD_TO_JD);
+   int k = int((JD - StartJD)/Span);
+   if(k == int(coef.size())) k--;
+   const vector<double>& rec(coef[k]);
+
+   // sub-interval
+   double sub = Span/c_nsets[which];
+   int s = int((JD - rec[0])/sub);
+   if(s == c_nsets[which]) s--;
+   double T = 2.0*(JD - (rec[0] + s*sub))/sub - 1.0;
+
+   int ncomp = (which == NUTATIONS ? 2 : 3);
+   int N = c_ncoeff[which];
+   int i0 = c_offset[which]-1 + (s*ncomp + comp)*N;
+   double sum = 0.0, theta = acos(T);
+   for(int j=0; j<N; j++)
+      sum += rec[i0+j] * cos(j*theta);
+   return sum;
+}
+
+//------------------------------------------------------------------------------------
+vector<double> SolarSystemEphemeris_T ::
+testTimes(int n) const
+{
+   vector<double> times;
+   double first(StartJD - MJD_TO_JD), range(coef.size()*Span);
+   for(int i=0; i<n; i++)
+      times.push_back(first + range * fmod(0.6180339887*(i+1), 1.0));
+   return times;
+}
+
+//------------------------------------------------------------------------------------
+int SolarSystemEphemeris_T ::
+accuracyTest()
+{
+   TUDEF("SolarSystemEphemeris", "RelativeInertialPositionVelocity");
+
+   string fn(tempPath + "SolarSystemEphemeris_T.bin");
+   makeEphemeris(fn, Nrec);
+
+   SolarSystemEphemeris sse;
+   TUASSERTE(int, 0, sse.initializeWithBinaryFile(fn));
+   TUASSERTE(int, 999, sse.EphNumber());
+   const SolarSystemEphemeris& csse(sse);
+
+   // random times, the record boundaries and the ends of the ephemeris
+   vector<double> times(testTimes(500));
+   for(int k=0; k<=Nrec; k++)
+      times.push_back(StartJD - MJD_TO_JD + k*Span);
+
+   const struct { SolarSystemEphemeris::Planet id; int which; } bodies[] = {
+      { SolarSystemEphemeris::idSun, SUN },
+      { SolarSystemEphemeris::idMars, MARS },
+      { SolarSystemEphemeris::idPluto, PLUTO } };
+
+   double pv[6], pvp[6], pvm[6], h(1.e-4);
+   int bad = 0, badvel = 0;
+   for(size_t i=0; i<times.size(); i++) {
+      for(int b=0; b<3; b++) {
+         csse.RelativeInertialPositionVelocity(times[i], bodies[b].id,
+                      SolarSystemEphemeris::idSolarSystemBarycenter, pv);
+         for(int c=0; c<3; c++) {
+            double x = series(bodies[b].which, c, times[i]);
+            if(fabs(pv[c] - x) > 1.e-6*(1.0 + fabs(x))) {
+               if(bad++ < 5)
+                  cout << "Position differs at MJD " << times[i] << " body "
+                       << bodies[b].id << " comp " << c << " : " << pv[c]
+                       << " != " << x << endl;
+            }
+         }
+
+         // velocity by differencing, away from the ends of the ephemeris
+         if(i >= 500) continue;
+         csse.RelativeInertialPositionVelocity(times[i]+h, bodies[b].id,
+                      SolarSystemEphemeris::idSolarSystemBarycenter, pvp);
+         csse.RelativeInertialPositionVelocity(times[i]-h, bodies[b].id,
+                      SolarSystemEphemeris::idSolarSystemBarycenter, pvm);
+         for(int c=0; c<3; c++) {
+            double v = (pvp[c]-pvm[c])/(2*h);
+            if(fabs(pv[c+3] - v) > 1.e-4*(1.0 + fabs(v))) badvel++;
+         }
+      }
+
+      // nutations have two components
+      csse.RelativeInertialPositionVelocity(times[i],
+                   SolarSystemEphemeris::idNutations,
+                   SolarSystemEphemeris::idSolarSystemBarycenter, pv);
+      for(int c=0; c<2; c++) {
+         double x = series(NUTATIONS, c, times[i]);
+         if(fabs(pv[c] - x) > 1.e-6*(1.0 + fabs(x))) bad++;
+      }
+   }
+   TUASSERTE(int, 0, bad);
+   TUASSERTE(int, 0, badvel);
+
+   // relative positions are differences
+   csse.RelativeInertialPositionVelocity(times[0], SolarSystemEphemeris::idMars,
+                                         SolarSystemEphemeris::idSun, pv);
+   for(int c=0; c<3; c++) {
+      double x = series(MARS, c, times[0])
+               - series(SUN, c, times[0]);
+      TUASSERTFEPS(x, pv[c], 1.e-6*(1.0 + fabs(x)));
+   }
+
+   // the data read by readBinaryFile() is the same data
+   SolarSystemEphemeris rd;
+   TUASSERTE(int, 0, rd.readBinaryFile(fn));
+   TUASSERTFE(sse.startTimeMJD(), rd.startTimeMJD());
+   TUASSERTFE(sse.endTimeMJD(), rd.endTimeMJD());
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int SolarSystemEphemeris_T ::
+errorTest()
+{
+   TUDEF("SolarSystemEphemeris", "RelativeInertialPositionVelocity");
+
+   string fn(tempPath + "SolarSystemEphemeris_T.bin");
+   makeEphemeris(fn, Nrec);
+
+   double pv[6];
+   const SolarSystemEphemeris empty;
+   TUCSM("RelativeInertialPositionVelocity");
+   TUTHROW(empty.RelativeInertialPositionVelocity(55000.0,
+           SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+
+   SolarSystemEphemeris sse;
+   sse.initializeWithBinaryFile(fn);
+   double first(StartJD - MJD_TO_JD), last(first + Nrec*Span);
+   TUTHROW(sse.RelativeInertialPositionVelocity(first - 1.e-3,
+           SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+   TUTHROW(sse.RelativeInertialPositionVelocity(last + 1.e-3,
+           SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+   try {
+      sse.RelativeInertialPositionVelocity(first, SolarSystemEphemeris::idSun,
+                                           SolarSystemEphemeris::idEarth, pv);
+      sse.RelativeInertialPositionVelocity(last, SolarSystemEphemeris::idSun,
+                                           SolarSystemEphemeris::idEarth, pv);
+      TUPASS("ends of the ephemeris");
+   }
+   catch(Exception& e) {
+      TUFAIL("ends of the ephemeris: " + e.getText());
+   }
+
+   // the records must be contiguous
+   TUCSM("initializeWithBinaryFile");
+   string gapfn(tempPath + "SolarSystemEphemeris_T_gap.bin");
+   makeEphemeris(gapfn, 20, 10);
+   SolarSystemEphemeris gap;
+   TUTHROW(gap.initializeWithBinaryFile(gapfn));
+   TUTHROW(gap.RelativeInertialPositionVelocity(first + 1.0,
+           SolarSystemEphemeris::idSun, SolarSystemEphemeris::idEarth, pv));
+
+   // a missing file
+   TUTHROW(gap.initializeWithBinaryFile(tempPath + "SolarSystemEphemeris_T.none"));
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int SolarSystemEphemeris_T ::
+threadTest()
+{
+   TUDEF("SolarSystemEphemeris", "RelativeInertialPositionVelocity");
+
+   string fn(tempPath + "SolarSystemEphemeris_T.bin");
+   makeEphemeris(fn, Nrec);
+   SolarSystemEphemeris sse;
+   sse.initializeWithBinaryFile(fn);
+   const SolarSystemEphemeris& csse(sse);
+
+   const int N = 200000;
+   vector<double> times(testTimes(N));
+
+   // serial
+   vector<double> serial(6*N);
+   auto t0 = chrono::steady_clock::now();
+   for(int i=0; i<N; i++)
+      csse.RelativeInertialPositionVelocity(times[i], SolarSystemEphemeris::idMoon,
+                                  SolarSystemEphemeris::idEarth, &serial[6*i]);
+   double dt1 = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+
+   // threads, each taking every nthr'th time
+   unsigned nthr = max(2u, min(8u, thread::hardware_concurrency()));
+   vector<double> threaded(6*N);
+   vector<thread> threads;
+   t0 = chrono::steady_clock::now();
+   for(unsigned t=0; t<nthr; t++)
+      threads.push_back(thread([&, t]() {
+         for(int i=t; i<N; i+=nthr)
+            csse.RelativeInertialPositionVelocity(times[i],
+                  SolarSystemEphemeris::idMoon, SolarSystemEphemeris::idEarth,
+                  &threaded[6*i]);
+      }));
+   for(unsigned t=0; t<nthr; t++)
+      threads[t].join();
+   double dtN = chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+
+   int ndiff = 0;
+   for(int i=0; i<6*N; i++)
+      if(serial[i] != threaded[i]) ndiff++;
+   TUASSERTE(int, 0, ndiff);
+
+   cout << "Moon at " << N << " random times: " << dt1 << " s serial, "
+        << dtN << " s with " << nthr << " threads" << endl;
+
+   TURETURN();
+}
+
+//------------------------------------------------------------------------------------
+int main()
+{
+   SolarSystemEphemeris_T testClass;
+   int errorTotal = 0;
+
+   errorTotal += testClass.accuracyTest();
+   errorTotal += testClass.errorTest();
+   errorTotal += testClass.threadTest();
+
+   cout << "Total Failures for " << __FILE__ << ": " << errorTotal << endl;
+
+   return errorTotal;
+}